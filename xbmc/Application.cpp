@@ -1175,6 +1175,7 @@ void CApplication::CreateUserDirs()
   CDirectory::Create("special://masterprofile/");
   CDirectory::Create("special://temp/");
   CDirectory::Create("special://temp/temp"); // temp directory for python and dllGetTempPathA
+  CDirectory::Create("special://temp/dircache"); // network directory listings kept across restarts
 }
 
 bool CApplication::Initialize()
@@ -27,6 +27,7 @@
 #include "utils/TimeUtils.h"
 #include "utils/MathUtils.h"
 #include "utils/EndianSwap.h"
+#include "threads/Atomics.h"
 #include "threads/SingleLock.h"
 #include "settings/GUISettings.h"
 #include "settings/Settings.h"
@@ -67,6 +68,8 @@ CSoftAE::CSoftAE():
   m_rawPassthrough     (false       ),
   m_soundMode          (AE_SOUND_OFF),
   m_streamsPlaying     (false       ),
+  m_mixIndex           (0           ),
+  m_mixSequence        (0           ),
   m_encoder            (NULL        ),
   m_converted          (NULL        ),
   m_convertedSize      (0           ),
@@ -456,6 +459,7 @@ void CSoftAE::InternalOpenSink()
   }
 
   /* any new streams need to be initialized */
+  streamLock.Enter();
   for (StreamList::iterator itt = m_newStreams.begin(); itt != m_newStreams.end(); ++itt)
   {
     (*itt)->Initialize();
@@ -465,6 +469,8 @@ void CSoftAE::InternalOpenSink()
   }
   m_newStreams.clear();
   m_streamsPlaying = !m_playingStreams.empty();
+  PublishPlayingStreams();
+  streamLock.Leave();
 
   m_softSuspend = false;
 
@@ -734,6 +740,7 @@ void CSoftAE::ResumeStream(CSoftAEStream *stream)
   CSingleLock streamLock(m_streamLock);
   m_playingStreams.push_back(stream);
   stream->m_paused = false;
+  PublishPlayingStreams();
   streamLock.Leave();
 
   m_streamsPlaying = true;
@@ -1010,10 +1017,12 @@ void CSoftAE::Run()
       uint8_t *out = (uint8_t*)m_buffer.Take(m_frameSize);
       memset(out, 0, m_frameSize);
 
-      /* run the stream stage */
+      /* run the stream stage, see PublishPlayingStreams */
       CSoftAEStream *oldMaster = m_masterStream;
+      AtomicIncrement(&m_mixSequence);
       if ((this->*m_streamStageFn)(m_chLayout.Count(), out, restart) > 0)
         hasAudio = true; /* have some audio */
+      AtomicIncrement(&m_mixSequence);
 
       /* if in audiophile mode and the master stream has changed, flag for restart */
       if (m_audiophile && oldMaster != m_masterStream)
@@ -1282,12 +1291,11 @@ int CSoftAE::RunTranscodeStage(bool hasAudio)
 
 unsigned int CSoftAE::RunRawStreamStage(unsigned int channelCount, void *out, bool &restart)
 {
+  const StreamList &streams = m_mixStreams[m_mixIndex];
   StreamList resumeStreams;
-  static StreamList::iterator itt;
-  CSingleLock streamLock(m_streamLock);
 
   /* handle playing streams */
-  for (itt = m_playingStreams.begin(); itt != m_playingStreams.end(); ++itt)
+  for (StreamList::const_iterator itt = streams.begin(); itt != streams.end(); ++itt)
   {
     CSoftAEStream *sitt = *itt;
     if (sitt == m_masterStream)
@@ -1326,20 +1334,17 @@ unsigned int CSoftAE::RunRawStreamStage(unsigned int channelCount, void *out, bo
 
 unsigned int CSoftAE::RunStreamStage(unsigned int channelCount, void *out, bool &restart)
 {
-  // no point doing anything if we have no streams,
-  // we do not have to take a lock just to check empty
-  if (m_playingStreams.empty())
+  // no point doing anything if we have no streams
+  const StreamList &streams = m_mixStreams[m_mixIndex];
+  if (streams.empty())
     return 0;
 
   float *dst = (float*)out;
   unsigned int mixed = 0;
 
-  /* identify the master stream */
-  CSingleLock streamLock(m_streamLock);
-
   /* mix in any running streams */
   StreamList resumeStreams;
-  for (StreamList::iterator itt = m_playingStreams.begin(); itt != m_playingStreams.end(); ++itt)
+  for (StreamList::const_iterator itt = streams.begin(); itt != streams.end(); ++itt)
   {
     CSoftAEStream *stream = *itt;
 
@@ -1373,6 +1378,11 @@ inline void CSoftAE::ResumeSlaveStreams(const StreamList &streams)
   if (streams.empty())
     return;
 
+  /* dont wait if the streams are being changed, they are still drained on the next frame */
+  CSingleTryLock streamLock(m_streamLock);
+  if (!streamLock.IsOwner())
+    return;
+
   /* resume any streams that need to be */
   for (StreamList::const_iterator itt = streams.begin(); itt != streams.end(); ++itt)
   {
@@ -1381,6 +1391,7 @@ inline void CSoftAE::ResumeSlaveStreams(const StreamList &streams)
     stream->m_slave->m_paused = false;
     stream->m_slave = NULL;
   }
+  PublishPlayingStreams();
 }
 
 inline void CSoftAE::RemoveStream(StreamList &streams, CSoftAEStream *stream)
@@ -1389,8 +1400,33 @@ inline void CSoftAE::RemoveStream(StreamList &streams, CSoftAEStream *stream)
   if (f != streams.end())
     streams.erase(f);
 
-  if (streams == m_playingStreams)
+  if (&streams == &m_playingStreams)
+  {
     m_streamsPlaying = !m_playingStreams.empty();
+    PublishPlayingStreams();
+  }
+}
+
+/* this method MUST be called while holding m_streamLock */
+void CSoftAE::PublishPlayingStreams()
+{
+  /* the list not in use by the stream stage is free to be changed */
+  long index = 1 - m_mixIndex;
+  m_mixStreams[index] = m_playingStreams;
+
+  /* cas is a full barrier, the stream stage sees the complete list */
+  cas(&m_mixIndex, 1 - index, index);
+
+  /*
+    wait for the stream stage to finish with the old list, after that no
+    stream removed from it is referenced anymore and it can be reused
+  */
+  long sequence = m_mixSequence;
+  if ((sequence & 1) && !(m_thread && m_thread->IsCurrentThread()))
+  {
+    while (m_mixSequence == sequence)
+      Sleep(0);
+  }
 }
 
 inline void CSoftAE::ProcessSuspend()
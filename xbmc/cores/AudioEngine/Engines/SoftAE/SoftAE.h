@@ -185,6 +185,14 @@ private:
   bool           m_transcode;
   bool           m_rawPassthrough;
   StreamList     m_newStreams, m_streams, m_playingStreams;
+
+  /*
+    the stream stage mixes m_mixStreams[m_mixIndex], a copy of m_playingStreams,
+    without taking m_streamLock. m_mixSequence is odd while it is running.
+  */
+  StreamList     m_mixStreams[2];
+  volatile long  m_mixIndex;
+  volatile long  m_mixSequence;
   SoundList      m_sounds;
   SoundStateList m_playing_sounds;
   int            m_soundMode;
@@ -242,5 +250,6 @@ private:
   void         RunNormalizeStage (unsigned int channelCount, void *out, unsigned int mixed);
 
   void         RemoveStream(StreamList &streams, CSoftAEStream *stream);
+  void         PublishPlayingStreams();
 };
 
@@ -19,12 +19,16 @@
  */
 
 #include "system.h"
+#include "threads/Atomics.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/MathUtils.h"
+#include "settings/AdvancedSettings.h"
 
 #include "AEFactory.h"
 #include "Utils/AEUtil.h"
+#include "Resamplers/AEResamplePolyphase.h"
+#include "Resamplers/AEResampleSRC.h"
 
 #include "SoftAE.h"
 #include "SoftAEStream.h"
@@ -34,6 +38,13 @@
 
 using namespace std;
 
+static IAEResample *CreateResampler()
+{
+  if (g_advancedSettings.m_audioResampler.Equals("polyphase"))
+    return new CAEResamplePolyphase();
+  return new CAEResampleSRC();
+}
+
 CSoftAEStream::CSoftAEStream(enum AEDataFormat dataFormat, unsigned int sampleRate, unsigned int encodedSampleRate, CAEChannelInfo channelLayout, unsigned int options) :
   m_resampleRatio   (1.0  ),
   m_internalRatio   (1.0  ),
@@ -42,11 +53,14 @@ CSoftAEStream::CSoftAEStream(enum AEDataFormat dataFormat, unsigned int sampleRa
   m_delete          (false),
   m_volume          (1.0f ),
   m_rgain           (1.0f ),
-  m_refillBuffer    (0    ),
+  m_refilling       (false),
   m_convertFn       (NULL ),
-  m_ssrc            (NULL ),
-  m_framesBuffered  (0    ),
+  m_resampler       (NULL ),
+  m_resampleBuffer  (NULL ),
+  m_resampleFrames  (0    ),
   m_newPacket       (NULL ),
+  m_consumer        (0    ),
+  m_framesBuffered  (0    ),
   m_packet          (NULL ),
   m_vizPacketPos    (NULL ),
   m_draining        (false),
@@ -55,8 +69,6 @@ CSoftAEStream::CSoftAEStream(enum AEDataFormat dataFormat, unsigned int sampleRa
   m_fadeRunning     (false),
   m_slave           (NULL )
 {
-  m_ssrcData.data_out = NULL;
-
   m_initDataFormat        = dataFormat;
   m_initSampleRate        = sampleRate;
   m_initEncodedSampleRate = encodedSampleRate;
@@ -87,9 +99,13 @@ void CSoftAEStream::InitializeRemap()
     if (AE.GetChannelLayout() != m_aeChannelLayout)
     {
       InternalFlush();
+
+      /* the AE thread reads the frames using the frame size */
+      AcquireConsumer();
       m_aeChannelLayout = AE.GetChannelLayout();
       m_samplesPerFrame = AE.GetChannelLayout().Count();
       m_aeBytesPerFrame = AE_IS_RAW(m_initDataFormat) ? m_bytesPerFrame : (m_samplesPerFrame * sizeof(float));
+      ReleaseConsumer();
     }
   }
 }
@@ -107,8 +123,10 @@ void CSoftAEStream::Initialize()
 
     if (m_resample)
     {
-      _aligned_free(m_ssrcData.data_out);
-      m_ssrcData.data_out = NULL;
+      _aligned_free(m_resampleBuffer);
+      m_resampleBuffer = NULL;
+      delete m_resampler;
+      m_resampler = NULL;
     }
   }
 
@@ -138,7 +156,7 @@ void CSoftAEStream::Initialize()
   // set the waterlevel to 75 percent of the number of frames per second.
   // this lets us drain the main buffer down futher before flagging an underrun.
   m_waterLevel      = AE.GetSampleRate() - (AE.GetSampleRate() / 4);
-  m_refillBuffer    = m_waterLevel;
+  m_refilling       = true;
 
   m_format.m_dataFormat    = useDataFormat;
   m_format.m_sampleRate    = m_initSampleRate;
@@ -164,8 +182,6 @@ void CSoftAEStream::Initialize()
     m_newPacket->data.Alloc(m_format.m_frameSamples * sizeof(float));
   }
 
-  m_packet = NULL;
-
   m_inputBuffer.Alloc(m_format.m_frames * m_format.m_frameSize);
 
   m_resample      = (m_forceResample || m_initSampleRate != AE.GetSampleRate()) && !AE_IS_RAW(m_initDataFormat);
@@ -188,16 +204,31 @@ void CSoftAEStream::Initialize()
   /* if we need to resample, set it up */
   if (m_resample)
   {
-    int err;
-    m_ssrc                   = src_new(SRC_SINC_MEDIUM_QUALITY, m_initChannelLayout.Count(), &err);
-    m_ssrcData.data_in       = m_convertBuffer;
-    m_internalRatio          = (double)AE.GetSampleRate() / (double)m_initSampleRate;
-    m_ssrcData.src_ratio     = m_internalRatio;
-    m_ssrcData.data_out      = (float*)_aligned_malloc(m_format.m_frameSamples * (int)std::ceil(m_ssrcData.src_ratio) * sizeof(float), 16);
-    m_ssrcData.output_frames = m_format.m_frames * (long)std::ceil(m_ssrcData.src_ratio);
-    m_ssrcData.end_of_input  = 0;
+    m_internalRatio  = (double)AE.GetSampleRate() / (double)m_initSampleRate;
+    m_resampler      = CreateResampler();
+    if (!m_resampler->Initialize(m_initChannelLayout.Count(), m_internalRatio))
+    {
+      delete m_resampler;
+      m_resampler = NULL;
+      m_resample  = false;
+      m_valid     = false;
+      return;
+    }
+    CLog::Log(LOGDEBUG, "CSoftAEStream::Initialize - Resampling from %u to %u using %s", m_initSampleRate, AE.GetSampleRate(), m_resampler->GetName());
+
+    m_resampleBuffer = (float*)_aligned_malloc(m_format.m_frameSamples * (int)std::ceil(m_internalRatio) * sizeof(float), 16);
+    m_resampleFrames = m_format.m_frames * (unsigned int)std::ceil(m_internalRatio);
   }
 
+  /*
+    the queue has to hold the packets up to the waterlevel plus the ones made
+    from a full input buffer, this is called from the AE thread so it is not
+    reading from the queue while it is replaced
+  */
+  delete m_packet;
+  m_packet = NULL;
+  m_outBuffer.Create(m_waterLevel / m_format.m_frames + 2 * ((unsigned int)std::ceil(m_internalRatio) + 2));
+
   m_limiter.SetSamplerate(AE.GetSampleRate());
 
   m_chLayoutCount = m_format.m_channelLayout.Count();
@@ -221,9 +252,9 @@ CSoftAEStream::~CSoftAEStream()
 
   if (m_resample)
   {
-    _aligned_free(m_ssrcData.data_out);
-    src_delete(m_ssrc);
-    m_ssrc = NULL;
+    _aligned_free(m_resampleBuffer);
+    delete m_resampler;
+    m_resampler = NULL;
   }
 
   delete m_newPacket;
@@ -237,10 +268,11 @@ unsigned int CSoftAEStream::GetSpace()
   if (!m_valid || m_draining)
     return 0;
 
-  if (m_framesBuffered >= m_waterLevel)
+  unsigned int framesBuffered = GetFramesBuffered();
+  if (framesBuffered >= m_waterLevel)
     return 0;
 
-  return m_inputBuffer.Free() + (std::max(0U, (m_waterLevel - m_framesBuffered)) * m_format.m_frameSize);
+  return m_inputBuffer.Free() + ((m_waterLevel - framesBuffered) * m_format.m_frameSize);
 }
 
 unsigned int CSoftAEStream::AddData(void *data, unsigned int size)
@@ -253,7 +285,7 @@ unsigned int CSoftAEStream::AddData(void *data, unsigned int size)
   if (m_draining)
   {
     /* if the stream has finished draining, cork it */
-    if (m_packet && !m_packet->data.Used() && m_outBuffer.empty())
+    if (!m_packet && m_outBuffer.IsEmpty())
       m_draining = false;
     else
       return 0;
@@ -286,7 +318,7 @@ unsigned int CSoftAEStream::AddData(void *data, unsigned int size)
   lock.Leave();
 
   /* if the stream is flagged to autoStart when the buffer is full, then do it */
-  if (m_autoStart && m_framesBuffered >= m_waterLevel)
+  if (m_autoStart && GetFramesBuffered() >= m_waterLevel)
     Resume();
 
   return taken;
@@ -322,12 +354,10 @@ unsigned int CSoftAEStream::ProcessFrameBuffer()
   /* resample it if we need to */
   if (m_resample)
   {
-    m_ssrcData.input_frames = samples / m_chLayoutCount;
-    if (src_process(m_ssrc, &m_ssrcData) != 0)
-      return 0;
-    data     = (uint8_t*)m_ssrcData.data_out;
-    frames   = m_ssrcData.output_frames_gen;
-    consumed = m_ssrcData.input_frames_used * m_bytesPerFrame;
+    unsigned int used;
+    frames   = m_resampler->Resample(m_convertBuffer, samples / m_chLayoutCount, m_resampleBuffer, m_resampleFrames, used);
+    data     = (uint8_t*)m_resampleBuffer;
+    consumed = used * m_bytesPerFrame;
     if (!frames)
       return consumed;
 
@@ -340,16 +370,8 @@ unsigned int CSoftAEStream::ProcessFrameBuffer()
     consumed = frames * m_bytesPerFrame;
   }
 
-  if (m_refillBuffer)
-  {
-    if (frames > m_refillBuffer)
-      m_refillBuffer = 0;
-    else
-      m_refillBuffer -= frames;
-  }
-
   /* buffer the data */
-  m_framesBuffered += frames;
+  AtomicAdd(&m_framesBuffered, frames);
   const unsigned int inputBlockSize = m_format.m_frames * m_format.m_channelLayout.Count() * sampleSize;
 
   size_t remaining = samples * sampleSize;
@@ -367,7 +389,7 @@ unsigned int CSoftAEStream::ProcessFrameBuffer()
     /* if we have a full block of data */
     if (AE_IS_RAW(m_initDataFormat))
     {
-      m_outBuffer.push_back(m_newPacket);
+      PushPacket(m_newPacket);
       m_newPacket = new PPacket();
       m_newPacket->data.Alloc(inputBlockSize);
       continue;
@@ -399,17 +421,49 @@ unsigned int CSoftAEStream::ProcessFrameBuffer()
     }
 
     /* add the packet to the output */
-    m_outBuffer.push_back(pkt);
+    PushPacket(pkt);
     m_newPacket->data.Empty();
   }
 
   return consumed;
 }
 
+void CSoftAEStream::PushPacket(PPacket *packet)
+{
+  if (m_outBuffer.Push(packet))
+    return;
+
+  /* can't happen unless the queue was sized too small */
+  CLog::Log(LOGERROR, "CSoftAEStream::PushPacket - Packet queue is full, dropping packet");
+  AtomicSubtract(&m_framesBuffered, packet->data.Used() / m_aeBytesPerFrame);
+  delete packet;
+}
+
+void CSoftAEStream::AcquireConsumer()
+{
+  /* the AE thread only holds it for a single frame */
+  while (cas(&m_consumer, 0, 1) != 0)
+    Sleep(0);
+}
+
+void CSoftAEStream::ReleaseConsumer()
+{
+  cas(&m_consumer, 1, 0);
+}
+
 uint8_t* CSoftAEStream::GetFrame()
 {
-  CExclusiveLock lock(m_lock);
+  /* never wait for another thread, if the buffers are being flushed there is nothing to return anyway */
+  if (cas(&m_consumer, 0, 1) != 0)
+    return NULL;
 
+  uint8_t *ret = InternalGetFrame();
+  ReleaseConsumer();
+  return ret;
+}
+
+uint8_t* CSoftAEStream::InternalGetFrame()
+{
   /* if we are fading, this runs even if we have underrun as it is time based */
   if (m_fadeRunning)
   {
@@ -427,10 +481,18 @@ uint8_t* CSoftAEStream::GetFrame()
     }
   }
 
-  /* if we have been deleted or are refilling but not draining */
-  if (!m_valid || m_delete || (m_refillBuffer && !m_draining))
+  /* if we have been deleted */
+  if (!m_valid || m_delete)
     return NULL;
 
+  /* if we are refilling but not draining */
+  if (m_refilling && !m_draining)
+  {
+    if (GetFramesBuffered() < m_waterLevel)
+      return NULL;
+    m_refilling = false;
+  }
+
   /* if the packet is empty, advance to the next one */
   if (!m_packet || m_packet->data.CursorEnd())
   {
@@ -438,7 +500,8 @@ uint8_t* CSoftAEStream::GetFrame()
     m_packet = NULL;
 
     /* no more packets, return null */
-    if (m_outBuffer.empty())
+    PPacket *packet;
+    if (!m_outBuffer.Pop(packet))
     {
       if (m_draining)
         return NULL;
@@ -446,15 +509,13 @@ uint8_t* CSoftAEStream::GetFrame()
       {
         /* underrun, we need to refill our buffers */
         CLog::Log(LOGDEBUG, "CSoftAEStream::GetFrame - Underrun");
-        ASSERT(m_waterLevel > m_framesBuffered);
-        m_refillBuffer = m_waterLevel - m_framesBuffered;
+        m_refilling = true;
         return NULL;
       }
     }
 
     /* get the next packet */
-    m_packet = m_outBuffer.front();
-    m_outBuffer.pop_front();
+    m_packet = packet;
   }
 
   /* fetch one frame of data */
@@ -473,7 +534,7 @@ uint8_t* CSoftAEStream::GetFrame()
     }
   }
 
-  --m_framesBuffered;
+  AtomicDecrement(&m_framesBuffered);
   return ret;
 }
 
@@ -484,7 +545,7 @@ double CSoftAEStream::GetDelay()
 
   double delay = AE.GetDelay();
   delay += (double)(m_inputBuffer.Used() / m_format.m_frameSize) / (double)m_format.m_sampleRate;
-  delay += (double)m_framesBuffered                              / (double)AE.GetSampleRate();
+  delay += (double)GetFramesBuffered()                           / (double)AE.GetSampleRate();
 
   return delay;
 }
@@ -496,7 +557,7 @@ double CSoftAEStream::GetCacheTime()
 
   double time;
   time  = (double)(m_inputBuffer.Used() / m_format.m_frameSize) / (double)m_format.m_sampleRate;
-  time += (double)(m_waterLevel - m_framesBuffered)             / (double)AE.GetSampleRate();
+  time += (double)(m_waterLevel - GetFramesBuffered())          / (double)AE.GetSampleRate();
   time += AE.GetCacheTime();
   return time;
 }
@@ -538,8 +599,8 @@ void CSoftAEStream::Drain()
 
 bool CSoftAEStream::IsDrained()
 {
-  CSharedLock lock(m_lock);
-  return (m_draining && !m_packet && m_outBuffer.empty());
+  /* called by the AE thread, so this must not wait for m_lock */
+  return (m_draining && !m_packet && m_outBuffer.IsEmpty());
 }
 
 void CSoftAEStream::Flush()
@@ -556,10 +617,7 @@ void CSoftAEStream::InternalFlush()
 {
   /* reset the resampler */
   if (m_resample)
-  {
-    m_ssrcData.end_of_input = 0;
-    src_reset(m_ssrc);
-  }
+    m_resampler->Reset();
 
   /* invalidate any incoming samples */
   m_newPacket->data.Empty();
@@ -568,21 +626,20 @@ void CSoftAEStream::InternalFlush()
     clear the current buffered packet, we cant delete the data as it may be
     in use by the AE thread, so we just seek to the end of the buffer
   */
+  AcquireConsumer();
   if (m_packet)
     m_packet->data.CursorSeek(m_packet->data.Size());
 
   /* clear any other buffered packets */
-  while (!m_outBuffer.empty())
-  {
-    PPacket *p = m_outBuffer.front();
-    m_outBuffer.pop_front();
+  PPacket *p;
+  while (m_outBuffer.Pop(p))
     delete p;
-  }
 
   /* reset our counts */
   m_framesBuffered = 0;
-  m_refillBuffer   = m_waterLevel;
+  m_refilling      = true;
   m_draining       = false;
+  ReleaseConsumer();
 }
 
 double CSoftAEStream::GetResampleRatio()
@@ -591,7 +648,7 @@ double CSoftAEStream::GetResampleRatio()
     return 1.0f;
 
   CSharedLock lock(m_lock);
-  return m_ssrcData.src_ratio;
+  return m_resampler->GetRatio();
 }
 
 bool CSoftAEStream::SetResampleRatio(double ratio)
@@ -599,21 +656,20 @@ bool CSoftAEStream::SetResampleRatio(double ratio)
   if (!m_resample)
     return false;
 
-  CSharedLock lock(m_lock);
+  CExclusiveLock lock(m_lock);
 
-  int oldRatioInt = (int)std::ceil(m_ssrcData.src_ratio);
+  int oldRatioInt = (int)std::ceil(m_resampler->GetRatio());
 
   m_resampleRatio = ratio;
-
-  src_set_ratio(m_ssrc, m_resampleRatio * m_internalRatio);
-  m_ssrcData.src_ratio = m_resampleRatio * m_internalRatio;
+  if (!m_resampler->SetRatio(m_resampleRatio * m_internalRatio))
+    return false;
 
   //Check the resample buffer size and resize if necessary.
-  if (oldRatioInt < std::ceil(m_ssrcData.src_ratio))
+  if (oldRatioInt < std::ceil(m_resampler->GetRatio()))
   {
-    _aligned_free(m_ssrcData.data_out);
-    m_ssrcData.data_out      = (float*)_aligned_malloc(m_format.m_frameSamples * (int)std::ceil(m_ssrcData.src_ratio) * sizeof(float), 16);
-    m_ssrcData.output_frames = m_format.m_frames * (long)std::ceil(m_ssrcData.src_ratio);
+    _aligned_free(m_resampleBuffer);
+    m_resampleBuffer = (float*)_aligned_malloc(m_format.m_frameSamples * (int)std::ceil(m_resampler->GetRatio()) * sizeof(float), 16);
+    m_resampleFrames = m_format.m_frames * (unsigned int)std::ceil(m_resampler->GetRatio());
   }
   return true;
 }
@@ -621,17 +677,22 @@ bool CSoftAEStream::SetResampleRatio(double ratio)
 void CSoftAEStream::RegisterAudioCallback(IAudioCallback* pCallback)
 {
   CExclusiveLock lock(m_lock);
+  if (pCallback)
+    pCallback->OnInitialize(2, m_initSampleRate, 32);
+
+  AcquireConsumer();
   m_vizBufferSamples = 0;
   m_audioCallback = pCallback;
-  if (m_audioCallback)
-    m_audioCallback->OnInitialize(2, m_initSampleRate, 32);
+  ReleaseConsumer();
 }
 
 void CSoftAEStream::UnRegisterAudioCallback()
 {
   CExclusiveLock lock(m_lock);
+  AcquireConsumer();
   m_audioCallback = NULL;
   m_vizBufferSamples = 0;
+  ReleaseConsumer();
 }
 
 void CSoftAEStream::FadeVolume(float from, float target, unsigned int time)
@@ -641,16 +702,17 @@ void CSoftAEStream::FadeVolume(float from, float target, unsigned int time)
     return;
 
   CExclusiveLock lock(m_lock);
+  AcquireConsumer();
   float delta   = target - from;
   m_fadeDirUp   = target > from;
   m_fadeTarget  = target;
   m_fadeStep    = delta / (((float)AE.GetSampleRate() / 1000.0f) * (float)time);
   m_fadeRunning = true;
+  ReleaseConsumer();
 }
 
 bool CSoftAEStream::IsFading()
 {
-  CSharedLock lock(m_lock);
   return m_fadeRunning;
 }
 
@@ -19,17 +19,16 @@
  *
  */
 
-#include <samplerate.h>
-#include <list>
-
 #include "threads/SharedSection.h"
 
 #include "AEAudioFormat.h"
 #include "Interfaces/AEStream.h"
+#include "Interfaces/AEResample.h"
 #include "Utils/AEConvert.h"
 #include "Utils/AERemap.h"
 #include "Utils/AEBuffer.h"
 #include "Utils/AELimiter.h"
+#include "Utils/AERingQueue.h"
 
 class IAEPostProc;
 class CSoftAEStream : public IAEStream
@@ -53,7 +52,7 @@ public:
   virtual unsigned int      GetSpace        ();
   virtual unsigned int      AddData         (void *data, unsigned int size);
   virtual double            GetDelay        ();
-  virtual bool              IsBuffering     () { return m_refillBuffer > 0; }
+  virtual bool              IsBuffering     () { return m_refilling && GetFramesBuffered() < m_waterLevel; }
   virtual double            GetCacheTime    ();
   virtual double            GetCacheTotal   ();
 
@@ -90,6 +89,7 @@ public:
 private:
   void InternalFlush();
   void CheckResampleBuffers();
+  unsigned int GetFramesBuffered() { return (unsigned int)m_framesBuffered; }
 
   CSharedSection    m_lock;
   enum AEDataFormat m_initDataFormat;
@@ -118,7 +118,7 @@ private:
   float                   m_volume;        /* the volume level */
   float                   m_rgain;         /* replay gain level */
   unsigned int            m_waterLevel;    /* the fill level to fall below before calling the data callback */
-  unsigned int            m_refillBuffer;  /* how many frames that need to be buffered before we return any frames */
+  bool                    m_refilling;     /* true if the waterlevel has to be reached before we return any frames */
 
   CAEConvert::AEConvertToFn m_convertFn;
 
@@ -128,13 +128,25 @@ private:
   unsigned int        m_samplesPerFrame;
   CAEChannelInfo      m_aeChannelLayout;
   unsigned int        m_aeBytesPerFrame;
-  SRC_STATE          *m_ssrc;
-  SRC_DATA            m_ssrcData;
-  unsigned int        m_framesBuffered;
-  std::list<PPacket*> m_outBuffer;
+  IAEResample        *m_resampler;
+  float              *m_resampleBuffer;
+  unsigned int        m_resampleFrames;
   unsigned int        ProcessFrameBuffer();
+  void                PushPacket(PPacket *packet);
   PPacket            *m_newPacket;
+
+  /*
+    the packets are handed to the AE thread without taking m_lock. it owns
+    the reading side of m_outBuffer and m_packet while it holds m_consumer,
+    anyone else has to acquire m_consumer to touch them
+  */
+  volatile long       m_consumer;
+  volatile long       m_framesBuffered;
+  AERingQueue<PPacket*> m_outBuffer;
   PPacket            *m_packet;
+  uint8_t*            InternalGetFrame();
+  void                AcquireConsumer();
+  void                ReleaseConsumer();
   uint8_t            *m_packetPos;
   float              *m_vizPacketPos;
   bool                m_paused;
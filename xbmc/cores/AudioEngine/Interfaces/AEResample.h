@@ -0,0 +1,81 @@
+#pragma once
+/*
+ *      Copyright (C) 2010-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * IAEResample interface for sample rate converters working on interleaved
+ * float samples
+ */
+class IAEResample
+{
+public:
+  /**
+   * Constructor
+   */
+  IAEResample() {};
+
+  /**
+   * Destructor
+   */
+  virtual ~IAEResample() {};
+
+  /**
+   * Returns the name of the resampler
+   * @return the name of the resampler
+   */
+  virtual const char *GetName() = 0;
+
+  /**
+   * Called to setup the resampler
+   * @param channels the number of interleaved channels
+   * @param ratio the output sample rate divided by the input sample rate
+   * @return true on success, false on failure
+   */
+  virtual bool Initialize(unsigned int channels, double ratio) = 0;
+
+  /**
+   * Changes the ratio while resampling, eg. to keep the audio in sync with the video
+   * @param ratio the output sample rate divided by the input sample rate
+   * @return true on success, false on failure
+   */
+  virtual bool SetRatio(double ratio) = 0;
+
+  /**
+   * Returns the current ratio
+   * @return the output sample rate divided by the input sample rate
+   */
+  virtual double GetRatio() = 0;
+
+  /**
+   * Drops any buffered samples
+   */
+  virtual void Reset() = 0;
+
+  /**
+   * Resamples the supplied frames
+   * @param in the input frames
+   * @param inFrames the number of frames in in
+   * @param out the buffer for the resampled frames
+   * @param outFrames the number of frames that fit into out
+   * @param inUsed returns the number of input frames consumed
+   * @return the number of frames written to out
+   */
+  virtual unsigned int Resample(float *in, unsigned int inFrames, float *out, unsigned int outFrames, unsigned int &inUsed) = 0;
+};
@@ -0,0 +1,310 @@
+/*
+ *      Copyright (C) 2010-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <map>
+
+#include "system.h"
+#include "AEResamplePolyphase.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+#if defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* the tap the output frame is centered on, the filter reaches one tap further ahead than back */
+#define CENTER_TAP (AE_POLYPHASE_TAPS / 2 - 1)
+
+/* kaiser window shape, gives about 80dB stop band attenuation */
+#define KAISER_BETA 7.857
+
+/* the pass band ends this far below the nyquist frequency (in 1/1000) to leave room for the transition band */
+#define PASSBAND 920
+
+/* how many input frames are buffered at most in addition to the filter length */
+#define HISTORY_FRAMES 8192
+
+static CCriticalSection g_tableSection;
+static std::map<unsigned int, float*> g_tables;
+
+/* zeroth order modified bessel function of the first kind */
+static double BesselI0(double x)
+{
+  double sum  = 1.0;
+  double term = 1.0;
+  for (int k = 1; k < 50; ++k)
+  {
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+    sum  += term;
+    if (term < sum * 1e-12)
+      break;
+  }
+  return sum;
+}
+
+static inline float DotProduct(const float *samples, const float *coefs)
+{
+#if defined(__SSE__)
+  __m128 acc0 = _mm_setzero_ps();
+  __m128 acc1 = _mm_setzero_ps();
+  for (unsigned int i = 0; i < AE_POLYPHASE_TAPS; i += 8)
+  {
+    acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(samples + i    ), _mm_load_ps(coefs + i    )));
+    acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(samples + i + 4), _mm_load_ps(coefs + i + 4)));
+  }
+  acc0 = _mm_add_ps(acc0, acc1);
+  acc0 = _mm_add_ps(acc0, _mm_movehl_ps(acc0, acc0));
+  acc0 = _mm_add_ss(acc0, _mm_shuffle_ps(acc0, acc0, 1));
+  return _mm_cvtss_f32(acc0);
+#elif defined(__ARM_NEON__)
+  float32x4_t acc0 = vdupq_n_f32(0.0f);
+  float32x4_t acc1 = vdupq_n_f32(0.0f);
+  for (unsigned int i = 0; i < AE_POLYPHASE_TAPS; i += 8)
+  {
+    acc0 = vmlaq_f32(acc0, vld1q_f32(samples + i    ), vld1q_f32(coefs + i    ));
+    acc1 = vmlaq_f32(acc1, vld1q_f32(samples + i + 4), vld1q_f32(coefs + i + 4));
+  }
+  acc0 = vaddq_f32(acc0, acc1);
+  float32x2_t sum = vadd_f32(vget_low_f32(acc0), vget_high_f32(acc0));
+  sum = vpadd_f32(sum, sum);
+  return vget_lane_f32(sum, 0);
+#else
+  float acc0 = 0.0f, acc1 = 0.0f, acc2 = 0.0f, acc3 = 0.0f;
+  for (unsigned int i = 0; i < AE_POLYPHASE_TAPS; i += 4)
+  {
+    acc0 += samples[i    ] * coefs[i    ];
+    acc1 += samples[i + 1] * coefs[i + 1];
+    acc2 += samples[i + 2] * coefs[i + 2];
+    acc3 += samples[i + 3] * coefs[i + 3];
+  }
+  return (acc0 + acc1) + (acc2 + acc3);
+#endif
+}
+
+CAEResamplePolyphase::CAEResamplePolyphase() :
+  m_channels   (0   ),
+  m_ratio      (1.0 ),
+  m_step       (1.0 ),
+  m_position   (0.0 ),
+  m_cutoff     (0   ),
+  m_table      (NULL),
+  m_coefs      (NULL),
+  m_history    (NULL),
+  m_historySize(0   ),
+  m_historyUsed(0   )
+{
+}
+
+CAEResamplePolyphase::~CAEResamplePolyphase()
+{
+  _aligned_free(m_coefs);
+  _aligned_free(m_history);
+}
+
+bool CAEResamplePolyphase::Initialize(unsigned int channels, double ratio)
+{
+  if (channels == 0 || ratio <= 0.0)
+    return false;
+
+  _aligned_free(m_history);
+  m_channels    = channels;
+  m_historySize = AE_POLYPHASE_TAPS + HISTORY_FRAMES;
+  m_history     = (float*)_aligned_malloc(m_channels * m_historySize * sizeof(float), 16);
+
+  if (!m_coefs)
+    m_coefs = (float*)_aligned_malloc(AE_POLYPHASE_TAPS * sizeof(float), 16);
+
+  m_cutoff = 0;
+  if (!SetRatio(ratio))
+    return false;
+
+  Reset();
+  return true;
+}
+
+unsigned int CAEResamplePolyphase::GetCutoff(double ratio)
+{
+  /*
+    when downsampling the cutoff has to move down with the output nyquist
+    frequency, it is rounded down to whole percents so the small changes
+    made to keep in sync don't need new tables all the time
+  */
+  unsigned int cutoff = PASSBAND;
+  if (ratio < 1.0)
+    cutoff = std::max(10U, (unsigned int)(PASSBAND * ratio / 10.0) * 10);
+  return cutoff;
+}
+
+bool CAEResamplePolyphase::SetRatio(double ratio)
+{
+  if (ratio <= 0.0)
+    return false;
+
+  m_ratio = ratio;
+  m_step  = 1.0 / ratio;
+
+  unsigned int cutoff = GetCutoff(ratio);
+  if (cutoff != m_cutoff)
+  {
+    m_table  = GetTable(cutoff);
+    m_cutoff = cutoff;
+  }
+
+  return true;
+}
+
+void CAEResamplePolyphase::Reset()
+{
+  /* start with silence before the first frame so the output is not delayed by the filter */
+  memset(m_history, 0, m_channels * m_historySize * sizeof(float));
+  m_historyUsed = CENTER_TAP;
+  m_position    = CENTER_TAP;
+}
+
+const float *CAEResamplePolyphase::GetTable(unsigned int cutoff)
+{
+  CSingleLock lock(g_tableSection);
+  std::map<unsigned int, float*>::iterator itt = g_tables.find(cutoff);
+  if (itt != g_tables.end())
+    return itt->second;
+
+  /*
+    row p holds the coefficients for an output frame p / AE_POLYPHASE_PHASES
+    frames after the center tap, there is one extra row to interpolate to
+  */
+  float *table = (float*)_aligned_malloc((AE_POLYPHASE_PHASES + 1) * AE_POLYPHASE_TAPS * sizeof(float), 16);
+  const double fc   = cutoff / 1000.0;
+  const double half = AE_POLYPHASE_TAPS / 2;
+  const double norm = BesselI0(KAISER_BETA);
+
+  for (unsigned int p = 0; p <= AE_POLYPHASE_PHASES; ++p)
+  {
+    float *row = table + p * AE_POLYPHASE_TAPS;
+    double sum = 0.0;
+    for (unsigned int t = 0; t < AE_POLYPHASE_TAPS; ++t)
+    {
+      double x = (double)t - CENTER_TAP - (double)p / AE_POLYPHASE_PHASES;
+      double w = x / half;
+      double h = 0.0;
+      if (w > -1.0 && w < 1.0)
+      {
+        double sinc = x == 0.0 ? 1.0 : sin(M_PI * fc * x) / (M_PI * fc * x);
+        h = fc * sinc * BesselI0(KAISER_BETA * sqrt(1.0 - w * w)) / norm;
+      }
+      row[t] = (float)h;
+      sum   += h;
+    }
+
+    /* unity gain for every phase */
+    for (unsigned int t = 0; t < AE_POLYPHASE_TAPS; ++t)
+      row[t] = (float)(row[t] / sum);
+  }
+
+  CLog::Log(LOGDEBUG, "CAEResamplePolyphase::GetTable - Created the filter table for a cutoff of %u/1000", cutoff);
+  g_tables[cutoff] = table;
+  return table;
+}
+
+inline void CAEResamplePolyphase::MakeCoefficients(double fraction)
+{
+  double       phase  = fraction * AE_POLYPHASE_PHASES;
+  unsigned int row    = std::min((unsigned int)phase, (unsigned int)AE_POLYPHASE_PHASES - 1);
+  float        weight = (float)(phase - row);
+
+  const float *a = m_table + row * AE_POLYPHASE_TAPS;
+  const float *b = a + AE_POLYPHASE_TAPS;
+
+#if defined(__SSE__)
+  __m128 w = _mm_set1_ps(weight);
+  for (unsigned int t = 0; t < AE_POLYPHASE_TAPS; t += 4)
+  {
+    __m128 va = _mm_load_ps(a + t);
+    __m128 vb = _mm_load_ps(b + t);
+    _mm_store_ps(m_coefs + t, _mm_add_ps(va, _mm_mul_ps(w, _mm_sub_ps(vb, va))));
+  }
+#elif defined(__ARM_NEON__)
+  float32x4_t w = vdupq_n_f32(weight);
+  for (unsigned int t = 0; t < AE_POLYPHASE_TAPS; t += 4)
+  {
+    float32x4_t va = vld1q_f32(a + t);
+    float32x4_t vb = vld1q_f32(b + t);
+    vst1q_f32(m_coefs + t, vmlaq_f32(va, w, vsubq_f32(vb, va)));
+  }
+#else
+  for (unsigned int t = 0; t < AE_POLYPHASE_TAPS; ++t)
+    m_coefs[t] = a[t] + weight * (b[t] - a[t]);
+#endif
+}
+
+unsigned int CAEResamplePolyphase::Resample(float *in, unsigned int inFrames, float *out, unsigned int outFrames, unsigned int &inUsed)
+{
+  /* split the input into the history of each channel */
+  inUsed = std::min(inFrames, m_historySize - m_historyUsed);
+  for (unsigned int ch = 0; ch < m_channels; ++ch)
+  {
+    float       *dst = m_history + ch * m_historySize + m_historyUsed;
+    const float *src = in + ch;
+    for (unsigned int i = 0; i < inUsed; ++i, src += m_channels)
+      dst[i] = *src;
+  }
+  m_historyUsed += inUsed;
+
+  /* each output frame needs the frames up to half the filter length ahead of it */
+  unsigned int generated = 0;
+  while (generated < outFrames)
+  {
+    unsigned int index = (unsigned int)m_position;
+    if (index + AE_POLYPHASE_TAPS - CENTER_TAP > m_historyUsed)
+      break;
+
+    MakeCoefficients(m_position - index);
+
+    const float *samples = m_history + index - CENTER_TAP;
+    for (unsigned int ch = 0; ch < m_channels; ++ch, samples += m_historySize)
+      *out++ = DotProduct(samples, m_coefs);
+
+    m_position += m_step;
+    ++generated;
+  }
+
+  /* drop the frames which are not needed anymore */
+  unsigned int drop = std::min((unsigned int)m_position - std::min((unsigned int)m_position, (unsigned int)CENTER_TAP), m_historyUsed);
+  if (drop)
+  {
+    for (unsigned int ch = 0; ch < m_channels; ++ch)
+    {
+      float *block = m_history + ch * m_historySize;
+      memmove(block, block + drop, (m_historyUsed - drop) * sizeof(float));
+    }
+    m_historyUsed -= drop;
+    m_position    -= drop;
+  }
+
+  return generated;
+}
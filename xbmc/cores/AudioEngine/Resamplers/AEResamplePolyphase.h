@@ -0,0 +1,69 @@
+#pragma once
+/*
+ *      Copyright (C) 2010-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Interfaces/AEResample.h"
+
+/* the number of taps of the filter, a multiple of 8 */
+#define AE_POLYPHASE_TAPS   64
+/* the number of phases in the filter table, positions in between are interpolated */
+#define AE_POLYPHASE_PHASES 256
+
+/**
+ * Polyphase FIR resampler
+ *
+ * The filter is a Kaiser windowed sinc, evaluated once per cutoff frequency
+ * into a table of AE_POLYPHASE_PHASES phases which is shared by all the
+ * instances. Any ratio is supported as the coefficients for an output frame
+ * are interpolated from the two nearest phases, so the ratio can change
+ * while resampling without a glitch.
+ */
+class CAEResamplePolyphase : public IAEResample
+{
+public:
+  CAEResamplePolyphase();
+  virtual ~CAEResamplePolyphase();
+
+  virtual const char  *GetName() { return "polyphase"; }
+  virtual bool         Initialize(unsigned int channels, double ratio);
+  virtual bool         SetRatio(double ratio);
+  virtual double       GetRatio() { return m_ratio; }
+  virtual void         Reset();
+  virtual unsigned int Resample(float *in, unsigned int inFrames, float *out, unsigned int outFrames, unsigned int &inUsed);
+
+private:
+  static const float *GetTable(unsigned int cutoff);
+  static unsigned int GetCutoff(double ratio);
+  void MakeCoefficients(double fraction);
+
+  unsigned int  m_channels;
+  double        m_ratio;
+  double        m_step;     /* input frames per output frame */
+  double        m_position; /* position of the next output frame in the history */
+
+  unsigned int  m_cutoff;   /* cutoff of the table in 1/1000 of the input nyquist frequency */
+  const float  *m_table;
+  float        *m_coefs;    /* the coefficients for the current output frame */
+
+  /* the input samples not fully used yet, one block of m_historySize samples per channel */
+  float        *m_history;
+  unsigned int  m_historySize;
+  unsigned int  m_historyUsed;
+};
@@ -0,0 +1,84 @@
+/*
+ *      Copyright (C) 2010-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "AEResampleSRC.h"
+#include "utils/log.h"
+
+CAEResampleSRC::CAEResampleSRC() :
+  m_state(NULL)
+{
+  m_data.src_ratio = 1.0;
+}
+
+CAEResampleSRC::~CAEResampleSRC()
+{
+  if (m_state)
+    src_delete(m_state);
+}
+
+bool CAEResampleSRC::Initialize(unsigned int channels, double ratio)
+{
+  if (m_state)
+    src_delete(m_state);
+
+  int err;
+  m_state = src_new(SRC_SINC_MEDIUM_QUALITY, channels, &err);
+  if (!m_state)
+  {
+    CLog::Log(LOGERROR, "CAEResampleSRC::Initialize - Failed to create the converter: %s", src_strerror(err));
+    return false;
+  }
+
+  m_data.src_ratio    = ratio;
+  m_data.end_of_input = 0;
+  return true;
+}
+
+bool CAEResampleSRC::SetRatio(double ratio)
+{
+  if (!m_state || src_set_ratio(m_state, ratio) != 0)
+    return false;
+
+  m_data.src_ratio = ratio;
+  return true;
+}
+
+void CAEResampleSRC::Reset()
+{
+  if (m_state)
+    src_reset(m_state);
+}
+
+unsigned int CAEResampleSRC::Resample(float *in, unsigned int inFrames, float *out, unsigned int outFrames, unsigned int &inUsed)
+{
+  m_data.data_in       = in;
+  m_data.input_frames  = inFrames;
+  m_data.data_out      = out;
+  m_data.output_frames = outFrames;
+
+  if (!m_state || src_process(m_state, &m_data) != 0)
+  {
+    inUsed = 0;
+    return 0;
+  }
+
+  inUsed = m_data.input_frames_used;
+  return m_data.output_frames_gen;
+}
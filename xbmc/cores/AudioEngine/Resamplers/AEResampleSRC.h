@@ -0,0 +1,45 @@
+#pragma once
+/*
+ *      Copyright (C) 2010-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <samplerate.h>
+
+#include "cores/AudioEngine/Interfaces/AEResample.h"
+
+/**
+ * Resampler using the sinc converter of libsamplerate
+ */
+class CAEResampleSRC : public IAEResample
+{
+public:
+  CAEResampleSRC();
+  virtual ~CAEResampleSRC();
+
+  virtual const char  *GetName() { return "libsamplerate"; }
+  virtual bool         Initialize(unsigned int channels, double ratio);
+  virtual bool         SetRatio(double ratio);
+  virtual double       GetRatio() { return m_data.src_ratio; }
+  virtual void         Reset();
+  virtual unsigned int Resample(float *in, unsigned int inFrames, float *out, unsigned int outFrames, unsigned int &inUsed);
+
+private:
+  SRC_STATE *m_state;
+  SRC_DATA   m_data;
+};
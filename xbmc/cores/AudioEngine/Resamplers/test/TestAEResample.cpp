@@ -0,0 +1,184 @@
+/*
+ *      Copyright (C) 2010-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Resamplers/AEResamplePolyphase.h"
+#include "cores/AudioEngine/Resamplers/AEResampleSRC.h"
+#include "threads/SystemClock.h"
+
+#include "gtest/gtest.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+#define CHANNELS 2
+#define CHUNK    1024
+#define TONE     1000.0
+
+static std::vector<float> Sine(double rate, unsigned int frames)
+{
+  std::vector<float> samples(frames * CHANNELS);
+  for (unsigned int i = 0; i < frames; i++)
+    for (unsigned int c = 0; c < CHANNELS; c++)
+      samples[i * CHANNELS + c] = (float)(0.5 * sin(2.0 * M_PI * TONE * i / rate));
+
+  return samples;
+}
+
+/* feeds the input in chunks like SoftAEStream does, returns the frames made */
+static unsigned int Process(IAEResample &resampler, std::vector<float> &in, std::vector<float> &out)
+{
+  unsigned int inFrames  = in.size() / CHANNELS;
+  unsigned int outFrames = out.size() / CHANNELS;
+  unsigned int pos = 0, made = 0;
+  while (pos < inFrames && made < outFrames)
+  {
+    unsigned int used;
+    unsigned int take = std::min((unsigned int)CHUNK, inFrames - pos);
+    made += resampler.Resample(&in[pos * CHANNELS], take, &out[made * CHANNELS], outFrames - made, used);
+    pos  += used;
+  }
+
+  return made;
+}
+
+/* signal to noise ratio in dB against the ideal tone, skipping both ends */
+static double SNR(const std::vector<float> &out, unsigned int frames, double rate)
+{
+  double signal = 0.0, noise = 0.0;
+  for (unsigned int i = 2000; i + 2000 < frames; i++)
+  {
+    double ideal = 0.5 * sin(2.0 * M_PI * TONE * i / rate);
+    double diff  = out[i * CHANNELS + 1] - ideal;
+    signal += ideal * ideal;
+    noise  += diff  * diff;
+  }
+
+  return 10.0 * log10(signal / noise);
+}
+
+static const double rates[][2] =
+{
+  { 44100, 48000 },
+  { 48000, 44100 },
+  { 48000, 96000 },
+  { 96000, 48000 }
+};
+
+TEST(TestAEResample, Polyphase)
+{
+  for (unsigned int r = 0; r < sizeof(rates) / sizeof(rates[0]); r++)
+  {
+    double inRate  = rates[r][0];
+    double outRate = rates[r][1];
+    std::vector<float> in = Sine(inRate, (unsigned int)inRate);
+    std::vector<float> out(((unsigned int)outRate + CHUNK) * CHANNELS);
+
+    CAEResamplePolyphase resampler;
+    ASSERT_TRUE(resampler.Initialize(CHANNELS, outRate / inRate));
+    EXPECT_DOUBLE_EQ(outRate / inRate, resampler.GetRatio());
+
+    unsigned int made = Process(resampler, in, out);
+    EXPECT_NEAR(outRate, made, 64) << inRate << " -> " << outRate;
+
+    /* the filter delay is compensated, so the output is in phase with the input */
+    EXPECT_GT(SNR(out, made, outRate), 80.0) << inRate << " -> " << outRate;
+  }
+}
+
+TEST(TestAEResample, PolyphaseSetRatio)
+{
+  std::vector<float> in(4410 * CHANNELS, 0.25f);
+  std::vector<float> out(20000 * CHANNELS);
+
+  CAEResamplePolyphase resampler;
+  ASSERT_TRUE(resampler.Initialize(CHANNELS, 48000.0 / 44100.0));
+  unsigned int used;
+  unsigned int made = resampler.Resample(&in[0], 4410, &out[0], 20000, used);
+  EXPECT_EQ(4410u, used);
+
+  ASSERT_TRUE(resampler.SetRatio(48000.0 / 44100.0 * 1.01));
+  EXPECT_DOUBLE_EQ(48000.0 / 44100.0 * 1.01, resampler.GetRatio());
+  unsigned int more = resampler.Resample(&in[0], 4410, &out[made * CHANNELS], 20000 - made, used);
+  EXPECT_EQ(4410u, used);
+  EXPECT_NEAR(4800 * 1.01, more, 64);
+
+  /* a constant input stays constant across the change */
+  for (unsigned int i = made - 100; i < made + more - 100; i++)
+    ASSERT_NEAR(0.25f, out[i * CHANNELS], 0.001f) << "frame " << i;
+
+  resampler.Reset();
+  made = resampler.Resample(&in[0], 4410, &out[0], 20000, used);
+  EXPECT_NEAR(4800 * 1.01, made, 64);
+}
+
+TEST(TestAEResample, PolyphaseOutputFull)
+{
+  std::vector<float> in(4410 * CHANNELS, 0.25f);
+  std::vector<float> out(100 * CHANNELS + 1, 12345.0f);
+
+  CAEResamplePolyphase resampler;
+  ASSERT_TRUE(resampler.Initialize(CHANNELS, 2.0));
+  unsigned int used;
+  EXPECT_EQ(100u, resampler.Resample(&in[0], 4410, &out[0], 100, used));
+  EXPECT_EQ(12345.0f, out[100 * CHANNELS]);
+
+  /* whatever was taken but not resampled yet comes out on the next calls */
+  std::vector<float> rest(10000 * CHANNELS);
+  unsigned int made = resampler.Resample(&in[0], 0, &rest[0], 10000, used);
+  EXPECT_EQ(0u, used);
+  EXPECT_GT(made, 0u);
+}
+
+/* prints the share of one CPU needed per stream, this is informational
+   and doesn't fail unless the resampler can't keep up at all */
+static void Benchmark(IAEResample &resampler, double inRate, double outRate)
+{
+  const unsigned int seconds = 2;
+  std::vector<float> in = Sine(inRate, (unsigned int)inRate * seconds);
+  std::vector<float> out(((unsigned int)outRate * seconds + CHUNK) * CHANNELS);
+
+  ASSERT_TRUE(resampler.Initialize(CHANNELS, outRate / inRate));
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  for (unsigned int i = 0; i < 5; i++)
+  {
+    resampler.Reset();
+    Process(resampler, in, out);
+  }
+  unsigned int elapsed = XbmcThreads::SystemClockMillis() - start;
+
+  double cpu = elapsed / 5.0 / (seconds * 1000.0) * 100.0;
+  printf("%-14s %6.0f -> %6.0f: %.2f%% CPU per stream\n", resampler.GetName(), inRate, outRate, cpu);
+  EXPECT_LT(cpu, 100.0);
+}
+
+/* timings depend on the machine and would only clutter the output of
+   the normal run, pass --gtest_also_run_disabled_tests to see them */
+TEST(TestAEResample, DISABLED_Benchmark)
+{
+  for (unsigned int r = 0; r < sizeof(rates) / sizeof(rates[0]); r++)
+  {
+    CAEResamplePolyphase polyphase;
+    Benchmark(polyphase, rates[r][0], rates[r][1]);
+
+    CAEResampleSRC src;
+    Benchmark(src, rates[r][0], rates[r][1]);
+  }
+}
@@ -30,7 +30,19 @@
 #include "utils/TimeUtils.h"
 #include "settings/GUISettings.h"
 
-CAESinkProfiler::CAESinkProfiler()
+/* how often the statistics are logged, in seconds */
+#define PROFILER_REPORT_INTERVAL 5
+
+CAESinkProfiler::CAESinkProfiler() :
+  m_ts           (0),
+  m_bufferEnd    (0),
+  m_report       (0),
+  m_packets      (0),
+  m_underruns    (0),
+  m_minInterval  (0),
+  m_maxInterval  (0),
+  m_totalInterval(0),
+  m_totalJitter  (0)
 {
 }
 
@@ -49,11 +61,18 @@ bool CAESinkProfiler::Initialize(AEAudioFormat &format, std::string &device)
   format.m_frames        = 30720;
   format.m_frameSamples  = format.m_channelLayout.Count();
   format.m_frameSize     = format.m_frameSamples * sizeof(float);
+
+  m_format    = format;
+  m_ts        = 0;
+  m_bufferEnd = 0;
+  m_report    = CurrentHostCounter();
   return true;
 }
 
 void CAESinkProfiler::Deinitialize()
 {
+  if (m_packets)
+    LogStatistics();
 }
 
 bool CAESinkProfiler::IsCompatible(const AEAudioFormat format, const std::string device)
@@ -69,19 +88,87 @@ bool CAESinkProfiler::IsCompatible(const AEAudioFormat format, const std::string
 
 double CAESinkProfiler::GetDelay()
 {
-  return 0.0f;
+  int64_t buffered = m_bufferEnd - CurrentHostCounter();
+  if (buffered <= 0)
+    return 0.0;
+
+  return (double)buffered / (double)CurrentHostFrequency();
 }
 
 unsigned int CAESinkProfiler::AddPackets(uint8_t *data, unsigned int frames, bool hasAudio)
 {
-  int64_t ts = CurrentHostCounter();
-  CLog::Log(LOGDEBUG, "CAESinkProfiler::AddPackets - latency %f ms", (float)(ts - m_ts) / 1000000.0f);
+  int64_t freq = CurrentHostFrequency();
+  int64_t ts   = CurrentHostCounter();
+
+  /*
+    the packets should arrive at the rate they are played at, the jitter is
+    how far the time since the last packet is off from the length of a packet
+  */
+  if (m_ts)
+  {
+    int64_t interval = ts - m_ts;
+    int64_t expected = (int64_t)frames * freq / m_format.m_sampleRate;
+    if (!m_packets || interval < m_minInterval)
+      m_minInterval = interval;
+    if (!m_packets || interval > m_maxInterval)
+      m_maxInterval = interval;
+    m_totalInterval += interval;
+    m_totalJitter   += interval > expected ? interval - expected : expected - interval;
+    m_packets++;
+  }
   m_ts = ts;
+
+  /* emulate a device playing the data in real time, audio arriving after it ran dry is an underrun */
+  if (m_bufferEnd < ts)
+  {
+    if (m_bufferEnd && hasAudio)
+    {
+      m_underruns++;
+      CLog::Log(LOGDEBUG, "CAESinkProfiler::AddPackets - underrun, %f ms late", (double)(ts - m_bufferEnd) * 1000.0 / freq);
+    }
+    m_bufferEnd = ts;
+  }
+  m_bufferEnd += (int64_t)frames * freq / m_format.m_sampleRate;
+
+  if (ts - m_report >= PROFILER_REPORT_INTERVAL * freq && m_packets)
+    LogStatistics();
+
+  /* block like a device would until there is room for another packet */
+  int64_t bufferSize = (int64_t)m_format.m_frames * freq / m_format.m_sampleRate;
+  if (m_bufferEnd - ts > bufferSize)
+    Sleep((unsigned int)((m_bufferEnd - ts - bufferSize) * 1000 / freq));
+
   return frames;
 }
 
 void CAESinkProfiler::Drain()
 {
+  int64_t buffered = m_bufferEnd - CurrentHostCounter();
+  if (buffered > 0)
+    Sleep((unsigned int)(buffered * 1000 / CurrentHostFrequency()));
+
+  m_ts        = 0;
+  m_bufferEnd = 0;
+}
+
+void CAESinkProfiler::LogStatistics()
+{
+  double msPerTick = 1000.0 / (double)CurrentHostFrequency();
+  CLog::Log(LOGDEBUG, "CAESinkProfiler - %u packets, interval min/avg/max %.3f/%.3f/%.3f ms, average jitter %.3f ms, %u underruns",
+    m_packets,
+    m_minInterval * msPerTick,
+    m_totalInterval * msPerTick / m_packets,
+    m_maxInterval * msPerTick,
+    m_totalJitter * msPerTick / m_packets,
+    m_underruns);
+
+  m_report        = CurrentHostCounter();
+  m_packets       = 0;
+  m_underruns     = 0;
+  m_minInterval   = 0;
+  m_maxInterval   = 0;
+  m_totalInterval = 0;
+  m_totalJitter   = 0;
 }
 
 void CAESinkProfiler::EnumerateDevices (AEDeviceList &devices, bool passthrough)
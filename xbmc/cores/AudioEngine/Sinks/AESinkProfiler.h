@@ -43,5 +43,18 @@ public:
   virtual void         Drain           ();
   static void          EnumerateDevices(AEDeviceList &devices, bool passthrough);
 private:
-  int64_t m_ts;
+  void LogStatistics();
+
+  AEAudioFormat m_format;
+  int64_t       m_ts;        /* host counter of the last AddPackets call */
+  int64_t       m_bufferEnd; /* host counter at which the emulated device runs out of data */
+  int64_t       m_report;    /* host counter of the last statistics report */
+
+  /* statistics since the last report, in host counter ticks */
+  unsigned int  m_packets;
+  unsigned int  m_underruns;
+  int64_t       m_minInterval;
+  int64_t       m_maxInterval;
+  int64_t       m_totalInterval;
+  int64_t       m_totalJitter;
 };
@@ -25,6 +25,7 @@
 #include "AEUtil.h"
 #include "utils/MathUtils.h"
 #include "utils/EndianSwap.h"
+#include "utils/CPUInfo.h"
 #include <stdint.h>
 
 #if defined(TARGET_WINDOWS)
@@ -65,8 +66,53 @@ static inline int safeRound(double f)
   return MathUtils::round_int(f);
 }
 
+#if defined(__SSE2__)
+/* swaps the byte order of each of the 32 bit integers in val */
+static inline __m128i SwapBytes32(__m128i val)
+{
+  val = _mm_or_si128(_mm_slli_epi16(val, 8), _mm_srli_epi16(val, 8));
+  return _mm_shufflehi_epi16(_mm_shufflelo_epi16(val, 0xB1), 0xB1);
+}
+
+/* same as safeRound() for each of the two values in val */
+static inline __m128i SafeRound2(__m128d val)
+{
+  const __m128d up   = _mm_set1_pd(0.5f);
+  const __m128d down = _mm_set1_pd(0.4999999f);
+  const __m128d max  = _mm_set1_pd(INT_MAX);
+  const __m128d min  = _mm_set1_pd(INT_MIN);
+
+  __m128d positive = _mm_cmpgt_pd(val, _mm_setzero_pd());
+  val = _mm_add_pd(val, _mm_or_pd(_mm_and_pd(positive, up), _mm_andnot_pd(positive, _mm_sub_pd(_mm_setzero_pd(), down))));
+  return _mm_cvttpd_epi32(_mm_max_pd(_mm_min_pd(val, max), min));
+}
+#endif
+
 CAEConvert::AEConvertToFn CAEConvert::ToFloat(enum AEDataFormat dataFormat)
 {
+#if defined(__SSE2__)
+  if (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_SSE2)
+  {
+    switch (dataFormat)
+    {
+      case AE_FMT_S16NE : return &S16LE_Float_SSE2;
+      case AE_FMT_S32NE : return &S32LE_Float_SSE2;
+      case AE_FMT_S24NE4: return &S24LE4_Float_SSE2;
+      case AE_FMT_S24NE3: return &S24LE3_Float_SSE2;
+      case AE_FMT_S16LE : return &S16LE_Float_SSE2;
+      case AE_FMT_S16BE : return &S16BE_Float_SSE2;
+      case AE_FMT_S24LE4: return &S24LE4_Float_SSE2;
+      case AE_FMT_S24BE4: return &S24BE4_Float_SSE2;
+      case AE_FMT_S24LE3: return &S24LE3_Float_SSE2;
+      case AE_FMT_S24BE3: return &S24BE3_Float_SSE2;
+      case AE_FMT_S32LE : return &S32LE_Float_SSE2;
+      case AE_FMT_S32BE : return &S32BE_Float_SSE2;
+      default:
+        break;
+    }
+  }
+#endif
+
   switch (dataFormat)
   {
     case AE_FMT_U8    : return &U8_Float;
@@ -103,6 +149,11 @@ CAEConvert::AEConvertToFn CAEConvert::ToFloat(enum AEDataFormat dataFormat)
 
 CAEConvert::AEConvertFrFn CAEConvert::FrFloat(enum AEDataFormat dataFormat)
 {
+#if defined(__SSE2__)
+  if ((g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_SSE2) && dataFormat == AE_FMT_S24NE3)
+    return &Float_S24NE3_SSE2;
+#endif
+
   switch (dataFormat)
   {
     case AE_FMT_U8    : return &Float_U8;
@@ -176,7 +227,7 @@ unsigned int CAEConvert::S16LE_Float(uint8_t* data, const unsigned int samples,
   }
 #else
   for (unsigned int i = 0; i < samples; ++i, data += 2)
-    *dest++ = Endian_SwapLE16(*(int16_t*)data) * mul;
+    *dest++ = (int16_t)Endian_SwapLE16(*(int16_t*)data) * mul;
 #endif
 
   return samples;
@@ -207,7 +258,7 @@ unsigned int CAEConvert::S16BE_Float(uint8_t* data, const unsigned int samples,
   }
 #else
   for (unsigned int i = 0; i < samples; ++i, data += 2)
-    *dest++ = Endian_SwapBE16(*(int16_t*)data) * mul;
+    *dest++ = (int16_t)Endian_SwapBE16(*(int16_t*)data) * mul;
 #endif
 
   return samples;
@@ -247,7 +298,7 @@ unsigned int CAEConvert::S24BE3_Float(uint8_t *data, const unsigned int samples,
 {
   for (unsigned int i = 0; i < samples; ++i, data += 3)
   {
-    int s = (data[1] << 24) | (data[2] << 16) | (data[3] << 8);
+    int s = (data[0] << 24) | (data[1] << 16) | (data[2] << 8);
     *dest++ = (float)s * INT32_SCALE;
   }
   return samples;
@@ -261,15 +312,15 @@ unsigned int CAEConvert::S32LE_Float(uint8_t *data, const unsigned int samples,
   /* do this in groups of 4 to give the compiler a better chance of optimizing this */
   for (float *end = dest + (samples & ~0x3); dest < end;)
   {
-    *dest++ = (float)Endian_SwapLE32(*src++) * factor;
-    *dest++ = (float)Endian_SwapLE32(*src++) * factor;
-    *dest++ = (float)Endian_SwapLE32(*src++) * factor;
-    *dest++ = (float)Endian_SwapLE32(*src++) * factor;
+    *dest++ = (float)(int32_t)Endian_SwapLE32(*src++) * factor;
+    *dest++ = (float)(int32_t)Endian_SwapLE32(*src++) * factor;
+    *dest++ = (float)(int32_t)Endian_SwapLE32(*src++) * factor;
+    *dest++ = (float)(int32_t)Endian_SwapLE32(*src++) * factor;
   }
 
   /* process any remaining samples */
   for (float *end = dest + (samples & 0x3); dest < end;)
-    *dest++ = (float)Endian_SwapLE32(*src++) * factor;
+    *dest++ = (float)(int32_t)Endian_SwapLE32(*src++) * factor;
 
   return samples;
 }
@@ -320,15 +371,15 @@ unsigned int CAEConvert::S32BE_Float(uint8_t *data, const unsigned int samples,
   /* do this in groups of 4 to give the compiler a better chance of optimizing this */
   for (float *end = dest + (samples & ~0x3); dest < end;)
   {
-    *dest++ = (float)Endian_SwapBE32(*src++) * factor;
-    *dest++ = (float)Endian_SwapBE32(*src++) * factor;
-    *dest++ = (float)Endian_SwapBE32(*src++) * factor;
-    *dest++ = (float)Endian_SwapBE32(*src++) * factor;
+    *dest++ = (float)(int32_t)Endian_SwapBE32(*src++) * factor;
+    *dest++ = (float)(int32_t)Endian_SwapBE32(*src++) * factor;
+    *dest++ = (float)(int32_t)Endian_SwapBE32(*src++) * factor;
+    *dest++ = (float)(int32_t)Endian_SwapBE32(*src++) * factor;
   }
 
   /* process any remaining samples */
   for (float *end = dest + (samples & 0x3); dest < end;)
-    *dest++ = (float)Endian_SwapBE32(*src++) * factor;
+    *dest++ = (float)(int32_t)Endian_SwapBE32(*src++) * factor;
 
   return samples;
 }
@@ -371,6 +422,208 @@ unsigned int CAEConvert::S32BE_Float_Neon(uint8_t *data, const unsigned int samp
   return samples;
 }
 
+unsigned int CAEConvert::S16LE_Float_SSE2(uint8_t *data, const unsigned int samples, float *dest)
+{
+#if defined(__SSE2__)
+  static const float mul = 1.0f / (INT16_MAX + 0.5f);
+  const __m128 factor = _mm_set_ps1(mul);
+
+  /* groups of 8 samples */
+  unsigned int i = 0;
+  for (; i + 8 <= samples; i += 8, data += 16, dest += 8)
+  {
+    __m128i val = _mm_loadu_si128((__m128i*)data);
+    /* sign extend by moving the samples into the upper half of 32 bits */
+    __m128i lo  = _mm_srai_epi32(_mm_unpacklo_epi16(val, val), 16);
+    __m128i hi  = _mm_srai_epi32(_mm_unpackhi_epi16(val, val), 16);
+    _mm_storeu_ps(dest    , _mm_mul_ps(_mm_cvtepi32_ps(lo), factor));
+    _mm_storeu_ps(dest + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), factor));
+  }
+
+  /* process any remaining samples */
+  for (; i < samples; ++i, data += 2)
+    *dest++ = *(int16_t*)data * mul;
+#endif
+
+  return samples;
+}
+
+unsigned int CAEConvert::S16BE_Float_SSE2(uint8_t *data, const unsigned int samples, float *dest)
+{
+#if defined(__SSE2__)
+  static const float mul = 1.0f / (INT16_MAX + 0.5f);
+  const __m128 factor = _mm_set_ps1(mul);
+
+  /* groups of 8 samples */
+  unsigned int i = 0;
+  for (; i + 8 <= samples; i += 8, data += 16, dest += 8)
+  {
+    __m128i val = _mm_loadu_si128((__m128i*)data);
+    val = _mm_or_si128(_mm_slli_epi16(val, 8), _mm_srli_epi16(val, 8));
+    /* sign extend by moving the samples into the upper half of 32 bits */
+    __m128i lo  = _mm_srai_epi32(_mm_unpacklo_epi16(val, val), 16);
+    __m128i hi  = _mm_srai_epi32(_mm_unpackhi_epi16(val, val), 16);
+    _mm_storeu_ps(dest    , _mm_mul_ps(_mm_cvtepi32_ps(lo), factor));
+    _mm_storeu_ps(dest + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), factor));
+  }
+
+  /* process any remaining samples */
+  for (; i < samples; ++i, data += 2)
+    *dest++ = (int16_t)((data[0] << 8) | data[1]) * mul;
+#endif
+
+  return samples;
+}
+
+unsigned int CAEConvert::S24LE4_Float_SSE2(uint8_t *data, const unsigned int samples, float *dest)
+{
+#if defined(__SSE2__)
+  const __m128 factor = _mm_set_ps1(INT32_SCALE);
+
+  /* groups of 4 samples, the unused 4th byte is shifted out */
+  unsigned int i = 0;
+  for (; i + 4 <= samples; i += 4, data += 16, dest += 4)
+  {
+    __m128i val = _mm_slli_epi32(_mm_loadu_si128((__m128i*)data), 8);
+    _mm_storeu_ps(dest, _mm_mul_ps(_mm_cvtepi32_ps(val), factor));
+  }
+
+  /* process any remaining samples */
+  for (; i < samples; ++i, data += 4)
+  {
+    int s = (data[2] << 24) | (data[1] << 16) | (data[0] << 8);
+    *dest++ = (float)s * INT32_SCALE;
+  }
+#endif
+
+  return samples;
+}
+
+unsigned int CAEConvert::S24BE4_Float_SSE2(uint8_t *data, const unsigned int samples, float *dest)
+{
+#if defined(__SSE2__)
+  const __m128  factor = _mm_set_ps1(INT32_SCALE);
+  const __m128i mask   = _mm_set1_epi32(0xFFFFFF00);
+
+  /* groups of 4 samples, the unused 4th byte is masked out */
+  unsigned int i = 0;
+  for (; i + 4 <= samples; i += 4, data += 16, dest += 4)
+  {
+    __m128i val = _mm_and_si128(SwapBytes32(_mm_loadu_si128((__m128i*)data)), mask);
+    _mm_storeu_ps(dest, _mm_mul_ps(_mm_cvtepi32_ps(val), factor));
+  }
+
+  /* process any remaining samples */
+  for (; i < samples; ++i, data += 4)
+  {
+    int s = (data[0] << 24) | (data[1] << 16) | (data[2] << 8);
+    *dest++ = (float)s * INT32_SCALE;
+  }
+#endif
+
+  return samples;
+}
+
+unsigned int CAEConvert::S24LE3_Float_SSE2(uint8_t *data, const unsigned int samples, float *dest)
+{
+#if defined(__SSE2__)
+  const __m128 factor = _mm_set_ps1(INT32_SCALE);
+
+  /* groups of 4 samples, only the conversion itself is done in SIMD */
+  unsigned int i = 0;
+  for (; i + 4 <= samples; i += 4, data += 12, dest += 4)
+  {
+    __m128i val = _mm_setr_epi32(
+      (data[ 2] << 24) | (data[ 1] << 16) | (data[ 0] << 8),
+      (data[ 5] << 24) | (data[ 4] << 16) | (data[ 3] << 8),
+      (data[ 8] << 24) | (data[ 7] << 16) | (data[ 6] << 8),
+      (data[11] << 24) | (data[10] << 16) | (data[ 9] << 8));
+    _mm_storeu_ps(dest, _mm_mul_ps(_mm_cvtepi32_ps(val), factor));
+  }
+
+  /* process any remaining samples */
+  for (; i < samples; ++i, data += 3)
+  {
+    int s = (data[2] << 24) | (data[1] << 16) | (data[0] << 8);
+    *dest++ = (float)s * INT32_SCALE;
+  }
+#endif
+
+  return samples;
+}
+
+unsigned int CAEConvert::S24BE3_Float_SSE2(uint8_t *data, const unsigned int samples, float *dest)
+{
+#if defined(__SSE2__)
+  const __m128 factor = _mm_set_ps1(INT32_SCALE);
+
+  /* groups of 4 samples, only the conversion itself is done in SIMD */
+  unsigned int i = 0;
+  for (; i + 4 <= samples; i += 4, data += 12, dest += 4)
+  {
+    __m128i val = _mm_setr_epi32(
+      (data[0] << 24) | (data[ 1] << 16) | (data[ 2] << 8),
+      (data[3] << 24) | (data[ 4] << 16) | (data[ 5] << 8),
+      (data[6] << 24) | (data[ 7] << 16) | (data[ 8] << 8),
+      (data[9] << 24) | (data[10] << 16) | (data[11] << 8));
+    _mm_storeu_ps(dest, _mm_mul_ps(_mm_cvtepi32_ps(val), factor));
+  }
+
+  /* process any remaining samples */
+  for (; i < samples; ++i, data += 3)
+  {
+    int s = (data[0] << 24) | (data[1] << 16) | (data[2] << 8);
+    *dest++ = (float)s * INT32_SCALE;
+  }
+#endif
+
+  return samples;
+}
+
+unsigned int CAEConvert::S32LE_Float_SSE2(uint8_t *data, const unsigned int samples, float *dest)
+{
+#if defined(__SSE2__)
+  static const float factor = 1.0f / (float)INT32_MAX;
+  const __m128 mul = _mm_set_ps1(factor);
+  int32_t *src = (int32_t*)data;
+
+  /* groups of 4 samples */
+  for (float *end = dest + (samples & ~0x3); dest < end; src += 4, dest += 4)
+  {
+    __m128i val = _mm_loadu_si128((__m128i*)src);
+    _mm_storeu_ps(dest, _mm_mul_ps(_mm_cvtepi32_ps(val), mul));
+  }
+
+  /* process any remaining samples */
+  for (float *end = dest + (samples & 0x3); dest < end;)
+    *dest++ = (float)*src++ * factor;
+#endif
+
+  return samples;
+}
+
+unsigned int CAEConvert::S32BE_Float_SSE2(uint8_t *data, const unsigned int samples, float *dest)
+{
+#if defined(__SSE2__)
+  static const float factor = 1.0f / (float)INT32_MAX;
+  const __m128 mul = _mm_set_ps1(factor);
+  int32_t *src = (int32_t*)data;
+
+  /* groups of 4 samples */
+  for (float *end = dest + (samples & ~0x3); dest < end; src += 4, dest += 4)
+  {
+    __m128i val = SwapBytes32(_mm_loadu_si128((__m128i*)src));
+    _mm_storeu_ps(dest, _mm_mul_ps(_mm_cvtepi32_ps(val), mul));
+  }
+
+  /* process any remaining samples */
+  for (float *end = dest + (samples & 0x3); dest < end;)
+    *dest++ = (float)(int32_t)Endian_SwapBE32(*src++) * factor;
+#endif
+
+  return samples;
+}
+
 unsigned int CAEConvert::DOUBLE_Float(uint8_t *data, const unsigned int samples, float *dest)
 {
   double *src = (double*)data;
@@ -922,6 +1175,40 @@ unsigned int CAEConvert::Float_S24NE3(float *data, const unsigned int samples, u
   return samples * 3;
 }
 
+unsigned int CAEConvert::Float_S24NE3_SSE2(float *data, const unsigned int samples, uint8_t *dest)
+{
+#if defined(__SSE2__)
+  const __m128 mul = _mm_set_ps1((float)INT24_MAX+.5f);
+
+  /* groups of 4 samples, rounded the same way as safeRound() does */
+  unsigned int i = 0;
+  for (; i + 4 <= samples; i += 4, data += 4, dest += 12)
+  {
+    __m128 in = _mm_mul_ps(_mm_loadu_ps(data), mul);
+    __m128i lo = SafeRound2(_mm_cvtps_pd(in));
+    __m128i hi = SafeRound2(_mm_cvtps_pd(_mm_movehl_ps(in, in)));
+
+    int32_t val[4];
+    _mm_storel_epi64((__m128i*)&val[0], lo);
+    _mm_storel_epi64((__m128i*)&val[2], hi);
+
+    /* the 4th byte of each write is overwritten by the next sample */
+    *((uint32_t*)(dest + 0)) = val[0] & 0xFFFFFF;
+    *((uint32_t*)(dest + 3)) = val[1] & 0xFFFFFF;
+    *((uint32_t*)(dest + 6)) = val[2] & 0xFFFFFF;
+    dest[ 9] = val[3];
+    dest[10] = val[3] >> 8;
+    dest[11] = val[3] >> 16;
+  }
+
+  /* process any remaining samples */
+  for (; i < samples; ++i, ++data, dest += 3)
+    *((uint32_t*)(dest)) = safeRound(*data * ((float)INT24_MAX+.5f)) & 0xFFFFFF;
+#endif
+
+  return samples * 3;
+}
+
 unsigned int CAEConvert::Float_S32LE(float *data, const unsigned int samples, uint8_t *dest)
 {
   int32_t *dst = (int32_t*)dest;
@@ -18,6 +18,7 @@
  *
  */
 #include <math.h>
+#include <string.h>
 #include <sstream>
 
 #include "AERemap.h"
@@ -28,7 +29,7 @@
 
 using namespace std;
 
-CAERemap::CAERemap() : m_inChannels(0), m_outChannels(0) 
+CAERemap::CAERemap() : m_inChannels(0), m_outChannels(0), m_remapFn(&CAERemap::RemapMixInfo)
 {
   memset(m_mixInfo, 0, sizeof(m_mixInfo));
 }
@@ -87,7 +88,10 @@ bool CAERemap::Initialize(CAEChannelInfo input, CAEChannelInfo output, bool fina
 
   /* the final stage does not need any down/upmix */
   if (finalStage)
+  {
+    SelectRemap();
     return true;
+  }
 
   /* downmix from the specified channel to the specified list of channels */
   #define RM(from, ...) \
@@ -240,9 +244,66 @@ bool CAERemap::Initialize(CAEChannelInfo input, CAEChannelInfo output, bool fina
   CLog::Log(LOGINFO, "====================\n");
 #endif
 
+  SelectRemap();
   return true;
 }
 
+void CAERemap::SelectRemap()
+{
+  /* flatten the mix info into a matrix with the levels of each input channel */
+  memset(m_copyIndex, 0, sizeof(m_copyIndex));
+  memset(m_matrix   , 0, sizeof(m_matrix   ));
+
+  bool copy     = true;
+  bool identity = m_inChannels == m_outChannels;
+  for (int o = 0; o < m_outChannels; ++o)
+  {
+    const AEMixInfo *info = &m_mixInfo[m_output[o]];
+    if (!info->in_dst || info->srcCount == 0)
+    {
+      m_copyIndex[o] = -1;
+      identity = false;
+    }
+    /* if there is only 1 source it is copied so we dont break DPL */
+    else if (info->srcCount == 1)
+    {
+      m_copyIndex[o] = info->srcIndex[0].index;
+      m_matrix[m_copyIndex[o]][o] = 1.0f;
+      identity &= m_copyIndex[o] == o;
+    }
+    else
+    {
+      for (int i = 0; i < info->srcCount; ++i)
+        m_matrix[info->srcIndex[i].index][o] += info->srcIndex[i].level;
+      copy     = false;
+      identity = false;
+    }
+  }
+
+  if (identity)
+    m_remapFn = &CAERemap::RemapIdentity;
+  else if (copy)
+    m_remapFn = &CAERemap::RemapCopy;
+#ifdef __SSE__
+  /* the most common layouts, 2.0 to 5.1, 5.1 to 2.0 and 7.1 to 5.1 */
+  else if (m_inChannels == 2 && m_outChannels == 6)
+    m_remapFn = &CAERemap::RemapMatrix<2, 6>;
+  else if (m_inChannels == 6 && m_outChannels == 2)
+    m_remapFn = &CAERemap::RemapMatrix<6, 2>;
+  else if (m_inChannels == 8 && m_outChannels == 6)
+    m_remapFn = &CAERemap::RemapMatrix<8, 6>;
+  else if (m_outChannels <= 4)
+    m_remapFn = &CAERemap::RemapMatrixGeneric<1>;
+  else if (m_outChannels <= 8)
+    m_remapFn = &CAERemap::RemapMatrixGeneric<2>;
+  else
+    m_remapFn = &CAERemap::RemapMatrixGeneric<AE_REMAP_STRIDE / 4>;
+#else
+  else
+    m_remapFn = &CAERemap::RemapMixInfo;
+#endif
+}
+
 void CAERemap::ResolveMix(const AEChannel from, CAEChannelInfo to)
 {
   AEMixInfo *fromInfo = &m_mixInfo[from];
@@ -280,8 +341,110 @@ void CAERemap::ResolveMix(const AEChannel from, CAEChannelInfo to)
   fromInfo->in_src   = false;
 }
 
-/* This method has unrolled loop for higher performance */
 void CAERemap::Remap(float * const in, float * const out, const unsigned int frames) const
+{
+  (this->*m_remapFn)(in, out, frames);
+}
+
+void CAERemap::RemapIdentity(float * const in, float * const out, const unsigned int frames) const
+{
+  memcpy(out, in, frames * m_outChannels * sizeof(float));
+}
+
+void CAERemap::RemapCopy(float * const in, float * const out, const unsigned int frames) const
+{
+  const float *src = in;
+  float       *dst = out;
+  for (unsigned int f = 0; f < frames; ++f, src += m_inChannels, dst += m_outChannels)
+    for (int o = 0; o < m_outChannels; ++o)
+      dst[o] = m_copyIndex[o] < 0 ? 0.0f : src[m_copyIndex[o]];
+}
+
+#ifdef __SSE__
+/*
+  each output frame is the sum of the matrix rows of the input channels
+  scaled by their samples, which keeps all output channels of a frame in
+  SIMD registers. As the output vectors are padded, stores of all but the
+  last frame spill into the next frame, which is written afterwards.
+*/
+template <int inChannels, int outChannels>
+void CAERemap::RemapMatrix(float * const in, float * const out, const unsigned int frames) const
+{
+  #define VECTORS ((outChannels + 3) / 4)
+
+  __m128 matrix[inChannels][VECTORS];
+  for (int i = 0; i < inChannels; ++i)
+    for (int v = 0; v < VECTORS; ++v)
+      matrix[i][v] = _mm_loadu_ps(&m_matrix[i][v * 4]);
+
+  const float *src = in;
+  float       *dst = out;
+  for (unsigned int f = 0; f < frames; ++f, src += inChannels, dst += outChannels)
+  {
+    __m128 sum[VECTORS];
+    for (int v = 0; v < VECTORS; ++v)
+      sum[v] = _mm_setzero_ps();
+
+    for (int i = 0; i < inChannels; ++i)
+    {
+      const __m128 sample = _mm_set1_ps(src[i]);
+      for (int v = 0; v < VECTORS; ++v)
+        sum[v] = _mm_add_ps(sum[v], _mm_mul_ps(sample, matrix[i][v]));
+    }
+
+    if (f + 1 < frames)
+    {
+      for (int v = 0; v < VECTORS; ++v)
+        _mm_storeu_ps(dst + v * 4, sum[v]);
+    }
+    else
+    {
+      float last[VECTORS * 4];
+      for (int v = 0; v < VECTORS; ++v)
+        _mm_storeu_ps(last + v * 4, sum[v]);
+      memcpy(dst, last, outChannels * sizeof(float));
+    }
+  }
+
+  #undef VECTORS
+}
+
+template <int vectors>
+void CAERemap::RemapMatrixGeneric(float * const in, float * const out, const unsigned int frames) const
+{
+  const float *src = in;
+  float       *dst = out;
+  for (unsigned int f = 0; f < frames; ++f, src += m_inChannels, dst += m_outChannels)
+  {
+    __m128 sum[vectors];
+    for (int v = 0; v < vectors; ++v)
+      sum[v] = _mm_setzero_ps();
+
+    for (int i = 0; i < m_inChannels; ++i)
+    {
+      const __m128 sample = _mm_set1_ps(src[i]);
+      for (int v = 0; v < vectors; ++v)
+        sum[v] = _mm_add_ps(sum[v], _mm_mul_ps(sample, _mm_loadu_ps(&m_matrix[i][v * 4])));
+    }
+
+    if (f + 1 < frames)
+    {
+      for (int v = 0; v < vectors; ++v)
+        _mm_storeu_ps(dst + v * 4, sum[v]);
+    }
+    else
+    {
+      float last[vectors * 4];
+      for (int v = 0; v < vectors; ++v)
+        _mm_storeu_ps(last + v * 4, sum[v]);
+      memcpy(dst, last, m_outChannels * sizeof(float));
+    }
+  }
+}
+#endif
+
+/* This method has unrolled loop for higher performance */
+void CAERemap::RemapMixInfo(float * const in, float * const out, const unsigned int frames) const
 {
   const unsigned int frameBlocks = frames & ~0x3;
 
@@ -21,6 +21,9 @@
 
 #include "cores/AudioEngine/AEAudioFormat.h"
 
+/* the number of output levels per input channel, padded for SIMD */
+#define AE_REMAP_STRIDE ((AE_CH_MAX + 3) & ~3)
+
 class CAERemap {
 public:
   CAERemap();
@@ -44,12 +47,27 @@ private:
     int               cpyCount; /* the number of times the channel has been cloned */
   } AEMixInfo;
 
+  typedef void (CAERemap::*RemapFn)(float * const in, float * const out, const unsigned int frames) const;
+
   AEMixInfo      m_mixInfo[AE_CH_MAX+1];
   CAEChannelInfo m_output;
   int            m_inChannels;
   int            m_outChannels;
 
+  RemapFn        m_remapFn;
+  int            m_copyIndex[AE_CH_MAX];                 /* input channel of each output channel, -1 for silence */
+  float          m_matrix   [AE_CH_MAX][AE_REMAP_STRIDE]; /* level of each input channel in each output channel */
+
   void ResolveMix(const AEChannel from, CAEChannelInfo to);
   void BuildUpmixMatrix(const CAEChannelInfo& input, const CAEChannelInfo& output);
+  void SelectRemap();
+
+  void RemapMixInfo(float * const in, float * const out, const unsigned int frames) const;
+  void RemapIdentity(float * const in, float * const out, const unsigned int frames) const;
+  void RemapCopy(float * const in, float * const out, const unsigned int frames) const;
+  template <int inChannels, int outChannels>
+  void RemapMatrix(float * const in, float * const out, const unsigned int frames) const;
+  template <int vectors>
+  void RemapMatrixGeneric(float * const in, float * const out, const unsigned int frames) const;
 };
 
@@ -0,0 +1,134 @@
+#pragma once
+/*
+ *      Copyright (C) 2010-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/Atomics.h"
+#include <stddef.h>   //NULL
+
+/**
+ * Fixed size queue of items which can be used by one read and one write
+ * thread at any one time without any locking.
+ * If you intend to call the Create() or Reset() methods, please make sure
+ * neither of the threads is using the queue.
+ */
+template<typename T>
+class AERingQueue {
+
+public:
+  AERingQueue() :
+    m_iRead(0),
+    m_iWritten(0),
+    m_iSize(0),
+    m_iMask(0),
+    m_Items(NULL)
+  {
+  }
+
+  ~AERingQueue()
+  {
+    delete[] m_Items;
+  }
+
+  /**
+   * Allocates space for at least size items, the size is rounded up to
+   * the next power of two.
+   */
+  void Create(unsigned int size)
+  {
+    unsigned int capacity = 1;
+    while (capacity < size)
+      capacity <<= 1;
+
+    delete[] m_Items;
+    m_Items    = new T[capacity];
+    m_iSize    = capacity;
+    m_iMask    = capacity - 1;
+    m_iRead    = 0;
+    m_iWritten = 0;
+  }
+
+  /**
+   * Drops all items, this method is not thread-safe.
+   */
+  void Reset()
+  {
+    m_iRead    = 0;
+    m_iWritten = 0;
+  }
+
+  /**
+   * Appends an item, may only be called from the write thread.
+   *
+   * @return false if the queue is full
+   */
+  bool Push(const T &item)
+  {
+    if (Size() >= m_iSize)
+      return false;
+
+    m_Items[m_iWritten & m_iMask] = item;
+    /* the increment is a full barrier, it publishes the item to the reader */
+    AtomicIncrement(&m_iWritten);
+    return true;
+  }
+
+  /**
+   * Removes the oldest item, may only be called from the read thread.
+   *
+   * @return false if the queue is empty
+   */
+  bool Pop(T &item)
+  {
+    if (IsEmpty())
+      return false;
+
+    item = m_Items[m_iRead & m_iMask];
+    /* the slot may be reused by the writer once the increment is visible */
+    AtomicIncrement(&m_iRead);
+    return true;
+  }
+
+  /**
+   * Number of items waiting, safe to call from any thread but only exact
+   * on the read and write threads.
+   */
+  unsigned int Size() const
+  {
+    return (unsigned long)m_iWritten - (unsigned long)m_iRead;
+  }
+
+  bool IsEmpty() const
+  {
+    return m_iWritten == m_iRead;
+  }
+
+  unsigned int GetCapacity() const
+  {
+    return m_iSize;
+  }
+
+private:
+  /* both counters only ever increase, the slot is the counter modulo the size */
+  volatile long m_iRead;
+  volatile long m_iWritten;
+  unsigned int  m_iSize;
+  unsigned int  m_iMask;
+  T            *m_Items;
+};
@@ -0,0 +1,178 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "cores/AudioEngine/Utils/AEConvert.h"
+#include "utils/MathUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <limits.h>
+#include <string.h>
+#include <vector>
+
+/* odd sized and starting at an odd offset so that all the code paths
+   dealing with alignment and remaining samples are taken */
+#define SAMPLES 1027
+#define OFFSET  3
+
+static std::vector<uint8_t> RandomBytes(size_t size)
+{
+  std::vector<uint8_t> bytes(size);
+  unsigned int seed = 12345;
+  for (size_t i = 0; i < size; i++)
+  {
+    seed = seed * 214013 + 2531011;
+    bytes[i] = (uint8_t)(seed >> 16);
+  }
+
+  return bytes;
+}
+
+/* reference values computed the same way the generic C code does */
+static float S16ToFloat(int16_t s)
+{
+  return s * (1.0f / (INT16_MAX + 0.5f));
+}
+
+static float S24ToFloat(uint8_t msb, uint8_t mid, uint8_t lsb)
+{
+  int s = (msb << 24) | (mid << 16) | (lsb << 8);
+  return (float)s * (-1.0f / INT_MIN);
+}
+
+static float S32ToFloat(int32_t s)
+{
+  return (float)s * (1.0f / (float)INT32_MAX);
+}
+
+static void Convert(enum AEDataFormat format, unsigned int size, std::vector<uint8_t> &input, std::vector<float> &output)
+{
+  input = RandomBytes(SAMPLES * size + OFFSET);
+  output.assign(SAMPLES + 1, 0.0f);
+
+  CAEConvert::AEConvertToFn convert = CAEConvert::ToFloat(format);
+  ASSERT_TRUE(convert != NULL);
+  EXPECT_EQ((unsigned int)SAMPLES, convert(&input[OFFSET], SAMPLES, &output[1]));
+}
+
+TEST(TestAEConvert, S16ToFloat)
+{
+  std::vector<uint8_t> input;
+  std::vector<float> output;
+
+  Convert(AE_FMT_S16LE, 2, input, output);
+  for (unsigned int i = 0; i < SAMPLES; i++)
+  {
+    const uint8_t *s = &input[OFFSET + i * 2];
+    ASSERT_EQ(S16ToFloat((int16_t)(s[0] | (s[1] << 8))), output[i + 1]) << "sample " << i;
+  }
+
+  Convert(AE_FMT_S16BE, 2, input, output);
+  for (unsigned int i = 0; i < SAMPLES; i++)
+  {
+    const uint8_t *s = &input[OFFSET + i * 2];
+    ASSERT_EQ(S16ToFloat((int16_t)((s[0] << 8) | s[1])), output[i + 1]) << "sample " << i;
+  }
+}
+
+TEST(TestAEConvert, S24ToFloat)
+{
+  std::vector<uint8_t> input;
+  std::vector<float> output;
+
+  Convert(AE_FMT_S24LE4, 4, input, output);
+  for (unsigned int i = 0; i < SAMPLES; i++)
+  {
+    const uint8_t *s = &input[OFFSET + i * 4];
+    ASSERT_EQ(S24ToFloat(s[2], s[1], s[0]), output[i + 1]) << "sample " << i;
+  }
+
+  Convert(AE_FMT_S24BE4, 4, input, output);
+  for (unsigned int i = 0; i < SAMPLES; i++)
+  {
+    const uint8_t *s = &input[OFFSET + i * 4];
+    ASSERT_EQ(S24ToFloat(s[0], s[1], s[2]), output[i + 1]) << "sample " << i;
+  }
+
+  Convert(AE_FMT_S24LE3, 3, input, output);
+  for (unsigned int i = 0; i < SAMPLES; i++)
+  {
+    const uint8_t *s = &input[OFFSET + i * 3];
+    ASSERT_EQ(S24ToFloat(s[2], s[1], s[0]), output[i + 1]) << "sample " << i;
+  }
+
+  Convert(AE_FMT_S24BE3, 3, input, output);
+  for (unsigned int i = 0; i < SAMPLES; i++)
+  {
+    const uint8_t *s = &input[OFFSET + i * 3];
+    ASSERT_EQ(S24ToFloat(s[0], s[1], s[2]), output[i + 1]) << "sample " << i;
+  }
+}
+
+TEST(TestAEConvert, S32ToFloat)
+{
+  std::vector<uint8_t> input;
+  std::vector<float> output;
+
+  Convert(AE_FMT_S32LE, 4, input, output);
+  for (unsigned int i = 0; i < SAMPLES; i++)
+  {
+    const uint8_t *s = &input[OFFSET + i * 4];
+    ASSERT_EQ(S32ToFloat((int32_t)(s[0] | (s[1] << 8) | (s[2] << 16) | (s[3] << 24))), output[i + 1]) << "sample " << i;
+  }
+
+  Convert(AE_FMT_S32BE, 4, input, output);
+  for (unsigned int i = 0; i < SAMPLES; i++)
+  {
+    const uint8_t *s = &input[OFFSET + i * 4];
+    ASSERT_EQ(S32ToFloat((int32_t)((s[0] << 24) | (s[1] << 16) | (s[2] << 8) | s[3])), output[i + 1]) << "sample " << i;
+  }
+}
+
+TEST(TestAEConvert, FloatToS24NE3)
+{
+  /* include values which are exactly between two integers */
+  std::vector<float> input(SAMPLES + 1);
+  for (unsigned int i = 0; i < SAMPLES; i++)
+  {
+    if (i % 3 == 0)
+      input[i + 1] = ((int)i - SAMPLES / 2 + 0.5f) / ((float)0x7FFFFF + .5f);
+    else
+      input[i + 1] = ((float)i / SAMPLES) * 2.0f - 1.0f;
+  }
+
+  std::vector<uint8_t> output(SAMPLES * 3 + OFFSET + 1, 0);
+  CAEConvert::AEConvertFrFn convert = CAEConvert::FrFloat(AE_FMT_S24NE3);
+  ASSERT_TRUE(convert != NULL);
+  EXPECT_EQ((unsigned int)SAMPLES * 3, convert(&input[1], SAMPLES, &output[OFFSET]));
+
+  for (unsigned int i = 0; i < SAMPLES; i++)
+  {
+    int expected = MathUtils::round_int(input[i + 1] * ((float)0x7FFFFF + .5f));
+    const uint8_t *s = &output[OFFSET + i * 3];
+#ifdef __BIG_ENDIAN__
+    int actual = (s[0] << 16) | (s[1] << 8) | s[2];
+#else
+    int actual = (s[2] << 16) | (s[1] << 8) | s[0];
+#endif
+    ASSERT_EQ(expected & 0xFFFFFF, actual) << "sample " << i;
+  }
+}
@@ -0,0 +1,130 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "cores/AudioEngine/Utils/AERemap.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+#define FRAMES 257
+
+static AEChannel layout20[] = { AE_CH_FL, AE_CH_FR, AE_CH_NULL };
+static AEChannel layout30[] = { AE_CH_FC, AE_CH_FR, AE_CH_FL, AE_CH_NULL };
+static AEChannel layout51[] = { AE_CH_FL, AE_CH_FR, AE_CH_FC, AE_CH_LFE, AE_CH_BL, AE_CH_BR, AE_CH_NULL };
+static AEChannel layout71[] = { AE_CH_FL, AE_CH_FR, AE_CH_FC, AE_CH_LFE, AE_CH_BL, AE_CH_BR, AE_CH_SL, AE_CH_SR, AE_CH_NULL };
+
+static std::vector<float> Samples(unsigned int count)
+{
+  std::vector<float> samples(count);
+  for (unsigned int i = 0; i < count; i++)
+    samples[i] = (float)((i * 7919) % 2001) / 1000.0f - 1.0f;
+
+  return samples;
+}
+
+/* remaps all frames at once and frame by frame, which has to give the
+   same result without touching anything after the output */
+static void Remap(const CAERemap &remap, unsigned int inChannels, unsigned int outChannels, std::vector<float> &in, std::vector<float> &out)
+{
+  in = Samples(FRAMES * inChannels);
+  out.assign(FRAMES * outChannels + 1, 12345.0f);
+  remap.Remap(&in[0], &out[0], FRAMES);
+  EXPECT_EQ(12345.0f, out[FRAMES * outChannels]);
+
+  std::vector<float> single(outChannels + 1, 12345.0f);
+  for (unsigned int f = 0; f < FRAMES; f++)
+  {
+    remap.Remap(&in[f * inChannels], &single[0], 1);
+    for (unsigned int o = 0; o < outChannels; o++)
+      ASSERT_EQ(single[o], out[f * outChannels + o]) << "frame " << f << " channel " << o;
+    EXPECT_EQ(12345.0f, single[outChannels]);
+  }
+  out.pop_back();
+}
+
+TEST(TestAERemap, Identity)
+{
+  CAERemap remap;
+  ASSERT_TRUE(remap.Initialize(CAEChannelInfo(layout51), CAEChannelInfo(layout51), false, true));
+
+  std::vector<float> in, out;
+  Remap(remap, 6, 6, in, out);
+  EXPECT_TRUE(in == out);
+}
+
+TEST(TestAERemap, Reorder)
+{
+  CAERemap remap;
+  ASSERT_TRUE(remap.Initialize(CAEChannelInfo(layout20), CAEChannelInfo(layout30), true));
+
+  std::vector<float> in, out;
+  Remap(remap, 2, 3, in, out);
+  for (unsigned int f = 0; f < FRAMES; f++)
+  {
+    EXPECT_EQ(0.0f         , out[f * 3 + 0]);
+    EXPECT_EQ(in[f * 2 + 1], out[f * 3 + 1]);
+    EXPECT_EQ(in[f * 2 + 0], out[f * 3 + 2]);
+  }
+}
+
+TEST(TestAERemap, Downmix)
+{
+  CAERemap remap;
+  ASSERT_TRUE(remap.Initialize(CAEChannelInfo(layout51), CAEChannelInfo(layout20), false, true));
+
+  std::vector<float> in, out;
+  Remap(remap, 6, 2, in, out);
+
+  /* the left channels only end up in the left output, the center in both */
+  float frame[6] = { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+  float result[2];
+  remap.Remap(frame, result, 1);
+  EXPECT_LT(0.0f, result[0]);
+  EXPECT_EQ(0.0f, result[1]);
+
+  frame[0] = 0.0f;
+  frame[2] = 1.0f;
+  remap.Remap(frame, result, 1);
+  EXPECT_LT(0.0f, result[0]);
+  EXPECT_FLOAT_EQ(result[0], result[1]);
+}
+
+TEST(TestAERemap, Matrix)
+{
+  std::vector<float> in, out;
+
+  CAERemap remap71;
+  ASSERT_TRUE(remap71.Initialize(CAEChannelInfo(layout71), CAEChannelInfo(layout51), false, true));
+  Remap(remap71, 8, 6, in, out);
+
+  CAERemap remap20;
+  ASSERT_TRUE(remap20.Initialize(CAEChannelInfo(layout71), CAEChannelInfo(layout20), false, true));
+  Remap(remap20, 8, 2, in, out);
+
+  /* channels with a single source are copied as they are */
+  Remap(remap71, 8, 6, in, out);
+  for (unsigned int f = 0; f < FRAMES; f++)
+  {
+    EXPECT_EQ(in[f * 8 + 2], out[f * 6 + 2]);
+    EXPECT_EQ(in[f * 8 + 3], out[f * 6 + 3]);
+  }
+}
@@ -0,0 +1,102 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AERingQueue.h"
+#include "threads/Thread.h"
+
+#include "gtest/gtest.h"
+
+#define ITEMS 20000
+
+class CQueueWriter : public CThread
+{
+public:
+  CQueueWriter(AERingQueue<unsigned int> &queue) : CThread("CQueueWriter"), m_queue(queue) {}
+
+protected:
+  virtual void Process()
+  {
+    for (unsigned int i = 0; i < ITEMS && !m_bStop; )
+    {
+      if (m_queue.Push(i))
+        i++;
+      else
+        XbmcThreads::ThreadSleep(0);
+    }
+  }
+
+private:
+  AERingQueue<unsigned int> &m_queue;
+};
+
+TEST(TestAERingQueue, PushPop)
+{
+  AERingQueue<unsigned int> queue;
+  queue.Create(3);
+  EXPECT_EQ(4U, queue.GetCapacity());
+  EXPECT_TRUE(queue.IsEmpty());
+
+  unsigned int item;
+  EXPECT_FALSE(queue.Pop(item));
+
+  for (unsigned int i = 0; i < 4; i++)
+    EXPECT_TRUE(queue.Push(i));
+  EXPECT_FALSE(queue.Push(4));
+  EXPECT_EQ(4U, queue.Size());
+
+  /* wrap around the end a few times */
+  for (unsigned int i = 0; i < 10; i++)
+  {
+    ASSERT_TRUE(queue.Pop(item));
+    EXPECT_EQ(i, item);
+    EXPECT_TRUE(queue.Push(i + 4));
+  }
+  EXPECT_EQ(4U, queue.Size());
+
+  queue.Reset();
+  EXPECT_TRUE(queue.IsEmpty());
+  EXPECT_FALSE(queue.Pop(item));
+}
+
+TEST(TestAERingQueue, Threaded)
+{
+  AERingQueue<unsigned int> queue;
+  queue.Create(16);
+
+  CQueueWriter writer(queue);
+  writer.Create();
+
+  unsigned int expected = 0;
+  while (expected < ITEMS)
+  {
+    unsigned int item;
+    if (!queue.Pop(item))
+    {
+      XbmcThreads::ThreadSleep(0);
+      continue;
+    }
+
+    ASSERT_EQ(expected, item);
+    expected++;
+  }
+
+  writer.StopThread();
+  EXPECT_TRUE(queue.IsEmpty());
+}
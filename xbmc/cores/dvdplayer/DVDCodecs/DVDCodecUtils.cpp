@@ -23,8 +23,20 @@
 #include "cores/VideoRenderers/RenderManager.h"
 #include "utils/log.h"
 #include "utils/fastmemcpy.h"
+#include "utils/CPUInfo.h"
 #include "DllSwScale.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+// planes from this size on are written past the cache, smaller ones may still be in it when read
+#define STREAM_MIN_BYTES (256 * 1024)
+
 // allocate a new picture (PIX_FMT_YUV420P)
 DVDVideoPicture* CDVDCodecUtils::AllocatePicture(int iWidth, int iHeight)
 {
@@ -107,55 +119,14 @@ bool CDVDCodecUtils::CopyPicture(DVDVideoPicture* pDst, DVDVideoPicture* pSrc)
 
 bool CDVDCodecUtils::CopyPicture(YV12Image* pImage, DVDVideoPicture *pSrc)
 {
-  BYTE *s = pSrc->data[0];
-  BYTE *d = pImage->plane[0];
   int w = pImage->width * pImage->bpp;
   int h = pImage->height;
-  if ((w == pSrc->iLineSize[0]) && ((unsigned int) pSrc->iLineSize[0] == pImage->stride[0]))
-  {
-    fast_memcpy(d, s, w*h);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      fast_memcpy(d, s, w);
-      s += pSrc->iLineSize[0];
-      d += pImage->stride[0];
-    }
-  }
-  s = pSrc->data[1];
-  d = pImage->plane[1];
+  CopyPlane(pImage->plane[0], pImage->stride[0], pSrc->data[0], pSrc->iLineSize[0], w, h);
+
   w =(pImage->width  >> pImage->cshift_x) * pImage->bpp;
   h =(pImage->height >> pImage->cshift_y);
-  if ((w==pSrc->iLineSize[1]) && ((unsigned int) pSrc->iLineSize[1]==pImage->stride[1]))
-  {
-    fast_memcpy(d, s, w*h);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      fast_memcpy(d, s, w);
-      s += pSrc->iLineSize[1];
-      d += pImage->stride[1];
-    }
-  }
-  s = pSrc->data[2];
-  d = pImage->plane[2];
-  if ((w==pSrc->iLineSize[2]) && ((unsigned int) pSrc->iLineSize[2]==pImage->stride[2]))
-  {
-    fast_memcpy(d, s, w*h);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      fast_memcpy(d, s, w);
-      s += pSrc->iLineSize[2];
-      d += pImage->stride[2];
-    }
-  }
+  CopyPlane(pImage->plane[1], pImage->stride[1], pSrc->data[1], pSrc->iLineSize[1], w, h);
+  CopyPlane(pImage->plane[2], pImage->stride[2], pSrc->data[2], pSrc->iLineSize[2], w, h);
   return true;
 }
 
@@ -185,27 +156,13 @@ DVDVideoPicture* CDVDCodecUtils::ConvertToNV12Picture(DVDVideoPicture *pSrc)
       pPicture->format = RENDER_FMT_NV12;
       
       // copy luma
-      uint8_t *s = pSrc->data[0];
-      uint8_t *d = pPicture->data[0];
-      for (int y = 0; y < (int)pSrc->iHeight; y++)
-      {
-        fast_memcpy(d, s, pSrc->iWidth);
-        s += pSrc->iLineSize[0];
-        d += pPicture->iLineSize[0];
-      }
+      CopyPlane(pPicture->data[0], pPicture->iLineSize[0], pSrc->data[0], pSrc->iLineSize[0], pSrc->iWidth, pSrc->iHeight);
 
       //copy chroma
-      uint8_t *s_u, *s_v, *d_uv;
-      for (int y = 0; y < (int)pSrc->iHeight/2; y++) {
-        s_u = pSrc->data[1] + (y * pSrc->iLineSize[1]);
-        s_v = pSrc->data[2] + (y * pSrc->iLineSize[2]);
-        d_uv = pPicture->data[1] + (y * pPicture->iLineSize[1]);
-        for (int x = 0; x < (int)pSrc->iWidth/2; x++) {
-          *d_uv++ = *s_u++;
-          *d_uv++ = *s_v++;
-        }
-      }
-      
+      InterleaveUV(pPicture->data[1], pPicture->iLineSize[1],
+                   pSrc->data[1], pSrc->iLineSize[1],
+                   pSrc->data[2], pSrc->iLineSize[2],
+                   pSrc->iWidth / 2, pSrc->iHeight / 2);
     }
     else
     {
@@ -280,70 +237,234 @@ DVDVideoPicture* CDVDCodecUtils::ConvertToYUV422PackedPicture(DVDVideoPicture *p
 
 bool CDVDCodecUtils::CopyNV12Picture(YV12Image* pImage, DVDVideoPicture *pSrc)
 {
-  BYTE *s = pSrc->data[0];
-  BYTE *d = pImage->plane[0];
-  int w = pSrc->iWidth;
-  int h = pSrc->iHeight;
   // Copy Y
-  if ((w == pSrc->iLineSize[0]) && ((unsigned int) pSrc->iLineSize[0] == pImage->stride[0]))
+  CopyPlane(pImage->plane[0], pImage->stride[0], pSrc->data[0], pSrc->iLineSize[0], pSrc->iWidth, pSrc->iHeight);
+
+  // Copy packed UV (width is same as for Y as it's both U and V components)
+  CopyPlane(pImage->plane[1], pImage->stride[1], pSrc->data[1], pSrc->iLineSize[1], pSrc->iWidth, pSrc->iHeight >> 1);
+
+  return true;
+}
+
+bool CDVDCodecUtils::CopyYUV422PackedPicture(YV12Image* pImage, DVDVideoPicture *pSrc)
+{
+  // Copy YUYV
+  CopyPlane(pImage->plane[0], pImage->stride[0], pSrc->data[0], pSrc->iLineSize[0], pSrc->iWidth * 2, pSrc->iHeight);
+
+  return true;
+}
+
+#if defined(__SSE2__)
+// copies a row with the stores aligned and bypassing the cache
+static inline void CopyRowStream(uint8_t *d, const uint8_t *s, int w)
+{
+  int head = (16 - ((uintptr_t)d & 15)) & 15;
+  if (head > w)
+    head = w;
+  memcpy(d, s, head);
+  d += head;
+  s += head;
+  w -= head;
+
+  int i = 0;
+  if (((uintptr_t)s & 15) == 0)
   {
-    fast_memcpy(d, s, w*h);
+    for (; i + 64 <= w; i += 64)
+    {
+      __m128i a = _mm_load_si128((const __m128i*)(s + i));
+      __m128i b = _mm_load_si128((const __m128i*)(s + i + 16));
+      __m128i c = _mm_load_si128((const __m128i*)(s + i + 32));
+      __m128i e = _mm_load_si128((const __m128i*)(s + i + 48));
+      _mm_stream_si128((__m128i*)(d + i), a);
+      _mm_stream_si128((__m128i*)(d + i + 16), b);
+      _mm_stream_si128((__m128i*)(d + i + 32), c);
+      _mm_stream_si128((__m128i*)(d + i + 48), e);
+    }
   }
   else
   {
-    for (int y = 0; y < h; y++)
+    for (; i + 64 <= w; i += 64)
     {
-      fast_memcpy(d, s, w);
-      s += pSrc->iLineSize[0];
-      d += pImage->stride[0];
+      __m128i a = _mm_loadu_si128((const __m128i*)(s + i));
+      __m128i b = _mm_loadu_si128((const __m128i*)(s + i + 16));
+      __m128i c = _mm_loadu_si128((const __m128i*)(s + i + 32));
+      __m128i e = _mm_loadu_si128((const __m128i*)(s + i + 48));
+      _mm_stream_si128((__m128i*)(d + i), a);
+      _mm_stream_si128((__m128i*)(d + i + 16), b);
+      _mm_stream_si128((__m128i*)(d + i + 32), c);
+      _mm_stream_si128((__m128i*)(d + i + 48), e);
     }
   }
-  
-  s = pSrc->data[1];
-  d = pImage->plane[1];
-  w = pSrc->iWidth;
-  h = pSrc->iHeight >> 1;
-  // Copy packed UV (width is same as for Y as it's both U and V components)
-  if ((w==pSrc->iLineSize[1]) && ((unsigned int) pSrc->iLineSize[1]==pImage->stride[1]))
+
+  for (; i + 16 <= w; i += 16)
+    _mm_stream_si128((__m128i*)(d + i), _mm_loadu_si128((const __m128i*)(s + i)));
+
+  memcpy(d + i, s + i, w - i);
+}
+#endif
+
+void CDVDCodecUtils::CopyPlane(uint8_t *dst, int dstStride, const uint8_t *src, int srcStride, int width, int height)
+{
+  // without padding the plane is one long row
+  if (width == srcStride && width == dstStride)
   {
-    fast_memcpy(d, s, w*h);
+    width *= height;
+    height = 1;
   }
-  else
+
+#if defined(__SSE2__)
+  if (width * height >= STREAM_MIN_BYTES && (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_SSE2))
   {
-    for (int y = 0; y < h; y++)
-    {
-      fast_memcpy(d, s, w);
-      s += pSrc->iLineSize[1];
-      d += pImage->stride[1];
-    }
+    for (int y = 0; y < height; y++, src += srcStride, dst += dstStride)
+      CopyRowStream(dst, src, width);
+
+    // streaming stores aren't ordered with other stores, finish them before the picture is handed on
+    _mm_sfence();
+    return;
   }
+#endif
 
-  return true;
+  // on arm fast_memcpy is the neon copy already
+  for (int y = 0; y < height; y++, src += srcStride, dst += dstStride)
+    fast_memcpy(dst, src, width);
 }
 
-bool CDVDCodecUtils::CopyYUV422PackedPicture(YV12Image* pImage, DVDVideoPicture *pSrc)
+void CDVDCodecUtils::InterleaveUV(uint8_t *dstUV, int dstStride, const uint8_t *srcU, int strideU, const uint8_t *srcV, int strideV, int width, int height)
 {
-  BYTE *s = pSrc->data[0];
-  BYTE *d = pImage->plane[0];
-  int w = pSrc->iWidth;
-  int h = pSrc->iHeight;
+#if defined(__SSE2__)
+  bool sse2   = (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_SSE2) != 0;
+  bool stream = sse2 && width * 2 * height >= STREAM_MIN_BYTES;
+#endif
 
-  // Copy YUYV
-  if ((w * 2 == pSrc->iLineSize[0]) && ((unsigned int) pSrc->iLineSize[0] == pImage->stride[0]))
+  for (int y = 0; y < height; y++, dstUV += dstStride, srcU += strideU, srcV += strideV)
   {
-    fast_memcpy(d, s, w*h*2);
+    uint8_t       *d = dstUV;
+    const uint8_t *u = srcU;
+    const uint8_t *v = srcV;
+    int x = 0;
+
+#if defined(__SSE2__)
+    if (sse2)
+    {
+      // pairs can only be moved to an aligned address from an even one
+      bool aligned = stream && ((uintptr_t)d & 1) == 0;
+      if (aligned)
+      {
+        for (; x < width && ((uintptr_t)(d + 2 * x) & 15); x++)
+        {
+          d[2 * x    ] = u[x];
+          d[2 * x + 1] = v[x];
+        }
+      }
+
+      for (; x + 16 <= width; x += 16)
+      {
+        __m128i mu = _mm_loadu_si128((const __m128i*)(u + x));
+        __m128i mv = _mm_loadu_si128((const __m128i*)(v + x));
+        __m128i lo = _mm_unpacklo_epi8(mu, mv);
+        __m128i hi = _mm_unpackhi_epi8(mu, mv);
+        if (aligned)
+        {
+          _mm_stream_si128((__m128i*)(d + 2 * x     ), lo);
+          _mm_stream_si128((__m128i*)(d + 2 * x + 16), hi);
+        }
+        else
+        {
+          _mm_storeu_si128((__m128i*)(d + 2 * x     ), lo);
+          _mm_storeu_si128((__m128i*)(d + 2 * x + 16), hi);
+        }
+      }
+    }
+#elif defined(__ARM_NEON__)
+    for (; x + 16 <= width; x += 16)
+    {
+      uint8x16x2_t uv;
+      uv.val[0] = vld1q_u8(u + x);
+      uv.val[1] = vld1q_u8(v + x);
+      vst2q_u8(d + 2 * x, uv);
+    }
+#endif
+
+    for (; x < width; x++)
+    {
+      d[2 * x    ] = u[x];
+      d[2 * x + 1] = v[x];
+    }
   }
-  else
+
+#if defined(__SSE2__)
+  if (stream)
+    _mm_sfence();
+#endif
+}
+
+void CDVDCodecUtils::DeinterleaveUV(uint8_t *dstU, int strideU, uint8_t *dstV, int strideV, const uint8_t *srcUV, int srcStride, int width, int height)
+{
+#if defined(__SSE2__)
+  bool sse2   = (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_SSE2) != 0;
+  bool stream = sse2 && width * 2 * height >= STREAM_MIN_BYTES;
+  const __m128i mask = _mm_set1_epi16(0x00ff);
+#endif
+
+  for (int y = 0; y < height; y++, dstU += strideU, dstV += strideV, srcUV += srcStride)
   {
-    for (int y = 0; y < h; y++)
+    uint8_t       *u = dstU;
+    uint8_t       *v = dstV;
+    const uint8_t *s = srcUV;
+    int x = 0;
+
+#if defined(__SSE2__)
+    if (sse2)
+    {
+      // both planes have to line up to stream into them
+      bool aligned = stream && (((uintptr_t)u ^ (uintptr_t)v) & 15) == 0;
+      if (aligned)
+      {
+        for (; x < width && ((uintptr_t)(u + x) & 15); x++)
+        {
+          u[x] = s[2 * x    ];
+          v[x] = s[2 * x + 1];
+        }
+      }
+
+      for (; x + 16 <= width; x += 16)
+      {
+        __m128i a  = _mm_loadu_si128((const __m128i*)(s + 2 * x     ));
+        __m128i b  = _mm_loadu_si128((const __m128i*)(s + 2 * x + 16));
+        __m128i mu = _mm_packus_epi16(_mm_and_si128(a, mask), _mm_and_si128(b, mask));
+        __m128i mv = _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+        if (aligned)
+        {
+          _mm_stream_si128((__m128i*)(u + x), mu);
+          _mm_stream_si128((__m128i*)(v + x), mv);
+        }
+        else
+        {
+          _mm_storeu_si128((__m128i*)(u + x), mu);
+          _mm_storeu_si128((__m128i*)(v + x), mv);
+        }
+      }
+    }
+#elif defined(__ARM_NEON__)
+    for (; x + 16 <= width; x += 16)
     {
-      fast_memcpy(d, s, w*2);
-      s += pSrc->iLineSize[0];
-      d += pImage->stride[0];
+      uint8x16x2_t uv = vld2q_u8(s + 2 * x);
+      vst1q_u8(u + x, uv.val[0]);
+      vst1q_u8(v + x, uv.val[1]);
+    }
+#endif
+
+    for (; x < width; x++)
+    {
+      u[x] = s[2 * x    ];
+      v[x] = s[2 * x + 1];
     }
   }
-  
-  return true;
+
+#if defined(__SSE2__)
+  if (stream)
+    _mm_sfence();
+#endif
 }
 
 bool CDVDCodecUtils::CopyDXVA2Picture(YV12Image* pImage, DVDVideoPicture *pSrc)
@@ -39,6 +39,15 @@ public:
   static bool CopyYUV422PackedPicture(YV12Image* pImage, DVDVideoPicture *pSrc);
   static bool CopyDXVA2Picture(YV12Image* pImage, DVDVideoPicture *pSrc);
 
+  /*
+   * plane kernels used by the copies above, CopyPlane takes the width in bytes,
+   * the UV ones in chroma samples. planes too large for the cache are written
+   * around it where the cpu allows, the renderer reads them from memory anyway
+   */
+  static void CopyPlane(uint8_t *dst, int dstStride, const uint8_t *src, int srcStride, int width, int height);
+  static void InterleaveUV(uint8_t *dstUV, int dstStride, const uint8_t *srcU, int strideU, const uint8_t *srcV, int strideV, int width, int height);
+  static void DeinterleaveUV(uint8_t *dstU, int strideU, uint8_t *dstV, int strideV, const uint8_t *srcUV, int srcStride, int width, int height);
+
   static bool IsVP3CompatibleWidth(int width);
 
   static double NormalizeFrameduration(double frameduration);
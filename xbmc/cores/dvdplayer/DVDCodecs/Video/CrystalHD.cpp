@@ -30,6 +30,7 @@
 #include "CrystalHD.h"
 
 #include "DVDClock.h"
+#include "DVDCodecs/DVDCodecUtils.h"
 #include "DynamicDll.h"
 #include "utils/SystemInfo.h"
 #include "threads/Atomics.h"
@@ -672,18 +673,8 @@ void CMPCOutputThread::CopyOutAsYV12(CPictureBuffer *pBuffer, BCM::BC_DTS_PROC_O
   }
   //copy chroma
   //copy uv packed to u,v planes (1/2 the width and 1/2 the height of y)
-  uint8_t *s_uv;
-  uint8_t *d_u = pBuffer->m_u_buffer_ptr;
-  uint8_t *d_v = pBuffer->m_v_buffer_ptr;
-  for (int y = 0; y < h/2; y++)
-  {
-    s_uv = procOut->UVbuff + (y * stride);
-    for (int x = 0; x < w/2; x++)
-    {
-      *d_u++ = *s_uv++;
-      *d_v++ = *s_uv++;
-    }
-  }
+  CDVDCodecUtils::DeinterleaveUV(pBuffer->m_u_buffer_ptr, w/2, pBuffer->m_v_buffer_ptr, w/2,
+                                 procOut->UVbuff, stride, w/2, h/2);
 }
 
 void CMPCOutputThread::CopyOutAsYV12DeInterlace(CPictureBuffer *pBuffer, BCM::BC_DTS_PROC_OUT *procOut, int w, int h, int stride)
@@ -700,24 +691,10 @@ void CMPCOutputThread::CopyOutAsYV12DeInterlace(CPictureBuffer *pBuffer, BCM::BC
   }
   //copy chroma
   //copy uv packed to u,v planes (1/2 the width and 1/2 the height of y)
-  uint8_t *s_uv;
-  uint8_t *d_u = pBuffer->m_u_buffer_ptr;
-  uint8_t *d_v = pBuffer->m_v_buffer_ptr;
-  for (int y = 0; y < h/4; y++)
-  {
-    s_uv = procOut->UVbuff + (y * stride);
-    for (int x = 0; x < w/2; x++)
-    {
-      *d_u++ = *s_uv++;
-      *d_v++ = *s_uv++;
-    }
-    s_uv = procOut->UVbuff + (y * stride);
-    for (int x = 0; x < w/2; x++)
-    {
-      *d_u++ = *s_uv++;
-      *d_v++ = *s_uv++;
-    }
-  }
+  //every source line is written to two lines, the second pass fills the odd ones
+  for (int line = 0; line < 2; line++)
+    CDVDCodecUtils::DeinterleaveUV(pBuffer->m_u_buffer_ptr + line * w/2, w, pBuffer->m_v_buffer_ptr + line * w/2, w,
+                                   procOut->UVbuff, stride, w/2, h/4);
 
   pBuffer->m_interlace = false;
 }
@@ -191,6 +191,26 @@ public:
    */
   virtual void SetDropState(bool bDrop) = 0;
 
+  enum EDecodeLevel {
+    DECODE_FULL = 0,         /* decode everything */
+    DECODE_SKIP_LOOPFILTER,  /* skip deblocking, artifacts may carry over to following frames */
+    DECODE_SKIP_NONREF,      /* skip frames no other frame is predicted from */
+    DECODE_KEYFRAMES,        /* only decode keyframes */
+  };
+
+  /*
+   * will be called by video player when decoding is about to fall behind,
+   * codec can then trade picture quality for time before frames are late.
+   * returns the level the codec actually decodes at
+   */
+  virtual int SetDecodeLevel(int level) { return DECODE_FULL; }
+
+  /*
+   * returns how many frames the codec skipped on purpose since it was opened,
+   * because of the drop state or the decode level
+   */
+  virtual unsigned GetSkippedFrames() { return 0; }
+
   /*
    * returns the number of demuxer bytes in any internal buffers
    */
@@ -237,4 +257,20 @@ public:
   {
     return 0;
   }
+
+  /*
+   * returns the number of threads decoding, and if they work on several frames
+   * at once or on slices of one frame, 0 if the codec doesn't use threads
+   */
+  virtual unsigned GetThreadCount(bool &frameThreads)
+  {
+    frameThreads = false;
+    return 0;
+  }
+
+  /*
+   * will be called by video player with the average time decoding took per
+   * frame and the duration of a frame, codec can then adapt its threading
+   */
+  virtual void SetDecodeTime(double decodeTime, double frameDuration) {}
 };
@@ -120,6 +120,32 @@ enum PixelFormat CDVDVideoCodecFFmpeg::GetFormat( struct AVCodecContext * avctx
   return ctx->m_dllAvCodec.avcodec_default_get_format(avctx, fmt);
 }
 
+// values of the threadingpolicy advanced setting
+enum EThreadingPolicy
+{
+  VIDEO_THREADING_AUTO  = 0,
+  VIDEO_THREADING_SLICE = 1,
+  VIDEO_THREADING_FRAME = 2
+};
+
+// if one of the hardware decoders GetFormat can switch to is enabled
+static bool HardwareDecodingEnabled()
+{
+#ifdef HAVE_LIBVDPAU
+  if (g_guiSettings.GetBool("videoplayer.usevdpau"))
+    return true;
+#endif
+#ifdef HAS_DX
+  if (g_guiSettings.GetBool("videoplayer.usedxva2"))
+    return true;
+#endif
+#ifdef HAVE_LIBVA
+  if (g_guiSettings.GetBool("videoplayer.usevaapi"))
+    return true;
+#endif
+  return false;
+}
+
 CDVDVideoCodecFFmpeg::CDVDVideoCodecFFmpeg() : CDVDVideoCodec()
 {
   m_pCodecContext = NULL;
@@ -142,6 +168,13 @@ CDVDVideoCodecFFmpeg::CDVDVideoCodecFFmpeg() : CDVDVideoCodec()
   m_iLastKeyframe = 0;
   m_dts = DVD_NOPTS_VALUE;
   m_started = false;
+  m_bFrameThreadsAllowed = false;
+  m_bFrameThreadsNext = false;
+  m_bFailed = false;
+  m_bDropState = false;
+  m_iDecodeLevel = DECODE_FULL;
+  m_iPending = 0;
+  m_iSkippedFrames = 0;
 }
 
 CDVDVideoCodecFFmpeg::~CDVDVideoCodecFFmpeg()
@@ -245,10 +278,6 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
   m_pCodecContext->workaround_bugs = FF_BUG_AUTODETECT;
   m_pCodecContext->get_format = GetFormat;
   m_pCodecContext->codec_tag = hints.codec_tag;
-  /* Only allow slice threading, since frame threading is more
-   * sensitive to changes in frame sizes, and it causes crashes
-   * during HW accell */
-  m_pCodecContext->thread_type = FF_THREAD_SLICE;
 
 #if defined(TARGET_DARWIN_IOS)
   // ffmpeg with enabled neon will crash and burn if this is enabled
@@ -291,11 +320,31 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
       m_dllAvUtil.av_opt_set(m_pCodecContext, it->m_name.c_str(), it->m_value.c_str(), 0);
   }
 
-  int num_threads = std::min(8 /*MAX_THREADS*/, g_cpuInfo.getCPUCount());
-  if( num_threads > 1 && !hints.software && m_pHardware == NULL // thumbnail extraction fails when run threaded
-  && ( pCodec->id == CODEC_ID_H264
-    || pCodec->id == CODEC_ID_MPEG4 ))
-    m_pCodecContext->thread_count = num_threads;
+  /* Frame threading is more sensitive to changes in frame sizes, and it
+   * causes crashes during HW accell, so it is only used when the codec
+   * can't end up decoding in hardware. It also adds a frame of latency per
+   * thread, so slice threading is preferred where it is fast enough. */
+  bool frameThreads = false;
+  m_bFrameThreadsAllowed = false;
+  m_bFrameThreadsNext = false;
+  if (!hints.software && m_pHardware == NULL // thumbnail extraction fails when run threaded
+  && g_cpuInfo.getCPUCount() > 1)
+  {
+    m_bFrameThreadsAllowed = (pCodec->capabilities & CODEC_CAP_FRAME_THREADS)
+                          && !(IsHardwareAllowed() && HardwareDecodingEnabled())
+                          && g_advancedSettings.m_videoThreadingPolicy != VIDEO_THREADING_SLICE;
+
+    if (m_bFrameThreadsAllowed)
+    {
+      if (g_advancedSettings.m_videoThreadingPolicy == VIDEO_THREADING_FRAME)
+        frameThreads = true;
+      // slices are too few to keep the cores busy in hd streams, or not supported at all
+      else if (hints.width * hints.height >= 1280 * 720
+           || !(pCodec->capabilities & CODEC_CAP_SLICE_THREADS))
+        frameThreads = true;
+    }
+    SetThreading(pCodec, frameThreads);
+  }
 
   if (m_dllAvCodec.avcodec_open2(m_pCodecContext, pCodec, NULL) < 0)
   {
@@ -306,10 +355,66 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
   m_pFrame = m_dllAvCodec.avcodec_alloc_frame();
   if (!m_pFrame) return false;
 
+  if (m_pCodecContext->active_thread_type)
+    CLog::Log(LOGNOTICE,"CDVDVideoCodecFFmpeg::Open() Using %d %s threads", m_pCodecContext->thread_count
+            , m_pCodecContext->active_thread_type == FF_THREAD_FRAME ? "frame" : "slice");
+
   UpdateName();
   return true;
 }
 
+void CDVDVideoCodecFFmpeg::SetThreading(const AVCodec *pCodec, bool frameThreads)
+{
+  int cpus = std::min(8 /*MAX_THREADS*/, g_cpuInfo.getCPUCount());
+  if (frameThreads)
+  {
+    // one more frame than cores, so none idles while a frame waits for its references
+    m_pCodecContext->thread_type  = FF_THREAD_FRAME;
+    m_pCodecContext->thread_count = std::min(8, cpus + 1);
+  }
+  else
+  {
+    // a thread per few hundred lines, more slices than that are rare
+    m_pCodecContext->thread_type  = FF_THREAD_SLICE;
+    m_pCodecContext->thread_count = cpus;
+    if (m_pCodecContext->coded_height > 0)
+      m_pCodecContext->thread_count = std::max(2, std::min(cpus, m_pCodecContext->coded_height / 180));
+  }
+}
+
+bool CDVDVideoCodecFFmpeg::ReopenThreaded(bool frameThreads)
+{
+  AVCodec *pCodec = m_pCodecContext->codec;
+  bool previous = m_pCodecContext->active_thread_type == FF_THREAD_FRAME;
+  m_dllAvCodec.avcodec_close(m_pCodecContext);
+  SetThreading(pCodec, frameThreads);
+
+  if (m_dllAvCodec.avcodec_open2(m_pCodecContext, pCodec, NULL) < 0)
+  {
+    CLog::Log(LOGERROR,"CDVDVideoCodecFFmpeg::ReopenThreaded() Unable to reopen codec with %s threads, going back"
+            , frameThreads ? "frame" : "slice");
+
+    m_dllAvCodec.avcodec_close(m_pCodecContext);
+    SetThreading(pCodec, previous);
+    if (m_dllAvCodec.avcodec_open2(m_pCodecContext, pCodec, NULL) < 0)
+    {
+      CLog::Log(LOGERROR,"CDVDVideoCodecFFmpeg::ReopenThreaded() Unable to reopen codec");
+      m_bFailed = true;
+      return false;
+    }
+  }
+
+  CLog::Log(LOGNOTICE,"CDVDVideoCodecFFmpeg::ReopenThreaded() Using %d %s threads", m_pCodecContext->thread_count
+          , m_pCodecContext->active_thread_type == FF_THREAD_FRAME ? "frame" : "slice");
+
+  m_started = false;
+  m_iLastKeyframe = m_pCodecContext->has_b_frames;
+  m_iPending = 0;
+  m_filters = "";
+  FilterClose();
+  return true;
+}
+
 void CDVDVideoCodecFFmpeg::Dispose()
 {
   if (m_pFrame) m_dllAvUtil.av_free(m_pFrame);
@@ -338,26 +443,52 @@ void CDVDVideoCodecFFmpeg::Dispose()
 
 void CDVDVideoCodecFFmpeg::SetDropState(bool bDrop)
 {
-  if( m_pCodecContext )
+  m_bDropState = bDrop;
+  UpdateDiscard();
+}
+
+int CDVDVideoCodecFFmpeg::SetDecodeLevel(int level)
+{
+  m_iDecodeLevel = std::max((int)DECODE_FULL, std::min((int)DECODE_KEYFRAMES, level));
+  UpdateDiscard();
+  return m_iDecodeLevel;
+}
+
+void CDVDVideoCodecFFmpeg::UpdateDiscard()
+{
+  if( !m_pCodecContext )
+    return;
+
+  int frame = AVDISCARD_DEFAULT;
+  int idct  = AVDISCARD_DEFAULT;
+  int loop  = g_advancedSettings.m_iSkipLoopFilter != 0 ? g_advancedSettings.m_iSkipLoopFilter : AVDISCARD_DEFAULT;
+
+  // the levels add up, each skips more than the one before
+  if (m_iDecodeLevel >= DECODE_SKIP_LOOPFILTER)
+    loop  = std::max(loop, (int)AVDISCARD_ALL);
+  if (m_iDecodeLevel >= DECODE_SKIP_NONREF)
   {
-    // i don't know exactly how high this should be set
-    // couldn't find any good docs on it. think it varies
-    // from codec to codec on what it does
+    frame = AVDISCARD_NONREF;
+    idct  = AVDISCARD_NONREF;
+  }
+  if (m_iDecodeLevel >= DECODE_KEYFRAMES)
+    frame = AVDISCARD_NONKEY;
 
-    //  2 seem to be to high.. it causes video to be ruined on following images
-    if( bDrop )
-    {
-      m_pCodecContext->skip_frame = AVDISCARD_NONREF;
-      m_pCodecContext->skip_idct = AVDISCARD_NONREF;
-      m_pCodecContext->skip_loop_filter = AVDISCARD_NONREF;
-    }
-    else
-    {
-      m_pCodecContext->skip_frame = AVDISCARD_DEFAULT;
-      m_pCodecContext->skip_idct = AVDISCARD_DEFAULT;
-      m_pCodecContext->skip_loop_filter = AVDISCARD_DEFAULT;
-    }
+  // i don't know exactly how high this should be set
+  // couldn't find any good docs on it. think it varies
+  // from codec to codec on what it does
+
+  //  2 seem to be to high.. it causes video to be ruined on following images
+  if( m_bDropState )
+  {
+    frame = std::max(frame, (int)AVDISCARD_NONREF);
+    idct  = std::max(idct,  (int)AVDISCARD_NONREF);
+    loop  = std::max(loop,  (int)AVDISCARD_NONREF);
   }
+
+  m_pCodecContext->skip_frame       = (AVDiscard)frame;
+  m_pCodecContext->skip_idct        = (AVDiscard)idct;
+  m_pCodecContext->skip_loop_filter = (AVDiscard)loop;
 }
 
 unsigned int CDVDVideoCodecFFmpeg::SetFilters(unsigned int flags)
@@ -425,7 +556,7 @@ int CDVDVideoCodecFFmpeg::Decode(BYTE* pData, int iSize, double dts, double pts)
 {
   int iGotPicture = 0, len = 0;
 
-  if (!m_pCodecContext)
+  if (!m_pCodecContext || m_bFailed)
     return VC_ERROR;
 
   if(pData)
@@ -478,6 +609,23 @@ int CDVDVideoCodecFFmpeg::Decode(BYTE* pData, int iSize, double dts, double pts)
     return VC_ERROR;
   }
 
+  // the decoder holds back up to its delay in packets before giving their
+  // pictures, any packet more without a picture has been skipped
+  if(pData)
+    m_iPending++;
+  if(iGotPicture && m_iPending > 0)
+    m_iPending--;
+
+  int delay = m_pCodecContext->has_b_frames;
+  if(m_pCodecContext->active_thread_type == FF_THREAD_FRAME)
+    delay += m_pCodecContext->thread_count - 1;
+  if(m_iPending > delay)
+  {
+    if(m_pCodecContext->skip_frame > AVDISCARD_DEFAULT)
+      m_iSkippedFrames++;
+    m_iPending = delay;
+  }
+
   if (!iGotPicture)
     return VC_BUFFER;
 
@@ -540,8 +688,22 @@ int CDVDVideoCodecFFmpeg::Decode(BYTE* pData, int iSize, double dts, double pts)
 
 void CDVDVideoCodecFFmpeg::Reset()
 {
+  if (m_bFailed)
+    return;
+
+  // the decoder starts over from a keyframe, the only time threading can
+  // change without showing frames decoded from missing references
+  if (m_bFrameThreadsNext && m_pCodecContext->active_thread_type != FF_THREAD_FRAME)
+  {
+    // the reopened codec has nothing to flush
+    m_bFrameThreadsNext = false;
+    ReopenThreaded(true);
+    return;
+  }
+
   m_started = false;
   m_iLastKeyframe = m_pCodecContext->has_b_frames;
+  m_iPending = 0;
   m_dllAvCodec.avcodec_flush_buffers(m_pCodecContext);
 
   if (m_pHardware)
@@ -861,3 +1023,31 @@ unsigned CDVDVideoCodecFFmpeg::GetConvergeCount()
   else
     return 0;
 }
+
+unsigned CDVDVideoCodecFFmpeg::GetThreadCount(bool &frameThreads)
+{
+  frameThreads = false;
+  if (!m_pCodecContext || !m_pCodecContext->active_thread_type)
+    return 0;
+
+  frameThreads = m_pCodecContext->active_thread_type == FF_THREAD_FRAME;
+  return m_pCodecContext->thread_count;
+}
+
+void CDVDVideoCodecFFmpeg::SetDecodeTime(double decodeTime, double frameDuration)
+{
+  if (!m_pCodecContext || m_bFailed || !m_bFrameThreadsAllowed || m_bFrameThreadsNext
+  ||  m_pCodecContext->active_thread_type == FF_THREAD_FRAME)
+    return;
+
+  // slice threads hardly keep up, decoding several frames at once uses the cores better
+  if (decodeTime < frameDuration * 0.8)
+    return;
+
+  CLog::Log(LOGNOTICE,"CDVDVideoCodecFFmpeg::SetDecodeTime() decoding takes %.1f of %.1f ms per frame, switching to frame threads on the next reset"
+          , decodeTime * 1000 / DVD_TIME_BASE, frameDuration * 1000 / DVD_TIME_BASE);
+
+  // the switch waits for the next reset, reopening the codec in the middle
+  // of a group of pictures would show garbage up to the next keyframe
+  m_bFrameThreadsNext = true;
+}
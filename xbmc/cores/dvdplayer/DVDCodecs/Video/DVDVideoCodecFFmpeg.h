@@ -57,9 +57,13 @@ public:
   bool GetPictureCommon(DVDVideoPicture* pDvdVideoPicture);
   virtual bool GetPicture(DVDVideoPicture* pDvdVideoPicture);
   virtual void SetDropState(bool bDrop);
+  virtual int  SetDecodeLevel(int level);
+  virtual unsigned GetSkippedFrames() { return m_iSkippedFrames; }
   virtual unsigned int SetFilters(unsigned int filters);
   virtual const char* GetName() { return m_name.c_str(); }; // m_name is never changed after open
   virtual unsigned GetConvergeCount();
+  virtual unsigned GetThreadCount(bool &frameThreads);
+  virtual void SetDecodeTime(double decodeTime, double frameDuration);
 
   bool               IsHardwareAllowed()                     { return !m_bSoftware; }
   IHardwareDecoder * GetHardware()                           { return m_pHardware; };
@@ -73,6 +77,10 @@ public:
 protected:
   static enum PixelFormat GetFormat(struct AVCodecContext * avctx, const PixelFormat * fmt);
 
+  void SetThreading(const AVCodec *pCodec, bool frameThreads);
+  bool ReopenThreaded(bool frameThreads);
+  void UpdateDiscard();
+
   int  FilterOpen(const CStdString& filters, bool scale);
   void FilterClose();
   int  FilterProcess(AVFrame* frame);
@@ -119,4 +127,14 @@ protected:
   double m_dts;
   bool   m_started;
   std::vector<PixelFormat> m_formats;
+
+  bool   m_bFrameThreadsAllowed; // frame threading can't be used with hardware decoding
+  bool   m_bFrameThreadsNext;    // switch to frame threading on the next reset
+  bool   m_bFailed;              // the codec couldn't be reopened, nothing is decoded anymore
+
+  bool   m_bDropState;           // the player asked to drop the next frame
+  int    m_iDecodeLevel;         // how much decoding the player asked to skip
+  int    m_iPending;             // packets that haven't given a picture yet
+  unsigned m_iSkippedFrames;     // packets skipped while discarding frames
+
 };
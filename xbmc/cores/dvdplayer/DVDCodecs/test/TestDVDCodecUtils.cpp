@@ -0,0 +1,230 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDCodecs/DVDCodecUtils.h"
+#include "cores/VideoRenderers/BaseRenderer.h"
+#include "threads/SystemClock.h"
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+static void Fill(std::vector<uint8_t> &data)
+{
+  for (size_t i = 0; i < data.size(); i++)
+    data[i] = (uint8_t)(i * 7 + (i >> 8));
+}
+
+/* odd widths, padded strides and unaligned starts, small and large enough to stream */
+static const int sizes[][2] =
+{
+  { 1,    1   },
+  { 17,   3   },
+  { 63,   5   },
+  { 720,  288 },
+  { 1921, 300 }
+};
+
+TEST(TestDVDCodecUtils, CopyPlane)
+{
+  for (unsigned int i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+  {
+    for (int pad = 0; pad < 3; pad++)
+    {
+      int w = sizes[i][0], h = sizes[i][1];
+      int srcStride = w + pad * 7, dstStride = w + pad * 5;
+
+      std::vector<uint8_t> src(srcStride * h + pad);
+      std::vector<uint8_t> dst(dstStride * h + pad, 0xee);
+      Fill(src);
+
+      CDVDCodecUtils::CopyPlane(&dst[pad], dstStride, &src[pad], srcStride, w, h);
+      for (int y = 0; y < h; y++)
+        ASSERT_EQ(0, memcmp(&dst[pad + y * dstStride], &src[pad + y * srcStride], w)) << w << "x" << h << " line " << y;
+
+      /* the padding is left alone */
+      if (pad > 0)
+        EXPECT_EQ(0xee, dst[pad + w]);
+    }
+  }
+}
+
+TEST(TestDVDCodecUtils, InterleaveUV)
+{
+  for (unsigned int i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+  {
+    for (int pad = 0; pad < 3; pad++)
+    {
+      int w = sizes[i][0], h = sizes[i][1];
+      int stride = w + pad * 3, uvStride = w * 2 + pad * 5;
+
+      std::vector<uint8_t> u(stride * h + pad), v(stride * h);
+      std::vector<uint8_t> uv(uvStride * h + pad);
+      std::vector<uint8_t> u2(stride * h), v2(stride * h + 1);
+      Fill(u);
+      Fill(v);
+      for (size_t j = 0; j < v.size(); j++)
+        v[j] ^= 0x55;
+
+      CDVDCodecUtils::InterleaveUV(&uv[pad], uvStride, &u[pad], stride, &v[0], stride, w, h);
+      for (int y = 0; y < h; y++)
+      {
+        for (int x = 0; x < w; x++)
+        {
+          ASSERT_EQ(u[pad + y * stride + x], uv[pad + y * uvStride + 2 * x    ]) << w << "x" << h << " at " << x << "," << y;
+          ASSERT_EQ(v[      y * stride + x], uv[pad + y * uvStride + 2 * x + 1]) << w << "x" << h << " at " << x << "," << y;
+        }
+      }
+
+      /* and back, with the planes at different alignments */
+      CDVDCodecUtils::DeinterleaveUV(&u2[0], stride, &v2[1], stride, &uv[pad], uvStride, w, h);
+      for (int y = 0; y < h; y++)
+      {
+        ASSERT_EQ(0, memcmp(&u2[y * stride    ], &u[pad + y * stride], w)) << w << "x" << h << " line " << y;
+        ASSERT_EQ(0, memcmp(&v2[y * stride + 1], &v[      y * stride], w)) << w << "x" << h << " line " << y;
+      }
+    }
+  }
+}
+
+static DVDVideoPicture *Picture(int width, int height)
+{
+  DVDVideoPicture *picture = CDVDCodecUtils::AllocatePicture(width, height);
+  if (picture)
+  {
+    picture->format = RENDER_FMT_YUV420P;
+    std::vector<uint8_t> data(width * height * 3 / 2);
+    Fill(data);
+    memcpy(picture->data[0], &data[0], data.size());
+  }
+  return picture;
+}
+
+static void Image(YV12Image &image, std::vector<uint8_t> &data, int width, int height, int padding)
+{
+  memset(&image, 0, sizeof(image));
+  image.width     = width;
+  image.height    = height;
+  image.cshift_x  = 1;
+  image.cshift_y  = 1;
+  image.bpp       = 1;
+  image.stride[0] = width + padding;
+  image.stride[1] = width / 2 + padding;
+  image.stride[2] = width / 2 + padding;
+
+  data.assign(image.stride[0] * height + image.stride[1] * height, 0);
+  image.plane[0] = &data[0];
+  image.plane[1] = image.plane[0] + image.stride[0] * height;
+  image.plane[2] = image.plane[1] + image.stride[1] * height / 2;
+}
+
+TEST(TestDVDCodecUtils, CopyPicture)
+{
+  DVDVideoPicture *picture = Picture(720, 576);
+  ASSERT_TRUE(picture != NULL);
+
+  for (int padding = 0; padding <= 32; padding += 32)
+  {
+    YV12Image image;
+    std::vector<uint8_t> data;
+    Image(image, data, 720, 576, padding);
+    EXPECT_TRUE(CDVDCodecUtils::CopyPicture(&image, picture));
+
+    for (int y = 0; y < 576; y++)
+      ASSERT_EQ(0, memcmp(image.plane[0] + y * image.stride[0], picture->data[0] + y * picture->iLineSize[0], 720));
+    for (int p = 1; p < 3; p++)
+      for (int y = 0; y < 288; y++)
+        ASSERT_EQ(0, memcmp(image.plane[p] + y * image.stride[p], picture->data[p] + y * picture->iLineSize[p], 360));
+  }
+
+  CDVDCodecUtils::FreePicture(picture);
+}
+
+TEST(TestDVDCodecUtils, ConvertToNV12Picture)
+{
+  DVDVideoPicture *picture = Picture(720, 576);
+  ASSERT_TRUE(picture != NULL);
+
+  DVDVideoPicture *nv12 = CDVDCodecUtils::ConvertToNV12Picture(picture);
+  ASSERT_TRUE(nv12 != NULL);
+  EXPECT_EQ(RENDER_FMT_NV12, nv12->format);
+
+  EXPECT_EQ(0, memcmp(nv12->data[0], picture->data[0], 720 * 576));
+  for (int y = 0; y < 288; y++)
+  {
+    for (int x = 0; x < 360; x++)
+    {
+      ASSERT_EQ(picture->data[1][y * picture->iLineSize[1] + x], nv12->data[1][y * nv12->iLineSize[1] + 2 * x    ]);
+      ASSERT_EQ(picture->data[2][y * picture->iLineSize[2] + x], nv12->data[1][y * nv12->iLineSize[1] + 2 * x + 1]);
+    }
+  }
+
+  CDVDCodecUtils::FreePicture(nv12);
+  CDVDCodecUtils::FreePicture(picture);
+}
+
+/* prints the time per frame of the copies done for every software decoded
+   frame, this is informational and only fails if a copy fails */
+static void Benchmark(int width, int height)
+{
+  const unsigned int frames = 50;
+  DVDVideoPicture *picture = Picture(width, height);
+  ASSERT_TRUE(picture != NULL);
+
+  YV12Image image;
+  std::vector<uint8_t> data;
+  Image(image, data, width, height, 64);
+
+  /* the picture has to be freed, so a failure only ends the loop */
+  bool copied = true;
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  for (unsigned int i = 0; copied && i < frames; i++)
+    copied = CDVDCodecUtils::CopyPicture(&image, picture);
+  unsigned int copy = XbmcThreads::SystemClockMillis() - start;
+
+  bool converted = true;
+  start = XbmcThreads::SystemClockMillis();
+  for (unsigned int i = 0; converted && i < frames; i++)
+  {
+    DVDVideoPicture *nv12 = CDVDCodecUtils::ConvertToNV12Picture(picture);
+    converted = nv12 != NULL;
+    if (converted)
+      CDVDCodecUtils::FreePicture(nv12);
+  }
+  unsigned int convert = XbmcThreads::SystemClockMillis() - start;
+
+  CDVDCodecUtils::FreePicture(picture);
+
+  EXPECT_TRUE(copied);
+  EXPECT_TRUE(converted);
+  if (copied && converted)
+    printf("%4dx%-4d: CopyPicture %.2f ms, ConvertToNV12Picture %.2f ms per frame\n",
+           width, height, (double)copy / frames, (double)convert / frames);
+}
+
+/* only of interest when working on the copies, so it is left out of the
+   normal run. --gtest_also_run_disabled_tests includes it */
+TEST(TestDVDCodecUtils, DISABLED_Benchmark)
+{
+  Benchmark(1920, 1080);
+  Benchmark(3840, 2160);
+}
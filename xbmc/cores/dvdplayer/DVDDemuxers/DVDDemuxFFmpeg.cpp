@@ -214,6 +214,8 @@ CDVDDemuxFFmpeg::CDVDDemuxFFmpeg() : CDVDDemux()
   m_bAVI = false;
   m_speed = DVD_PLAYSPEED_NORMAL;
   m_program = UINT_MAX;
+  m_keyframeStream = -1;
+  m_bKeyframeIndex = false;
 }
 
 CDVDDemuxFFmpeg::~CDVDDemuxFFmpeg()
@@ -238,6 +240,9 @@ bool CDVDDemuxFFmpeg::Open(CDVDInputStream* pInput)
   m_speed = DVD_PLAYSPEED_NORMAL;
   g_demuxer.set(this);
   m_program = UINT_MAX;
+  m_keyframes.Interrupt();
+  m_keyframeStream = -1;
+  m_bKeyframeIndex = false;
   const AVIOInterruptCB int_cb = { interrupt_cb, NULL };
 
   if (!pInput) return false;
@@ -434,6 +439,17 @@ bool CDVDDemuxFFmpeg::Open(CDVDInputStream* pInput)
   m_bMatroska = strncmp(m_pFormatContext->iformat->name, "matroska", 8) == 0;	// for "matroska.webm"
   m_bAVI = strcmp(m_pFormatContext->iformat->name, "avi") == 0;
 
+  // the index the container brought along (avi idx1, matroska cues) is only
+  // complete now, ffmpeg adds entries to it for every packet it reads later.
+  // matroska cues stored after the clusters are only read on the first seek,
+  // those files use our index, which costs no more than a byte seek.
+  bool bContainerIndex = false;
+  for (unsigned int i = 0; i < m_pFormatContext->nb_streams; i++)
+  {
+    if (m_pFormatContext->streams[i]->nb_index_entries > 0)
+      bContainerIndex = true;
+  }
+
   if (streaminfo)
   {
     /* too speed up dvd switches, only analyse very short */
@@ -495,6 +511,22 @@ bool CDVDDemuxFFmpeg::Open(CDVDInputStream* pInput)
       AddStream(i);
   }
 
+  // the keyframes are indexed for the first video stream
+  for (int i = 0; i < MAX_STREAMS; i++)
+  {
+    if (m_streams[i] && m_streams[i]->type == STREAM_VIDEO)
+    {
+      m_keyframeStream = i;
+      break;
+    }
+  }
+
+  // formats with an index of their own seek fine without ours, for the others
+  // ffmpeg has to search the file, which is slow and often lands off target
+  m_bKeyframeIndex = m_keyframeStream >= 0
+                  && !bContainerIndex
+                  && !(m_pFormatContext->iformat->flags & AVFMT_NO_BYTE_SEEK);
+
   return true;
 }
 
@@ -555,6 +587,7 @@ void CDVDDemuxFFmpeg::Flush()
     m_dllAvFormat.av_read_frame_flush(m_pFormatContext);
 
   m_iCurrentPts = DVD_NOPTS_VALUE;
+  m_keyframes.Interrupt();
 }
 
 void CDVDDemuxFFmpeg::Abort()
@@ -744,6 +777,14 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
         if (pPacket->dts != DVD_NOPTS_VALUE && (pPacket->dts > m_iCurrentPts || m_iCurrentPts == DVD_NOPTS_VALUE))
           m_iCurrentPts = pPacket->dts;
 
+        // remember where the keyframes of the video are, to seek straight to them later
+        if (pkt.stream_index == m_keyframeStream && pkt.flags & AV_PKT_FLAG_KEY && pkt.pos >= 0)
+        {
+          double ts = pPacket->pts != DVD_NOPTS_VALUE ? pPacket->pts : pPacket->dts;
+          if (ts != DVD_NOPTS_VALUE)
+            m_keyframes.Add(DVD_TIME_TO_MSEC(ts), pkt.pos);
+        }
+
 
         // check if stream has passed full duration, needed for live streams
         if(pkt.dts != (int64_t)AV_NOPTS_VALUE)
@@ -845,10 +886,17 @@ bool CDVDDemuxFFmpeg::SeekTime(int time, bool backwords, double *startpts)
   int ret;
   {
     CSingleLock lock(m_critSection);
-    ret = m_dllAvFormat.av_seek_frame(m_pFormatContext, -1, seek_pts, backwords ? AVSEEK_FLAG_BACKWARD : 0);
+    m_keyframes.Interrupt();
+
+    if (SeekKeyframe(time))
+      ret = 0;
+    else
+    {
+      ret = m_dllAvFormat.av_seek_frame(m_pFormatContext, -1, seek_pts, backwords ? AVSEEK_FLAG_BACKWARD : 0);
 
-    if(ret >= 0)
-      UpdateCurrentPTS();
+      if(ret >= 0)
+        UpdateCurrentPTS();
+    }
   }
 
   if(m_iCurrentPts == DVD_NOPTS_VALUE)
@@ -872,6 +920,7 @@ bool CDVDDemuxFFmpeg::SeekByte(int64_t pos)
   g_demuxer.set(this);
 
   CSingleLock lock(m_critSection);
+  m_keyframes.Interrupt();
   int ret = m_dllAvFormat.av_seek_frame(m_pFormatContext, -1, pos, AVSEEK_FLAG_BYTE);
 
   if(ret >= 0)
@@ -880,6 +929,29 @@ bool CDVDDemuxFFmpeg::SeekByte(int64_t pos)
   return (ret >= 0);
 }
 
+bool CDVDDemuxFFmpeg::UsesKeyframeIndex()
+{
+  return m_pFormatContext && m_bKeyframeIndex;
+}
+
+bool CDVDDemuxFFmpeg::SeekKeyframe(int time)
+{
+  if (!UsesKeyframeIndex())
+    return false;
+
+  int64_t pos;
+  int     keyTime;
+  if (!m_keyframes.Find(time, pos, keyTime))
+    return false;
+
+  if (m_dllAvFormat.av_seek_frame(m_pFormatContext, -1, pos, AVSEEK_FLAG_BYTE) < 0)
+    return false;
+
+  m_iCurrentPts = DVD_MSEC_TO_TIME(keyTime);
+  CLog::Log(LOGDEBUG, "%s - seek to %d using keyframe at %d", __FUNCTION__, time, keyTime);
+  return true;
+}
+
 void CDVDDemuxFFmpeg::UpdateCurrentPTS()
 {
   m_iCurrentPts = DVD_NOPTS_VALUE;
@@ -24,6 +24,7 @@
 #include "DllAvFormat.h"
 #include "DllAvCodec.h"
 #include "DllAvUtil.h"
+#include "DVDDemuxKeyframeIndex.h"
 
 #include "threads/CriticalSection.h"
 #include "threads/SystemClock.h"
@@ -110,6 +111,9 @@ public:
 
   bool Aborted();
 
+  CDVDDemuxKeyframeIndex& GetKeyframeIndex() { return m_keyframes; }
+  bool UsesKeyframeIndex();
+
   AVFormatContext* m_pFormatContext;
 
 protected:
@@ -122,6 +126,7 @@ protected:
 
   double ConvertTimestamp(int64_t pts, int den, int num);
   void UpdateCurrentPTS();
+  bool SeekKeyframe(int time);
 
   CCriticalSection m_critSection;
   #define MAX_STREAMS 100
@@ -140,6 +145,10 @@ protected:
   unsigned m_program;
   XbmcThreads::EndTime  m_timeout;
 
+  CDVDDemuxKeyframeIndex m_keyframes;     // keyframes of the video stream seen so far
+  int                    m_keyframeStream; // stream the keyframes are indexed for, -1 if none yet
+  bool                   m_bKeyframeIndex; // decided on open, the container has no index of its own
+
   CDVDInputStream* m_pInput;
 };
 
@@ -0,0 +1,244 @@
+/*
+ *      Copyright (C) 2010-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDDemuxKeyframeIndex.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define KEYFRAME_INDEX_SPACING 2000 // ms between the keyframes kept
+#define KEYFRAME_INDEX_MAX_GAP 5000 // ms a seek may go past a keyframe that isn't continued
+#define KEYFRAME_INDEX_VERSION 2
+
+CDVDDemuxKeyframeIndex::CDVDDemuxKeyframeIndex()
+{
+  Clear();
+  m_fileSize = -1;
+}
+
+void CDVDDemuxKeyframeIndex::Clear()
+{
+  m_entries.clear();
+  m_last    = -1;
+  m_changed = false;
+}
+
+void CDVDDemuxKeyframeIndex::Insert(const Entry &entry, int &index)
+{
+  /* find the first entry at or after the given time */
+  int lo = 0, hi = (int)m_entries.size();
+  while (lo < hi)
+  {
+    int mid = (lo + hi) / 2;
+    if (m_entries[mid].time < entry.time)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  /* one keyframe every KEYFRAME_INDEX_SPACING is plenty */
+  if (lo < (int)m_entries.size() && m_entries[lo].time - entry.time < KEYFRAME_INDEX_SPACING)
+  {
+    index = lo;
+    return;
+  }
+  if (lo > 0 && entry.time - m_entries[lo - 1].time < KEYFRAME_INDEX_SPACING)
+  {
+    index = lo - 1;
+    return;
+  }
+
+  Entry added = entry;
+
+  /* if the entry before has been read up to the next one, so has the new one */
+  if (lo > 0 && lo < (int)m_entries.size() && m_entries[lo - 1].continued)
+    added.continued = true;
+
+  m_entries.insert(m_entries.begin() + lo, added);
+  if (m_last >= lo)
+    m_last++;
+
+  index     = lo;
+  m_changed = true;
+}
+
+void CDVDDemuxKeyframeIndex::Add(int time, int64_t pos)
+{
+  if (time < 0 || pos < 0)
+    return;
+
+  Entry entry;
+  entry.time      = time;
+  entry.pos       = pos;
+  entry.continued = false;
+
+  int index;
+  Insert(entry, index);
+
+  /* everything from the keyframe read before up to this one has been read */
+  if (m_last >= 0 && m_last < index)
+  {
+    for (int i = m_last; i < index; i++)
+    {
+      if (!m_entries[i].continued)
+      {
+        m_entries[i].continued = true;
+        m_changed = true;
+      }
+    }
+  }
+
+  m_last = index;
+}
+
+void CDVDDemuxKeyframeIndex::Interrupt()
+{
+  m_last = -1;
+}
+
+bool CDVDDemuxKeyframeIndex::Find(int time, int64_t &pos, int &keyTime) const
+{
+  /* find the last entry at or before the given time */
+  int lo = 0, hi = (int)m_entries.size();
+  while (lo < hi)
+  {
+    int mid = (lo + hi) / 2;
+    if (m_entries[mid].time <= time)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  if (lo == 0)
+    return false;
+
+  const Entry &entry = m_entries[lo - 1];
+  if (!entry.continued && time - entry.time > KEYFRAME_INDEX_MAX_GAP)
+    return false;
+
+  pos     = entry.pos;
+  keyTime = entry.time;
+  return true;
+}
+
+void CDVDDemuxKeyframeIndex::Merge(const CDVDDemuxKeyframeIndex &other)
+{
+  for (unsigned int i = 0; i < other.m_entries.size(); i++)
+  {
+    const Entry &entry = other.m_entries[i];
+
+    int index;
+    Insert(entry, index);
+    if (entry.continued && !m_entries[index].continued)
+    {
+      m_entries[index].continued = true;
+      m_changed = true;
+    }
+  }
+}
+
+int CDVDDemuxKeyframeIndex::GetCoveredTime() const
+{
+  int covered = 0;
+  for (unsigned int i = 0; i + 1 < m_entries.size(); i++)
+  {
+    if (m_entries[i].continued)
+      covered += m_entries[i + 1].time - m_entries[i].time;
+  }
+  return covered;
+}
+
+CStdString CDVDDemuxKeyframeIndex::Serialize(unsigned int maxLength) const
+{
+  /* every round drops every other keyframe until it fits */
+  for (unsigned int step = 1; ; step *= 2)
+  {
+    CStdString data;
+    data.Format("%d;%lld;", KEYFRAME_INDEX_VERSION, (long long)m_fileSize);
+
+    int     time = 0;
+    int64_t pos  = 0;
+    for (unsigned int i = 0; i < m_entries.size(); i += step)
+    {
+      /* the keyframes are only continued if all dropped ones are */
+      bool continued = true;
+      for (unsigned int j = i; j < i + step && j < m_entries.size(); j++)
+        continued &= m_entries[j].continued;
+
+      /* the values are stored as differences to the previous ones */
+      char entry[64];
+      sprintf(entry, "%d,%lld,%d;", m_entries[i].time - time, (long long)(m_entries[i].pos - pos), continued ? 1 : 0);
+      data += entry;
+
+      time = m_entries[i].time;
+      pos  = m_entries[i].pos;
+    }
+
+    if (data.size() <= maxLength || step >= m_entries.size())
+      return data;
+  }
+}
+
+bool CDVDDemuxKeyframeIndex::Deserialize(const CStdString &data, int64_t fileSize)
+{
+  Clear();
+
+  const char *str = data.c_str();
+  char *end;
+  if (strtol(str, &end, 10) != KEYFRAME_INDEX_VERSION || *end != ';')
+    return false;
+  str = end + 1;
+
+  /* seeking to the positions of another file lands anywhere */
+  if (strtoll(str, &end, 10) != fileSize || *end != ';')
+    return false;
+  str = end + 1;
+
+  int     time = 0;
+  int64_t pos  = 0;
+  while (*str)
+  {
+    Entry entry;
+    time += strtol(str, &end, 10);
+    if (*end != ',')
+      break;
+    pos += strtoll(end + 1, &end, 10);
+    if (*end != ',')
+      break;
+    entry.continued = strtol(end + 1, &end, 10) != 0;
+    if (*end != ';')
+      break;
+    if (!m_entries.empty() && m_entries.back().time >= time)
+      break;
+    str = end + 1;
+
+    entry.time = time;
+    entry.pos  = pos;
+    m_entries.push_back(entry);
+  }
+
+  if (*str)
+  {
+    Clear();
+    return false;
+  }
+
+  m_fileSize = fileSize;
+  return true;
+}
@@ -0,0 +1,81 @@
+#pragma once
+/*
+ *      Copyright (C) 2010-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <vector>
+#include "utils/StdString.h"
+
+/*
+ * Index of the byte positions of the keyframes of a file, which is built
+ * while the file is read. Seeking to a keyframe of the index is a single
+ * byte seek, where the formats without an index of their own otherwise have
+ * to bisect or scan the file.
+ */
+class CDVDDemuxKeyframeIndex
+{
+public:
+  CDVDDemuxKeyframeIndex();
+
+  void Clear();
+
+  // adds a keyframe found while reading, time is in ms from the start of the file
+  void Add(int time, int64_t pos);
+
+  // the next keyframe added isn't read right after the previous one, eg. after a seek
+  void Interrupt();
+
+  // finds the last keyframe before time, fails if the index doesn't know the area
+  bool Find(int time, int64_t &pos, int &keyTime) const;
+
+  // adds the keyframes of another index of the same file
+  void Merge(const CDVDDemuxKeyframeIndex &other);
+
+  bool IsEmpty() const { return m_entries.empty(); }
+  bool IsChanged() const { return m_changed; }
+  void SetChanged(bool changed) { m_changed = changed; }
+
+  // the covered play time in ms, the parts read continuously only
+  int GetCoveredTime() const;
+
+  // size of the file the index is of, stored with it as the positions are of no use for another file
+  void SetFileSize(int64_t size) { m_fileSize = size; }
+  int64_t GetFileSize() const { return m_fileSize; }
+
+  // serializes the index into at most maxLength characters, dropping keyframes if needed
+  CStdString Serialize(unsigned int maxLength) const;
+  // fails if the index was stored for a file of another size, eg. one replaced under the same name
+  bool Deserialize(const CStdString &data, int64_t fileSize);
+
+private:
+  typedef struct
+  {
+    int     time;      // ms from the start of the file
+    int64_t pos;       // byte position of the packet
+    bool    continued; // if everything up to the next keyframe has been read
+  } Entry;
+
+  void Insert(const Entry &entry, int &index);
+
+  std::vector<Entry> m_entries; // ordered by time
+  int                m_last;    // entry that was read last, -1 if reading was interrupted
+  bool               m_changed;
+  int64_t            m_fileSize; // -1 if unknown
+};
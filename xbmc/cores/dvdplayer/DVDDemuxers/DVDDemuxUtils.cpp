@@ -24,6 +24,8 @@
 #include "DVDDemuxUtils.h"
 #include "DVDClock.h"
 #include "utils/log.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
 extern "C" {
 #if (defined USE_EXTERNAL_FFMPEG)
   #if (defined HAVE_LIBAVCODEC_AVCODEC_H)
@@ -36,13 +38,157 @@ extern "C" {
 #endif
 }
 
+/*
+ * Demux packets are allocated and freed at the rate of the incoming packets,
+ * so both the packets and their data buffers are kept in pools instead of
+ * going back to the heap. The buffers are pooled in a few size classes,
+ * the larger the class the fewer buffers it keeps.
+ */
+
+#define POOL_CLASSES   7           // packets without data plus six buffer sizes
+#define POOL_MAX_BYTES (1 << 20)   // bytes kept idle per buffer size
+#define POOL_MIN_COUNT 2           // buffers kept idle per buffer size at least
+#define POOL_MAX_EMPTY 64          // packets without data kept idle
+
+static const unsigned int g_poolSizes[POOL_CLASSES] = { 0, 1 << 10, 1 << 12, 1 << 14, 1 << 16, 1 << 18, 1 << 20 };
+
+typedef struct PooledPacket
+{
+  DemuxPacket          packet;   // has to be first, the callers only see this
+  BYTE*                buffer;   // the data buffer belonging to the packet
+  unsigned int         capacity; // size of the buffer, including the padding
+  struct PooledPacket* next;
+} PooledPacket;
+
+class CDemuxPacketPool
+{
+public:
+  CDemuxPacketPool()
+  {
+    for (int i = 0; i < POOL_CLASSES; i++)
+    {
+      m_free[i]  = NULL;
+      m_count[i] = 0;
+    }
+  }
+
+  ~CDemuxPacketPool()
+  {
+    Trim();
+  }
+
+  PooledPacket* Get(unsigned int capacity)
+  {
+    int c = GetClass(capacity);
+    if (c >= 0)
+    {
+      CSingleLock lock(m_section);
+      PooledPacket* pooled = m_free[c];
+      if (pooled)
+      {
+        m_free[c] = pooled->next;
+        m_count[c]--;
+        return pooled;
+      }
+      capacity = g_poolSizes[c];
+    }
+
+    PooledPacket* pooled = new PooledPacket;
+    pooled->buffer   = NULL;
+    pooled->capacity = capacity;
+    pooled->next     = NULL;
+    if (capacity > 0)
+    {
+      pooled->buffer = (BYTE*)_aligned_malloc(capacity, 16);
+      if (!pooled->buffer)
+      {
+        delete pooled;
+        return NULL;
+      }
+    }
+    return pooled;
+  }
+
+  void Put(PooledPacket* pooled)
+  {
+    int c = GetClass(pooled->capacity);
+
+    /* buffers that don't match a class exactly are too big to keep */
+    if (c < 0 || g_poolSizes[c] != pooled->capacity)
+    {
+      _aligned_free(pooled->buffer);
+      pooled->buffer   = NULL;
+      pooled->capacity = 0;
+      c = 0;
+    }
+
+    CSingleLock lock(m_section);
+    if (m_count[c] < MaxCount(c))
+    {
+      pooled->next = m_free[c];
+      m_free[c]    = pooled;
+      m_count[c]++;
+      return;
+    }
+    lock.Leave();
+
+    _aligned_free(pooled->buffer);
+    delete pooled;
+  }
+
+  void Trim()
+  {
+    CSingleLock lock(m_section);
+    for (int i = 0; i < POOL_CLASSES; i++)
+    {
+      while (m_free[i])
+      {
+        PooledPacket* pooled = m_free[i];
+        m_free[i] = pooled->next;
+        _aligned_free(pooled->buffer);
+        delete pooled;
+      }
+      m_count[i] = 0;
+    }
+  }
+
+private:
+  static int GetClass(unsigned int capacity)
+  {
+    for (int i = 0; i < POOL_CLASSES; i++)
+    {
+      if (capacity <= g_poolSizes[i])
+        return i;
+    }
+    return -1;
+  }
+
+  static unsigned int MaxCount(int c)
+  {
+    if (c == 0)
+      return POOL_MAX_EMPTY;
+    return std::max(POOL_MAX_BYTES / g_poolSizes[c], (unsigned int)POOL_MIN_COUNT);
+  }
+
+  CCriticalSection m_section;
+  PooledPacket*    m_free[POOL_CLASSES];
+  unsigned int     m_count[POOL_CLASSES];
+};
+
+static CDemuxPacketPool g_packetPool;
+
 void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 {
   if (pPacket)
   {
     try {
-      if (pPacket->pData) _aligned_free(pPacket->pData);
-      delete pPacket;
+      PooledPacket* pooled = (PooledPacket*)pPacket;
+
+      /* the data might have been replaced by a buffer of the caller */
+      if (pPacket->pData && pPacket->pData != pooled->buffer)
+        _aligned_free(pPacket->pData);
+
+      g_packetPool.Put(pooled);
     }
     catch(...) {
       CLog::Log(LOGERROR, "%s - Exception thrown while freeing packet", __FUNCTION__);
@@ -52,30 +198,28 @@ void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 
 DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
 {
-  DemuxPacket* pPacket = new DemuxPacket;
-  if (!pPacket) return NULL;
+  // need to allocate a few bytes more.
+  // From avcodec.h (ffmpeg)
+  /**
+    * Required number of additionally allocated bytes at the end of the input bitstream for decoding.
+    * this is mainly needed because some optimized bitstream readers read
+    * 32 or 64 bit at once and could read over the end<br>
+    * Note, if the first 23 bits of the additional bytes are not 0 then damaged
+    * MPEG bitstreams could cause overread and segfault
+    */
+  unsigned int capacity = iDataSize > 0 ? iDataSize + FF_INPUT_BUFFER_PADDING_SIZE : 0;
+
+  PooledPacket* pooled = g_packetPool.Get(capacity);
+  if (!pooled) return NULL;
 
+  DemuxPacket* pPacket = &pooled->packet;
   try
   {
     memset(pPacket, 0, sizeof(DemuxPacket));
 
     if (iDataSize > 0)
     {
-      // need to allocate a few bytes more.
-      // From avcodec.h (ffmpeg)
-      /**
-        * Required number of additionally allocated bytes at the end of the input bitstream for decoding.
-        * this is mainly needed because some optimized bitstream readers read
-        * 32 or 64 bit at once and could read over the end<br>
-        * Note, if the first 23 bits of the additional bytes are not 0 then damaged
-        * MPEG bitstreams could cause overread and segfault
-        */
-      pPacket->pData =(BYTE*)_aligned_malloc(iDataSize + FF_INPUT_BUFFER_PADDING_SIZE, 16);
-      if (!pPacket->pData)
-      {
-        FreeDemuxPacket(pPacket);
-        return NULL;
-      }
+      pPacket->pData = pooled->buffer;
 
       // reset the last 8 bytes to 0;
       memset(pPacket->pData + iDataSize, 0, FF_INPUT_BUFFER_PADDING_SIZE);
@@ -94,3 +238,8 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
   }
   return pPacket;
 }
+
+void CDVDDemuxUtils::TrimPacketPool()
+{
+  g_packetPool.Trim();
+}
@@ -0,0 +1,190 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "cores/dvdplayer/DVDDemuxers/DVDDemuxKeyframeIndex.h"
+
+#include "gtest/gtest.h"
+
+/* reads a keyframe every second from start to end, 100 bytes per ms */
+static void Read(CDVDDemuxKeyframeIndex &index, int start, int end)
+{
+  index.Interrupt();
+  for (int time = start; time <= end; time += 1000)
+    index.Add(time, (int64_t)time * 100);
+}
+
+TEST(TestDVDDemuxKeyframeIndex, AddFind)
+{
+  CDVDDemuxKeyframeIndex index;
+  EXPECT_TRUE(index.IsEmpty());
+  Read(index, 1000, 20000);
+  EXPECT_FALSE(index.IsEmpty());
+  EXPECT_TRUE(index.IsChanged());
+
+  int64_t pos;
+  int     keyTime;
+  EXPECT_FALSE(index.Find(500, pos, keyTime));
+
+  ASSERT_TRUE(index.Find(1000, pos, keyTime));
+  EXPECT_EQ(1000, keyTime);
+  EXPECT_EQ(100000, pos);
+
+  /* the keyframes kept are at least 2 seconds apart */
+  ASSERT_TRUE(index.Find(4500, pos, keyTime));
+  EXPECT_EQ(3000, keyTime);
+  EXPECT_EQ(300000, pos);
+
+  /* the last keyframe read only covers a few seconds past it */
+  EXPECT_TRUE(index.Find(23000, pos, keyTime));
+  EXPECT_EQ(19000, keyTime);
+  EXPECT_FALSE(index.Find(30000, pos, keyTime));
+
+  EXPECT_EQ(18000, index.GetCoveredTime());
+}
+
+TEST(TestDVDDemuxKeyframeIndex, Interrupt)
+{
+  CDVDDemuxKeyframeIndex index;
+  Read(index, 0, 10000);
+  Read(index, 60000, 70000);
+
+  /* nothing was read between the two parts */
+  int64_t pos;
+  int     keyTime;
+  EXPECT_TRUE(index.Find(14000, pos, keyTime));
+  EXPECT_EQ(10000, keyTime);
+  EXPECT_FALSE(index.Find(30000, pos, keyTime));
+  EXPECT_TRUE(index.Find(61000, pos, keyTime));
+  EXPECT_EQ(60000, keyTime);
+
+  EXPECT_EQ(20000, index.GetCoveredTime());
+
+  /* reading the gap joins them */
+  Read(index, 10000, 60000);
+  ASSERT_TRUE(index.Find(30000, pos, keyTime));
+  EXPECT_EQ(30000, keyTime);
+  EXPECT_EQ(3000000, pos);
+  EXPECT_EQ(70000, index.GetCoveredTime());
+}
+
+TEST(TestDVDDemuxKeyframeIndex, Merge)
+{
+  CDVDDemuxKeyframeIndex first, second;
+  Read(first, 0, 20000);
+  Read(second, 40000, 60000);
+  first.SetChanged(false);
+
+  first.Merge(second);
+  EXPECT_TRUE(first.IsChanged());
+  EXPECT_EQ(40000, first.GetCoveredTime());
+
+  int64_t pos;
+  int     keyTime;
+  ASSERT_TRUE(first.Find(51000, pos, keyTime));
+  EXPECT_EQ(50000, keyTime);
+  EXPECT_EQ(5000000, pos);
+  EXPECT_FALSE(first.Find(30000, pos, keyTime));
+
+  /* merging what is known already changes nothing */
+  first.SetChanged(false);
+  first.Merge(second);
+  EXPECT_FALSE(first.IsChanged());
+}
+
+TEST(TestDVDDemuxKeyframeIndex, Serialize)
+{
+  CDVDDemuxKeyframeIndex index, restored;
+  Read(index, 0, 20000);
+  Read(index, 60000, 80000);
+  index.SetFileSize(8000000);
+
+  CStdString data = index.Serialize(4096);
+  ASSERT_TRUE(restored.Deserialize(data, 8000000));
+  EXPECT_EQ(8000000, restored.GetFileSize());
+  EXPECT_EQ(data, restored.Serialize(4096));
+  EXPECT_EQ(index.GetCoveredTime(), restored.GetCoveredTime());
+  EXPECT_FALSE(restored.IsChanged());
+
+  for (int time = 0; time <= 90000; time += 500)
+  {
+    int64_t pos1 = -1, pos2 = -1;
+    int     key1 = -1, key2 = -1;
+    EXPECT_EQ(index.Find(time, pos1, key1), restored.Find(time, pos2, key2)) << time;
+    EXPECT_EQ(pos1, pos2) << time;
+    EXPECT_EQ(key1, key2) << time;
+  }
+
+  EXPECT_FALSE(restored.Deserialize("0;", 100));
+  EXPECT_TRUE(restored.IsEmpty());
+  EXPECT_FALSE(restored.Deserialize("1;0,0,1;", 100));
+  EXPECT_TRUE(restored.IsEmpty());
+  EXPECT_FALSE(restored.Deserialize("2;100;0,0,1;2000,x", 100));
+  EXPECT_TRUE(restored.IsEmpty());
+  EXPECT_FALSE(restored.Deserialize("2;100;2000,0,1;0,100,1;", 100));
+  EXPECT_TRUE(restored.IsEmpty());
+}
+
+TEST(TestDVDDemuxKeyframeIndex, SerializeFileSizeMismatch)
+{
+  CDVDDemuxKeyframeIndex index, restored;
+  Read(index, 0, 20000);
+  index.SetFileSize(2000000);
+  CStdString data = index.Serialize(4096);
+
+  /* the file has been replaced by one of another size since */
+  EXPECT_FALSE(restored.Deserialize(data, 2000001));
+  EXPECT_TRUE(restored.IsEmpty());
+
+  int64_t pos;
+  int     keyTime;
+  EXPECT_FALSE(restored.Find(10000, pos, keyTime));
+
+  /* writing it back for the new file replaces the stale one */
+  restored.SetFileSize(2000001);
+  restored.Merge(index);
+  ASSERT_TRUE(restored.Deserialize(restored.Serialize(4096), 2000001));
+  EXPECT_TRUE(restored.Find(10000, pos, keyTime));
+}
+
+TEST(TestDVDDemuxKeyframeIndex, SerializeThinned)
+{
+  CDVDDemuxKeyframeIndex index, restored;
+  Read(index, 0, 1000000);
+
+  CStdString full = index.Serialize(1000000);
+  CStdString data = index.Serialize(full.size() / 3);
+  EXPECT_LE(data.size(), full.size() / 3);
+
+  /* fewer keyframes but the same span, still continuous */
+  ASSERT_TRUE(restored.Deserialize(data, -1));
+  EXPECT_EQ(index.GetCoveredTime(), restored.GetCoveredTime());
+
+  int64_t pos;
+  int     keyTime;
+  ASSERT_TRUE(restored.Find(500000, pos, keyTime));
+  EXPECT_LE(keyTime, 500000);
+  EXPECT_GT(keyTime, 500000 - 16000);
+  EXPECT_EQ((int64_t)keyTime * 100, pos);
+
+  /* if nothing fits the index is still valid, just empty */
+  data = index.Serialize(0);
+  EXPECT_TRUE(restored.Deserialize(data, -1));
+}
@@ -49,6 +49,12 @@
 #include "DllSwScale.h"
 #include "filesystem/File.h"
 #include "TextureCache.h"
+#include "utils/Job.h"
+#include "utils/StringUtils.h"
+#include "filesystem/Directory.h"
+#include "settings/Settings.h"
+#include "threads/Thread.h"
+#include "threads/Atomics.h"
 
 
 bool CDVDFileInfo::GetFileDuration(const CStdString &path, int& duration)
@@ -74,6 +80,61 @@ bool CDVDFileInfo::GetFileDuration(const CStdString &path, int& duration)
     return false;
 }
 
+bool CDVDFileInfo::BuildKeyframeIndex(const CStdString &path, CDVDDemuxKeyframeIndex &index, const CJob *job)
+{
+  std::auto_ptr<CDVDInputStream> input;
+  std::auto_ptr<CDVDDemux> demux;
+
+  input.reset(CDVDFactoryInputStream::CreateInputStream(NULL, path, ""));
+  if (!input.get() || !input->IsStreamType(DVDSTREAM_TYPE_FILE))
+    return false;
+
+  if (!input->Open(path, ""))
+    return false;
+
+  demux.reset(CDVDFactoryDemuxer::CreateDemuxer(input.get()));
+  CDVDDemuxFFmpeg *demuxer = dynamic_cast<CDVDDemuxFFmpeg*>(demux.get());
+  if (!demuxer || !demuxer->UsesKeyframeIndex())
+    return false;
+
+  index.SetFileSize(input->GetLength());
+  unsigned int total = (unsigned int)(input->GetLength() / 1024);
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  while (DemuxPacket *pPacket = demuxer->Read())
+  {
+    CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+    if (job && job->ShouldCancel((unsigned int)(input->Seek(0, SEEK_CUR) / 1024), total))
+      return false;
+  }
+
+  index.Merge(demuxer->GetKeyframeIndex());
+  CLog::Log(LOGDEBUG, "%s - indexed %s in %u ms", __FUNCTION__, path.c_str(), XbmcThreads::SystemClockMillis() - start);
+  return !index.IsEmpty();
+}
+
+#define THUMB_MAX_BLACK_PICTURES 3
+
+// checks if the picture is mostly dark, looking at a grid of luma samples
+static bool IsBlackPicture(const DVDVideoPicture &picture)
+{
+  if (!picture.data[0] || picture.iWidth < 16 || picture.iHeight < 16)
+    return false;
+
+  unsigned int samples = 0, bright = 0;
+  for (unsigned int y = picture.iHeight / 16; y < picture.iHeight; y += picture.iHeight / 16)
+  {
+    const uint8_t *line = picture.data[0] + y * picture.iLineSize[0];
+    for (unsigned int x = picture.iWidth / 32; x < picture.iWidth; x += picture.iWidth / 16)
+    {
+      samples++;
+      if (line[x] > 40)
+        bright++;
+    }
+  }
+
+  return bright * 20 < samples;
+}
+
 int DegreeToOrientation(int degrees)
 {
   switch(degrees)
@@ -162,16 +223,13 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &deta
     CDVDStreamInfo hint(*pDemuxer->GetStream(nVideoStream), true);
     hint.software = true;
 
-    if (hint.codec == CODEC_ID_MPEG2VIDEO || hint.codec == CODEC_ID_MPEG1VIDEO)
-    {
-      // libmpeg2 is not thread safe so use ffmepg for mpeg2/mpeg1 thumb extraction
-      CDVDCodecOptions dvdOptions;
-      pVideoCodec = CDVDFactoryCodec::OpenCodec(new CDVDVideoCodecFFmpeg(), hint, dvdOptions);
-    }
-    else
-    {
+    // libmpeg2 is not thread safe so use ffmpeg for thumb extraction, which
+    // also only needs to decode the keyframes as the thumb is taken from one
+    CDVDCodecOptions dvdOptions;
+    dvdOptions.m_keys.push_back(CDVDCodecOption("skip_frame", "nokey"));
+    pVideoCodec = CDVDFactoryCodec::OpenCodec(new CDVDVideoCodecFFmpeg(), hint, dvdOptions);
+    if (!pVideoCodec && hint.codec != CODEC_ID_MPEG2VIDEO && hint.codec != CODEC_ID_MPEG1VIDEO)
       pVideoCodec = CDVDFactoryCodec::CreateVideoCodec( hint );
-    }
 
     if (pVideoCodec)
     {
@@ -189,6 +247,7 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &deta
 
         // num streams * 80 frames, should get a valid frame, if not abort.
         int abort_index = pDemuxer->GetNrOfStreams() * 80;
+        int blackPictures = 0;
         do
         {
           pPacket = pDemuxer->Read();
@@ -215,7 +274,19 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &deta
             if (pVideoCodec->GetPicture(&picture))
             {
               if(!(picture.iFlags & DVP_FLAG_DROPPED))
-                break;
+              {
+                // a dark picture, eg. from a fade, makes a poor thumb, skip ahead a little
+                if (blackPictures >= THUMB_MAX_BLACK_PICTURES || !IsBlackPicture(picture))
+                  break;
+
+                blackPictures++;
+                nSeekTo += nTotalLen / 20;
+                CLog::Log(LOGDEBUG,"%s - black picture, seeking to pos %dms in %s", __FUNCTION__, nSeekTo, strPath.c_str());
+                if (!pDemuxer->SeekTime(nSeekTo, true))
+                  break;
+                pVideoCodec->Reset();
+                abort_index = pDemuxer->GetNrOfStreams() * 80;
+              }
             }
           }
 
@@ -283,6 +354,78 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &deta
   return bOk;
 }
 
+class CThumbBenchmarkWorker : public CThread
+{
+public:
+  CThumbBenchmarkWorker(const std::vector<CStdString> &files, volatile long &next)
+    : CThread("CThumbBenchmarkWorker"), m_files(files), m_next(next), m_extracted(0)
+  {
+  }
+
+  unsigned int GetExtracted() const { return m_extracted; }
+
+protected:
+  virtual void Process()
+  {
+    // the workers take the files in turn until all are done
+    long i;
+    while (!m_bStop && (i = AtomicIncrement(&m_next) - 1) < (long)m_files.size())
+    {
+      CTextureDetails details;
+      details.file = StringUtils::Format("benchmark-%ld.jpg", i);
+      if (CDVDFileInfo::ExtractThumb(m_files[i], details, NULL))
+        m_extracted++;
+      XFILE::CFile::Delete(CTextureCache::GetCachedPath(details.file));
+    }
+  }
+
+private:
+  const std::vector<CStdString> &m_files;
+  volatile long                 &m_next;
+  unsigned int                   m_extracted;
+};
+
+bool CDVDFileInfo::BenchmarkExtractThumbs(const CStdString &directory, unsigned int threads)
+{
+  CFileItemList items;
+  if (!XFILE::CDirectory::GetDirectory(directory, items, g_settings.m_videoExtensions, XFILE::DIR_FLAG_NO_FILE_DIRS))
+    return false;
+
+  std::vector<CStdString> files;
+  for (int i = 0; i < items.Size(); i++)
+  {
+    if (!items[i]->m_bIsFolder)
+      files.push_back(items[i]->GetPath());
+  }
+  if (files.empty())
+    return false;
+
+  CLog::Log(LOGNOTICE, "%s - extracting thumbs from %u files in %s with %u threads", __FUNCTION__,
+            (unsigned int)files.size(), directory.c_str(), threads);
+
+  volatile long next = 0;
+  std::vector<CThumbBenchmarkWorker*> workers;
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  for (unsigned int i = 0; i < threads; i++)
+  {
+    workers.push_back(new CThumbBenchmarkWorker(files, next));
+    workers.back()->Create();
+  }
+
+  unsigned int extracted = 0;
+  for (unsigned int i = 0; i < workers.size(); i++)
+  {
+    workers[i]->WaitForThreadExit(0xFFFFFFFF);
+    extracted += workers[i]->GetExtracted();
+    delete workers[i];
+  }
+  unsigned int elapsed = XbmcThreads::SystemClockMillis() - start;
+
+  CLog::Log(LOGNOTICE, "%s - extracted %u of %u thumbs in %u ms, %.1f ms per file", __FUNCTION__,
+            extracted, (unsigned int)files.size(), elapsed, (double)elapsed / files.size());
+  return true;
+}
+
 /**
  * \brief Open the item pointed to by pItem and extact streamdetails
  * \return true if the stream details have changed
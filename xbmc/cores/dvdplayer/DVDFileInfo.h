@@ -26,6 +26,8 @@ class CDVDDemux;
 class CStreamDetails;
 class CDVDInputStream;
 class CTextureDetails;
+class CDVDDemuxKeyframeIndex;
+class CJob;
 
 class CDVDFileInfo
 {
@@ -38,4 +40,10 @@ public:
   static bool DemuxerToStreamDetails(CDVDInputStream* pInputStream, CDVDDemux *pDemux, CStreamDetails &details, const CStdString &path = "");
 
   static bool GetFileDuration(const CStdString &path, int &duration);
+
+  // Read the whole file to index the keyframes of its video, fails if the file doesn't need the index
+  static bool BuildKeyframeIndex(const CStdString &path, CDVDDemuxKeyframeIndex &index, const CJob *job = NULL);
+
+  // Extract thumbnails from all videos in a directory using a number of threads, and log the timings
+  static bool BenchmarkExtractThumbs(const CStdString &directory, unsigned int threads);
 };
@@ -40,12 +40,41 @@ CDVDMessageQueue::CDVDMessageQueue(const string &owner) : m_hEvent(true)
   m_TimeFront     = DVD_NOPTS_VALUE;
   m_TimeSize      = 1.0 / 4.0; /* 4 seconds */
   m_iMaxDataSize  = 0;
+
+  m_front = NULL;
+  m_back  = NULL;
+  m_free  = NULL;
 }
 
 CDVDMessageQueue::~CDVDMessageQueue()
 {
   // remove all remaining messages
-  Flush();
+  Flush(CDVDMsg::NONE);
+
+  while (m_free)
+  {
+    SNode* node = m_free;
+    m_free = node->next;
+    delete node;
+  }
+}
+
+void CDVDMessageQueue::Remove(SNode* node)
+{
+  if (node->prev)
+    node->prev->next = node->next;
+  else
+    m_front = node->next;
+
+  if (node->next)
+    node->next->prev = node->prev;
+  else
+    m_back = node->prev;
+
+  node->message = NULL;
+  node->prev    = NULL;
+  node->next    = m_free;
+  m_free        = node;
 }
 
 void CDVDMessageQueue::Init()
@@ -62,12 +91,15 @@ void CDVDMessageQueue::Flush(CDVDMsg::Message type)
 {
   CSingleLock lock(m_section);
 
-  for(SList::iterator it = m_list.begin(); it != m_list.end();)
+  for (SNode* node = m_front; node;)
   {
-    if (it->message->IsType(type) ||  type == CDVDMsg::NONE)
-      it = m_list.erase(it);
-    else
-      it++;
+    SNode* next = node->next;
+    if (node->message->IsType(type) ||  type == CDVDMsg::NONE)
+    {
+      node->message->Release();
+      Remove(node);
+    }
+    node = next;
   }
 
   if (type == CDVDMsg::DEMUXER_PACKET ||  type == CDVDMsg::NONE)
@@ -116,14 +148,40 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority)
     return MSGQ_INVALID_MSG;
   }
 
-  SList::iterator it = m_list.begin();
-  while(it != m_list.end())
+  SNode* node = m_free;
+  if (node)
+    m_free = node->next;
+  else
+  {
+    node = new SNode;
+    if (!node)
+    {
+      pMsg->Release();
+      return MSGQ_OUT_OF_MEMORY;
+    }
+  }
+
+  SNode* it = m_front;
+  while(it)
   {
     if(priority <= it->priority)
       break;
-    it++;
+    it = it->next;
   }
-  m_list.insert(it, DVDMessageListItem(pMsg, priority));
+
+  // the queue takes over the reference of the caller
+  node->message  = pMsg;
+  node->priority = priority;
+  node->next     = it;
+  node->prev     = it ? it->prev : m_back;
+  if (node->prev)
+    node->prev->next = node;
+  else
+    m_front = node;
+  if (it)
+    it->prev = node;
+  else
+    m_back = node;
 
   if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET) && priority == 0)
   {
@@ -140,8 +198,6 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority)
     }
   }
 
-  pMsg->Release();
-
   m_hEvent.Set(); // inform waiter for new packet
 
   return MSGQ_OK;
@@ -161,7 +217,7 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
     return MSGQ_NOT_INITIALIZED;
   }
 
-  if(m_list.empty() && m_bEmptied == false && priority == 0 && m_owner != "teletext")
+  if(!m_back && m_bEmptied == false && priority == 0 && m_owner != "teletext")
   {
 #if !defined(TARGET_RASPBERRY_PI)
     CLog::Log(LOGWARNING, "CDVDMessageQueue(%s)::Get - asked for new data packet, with nothing available", m_owner.c_str());
@@ -171,14 +227,14 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
 
   while (!m_bAbortRequest)
   {
-    if(!m_list.empty() && m_list.back().priority >= priority && !m_bCaching)
+    if(m_back && m_back->priority >= priority && !m_bCaching)
     {
-      DVDMessageListItem& item(m_list.back());
-      priority = item.priority;
+      SNode* item = m_back;
+      priority = item->priority;
 
-      if (item.message->IsType(CDVDMsg::DEMUXER_PACKET) && item.priority == 0)
+      if (item->message->IsType(CDVDMsg::DEMUXER_PACKET) && item->priority == 0)
       {
-        DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)item.message)->GetPacket();
+        DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)item->message)->GetPacket();
         if(packet)
         {
           m_iDataSize -= packet->iSize;
@@ -192,8 +248,9 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
           m_bEmptied = false;
       }
 
-      *pMsg = item.message->Acquire();
-      m_list.pop_back();
+      // the reference of the queue goes to the caller
+      *pMsg = item->message;
+      Remove(item);
 
       ret = MSGQ_OK;
       break;
@@ -230,9 +287,9 @@ unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
     return 0;
 
   unsigned count = 0;
-  for(SList::iterator it = m_list.begin(); it != m_list.end();it++)
+  for (SNode* node = m_front; node; node = node->next)
   {
-    if(it->message->IsType(type))
+    if(node->message->IsType(type))
       count++;
   }
 
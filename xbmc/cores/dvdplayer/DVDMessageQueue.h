@@ -22,52 +22,9 @@
 
 #include "DVDMessage.h"
 #include <string>
-#include <list>
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
 
-struct DVDMessageListItem
-{
-  DVDMessageListItem(CDVDMsg* msg, int prio)
-  {
-    message  = msg->Acquire();
-    priority = prio;
-  }
-  DVDMessageListItem()
-  {
-    message  = NULL;
-    priority = 0;
-  }
-  DVDMessageListItem(const DVDMessageListItem& item)
-  {
-    if(item.message)
-      message = item.message->Acquire();
-    else
-      message = NULL;
-    priority = item.priority;
-  }
- ~DVDMessageListItem()
-  {
-    if(message)
-      message->Release();
-  }
-
-  DVDMessageListItem& operator=(const DVDMessageListItem& item)
-  {
-    if(message)
-      message->Release();
-    if(item.message)
-      message = item.message->Acquire();
-    else
-      message = NULL;
-    priority = item.priority;
-    return *this;
-  }
-
-  CDVDMsg* message;
-  int      priority;
-};
-
 enum MsgQueueReturnCode
 {
   MSGQ_OK               = 1,
@@ -140,7 +97,21 @@ private:
   bool m_bEmptied;
   std::string m_owner;
 
-  typedef std::list<DVDMessageListItem> SList;
-  SList m_list;
+  /* the messages are kept in a doubly linked list sorted by priority, the
+     next message to return is at the back. The nodes of removed messages
+     are kept for reuse so queueing a message doesn't allocate */
+  struct SNode
+  {
+    CDVDMsg* message;
+    int      priority;
+    SNode*   prev;
+    SNode*   next;
+  };
+
+  void Remove(SNode* node);
+
+  SNode* m_front;
+  SNode* m_back;
+  SNode* m_free;
 };
 
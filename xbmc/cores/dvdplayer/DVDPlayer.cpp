@@ -84,10 +84,72 @@
 #include "Util.h"
 #include "LangInfo.h"
 #include "ApplicationMessenger.h"
+#include "video/VideoDatabase.h"
+#include "utils/JobManager.h"
 
 using namespace std;
 using namespace PVR;
 
+// the index is thinned out to fit, 60KB hold an entry every few seconds of a 4 hour recording
+#define KEYFRAME_INDEX_MAX_LENGTH 60000
+
+static bool ReadKeyframeIndex(const CStdString &path, int64_t fileSize, CDVDDemuxKeyframeIndex &index)
+{
+  CVideoDatabase db;
+  CStdString data;
+  if (!db.Open() || !db.GetKeyframeIndex(path, data))
+    return false;
+
+  return index.Deserialize(data, fileSize);
+}
+
+static void WriteKeyframeIndex(const CStdString &path, const CDVDDemuxKeyframeIndex &index)
+{
+  if (!index.IsChanged())
+    return;
+
+  // keep what others have stored since the index was read, an index
+  // stored for a file of another size is overwritten
+  CDVDDemuxKeyframeIndex stored;
+  ReadKeyframeIndex(path, index.GetFileSize(), stored);
+  stored.SetFileSize(index.GetFileSize());
+  stored.Merge(index);
+  if (!stored.IsChanged())
+    return;
+
+  CVideoDatabase db;
+  if (db.Open())
+    db.SetKeyframeIndex(path, stored.Serialize(KEYFRAME_INDEX_MAX_LENGTH));
+}
+
+class CKeyframeIndexJob : public CJob
+{
+public:
+  CKeyframeIndexJob(const CStdString &path) : m_path(path) {}
+
+  virtual const char *GetType() const { return "keyframeindex"; }
+
+  virtual bool operator==(const CJob* job) const
+  {
+    if (strcmp(job->GetType(), GetType()) == 0)
+      return m_path == ((const CKeyframeIndexJob*)job)->m_path;
+    return false;
+  }
+
+  virtual bool DoWork()
+  {
+    CDVDDemuxKeyframeIndex index;
+    if (!CDVDFileInfo::BuildKeyframeIndex(m_path, index, this))
+      return false;
+
+    WriteKeyframeIndex(m_path, index);
+    return true;
+  }
+
+private:
+  CStdString m_path;
+};
+
 void CSelectionStreams::Clear(StreamType type, StreamSource source)
 {
   CSingleLock lock(m_section);
@@ -635,7 +697,10 @@ bool CDVDPlayer::OpenInputStream()
 bool CDVDPlayer::OpenDemuxStream()
 {
   if(m_pDemuxer)
+  {
+    SaveKeyframeIndex();
     SAFE_DELETE(m_pDemuxer);
+  }
 
   CLog::Log(LOGNOTICE, "Creating Demuxer");
 
@@ -679,9 +744,57 @@ bool CDVDPlayer::OpenDemuxStream()
   if(len > 0 && tim > 0)
     m_pInputStream->SetReadRate(len * 1000 / tim);
 
+  LoadKeyframeIndex();
+
+  return true;
+}
+
+bool CDVDPlayer::UseKeyframeIndex()
+{
+  CDVDDemuxFFmpeg *demuxer = dynamic_cast<CDVDDemuxFFmpeg*>(m_pDemuxer);
+  if (!demuxer || !demuxer->UsesKeyframeIndex())
+    return false;
+
+  // byte positions are only stable for files and recordings
+  if (!m_pInputStream->IsStreamType(DVDSTREAM_TYPE_FILE)
+  &&  !m_pInputStream->IsStreamType(DVDSTREAM_TYPE_PVRMANAGER))
+    return false;
+
+  if (m_item.IsLiveTV() || m_pInputStream->GetLength() <= 0)
+    return false;
+
   return true;
 }
 
+void CDVDPlayer::LoadKeyframeIndex()
+{
+  if (!UseKeyframeIndex())
+    return;
+
+  CDVDDemuxKeyframeIndex &index = ((CDVDDemuxFFmpeg*)m_pDemuxer)->GetKeyframeIndex();
+  index.SetFileSize(m_pInputStream->GetLength());
+
+  // the stored index is dropped if the file has been replaced since
+  CDVDDemuxKeyframeIndex stored;
+  ReadKeyframeIndex(m_filename, index.GetFileSize(), stored);
+  index.Merge(stored);
+  index.SetChanged(false);
+
+  // index what playback hasn't reached yet in the background, so seeks there are fast too
+  int length = m_pDemuxer->GetStreamLength();
+  if (g_advancedSettings.m_videoKeyframeIndexJob && m_pInputStream->IsStreamType(DVDSTREAM_TYPE_FILE)
+  &&  length > 0 && stored.GetCoveredTime() < length * 9 / 10)
+    CJobManager::GetInstance().AddJob(new CKeyframeIndexJob(m_filename), NULL, CJob::PRIORITY_LOW);
+}
+
+void CDVDPlayer::SaveKeyframeIndex()
+{
+  if (!UseKeyframeIndex())
+    return;
+
+  WriteKeyframeIndex(m_filename, ((CDVDDemuxFFmpeg*)m_pDemuxer)->GetKeyframeIndex());
+}
+
 void CDVDPlayer::OpenDefaultStreams(bool reset)
 {
   // bypass for DVDs. The DVD Navigator has already dictated which streams to open.
@@ -1938,6 +2051,7 @@ void CDVDPlayer::OnExit()
     // destroy the demuxer
     if (m_pDemuxer)
     {
+      SaveKeyframeIndex();
       CLog::Log(LOGNOTICE, "CDVDPlayer::OnExit() deleting demuxer");
       delete m_pDemuxer;
     }
@@ -1963,6 +2077,9 @@ void CDVDPlayer::OnExit()
 
     m_messenger.End();
 
+    // give the memory of the demux packets kept for reuse back
+    CDVDDemuxUtils::TrimPacketPool();
+
   }
   catch (...)
   {
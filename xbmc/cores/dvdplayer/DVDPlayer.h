@@ -336,6 +336,10 @@ protected:
   bool OpenDemuxStream();
   void OpenDefaultStreams(bool reset = true);
 
+  bool UseKeyframeIndex();
+  void LoadKeyframeIndex();
+  void SaveKeyframeIndex();
+
   void UpdateApplication(double timeout);
   void UpdatePlayState(double timeout);
   double m_UpdateApplication;
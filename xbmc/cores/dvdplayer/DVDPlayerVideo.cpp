@@ -43,6 +43,7 @@
 #include <iomanip>
 #include <numeric>
 #include <iterator>
+#include <algorithm>
 #include "utils/log.h"
 
 using namespace std;
@@ -143,6 +144,21 @@ CDVDPlayerVideo::CDVDPlayerVideo( CDVDClock* pClock
   m_iDroppedRequest = 0;
   m_fForcedAspectRatio = 0;
   m_iNrOfPicturesNotToSkip = 0;
+  m_decodeTimeSum = 0.0;
+  m_decodeCount = 0;
+  m_decodeTime = 0.0;
+  m_decodeThreads = 0;
+  m_decodeFrameThreads = false;
+  m_decodeTimeHigh = 0.0;
+  m_outputSlack = 0.0;
+  m_decodeLevel = CDVDVideoCodec::DECODE_FULL;
+  m_decodeLevelBehind = 0;
+  m_decodeLevelAhead = 0;
+  m_decodeSampleCount = 0;
+  m_decodeSampleNext = 0;
+  m_decodeSkipped = 0;
+  m_iDropReason = DROP_OTHER;
+  memset(m_iDroppedReason, 0, sizeof(m_iDroppedReason));
   m_messageQueue.SetMaxDataSize(40 * 1024 * 1024);
   m_messageQueue.SetMaxTimeSize(8.0);
   g_dvdPerformanceCounter.EnableVideoQueue(&m_messageQueue);
@@ -261,6 +277,21 @@ void CDVDPlayerVideo::OpenStream(CDVDStreamInfo &hint, CDVDVideoCodec* codec)
   m_stalled = m_messageQueue.GetPacketCount(CDVDMsg::DEMUXER_PACKET) == 0;
   m_started = false;
   m_codecname = m_pVideoCodec->GetName();
+
+  m_decodeTimeSum = 0.0;
+  m_decodeCount   = 0;
+  m_decodeTime    = 0.0;
+  m_decodeThreads = m_pVideoCodec->GetThreadCount(m_decodeFrameThreads);
+
+  // a new codec starts out decoding everything
+  m_decodeSampleCount = 0;
+  m_decodeSampleNext  = 0;
+  m_decodeSkipped     = m_pVideoCodec->GetSkippedFrames();
+  m_decodeTimeHigh    = 0.0;
+  m_outputSlack       = 0.0;
+  m_decodeLevel       = CDVDVideoCodec::DECODE_FULL;
+  m_decodeLevelBehind = 0;
+  m_decodeLevelAhead  = 0;
 }
 
 void CDVDPlayerVideo::CloseStream(bool bWaitForBuffers)
@@ -298,6 +329,7 @@ void CDVDPlayerVideo::CloseStream(bool bWaitForBuffers)
 void CDVDPlayerVideo::OnStartup()
 {
   m_iDroppedFrames = 0;
+  memset(m_iDroppedReason, 0, sizeof(m_iDroppedReason));
 
   m_crop.x1 = m_crop.x2 = 0.0f;
   m_crop.y1 = m_crop.y2 = 0.0f;
@@ -543,8 +575,13 @@ void CDVDPlayerVideo::Process()
 
       mFilters = m_pVideoCodec->SetFilters(mFilters);
 
+      double decodeStart = CDVDClock::GetAbsoluteClock(false);
       int iDecoderState = m_pVideoCodec->Decode(pPacket->pData, pPacket->iSize, pPacket->dts, pPacket->pts);
 
+      // decoding while dropping or not at normal speed is no measure of what playback needs
+      if (!bRequestDrop && m_speed == DVD_PLAYSPEED_NORMAL)
+        UpdateDecodeTime(CDVDClock::GetAbsoluteClock(false) - decodeStart);
+
       // buffer packets so we can recover should decoder flush for some reason
       if(m_pVideoCodec->GetConvergeCount() > 0)
       {
@@ -562,9 +599,20 @@ void CDVDPlayerVideo::Process()
       if(bRequestDrop && !bPacketDrop && (iDecoderState & VC_BUFFER) && !(iDecoderState & VC_PICTURE))
       {
         m_iDroppedFrames++;
+        m_iDroppedReason[DROP_DECODER]++;
         iDropped++;
       }
 
+      // the decode level skips frames on purpose, so they don't count towards forcing a picture.
+      // only the codec can tell them apart from pictures it holds back for reordering
+      unsigned skipped = m_pVideoCodec->GetSkippedFrames();
+      if(!bRequestDrop && skipped > m_decodeSkipped)
+      {
+        m_iDroppedFrames += skipped - m_decodeSkipped;
+        m_iDroppedReason[DROP_LEVEL] += skipped - m_decodeSkipped;
+      }
+      m_decodeSkipped = skipped;
+
       // loop while no error
       while (!m_bStop)
       {
@@ -698,6 +746,7 @@ void CDVDPlayerVideo::Process()
             if(m_started == false)
             {
               m_codecname = m_pVideoCodec->GetName();
+              m_decodeThreads = m_pVideoCodec->GetThreadCount(m_decodeFrameThreads);
               m_started = true;
               m_messageParent.Put(new CDVDMsgInt(CDVDMsg::PLAYER_STARTED, DVDPLAYER_VIDEO));
             }
@@ -719,6 +768,7 @@ void CDVDPlayerVideo::Process()
             if( (iResult & EOS_DROPPED) && !bPacketDrop )
             {
               m_iDroppedFrames++;
+              m_iDroppedReason[m_iDropReason]++;
               iDropped++;
             }
             else
@@ -1238,6 +1288,12 @@ int CDVDPlayerVideo::OutputPicture(const DVDVideoPicture* src, double pts)
   m_FlipTimeStamp += max(0.0, iSleepTime);
   m_FlipTimeStamp += iFrameDuration;
 
+  // the lead we have on the display time tells how much longer decoding may take
+  if (m_speed == DVD_PLAYSPEED_NORMAL && !m_stalled)
+    m_outputSlack = iSleepTime;
+
+  m_iDropReason = DROP_OTHER;
+
   if (iSleepTime <= 0 && m_speed)
     m_iLateFrames++;
   else
@@ -1261,6 +1317,7 @@ int CDVDPlayerVideo::OutputPicture(const DVDVideoPicture* src, double pts)
       if (m_iDroppedRequest > 5)
       {
         m_iDroppedRequest--; //decrease so we only drop half the frames
+        m_iDropReason = DROP_LATE;
         return result | EOS_DROPPED;
       }
       m_iDroppedRequest++;
@@ -1273,9 +1330,11 @@ int CDVDPlayerVideo::OutputPicture(const DVDVideoPicture* src, double pts)
 
   if( m_speed < 0 )
   {
+    m_iDropReason = DROP_SPEED;
     if( iClockSleep < -DVD_MSEC_TO_TIME(200)
     && !(pPicture->iFlags & DVP_FLAG_NOSKIP) )
       return result | EOS_DROPPED;
+    m_iDropReason = DROP_OTHER;
   }
 
   if( (pPicture->iFlags & DVP_FLAG_DROPPED) )
@@ -1293,7 +1352,10 @@ int CDVDPlayerVideo::OutputPicture(const DVDVideoPicture* src, double pts)
     m_droptime += iFrameDuration;
 #ifndef PROFILE
     if( next < current && !(pPicture->iFlags & DVP_FLAG_NOSKIP) )
+    {
+      m_iDropReason = DROP_SPEED;
       return result | EOS_DROPPED;
+    }
 #endif
 
     while(!m_bStop && m_dropbase < m_droptime)             m_dropbase += frametime;
@@ -1518,6 +1580,86 @@ void CDVDPlayerVideo::AutoCrop(DVDVideoPicture *pPicture, RECT &crop)
     crop.top = crop.bottom = min;
 }
 
+void CDVDPlayerVideo::UpdateDecodeTime(double decodeTime)
+{
+  UpdateDecodeLevel(decodeTime);
+
+  m_decodeTimeSum += decodeTime;
+  m_decodeCount++;
+
+  // let the codec adapt to the average of a few seconds
+  if (m_decodeCount < 100 || m_fFrameRate <= 0.0)
+    return;
+
+  m_decodeTime = m_decodeTimeSum / m_decodeCount;
+  m_decodeTimeSum = 0.0;
+  m_decodeCount = 0;
+
+  m_pVideoCodec->SetDecodeTime(m_decodeTime, DVD_TIME_BASE / m_fFrameRate);
+  m_decodeThreads = m_pVideoCodec->GetThreadCount(m_decodeFrameThreads);
+}
+
+#define DECODELEVEL_SAMPLES_MIN 16  // decode times needed before judging
+#define DECODELEVEL_BEHIND      8   // packets about to fall behind before skipping more
+#define DECODELEVEL_AHEAD       250 // packets with time to spare before skipping less
+
+void CDVDPlayerVideo::UpdateDecodeLevel(double decodeTime)
+{
+  m_decodeSamples[m_decodeSampleNext] = decodeTime;
+  m_decodeSampleNext = (m_decodeSampleNext + 1) % DECODELEVEL_SAMPLES;
+  if (m_decodeSampleCount < DECODELEVEL_SAMPLES)
+    m_decodeSampleCount++;
+
+  if (m_decodeSampleCount < DECODELEVEL_SAMPLES_MIN || !m_bAllowDrop || m_fFrameRate <= 0.0)
+    return;
+
+  // the average hides the slow frames that make us late, go by the slowest tenth.
+  // until the ring is full the filled samples are the first ones
+  memcpy(m_decodeSorted, m_decodeSamples, m_decodeSampleCount * sizeof(double));
+  double* high = m_decodeSorted + m_decodeSampleCount * 9 / 10;
+  std::nth_element(m_decodeSorted, high, m_decodeSorted + m_decodeSampleCount);
+  m_decodeTimeHigh = *high;
+
+  double frametime = DVD_TIME_BASE / m_fFrameRate;
+
+  // skip more before the slow frames eat up the lead we have on the clock,
+  // waiting for frames to be late means dropping them in bursts
+  bool behind = m_decodeTimeHigh > frametime * 0.9
+             || (m_decodeTimeHigh > frametime * 0.6 && m_outputSlack < frametime * 0.5);
+  // skip less only when even the slow frames leave plenty of time, the
+  // lower level costs more than what is measured now
+  bool ahead  = m_decodeTimeHigh < frametime * 0.4 && m_outputSlack > frametime;
+
+  m_decodeLevelBehind = behind ? m_decodeLevelBehind + 1 : 0;
+  m_decodeLevelAhead  = ahead  ? m_decodeLevelAhead  + 1 : 0;
+
+  if (m_decodeLevelBehind >= DECODELEVEL_BEHIND && m_decodeLevel < CDVDVideoCodec::DECODE_KEYFRAMES)
+    SetDecodeLevel(m_decodeLevel + 1);
+  else if (m_decodeLevelAhead >= DECODELEVEL_AHEAD && m_decodeLevel > CDVDVideoCodec::DECODE_FULL)
+    SetDecodeLevel(m_decodeLevel - 1);
+}
+
+void CDVDPlayerVideo::SetDecodeLevel(int level)
+{
+  m_decodeLevelBehind = 0;
+  m_decodeLevelAhead  = 0;
+
+  // codecs that can't skip parts of decoding stay where they are
+  level = m_pVideoCodec->SetDecodeLevel(level);
+  if (level == m_decodeLevel)
+    return;
+
+  CLog::Log(LOGDEBUG, "CDVDPlayerVideo::SetDecodeLevel - decode level %d -> %d, slow frames take %.1f ms, lead %.1f ms"
+          , m_decodeLevel, level
+          , m_decodeTimeHigh * 1000 / DVD_TIME_BASE
+          , m_outputSlack * 1000 / DVD_TIME_BASE);
+
+  // times measured at the old level say nothing about the new one
+  m_decodeLevel = level;
+  m_decodeSampleCount = 0;
+  m_decodeSampleNext  = 0;
+}
+
 std::string CDVDPlayerVideo::GetPlayerInfo()
 {
   std::ostringstream s;
@@ -1526,6 +1668,20 @@ std::string CDVDPlayerVideo::GetPlayerInfo()
   s << ", dc:"   << m_codecname;
   s << ", Mb/s:" << fixed << setprecision(2) << (double)GetVideoBitrate() / (1024.0*1024.0);
   s << ", drop:" << m_iDroppedFrames;
+  if (m_iDroppedFrames > 0)
+    s << " (dec:"  << m_iDroppedReason[DROP_DECODER]
+      << " lvl:"   << m_iDroppedReason[DROP_LEVEL]
+      << " late:"  << m_iDroppedReason[DROP_LATE]
+      << " ff:"    << m_iDroppedReason[DROP_SPEED]
+      << " oth:"   << m_iDroppedReason[DROP_OTHER] << ")";
+  if (m_decodeLevel != CDVDVideoCodec::DECODE_FULL)
+  {
+    static const char* levels[] = { "full", "noloop", "noref", "key" };
+    s << ", skip:" << levels[m_decodeLevel];
+  }
+  s << ", dt:"   << fixed << setprecision(1) << m_decodeTime * 1000 / DVD_TIME_BASE << "ms";
+  if (m_decodeThreads > 0)
+    s << ", thr:" << m_decodeThreads << (m_decodeFrameThreads ? "f" : "s");
 
   int pc = m_pullupCorrection.GetPatternLength();
   if (pc > 0)
@@ -30,12 +30,57 @@
 #ifdef HAS_VIDEO_PLAYBACK
 #include "cores/VideoRenderers/RenderManager.h"
 #endif
+#include <list>
 
 enum CodecID;
 class CDemuxStreamVideo;
 class CDVDOverlayCodecCC;
 
+// holds a reference to a message the video player keeps back to process later
+struct DVDMessageListItem
+{
+  DVDMessageListItem(CDVDMsg* msg, int prio)
+  {
+    message  = msg->Acquire();
+    priority = prio;
+  }
+  DVDMessageListItem()
+  {
+    message  = NULL;
+    priority = 0;
+  }
+  DVDMessageListItem(const DVDMessageListItem& item)
+  {
+    if(item.message)
+      message = item.message->Acquire();
+    else
+      message = NULL;
+    priority = item.priority;
+  }
+ ~DVDMessageListItem()
+  {
+    if(message)
+      message->Release();
+  }
+
+  DVDMessageListItem& operator=(const DVDMessageListItem& item)
+  {
+    if(message)
+      message->Release();
+    if(item.message)
+      message = item.message->Acquire();
+    else
+      message = NULL;
+    priority = item.priority;
+    return *this;
+  }
+
+  CDVDMsg* message;
+  int      priority;
+};
+
 #define VIDEO_PICTURE_QUEUE_SIZE 1
+#define DECODELEVEL_SAMPLES 64 // decode times the decode level is judged by
 
 class CDVDPlayerVideo : public CThread
 {
@@ -133,6 +178,18 @@ protected:
   int m_iDroppedFrames;
   int m_iDroppedRequest;
 
+  enum EDropReason
+  {
+    DROP_DECODER = 0, // decoder was asked to drop as we were very late
+    DROP_LEVEL,       // decoder skipped the frame at the current decode level
+    DROP_LATE,        // still late after asking the decoder to drop
+    DROP_SPEED,       // more frames than can be shown at this speed
+    DROP_OTHER,       // flagged by the decoder or refused by the renderer
+    DROP_REASONS
+  };
+  int m_iDroppedReason[DROP_REASONS]; // dropped frames by reason
+  int m_iDropReason;                  // why OutputPicture dropped the last picture
+
   void   ResetFrameRateCalc();
   void   CalcFrameRate();
 
@@ -178,6 +235,28 @@ protected:
   bool m_started;
   std::string m_codecname;
 
+  void UpdateDecodeTime(double decodeTime);
+
+  double   m_decodeTimeSum;      // time spent decoding since the codec was last told
+  int      m_decodeCount;        // packets decoded since the codec was last told
+  double   m_decodeTime;         // average time decoding a packet took
+  unsigned m_decodeThreads;      // threads the codec decodes with, 0 if none
+  bool     m_decodeFrameThreads; // if the threads decode frames, not slices
+
+  void UpdateDecodeLevel(double decodeTime);
+  void SetDecodeLevel(int level);
+
+  double   m_decodeSamples[DECODELEVEL_SAMPLES]; // recent decode times, the oldest is overwritten
+  double   m_decodeSorted[DECODELEVEL_SAMPLES];  // scratch copy the percentile is picked from
+  unsigned m_decodeSampleCount;  // how many of the recent decode times are filled in
+  unsigned m_decodeSampleNext;   // where the next decode time goes
+  unsigned m_decodeSkipped;      // frames the codec had skipped on purpose when last asked
+  double   m_decodeTimeHigh;     // 90th percentile of the recent decode times
+  double   m_outputSlack;        // how early the last picture was output for its display time
+  int      m_decodeLevel;        // how much decoding the codec is asked to skip
+  int      m_decodeLevelBehind;  // packets in a row decoding was about to fall behind
+  int      m_decodeLevelAhead;   // packets in a row decoding had time to spare
+
   /* autosync decides on how much of clock we should use when deciding sleep time */
   /* the value is the same as 63% timeconstant, ie that the step response of */
   /* iSleepTime will be at 63% of iClockSleep after autosync frames */
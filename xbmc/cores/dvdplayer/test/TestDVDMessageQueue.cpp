@@ -0,0 +1,131 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "cores/dvdplayer/DVDMessageQueue.h"
+
+#include "gtest/gtest.h"
+
+/* takes the next message, dropping the reference the queue handed over so
+   only the one the test holds is left */
+static CDVDMsg::Message Get(CDVDMessageQueue &queue, int &priority)
+{
+  CDVDMsg* msg;
+  if (queue.Get(&msg, 0, priority) != MSGQ_OK)
+    return CDVDMsg::NONE;
+
+  CDVDMsg::Message type = msg->GetMessageType();
+  msg->Release();
+  return type;
+}
+
+class TestDVDMessageQueue : public testing::Test
+{
+protected:
+  TestDVDMessageQueue()
+    : m_queue("test")
+  {
+    m_queue.Init();
+    m_msgs[0] = new CDVDMsg(CDVDMsg::GENERAL_RESYNC);
+    m_msgs[1] = new CDVDMsg(CDVDMsg::GENERAL_FLUSH);
+    m_msgs[2] = new CDVDMsg(CDVDMsg::GENERAL_RESET);
+    m_msgs[3] = new CDVDMsg(CDVDMsg::GENERAL_EOF);
+  }
+
+  ~TestDVDMessageQueue()
+  {
+    m_queue.End();
+    for (int i = 0; i < 4; i++)
+      m_msgs[i]->Release();
+  }
+
+  void Put(int i, int priority)
+  {
+    EXPECT_EQ(MSGQ_OK, m_queue.Put(m_msgs[i]->Acquire(), priority));
+  }
+
+  CDVDMessageQueue m_queue;
+  CDVDMsg*         m_msgs[4];
+};
+
+TEST_F(TestDVDMessageQueue, PriorityOrder)
+{
+  Put(0, 0);
+  Put(1, 1);
+  Put(2, 0);
+  Put(3, 1);
+
+  /* the highest priority first, in the order they were put */
+  int priority = 0;
+  EXPECT_EQ(CDVDMsg::GENERAL_FLUSH, Get(m_queue, priority));
+  EXPECT_EQ(1, priority);
+  priority = 0;
+  EXPECT_EQ(CDVDMsg::GENERAL_EOF, Get(m_queue, priority));
+  EXPECT_EQ(1, priority);
+
+  /* nothing is left of the asked for priority */
+  priority = 1;
+  EXPECT_EQ(CDVDMsg::NONE, Get(m_queue, priority));
+
+  priority = 0;
+  EXPECT_EQ(CDVDMsg::GENERAL_RESYNC, Get(m_queue, priority));
+  EXPECT_EQ(0, priority);
+  EXPECT_EQ(CDVDMsg::GENERAL_RESET, Get(m_queue, priority));
+  EXPECT_EQ(CDVDMsg::NONE, Get(m_queue, priority));
+
+  for (int i = 0; i < 4; i++)
+    EXPECT_EQ(1, m_msgs[i]->GetNrOfReferences());
+}
+
+TEST_F(TestDVDMessageQueue, ReuseAfterFlush)
+{
+  for (int i = 0; i < 4; i++)
+    Put(i, i % 2);
+
+  /* flushing one type keeps the others in order */
+  m_queue.Flush(CDVDMsg::GENERAL_FLUSH);
+  EXPECT_EQ(1, m_msgs[1]->GetNrOfReferences());
+  EXPECT_EQ(0u, m_queue.GetPacketCount(CDVDMsg::GENERAL_FLUSH));
+  EXPECT_EQ(1u, m_queue.GetPacketCount(CDVDMsg::GENERAL_EOF));
+
+  m_queue.Flush(CDVDMsg::NONE);
+  for (int i = 0; i < 4; i++)
+    EXPECT_EQ(1, m_msgs[i]->GetNrOfReferences());
+
+  /* the nodes of the flushed messages are linked anew, in another order */
+  for (int round = 0; round < 3; round++)
+  {
+    Put(3, 0);
+    Put(2, 2);
+    Put(1, 0);
+    Put(0, 1);
+
+    CDVDMsg::Message expected[] = { CDVDMsg::GENERAL_RESET, CDVDMsg::GENERAL_RESYNC,
+                                    CDVDMsg::GENERAL_EOF, CDVDMsg::GENERAL_FLUSH, CDVDMsg::NONE };
+    for (int i = 0; i < 5; i++)
+    {
+      int priority = 0;
+      EXPECT_EQ(expected[i], Get(m_queue, priority)) << round << " " << i;
+    }
+  }
+
+  for (int i = 0; i < 4; i++)
+    EXPECT_EQ(1, m_msgs[i]->GetNrOfReferences());
+}
@@ -56,7 +56,7 @@ void CAudioDecoder::Destroy()
   m_canPlay = false;
 }
 
-bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
+bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset, unsigned int bufferSeconds)
 {
   Destroy();
 
@@ -92,8 +92,8 @@ bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
     return false;
   }
 
-  /* allocate the pcmBuffer for 2 seconds of audio */
-  m_pcmBuffer.Create(2 * blockSize * m_codec->m_SampleRate);
+  /* allocate the pcmBuffer for at least 2 seconds of audio */
+  m_pcmBuffer.Create(std::max(bufferSeconds, (unsigned int)PREFILL_SECONDS) * blockSize * m_codec->m_SampleRate);
 
   // set total time from the given tag
   if (file.HasMusicInfoTag() && file.GetMusicInfoTag()->GetDuration())
@@ -107,6 +107,44 @@ bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
   return true;
 }
 
+void CAudioDecoder::Adopt(CAudioDecoder &other)
+{
+  Destroy();
+
+  CSingleLock lock(m_critSection);
+  CSingleLock otherLock(other.m_critSection);
+
+  m_codec = other.m_codec;
+  other.m_codec = NULL;
+
+  m_pcmBuffer.Create(other.m_pcmBuffer.getSize());
+  m_pcmBuffer.Copy(other.m_pcmBuffer);
+  other.m_pcmBuffer.Destroy();
+
+  m_eof     = other.m_eof;
+  m_status  = other.m_status;
+  m_canPlay = false;
+
+  other.m_eof     = false;
+  other.m_status  = STATUS_NO_FILE;
+  other.m_canPlay = false;
+
+  /* the buffer of a decoder prepared in the background is larger, there's
+     no point in filling all of it before playing */
+  if (m_status == STATUS_QUEUING && IsPrefilled())
+    m_status = STATUS_QUEUED;
+}
+
+bool CAudioDecoder::IsPrefilled()
+{
+  CSingleLock lock(m_critSection);
+  if (m_status != STATUS_QUEUING)
+    return m_status != STATUS_NO_FILE;
+
+  unsigned int blockSize = (m_codec->m_BitsPerSample >> 3) * m_codec->GetChannelInfo().Count();
+  return m_pcmBuffer.getMaxReadSize() > PREFILL_SECONDS * blockSize * m_codec->m_SampleRate * 0.9;
+}
+
 void CAudioDecoder::GetDataFormat(CAEChannelInfo *channelInfo, unsigned int *samplerate, unsigned int *encodedSampleRate, enum AEDataFormat *dataFormat)
 {
   if (!m_codec)
@@ -45,6 +45,9 @@ class CFileItem;
 #define STATUS_ENDING   4
 #define STATUS_ENDED    5
 
+// seconds decoded before a decoder created to play right away is queued
+#define PREFILL_SECONDS 2
+
 // return codes from decoders
 #define RET_ERROR -1
 #define RET_SUCCESS 0
@@ -56,9 +59,15 @@ public:
   CAudioDecoder();
   ~CAudioDecoder();
 
-  bool Create(const CFileItem &file, int64_t seekOffset);
+  bool Create(const CFileItem &file, int64_t seekOffset, unsigned int bufferSeconds = PREFILL_SECONDS);
   void Destroy();
 
+  // takes over the codec and the decoded data of another decoder, which is left empty
+  void Adopt(CAudioDecoder &other);
+
+  // if it has decoded as much as a decoder created to play right away waits for
+  bool IsPrefilled();
+
   int ReadSamples(int numsamples);
 
   bool CanSeek() { if (m_codec) return m_codec->CanSeek(); else return false; };
@@ -0,0 +1,263 @@
+/*
+ *      Copyright (C) 2010-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "AudioDecoderCache.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+using namespace std;
+
+CAudioDecoderCache::CAudioDecoderCache() :
+  CThread    ("CAudioDecoderCache"),
+  m_seconds  (g_advancedSettings.m_musicPreDecodeSeconds),
+  m_maxRecent(g_advancedSettings.m_musicDecodedHistory)
+{
+}
+
+CAudioDecoderCache::~CAudioDecoderCache()
+{
+  StopThread();
+  Clear();
+}
+
+void CAudioDecoderCache::SetUpcoming(const vector<CFileItem> &items)
+{
+  CSingleLock lock(m_critSection);
+
+  /* forget about the items which are not coming up anymore */
+  for (EntryList::iterator it = m_entries.begin(); it != m_entries.end();)
+  {
+    bool keep = !(*it)->upcoming;
+    for (vector<CFileItem>::const_iterator item = items.begin(); !keep && item != items.end(); ++item)
+      keep = IsSameItem((*it)->item, *item);
+
+    if (keep)
+      ++it;
+    else
+      Drop(it++);
+  }
+
+  for (vector<CFileItem>::const_iterator item = items.begin(); item != items.end(); ++item)
+    Add(*item, true);
+}
+
+void CAudioDecoderCache::AddRecent(const CFileItem &item)
+{
+  if (m_maxRecent == 0)
+    return;
+
+  CSingleLock lock(m_critSection);
+  Add(item, false);
+
+  /* drop the least recently played items */
+  unsigned int recent = 0;
+  for (EntryList::iterator it = m_entries.begin(); it != m_entries.end();)
+  {
+    if (!(*it)->upcoming && ++recent > m_maxRecent)
+      Drop(it++);
+    else
+      ++it;
+  }
+}
+
+bool CAudioDecoderCache::Take(const CFileItem &item, CAudioDecoder &decoder)
+{
+  CSingleLock lock(m_critSection);
+  while (true)
+  {
+    EntryList::iterator it = Find(item);
+    if (it == m_entries.end())
+      return false;
+
+    Entry *entry = *it;
+    if (!entry->busy)
+    {
+      /* if it wasn't opened or filled far enough yet the caller is faster
+         doing it itself, a cold decoder only has to fill 2 seconds */
+      bool taken = entry->opened && entry->decoder.IsPrefilled();
+      if (taken)
+        decoder.Adopt(entry->decoder);
+
+      Drop(it);
+      return taken;
+    }
+
+    /* the decoder is being opened or filled, which won't take longer
+       than opening it again */
+    m_done.Reset();
+    lock.Leave();
+    m_done.WaitMSec(100);
+    lock.Enter();
+  }
+}
+
+void CAudioDecoderCache::Clear()
+{
+  CSingleLock lock(m_critSection);
+  while (!m_entries.empty())
+    Drop(m_entries.begin());
+}
+
+bool CAudioDecoderCache::IsSameItem(const CFileItem &left, const CFileItem &right)
+{
+  /* the tracks of a cue sheet share the file */
+  return left.GetPath() == right.GetPath() &&
+         left.m_lStartOffset == right.m_lStartOffset;
+}
+
+CAudioDecoderCache::EntryList::iterator CAudioDecoderCache::Find(const CFileItem &item)
+{
+  for (EntryList::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+  {
+    if (!(*it)->dropped && IsSameItem((*it)->item, item))
+      return it;
+  }
+
+  return m_entries.end();
+}
+
+void CAudioDecoderCache::Drop(EntryList::iterator it)
+{
+  Entry *entry = *it;
+  m_entries.erase(it);
+
+  /* the cache thread deletes it once it's done with it */
+  if (entry->busy)
+    entry->dropped = true;
+  else
+    delete entry;
+}
+
+void CAudioDecoderCache::Add(const CFileItem &item, bool upcoming)
+{
+  Entry *entry;
+  EntryList::iterator it = Find(item);
+  if (it != m_entries.end())
+  {
+    entry = *it;
+    m_entries.erase(it);
+  }
+  else
+  {
+    entry = new Entry();
+    entry->item     = item;
+    entry->opened   = false;
+    entry->busy     = false;
+    entry->dropped  = false;
+  }
+  entry->upcoming = upcoming;
+
+  /* upcoming items go to the end of their part of the list and recent
+     ones to the front of theirs, which is the same place */
+  for (it = m_entries.begin(); it != m_entries.end() && (*it)->upcoming; ++it) {}
+  m_entries.insert(it, entry);
+
+  if (!IsRunning())
+    Create();
+
+  m_work.Set();
+}
+
+CAudioDecoderCache::Entry *CAudioDecoderCache::NextToOpen()
+{
+  for (EntryList::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+  {
+    if (!(*it)->opened)
+      return *it;
+  }
+
+  return NULL;
+}
+
+CAudioDecoderCache::Entry *CAudioDecoderCache::NextToDecode()
+{
+  for (EntryList::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+  {
+    /* the decoder is queued once its buffer is (almost) full */
+    if ((*it)->decoder.GetStatus() == STATUS_QUEUING)
+      return *it;
+  }
+
+  return NULL;
+}
+
+void CAudioDecoderCache::Process()
+{
+  SetPriority(GetMinPriority());
+
+  while (!m_bStop)
+  {
+    CSingleLock lock(m_critSection);
+
+    /* opening the upcoming items comes first, so does opening before decoding */
+    Entry *entry = NextToOpen();
+    bool   open  = entry != NULL;
+    if (!entry)
+      entry = NextToDecode();
+
+    if (!entry)
+    {
+      lock.Leave();
+      AbortableWait(m_work);
+      continue;
+    }
+
+    entry->busy = true;
+    lock.Leave();
+
+    bool ok;
+    if (open)
+    {
+      const CFileItem &item = entry->item;
+      ok = entry->decoder.Create(item, (item.m_lStartOffset * 1000) / 75, m_seconds);
+      if (ok)
+        CLog::Log(LOGDEBUG, "CAudioDecoderCache::Process - Opened %s", item.GetPath().c_str());
+    }
+    else
+    {
+      int result = entry->decoder.ReadSamples(PACKET_SIZE);
+      ok = result != RET_ERROR;
+
+      /* the codec had nothing for us, don't spin on it */
+      if (result == RET_SLEEP)
+        Sleep(10);
+    }
+
+    lock.Enter();
+    entry->busy   = false;
+    entry->opened = true;
+    if (entry->dropped)
+      delete entry;
+    else if (!ok)
+    {
+      CLog::Log(LOGWARNING, "CAudioDecoderCache::Process - Failed to prepare %s", entry->item.GetPath().c_str());
+      for (EntryList::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+      {
+        if (*it == entry)
+        {
+          Drop(it);
+          break;
+        }
+      }
+    }
+    m_done.Set();
+  }
+}
@@ -0,0 +1,96 @@
+#pragma once
+/*
+ *      Copyright (C) 2010-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <list>
+#include <vector>
+
+#include "AudioDecoder.h"
+#include "FileItem.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+
+/*!
+ \brief Keeps audio decoders opened and primed with decoded data in the background
+
+ Opening a codec on a network share can take a while, so PAPlayer hands
+ the upcoming playlist items to the cache which opens them and decodes
+ their first seconds on a thread of its own. The items that were played
+ recently are kept the same way so skipping back starts right away.
+ */
+class CAudioDecoderCache : public CThread
+{
+public:
+  CAudioDecoderCache();
+  virtual ~CAudioDecoderCache();
+
+  /*!
+   \brief Replaces the items that are about to be played
+   */
+  void SetUpcoming(const std::vector<CFileItem> &items);
+
+  /*!
+   \brief Remembers an item that has just been played
+   */
+  void AddRecent(const CFileItem &item);
+
+  /*!
+   \brief Hands the prepared decoder for an item over
+   \return False if the item hasn't been prepared far enough to start playing
+           sooner than opening it again, decoder is left untouched then
+   */
+  bool Take(const CFileItem &item, CAudioDecoder &decoder);
+
+  /*!
+   \brief Closes all prepared decoders
+   */
+  void Clear();
+
+protected:
+  virtual void Process();
+
+private:
+  typedef struct
+  {
+    CFileItem     item;
+    CAudioDecoder decoder;
+    bool          upcoming; /* if it is about to be played, otherwise it has been played recently */
+    bool          opened;   /* if the decoder has been created */
+    bool          busy;     /* if the cache thread is working on the decoder */
+    bool          dropped;  /* if the cache thread has to delete it once it is done */
+  } Entry;
+
+  typedef std::list<Entry*> EntryList;
+
+  static bool IsSameItem(const CFileItem &left, const CFileItem &right);
+  EntryList::iterator Find(const CFileItem &item);
+  void Drop(EntryList::iterator it);
+  void Add(const CFileItem &item, bool upcoming);
+  Entry *NextToOpen();
+  Entry *NextToDecode();
+
+  CCriticalSection m_critSection;
+  CEvent           m_work;       /* set when there is something to do */
+  CEvent           m_done;       /* set when the cache thread finished with a decoder */
+  EntryList        m_entries;    /* the upcoming items first, then the recent ones, most recent first */
+  unsigned int     m_seconds;
+  unsigned int     m_maxRecent;
+};
@@ -21,11 +21,14 @@
 #include "PAPlayer.h"
 #include "CodecFactory.h"
 #include "FileItem.h"
+#include "PlayListPlayer.h"
+#include "playlists/PlayList.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/GUISettings.h"
 #include "settings/Settings.h"
 #include "music/tags/MusicInfoTag.h"
 #include "utils/TimeUtils.h"
+#include "utils/URIUtils.h"
 #include "utils/log.h"
 #include "utils/MathUtils.h"
 
@@ -240,6 +243,9 @@ bool PAPlayer::OpenFile(const CFileItem& file, const CPlayerOptions &options)
   if (!QueueNextFileEx(file, false))
     return false;
 
+  /* the file is the current playlist item */
+  PreDecodeUpcoming(1);
+
   CSharedLock lock(m_streamsLock);
   if (m_streams.size() == 2)
   {
@@ -286,14 +292,48 @@ void PAPlayer::UpdateCrossfadeTime(const CFileItem& file)
 
 bool PAPlayer::QueueNextFile(const CFileItem &file)
 {
-  return QueueNextFileEx(file);
+  if (!QueueNextFileEx(file))
+    return false;
+
+  /* the file is the playlist item after the current one */
+  PreDecodeUpcoming(2);
+  return true;
+}
+
+void PAPlayer::PreDecodeUpcoming(int offset)
+{
+  std::vector<CFileItem> items;
+
+  int playlistId = g_playlistPlayer.GetCurrentPlaylist();
+  if (playlistId != PLAYLIST_NONE)
+  {
+    const PLAYLIST::CPlayList &playlist = g_playlistPlayer.GetPlaylist(playlistId);
+    for (int i = 0; i < g_advancedSettings.m_musicPreDecodeTracks; i++)
+    {
+      int next = g_playlistPlayer.GetNextSong(offset + i);
+      if (next < 0 || next >= playlist.size())
+        break;
+
+      /* only items that can be opened as they are, and aren't endless */
+      const CFileItem &item = *playlist[next];
+      if (!item.IsAudio() || item.IsPlugin() || item.IsInternetStream() || URIUtils::IsUPnP(item.GetPath()))
+        continue;
+
+      items.push_back(item);
+    }
+  }
+
+  m_decoderCache.SetUpcoming(items);
 }
 
 bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */)
 {
   StreamInfo *si = new StreamInfo();
 
-  if (!si->m_decoder.Create(file, (file.m_lStartOffset * 1000) / 75))
+  /* a decoder which has been prepared in the background is ready right away */
+  if (m_decoderCache.Take(file, si->m_decoder))
+    CLog::Log(LOGDEBUG, "PAPlayer::QueueNextFileEx - Using the prepared decoder for %s", file.GetPath().c_str());
+  else if (!si->m_decoder.Create(file, (file.m_lStartOffset * 1000) / 75))
   {
     CLog::Log(LOGWARNING, "PAPlayer::QueueNextFileEx - Failed to create the decoder");
 
@@ -326,6 +366,7 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */)
   UpdateCrossfadeTime(file);
 
   /* init the streaminfo struct */
+  si->m_item               = file;
   si->m_decoder.GetDataFormat(&si->m_channelInfo, &si->m_sampleRate, &si->m_encodedSampleRate, &si->m_dataFormat);
   si->m_startOffset        = file.m_lStartOffset * 1000 / 75;
   si->m_endOffset          = file.m_lEndOffset   * 1000 / 75;
@@ -557,6 +598,10 @@ inline void PAPlayer::ProcessStreams(double &delay, double &buffer)
       si->m_stream->UnRegisterAudioCallback();
       si->m_decoder.Destroy();      
       si->m_stream->Drain();
+
+      /* keep the item prepared in case we come back to it, now that
+         its own decoder is gone the cache doesn't decode it twice */
+      m_decoderCache.AddRecent(si->m_item);
       m_finishing.push_back(si);
       return;
     }
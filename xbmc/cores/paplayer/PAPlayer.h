@@ -25,6 +25,7 @@
 #include "cores/IPlayer.h"
 #include "threads/Thread.h"
 #include "AudioDecoder.h"
+#include "AudioDecoderCache.h"
 #include "threads/SharedSection.h"
 
 #include "cores/IAudioCallback.h"
@@ -94,6 +95,7 @@ protected:
 
 private:
   typedef struct {
+    CFileItem         m_item;                /* the item being played */
     CAudioDecoder     m_decoder;             /* the stream decoder */
     int64_t           m_startOffset;         /* the stream start offset */
     int64_t           m_endOffset;           /* the stream end offset */
@@ -139,8 +141,10 @@ private:
   CSharedSection      m_streamsLock;         /* lock for the stream list */
   StreamList          m_streams;             /* playing streams */  
   StreamList          m_finishing;           /* finishing streams */
+  CAudioDecoderCache  m_decoderCache;        /* decoders of the upcoming and recently played items */
 
   bool QueueNextFileEx(const CFileItem &file, bool fadeIn = true);
+  void PreDecodeUpcoming(int offset);
   void SoftStart(bool wait = false);
   void SoftStop(bool wait = false, bool close = true);
   void CloseAllStreams(bool fade = true);
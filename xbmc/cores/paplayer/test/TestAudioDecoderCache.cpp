@@ -0,0 +1,142 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/paplayer/AudioDecoderCache.h"
+#include "filesystem/File.h"
+#include "FileItem.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+
+#define WAV_SECONDS 30
+#define WAV_RATE    44100
+
+/* Writes a plain 16 bit stereo PCM wav file which is long enough for
+ * the cache to be caught in the middle of filling its buffer.
+ */
+class TestAudioDecoderCache : public testing::Test
+{
+protected:
+  TestAudioDecoderCache()
+    : m_item("special://temp/audiodecodercache.wav", false)
+  {
+    unsigned int size = WAV_SECONDS * WAV_RATE * 4;
+    std::string data("RIFF", 4);
+    AddInt(data, 36 + size, 4);
+    data.append("WAVEfmt ", 8);
+    AddInt(data, 16, 4);
+    AddInt(data, 1, 2);            // PCM
+    AddInt(data, 2, 2);            // channels
+    AddInt(data, WAV_RATE, 4);
+    AddInt(data, WAV_RATE * 4, 4); // bytes per second
+    AddInt(data, 4, 2);            // bytes per frame
+    AddInt(data, 16, 2);           // bits per sample
+    data.append("data", 4);
+    AddInt(data, size, 4);
+    for (unsigned int i = 0; i < size / 2; i++)
+      AddInt(data, (i * 97) & 0x3fff, 2);
+
+    XFILE::CFile file;
+    if (file.OpenForWrite(m_item.GetPath(), true))
+    {
+      file.Write(data.c_str(), data.size());
+      file.Close();
+    }
+  }
+
+  ~TestAudioDecoderCache()
+  {
+    XFILE::CFile::Delete(m_item.GetPath());
+  }
+
+  static void AddInt(std::string &data, unsigned int value, unsigned int bytes)
+  {
+    for (unsigned int i = 0; i < bytes; i++)
+      data += (char)((value >> (i * 8)) & 0xff);
+  }
+
+  /* decodes until the 2 seconds a cold decoder waits for are there,
+     while a buffer prepared in the background holds 10 */
+  static bool Prefill(CAudioDecoder &decoder)
+  {
+    for (int i = 0; i < 1000 && !decoder.IsPrefilled(); i++)
+    {
+      if (decoder.ReadSamples(PACKET_SIZE) == RET_ERROR)
+        return false;
+    }
+    return decoder.IsPrefilled();
+  }
+
+  CFileItem m_item;
+};
+
+TEST_F(TestAudioDecoderCache, AdoptPartlyFilled)
+{
+  CAudioDecoder prepared;
+  ASSERT_TRUE(prepared.Create(m_item, 0, 10));
+  ASSERT_TRUE(Prefill(prepared));
+  EXPECT_EQ(STATUS_QUEUING, prepared.GetStatus());
+
+  /* it plays as soon as a cold decoder would, not once all 10 seconds are there */
+  CAudioDecoder decoder;
+  decoder.Adopt(prepared);
+  EXPECT_EQ(STATUS_QUEUED, decoder.GetStatus());
+  EXPECT_GT(decoder.GetDataSize(), 0u);
+  EXPECT_EQ(STATUS_NO_FILE, prepared.GetStatus());
+}
+
+TEST_F(TestAudioDecoderCache, AdoptBarelyFilled)
+{
+  CAudioDecoder prepared;
+  ASSERT_TRUE(prepared.Create(m_item, 0, 10));
+  ASSERT_NE(RET_ERROR, prepared.ReadSamples(PACKET_SIZE));
+  EXPECT_FALSE(prepared.IsPrefilled());
+
+  CAudioDecoder decoder;
+  decoder.Adopt(prepared);
+  EXPECT_EQ(STATUS_QUEUING, decoder.GetStatus());
+  EXPECT_EQ(0u, decoder.GetDataSize());
+}
+
+TEST_F(TestAudioDecoderCache, TakePartlyFilled)
+{
+  CAudioDecoderCache cache;
+  std::vector<CFileItem> items(1, m_item);
+
+  /* the cache thread fills 10 seconds, whatever it hands over while it is
+     at it has to be ready to play right away */
+  CAudioDecoder decoder;
+  bool taken = false;
+  for (unsigned int wait = 10; !taken && wait < 2000; wait *= 2)
+  {
+    cache.SetUpcoming(items);
+    XbmcThreads::ThreadSleep(wait);
+    taken = cache.Take(m_item, decoder);
+  }
+
+  ASSERT_TRUE(taken);
+  EXPECT_NE(STATUS_QUEUING, decoder.GetStatus());
+  EXPECT_GT(decoder.GetDataSize(), 0u);
+
+  /* it's not prepared anymore once it has been taken */
+  CAudioDecoder again;
+  EXPECT_FALSE(cache.Take(m_item, again));
+}
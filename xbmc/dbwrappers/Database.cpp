@@ -308,6 +308,69 @@ bool CDatabase::CommitInsertQueries()
   return bReturn;
 }
 
+bool CDatabase::BeginBulkInsert(const CStdString &strStatement)
+{
+  if (strStatement.IsEmpty())
+    return false;
+
+  if (strStatement == m_bulkStatement)
+    return true;
+
+  EndBulkInsert();
+
+  if (NULL == m_pDB.get()) return false;
+  if (NULL == m_pDS2.get()) return false;
+
+  try
+  {
+    m_pDS2->prepare_statement(strStatement);
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - failed to prepare query: %s", __FUNCTION__, strStatement.c_str());
+    return false;
+  }
+
+  m_bulkStatement = strStatement;
+  return true;
+}
+
+bool CDatabase::BulkInsertRow(const std::vector<field_value> &values)
+{
+  if (m_bulkStatement.IsEmpty())
+    return false;
+
+  try
+  {
+    for (unsigned int i = 0; i < values.size(); i++)
+      m_pDS2->bind(i + 1, values[i]);
+    m_pDS2->exec_statement();
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - failed to execute query: %s", __FUNCTION__, m_bulkStatement.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+void CDatabase::EndBulkInsert()
+{
+  if (m_bulkStatement.IsEmpty())
+    return;
+
+  try
+  {
+    m_pDS2->finalize_statement();
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - failed to release query: %s", __FUNCTION__, m_bulkStatement.c_str());
+  }
+  m_bulkStatement.clear();
+}
+
 bool CDatabase::Open()
 {
   DatabaseSettings db_fallback;
@@ -577,6 +640,7 @@ void CDatabase::Close()
   m_openCount = 0;
 
   if (NULL == m_pDB.get() ) return ;
+  EndBulkInsert();
   if (NULL != m_pDS.get()) m_pDS->close();
   m_pDB->disconnect();
   m_pDB.reset();
@@ -668,7 +732,7 @@ void CDatabase::RollbackTransaction()
 
 bool CDatabase::InTransaction()
 {
-  if (NULL != m_pDB.get()) return false;
+  if (NULL == m_pDB.get()) return false;
   return m_pDB->in_transaction();
 }
 
@@ -25,9 +25,11 @@
 namespace dbiplus {
   class Database;
   class Dataset;
+  class field_value;
 }
 
 #include <memory>
+#include <vector>
 
 class DatabaseSettings; // forward
 class CDbUrl;
@@ -136,6 +138,29 @@ public:
    */
   bool CommitInsertQueries();
 
+  /*!
+   * @brief Prepare an INSERT or REPLACE statement for writing many rows.
+   * The statement is compiled once and every row added with BulkInsertRow() is written
+   * through it. It stays prepared until another statement is begun, EndBulkInsert() is
+   * called or the database is closed, so calling this again with the same statement is cheap.
+   * The rows are written right away, wrap them in a transaction to write them in one go.
+   * @param strStatement The query to prepare, with a '?' placeholder for each value.
+   * @return True if the statement was prepared successfully, false otherwise.
+   */
+  bool BeginBulkInsert(const CStdString &strStatement);
+
+  /*!
+   * @brief Write a row with the statement prepared by BeginBulkInsert().
+   * @param values The values for the placeholders, in order. Use a NULL field_value for NULL.
+   * @return True if the row was written successfully, false otherwise.
+   */
+  bool BulkInsertRow(const std::vector<dbiplus::field_value> &values);
+
+  /*!
+   * @brief Release the statement prepared by BeginBulkInsert().
+   */
+  void EndBulkInsert();
+
   virtual bool GetFilter(CDbUrl &dbUrl, Filter &filter, SortDescription &sorting) { return true; }
   virtual bool BuildSQL(const CStdString &strBaseDir, const CStdString &strQuery, Filter &filter, CStdString &strSQL, CDbUrl &dbUrl);
   virtual bool BuildSQL(const CStdString &strBaseDir, const CStdString &strQuery, Filter &filter, CStdString &strSQL, CDbUrl &dbUrl, SortDescription &sorting);
@@ -172,5 +197,6 @@ private:
   bool UpdateVersionNumber();
 
   bool m_bMultiWrite; /*!< True if there are any queries in the queue, false otherwise */
+  CStdString m_bulkStatement; /*!< The statement prepared by BeginBulkInsert(), empty if none */
   unsigned int m_openCount;
 };
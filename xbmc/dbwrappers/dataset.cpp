@@ -299,6 +299,77 @@ void Dataset::deletion() {
 }
 
 
+/* Generic prepared statements. Drivers without native support get the
+   placeholders replaced by escaped literals and the statement executed
+   through exec(), so callers can use the same code for every backend. */
+void Dataset::prepare_statement(const string &sql) {
+  if (sql.empty()) throw DbErrors("Empty statement!");
+  stmt_sql = sql;
+  stmt_params.clear();
+}
+
+
+void Dataset::bind(int index, const field_value &value) {
+  if (stmt_sql.empty()) throw DbErrors("No statement prepared!");
+  if (index < 1) throw DbErrors("Invalid parameter index %i", index);
+  if ((int)stmt_params.size() < index)
+    stmt_params.resize(index);
+  stmt_params[index-1] = value;
+}
+
+
+int Dataset::exec_statement() {
+  if (stmt_sql.empty()) throw DbErrors("No statement prepared!");
+  if (db == NULL) throw DbErrors("No Database Connection");
+
+  string qry;
+  qry.reserve(stmt_sql.size() * 2);
+  unsigned int param = 0;
+  bool quoted = false;
+  for (string::const_iterator i = stmt_sql.begin(); i != stmt_sql.end(); i++) {
+    if (*i == '\'')
+      quoted = !quoted;
+    if (*i != '?' || quoted) {
+      qry += *i;
+      continue;
+    }
+
+    if (param >= stmt_params.size() || stmt_params[param].get_isNull())
+      qry += "NULL";
+    else {
+      const field_value &fv = stmt_params[param];
+      switch (fv.get_fType()) {
+      case ft_Boolean:
+        qry += fv.get_asBool() ? "1" : "0";
+        break;
+      case ft_Short:
+      case ft_UShort:
+      case ft_Int:
+      case ft_UInt:
+      case ft_Float:
+      case ft_Double:
+      case ft_Int64:
+        qry += fv.get_asString();
+        break;
+      default:
+        qry += db->prepare("'%s'", fv.get_asString().c_str());
+        break;
+      }
+    }
+    param++;
+  }
+  stmt_params.clear();
+
+  return exec(qry);
+}
+
+
+void Dataset::finalize_statement() {
+  stmt_sql.clear();
+  stmt_params.clear();
+}
+
+
 bool Dataset::set_field_value(const char *f_name, const field_value &value) {
   bool found = false;
   if ((ds_state == dsInsert) || (ds_state == dsEdit)) {
@@ -196,6 +196,9 @@ protected:
   int frecno; 			// number of current row bei bewegung
   std::string sql;
 
+  std::string stmt_sql;         // prepared statement
+  sql_record stmt_params;       // values bound to the prepared statement
+
   ParamList plist;              // Paramlist for locate
   bool fbof, feof;
   bool autocommit;		// for transactions
@@ -296,6 +299,16 @@ public:
   virtual const void* getExecRes()=0;
 /* as open, but with our query exept Sql */
   virtual bool query(const char *sql) = 0;
+/* prepares a statement with '?' placeholders that can be executed many times */
+  virtual void prepare_statement(const std::string &sql);
+/* binds a value to a placeholder of the prepared statement (starting with 1) */
+  virtual void bind(int index, const field_value &value);
+/* executes the prepared statement with the bound values, the bindings are cleared afterwards */
+  virtual int  exec_statement();
+/* releases the prepared statement */
+  virtual void finalize_statement();
+/* true if a statement is prepared */
+  virtual bool has_statement() const { return !stmt_sql.empty(); }
 /* Close SQL Query*/
   virtual void close();
 /* This function looks for field Field_name with value equal Field_value
@@ -410,6 +410,7 @@ string SqliteDatabase::vprepare(const char *format, va_list args)
 SqliteDataset::SqliteDataset():Dataset() {
   haveError = false;
   db = NULL;
+  prepared_stmt = NULL;
   errmsg = NULL;
   autorefresh = false;
 }
@@ -418,11 +419,13 @@ SqliteDataset::SqliteDataset():Dataset() {
 SqliteDataset::SqliteDataset(SqliteDatabase *newDb):Dataset(newDb) {
   haveError = false;
   db = newDb;
+  prepared_stmt = NULL;
   errmsg = NULL;
   autorefresh = false;
 }
 
  SqliteDataset::~SqliteDataset(){
+   if (prepared_stmt) sqlite3_finalize(prepared_stmt);
    if (errmsg) sqlite3_free(errmsg);
  }
 
@@ -597,6 +600,82 @@ const void* SqliteDataset::getExecRes() {
 }
 
 
+void SqliteDataset::prepare_statement(const string &sql) {
+  if (!handle()) throw DbErrors("No Database Connection");
+  finalize_statement();
+
+  if (db->setErr(sqlite3_prepare_v2(handle(),sql.c_str(),-1,&prepared_stmt,NULL),sql.c_str()) != SQLITE_OK)
+  {
+    prepared_stmt = NULL;
+    throw DbErrors(db->getErrorMsg());
+  }
+  stmt_sql = sql;
+}
+
+
+void SqliteDataset::bind(int index, const field_value &value) {
+  if (!prepared_stmt) throw DbErrors("No statement prepared!");
+
+  int res;
+  if (value.get_isNull())
+    res = sqlite3_bind_null(prepared_stmt, index);
+  else
+  {
+    switch (value.get_fType()) {
+    case ft_Boolean:
+    case ft_Short:
+    case ft_UShort:
+    case ft_Int:
+      res = sqlite3_bind_int(prepared_stmt, index, value.get_asInt());
+      break;
+    case ft_UInt:
+      res = sqlite3_bind_int64(prepared_stmt, index, value.get_asUInt());
+      break;
+    case ft_Int64:
+      res = sqlite3_bind_int64(prepared_stmt, index, value.get_asInt64());
+      break;
+    case ft_Float:
+    case ft_Double:
+      res = sqlite3_bind_double(prepared_stmt, index, value.get_asDouble());
+      break;
+    default:
+    {
+      const string str = value.get_asString();
+      res = sqlite3_bind_text(prepared_stmt, index, str.c_str(), str.size(), SQLITE_TRANSIENT);
+      break;
+    }
+    }
+  }
+
+  if (db->setErr(res, stmt_sql.c_str()) != SQLITE_OK)
+    throw DbErrors(db->getErrorMsg());
+}
+
+
+int SqliteDataset::exec_statement() {
+  if (!prepared_stmt) throw DbErrors("No statement prepared!");
+
+  int res = sqlite3_step(prepared_stmt);
+  sqlite3_reset(prepared_stmt);
+  sqlite3_clear_bindings(prepared_stmt);
+
+  if (res != SQLITE_DONE && res != SQLITE_ROW)
+  {
+    db->setErr(res, stmt_sql.c_str());
+    throw DbErrors(db->getErrorMsg());
+  }
+  return SQLITE_OK;
+}
+
+
+void SqliteDataset::finalize_statement() {
+  if (prepared_stmt)
+    sqlite3_finalize(prepared_stmt);
+  prepared_stmt = NULL;
+  Dataset::finalize_statement();
+}
+
+
 bool SqliteDataset::query(const char *query) {
     if(!handle()) throw DbErrors("No Database Connection");
     std::string qry = query;
@@ -107,6 +107,7 @@ public:
 class SqliteDataset : public Dataset {
 protected:
   sqlite3* handle();
+  sqlite3_stmt *prepared_stmt;  // compiled statement of prepare_statement()
 
 /* Makes direct queries to database */
   virtual void make_query(StringList &_sql);
@@ -147,6 +148,11 @@ or insert() operations default = false) */
 /* as open, but with our query exept Sql */
   virtual bool query(const char *query);
   virtual bool query(const std::string &query);
+/* prepared statements are compiled once and reused for every exec_statement() */
+  virtual void prepare_statement(const std::string &sql);
+  virtual void bind(int index, const field_value &value);
+  virtual int  exec_statement();
+  virtual void finalize_statement();
 /* func. closes a query */
   virtual void close(void);
 /* Cancel changes, made in insert or edit states of dataset */
@@ -0,0 +1,135 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "dbwrappers/sqlitedataset.h"
+#include "filesystem/SpecialProtocol.h"
+
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <stdio.h>
+
+using namespace dbiplus;
+
+class TestDataset : public testing::Test
+{
+protected:
+  TestDataset()
+  {
+    m_path = CSpecialProtocol::TranslatePath("special://temp/");
+    remove((m_path + "TestDataset.db").c_str());
+
+    m_db.setHostName(m_path.c_str());
+    m_db.setDatabase("TestDataset.db");
+    m_db.connect(true);
+    m_ds.reset(m_db.CreateDataset());
+    m_ds->exec("CREATE TABLE test (id INTEGER PRIMARY KEY, name TEXT, value REAL, count INTEGER)");
+  }
+  ~TestDataset()
+  {
+    m_ds.reset();
+    m_db.disconnect();
+    remove((m_path + "TestDataset.db").c_str());
+  }
+
+  int Rows(const char *where = "1")
+  {
+    std::string sql = std::string("SELECT * FROM test WHERE ") + where;
+    m_ds->query(sql.c_str());
+    int rows = m_ds->num_rows();
+    m_ds->close();
+    return rows;
+  }
+
+  std::string m_path;
+  SqliteDatabase m_db;
+  std::auto_ptr<Dataset> m_ds;
+};
+
+TEST_F(TestDataset, PreparedStatement)
+{
+  m_ds->prepare_statement("INSERT INTO test (name, value, count) VALUES (?, ?, ?)");
+  EXPECT_TRUE(m_ds->has_statement());
+
+  field_value null;
+  null.set_isNull();
+  for (int i = 0; i < 100; i++)
+  {
+    m_ds->bind(1, field_value("it's a '?'"));
+    m_ds->bind(2, field_value(i * 0.5));
+    if (i % 2)
+      m_ds->bind(3, null);
+    else
+      m_ds->bind(3, field_value((int64_t)i << 32));
+    m_ds->exec_statement();
+  }
+  m_ds->finalize_statement();
+  EXPECT_FALSE(m_ds->has_statement());
+
+  EXPECT_EQ(100, Rows());
+  EXPECT_EQ(50, Rows("count IS NULL"));
+
+  m_ds->query("SELECT * FROM test WHERE id = 3");
+  ASSERT_EQ(1, m_ds->num_rows());
+  EXPECT_STREQ("it's a '?'", m_ds->fv("name").get_asString().c_str());
+  EXPECT_EQ(1.0, m_ds->fv("value").get_asDouble());
+  EXPECT_EQ((int64_t)2 << 32, m_ds->fv("count").get_asInt64());
+  m_ds->close();
+}
+
+TEST_F(TestDataset, PreparedStatementTransactions)
+{
+  /* the statement outlives the transactions it is used in */
+  m_ds->prepare_statement("INSERT INTO test (name) VALUES (?)");
+
+  m_db.start_transaction();
+  m_ds->bind(1, field_value("rolled back"));
+  m_ds->exec_statement();
+  m_db.rollback_transaction();
+
+  m_db.start_transaction();
+  m_ds->bind(1, field_value("committed"));
+  m_ds->exec_statement();
+  m_db.commit_transaction();
+
+  m_ds->bind(1, field_value("no transaction"));
+  m_ds->exec_statement();
+  m_ds->finalize_statement();
+
+  EXPECT_EQ(2, Rows());
+  EXPECT_EQ(0, Rows("name = 'rolled back'"));
+}
+
+TEST_F(TestDataset, GenericPreparedStatement)
+{
+  /* the drivers without prepared statements of their own substitute the values */
+  m_ds->Dataset::prepare_statement("INSERT INTO test (name, value, count) VALUES (?, ?, ?)");
+  m_ds->Dataset::bind(1, field_value("it's a '?'"));
+  m_ds->Dataset::bind(2, field_value(1.5));
+  m_ds->Dataset::exec_statement();
+  m_ds->Dataset::finalize_statement();
+
+  m_ds->query("SELECT * FROM test");
+  ASSERT_EQ(1, m_ds->num_rows());
+  EXPECT_STREQ("it's a '?'", m_ds->fv("name").get_asString().c_str());
+  EXPECT_EQ(1.5, m_ds->fv("value").get_asDouble());
+  EXPECT_TRUE(m_ds->fv("count").get_isNull());
+  m_ds->close();
+}
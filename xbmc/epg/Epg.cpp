@@ -544,6 +544,7 @@ bool CEpg::Persist(void)
     return false;
   }
 
+  bool bTagsPersisted = true;
   {
     CSingleLock lock(m_critSection);
     if (m_iEpgID <= 0 || m_bChanged)
@@ -556,20 +557,35 @@ bool CEpg::Persist(void)
     for (std::map<int, CEpgInfoTagPtr>::iterator it = m_deletedTags.begin(); it != m_deletedTags.end(); it++)
       database->Delete(*it->second);
 
+    /* the changed tags are written in a transaction of their own, which ends here on every path */
+    bool bStarted = !database->InTransaction();
+    if (bStarted)
+      database->BeginTransaction();
+
     for (std::map<int, CEpgInfoTagPtr>::iterator it = m_changedTags.begin(); it != m_changedTags.end(); it++)
-      it->second->Persist(false);
+      bTagsPersisted &= it->second->Persist(false);
+
+    if (bStarted)
+    {
+      if (bTagsPersisted)
+        bTagsPersisted = database->CommitTransaction();
+      else
+        database->RollbackTransaction();
+    }
 
     if (m_bUpdateLastScanTime)
       database->PersistLastEpgScanTime(m_iEpgID, true);
 
+    /* tags that weren't written are tried again with the next save */
     m_deletedTags.clear();
-    m_changedTags.clear();
+    if (bTagsPersisted)
+      m_changedTags.clear();
     m_bChanged            = false;
     m_bTagsChanged        = false;
     m_bUpdateLastScanTime = false;
   }
 
-  return database->CommitInsertQueries();
+  return database->CommitInsertQueries() && bTagsPersisted;
 }
 
 CDateTime CEpg::GetFirstDate(void) const
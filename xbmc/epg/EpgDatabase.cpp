@@ -369,47 +369,80 @@ int CEpgDatabase::Persist(const CEpgInfoTag &tag, bool bSingleUpdate /* = true *
   tag.FirstAiredAsUTC().GetAsTime(iFirstAired);
 
   int iBroadcastId = tag.BroadcastId();
-  CStdString strQuery;
-  
+
   /* Only store the genre string when needed */
   CStdString strGenre = (tag.GenreType() == EPG_GENRE_USE_STRING) ? StringUtils::Join(tag.Genre(), g_advancedSettings.m_videoItemSeparator) : "";
 
-  if (iBroadcastId < 0)
-  {
-    strQuery = FormatSQL("REPLACE INTO epgtags (idEpg, iStartTime, "
-        "iEndTime, sTitle, sPlotOutline, sPlot, iGenreType, iGenreSubType, sGenre, "
-        "iFirstAired, iParentalRating, iStarRating, bNotify, iSeriesId, "
-        "iEpisodeId, iEpisodePart, sEpisodeName, iBroadcastUid) "
-        "VALUES (%u, %u, %u, '%s', '%s', '%s', %i, %i, '%s', %u, %i, %i, %i, %i, %i, %i, '%s', %i);",
-        tag.EpgID(), iStartTime, iEndTime,
-        tag.Title(true).c_str(), tag.PlotOutline(true).c_str(), tag.Plot(true).c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
-        iFirstAired, tag.ParentalRating(), tag.StarRating(), tag.Notify(),
-        tag.SeriesNum(), tag.EpisodeNum(), tag.EpisodePart(), tag.EpisodeName().c_str(),
-        tag.UniqueBroadcastID());
-  }
-  else
-  {
-    strQuery = FormatSQL("REPLACE INTO epgtags (idEpg, iStartTime, "
-        "iEndTime, sTitle, sPlotOutline, sPlot, iGenreType, iGenreSubType, sGenre, "
-        "iFirstAired, iParentalRating, iStarRating, bNotify, iSeriesId, "
-        "iEpisodeId, iEpisodePart, sEpisodeName, iBroadcastUid, idBroadcast) "
-        "VALUES (%u, %u, %u, '%s', '%s', '%s', %i, %i, '%s', %u, %i, %i, %i, %i, %i, %i, '%s', %i, %i);",
-        tag.EpgID(), iStartTime, iEndTime,
-        tag.Title(true).c_str(), tag.PlotOutline(true).c_str(), tag.Plot(true).c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
-        iFirstAired, tag.ParentalRating(), tag.StarRating(), tag.Notify(),
-        tag.SeriesNum(), tag.EpisodeNum(), tag.EpisodePart(), tag.EpisodeName().c_str(),
-        tag.UniqueBroadcastID(), iBroadcastId);
-  }
-
   if (bSingleUpdate)
   {
+    CStdString strQuery;
+    if (iBroadcastId < 0)
+    {
+      strQuery = FormatSQL("REPLACE INTO epgtags (idEpg, iStartTime, "
+          "iEndTime, sTitle, sPlotOutline, sPlot, iGenreType, iGenreSubType, sGenre, "
+          "iFirstAired, iParentalRating, iStarRating, bNotify, iSeriesId, "
+          "iEpisodeId, iEpisodePart, sEpisodeName, iBroadcastUid) "
+          "VALUES (%u, %u, %u, '%s', '%s', '%s', %i, %i, '%s', %u, %i, %i, %i, %i, %i, %i, '%s', %i);",
+          tag.EpgID(), iStartTime, iEndTime,
+          tag.Title(true).c_str(), tag.PlotOutline(true).c_str(), tag.Plot(true).c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
+          iFirstAired, tag.ParentalRating(), tag.StarRating(), tag.Notify(),
+          tag.SeriesNum(), tag.EpisodeNum(), tag.EpisodePart(), tag.EpisodeName().c_str(),
+          tag.UniqueBroadcastID());
+    }
+    else
+    {
+      strQuery = FormatSQL("REPLACE INTO epgtags (idEpg, iStartTime, "
+          "iEndTime, sTitle, sPlotOutline, sPlot, iGenreType, iGenreSubType, sGenre, "
+          "iFirstAired, iParentalRating, iStarRating, bNotify, iSeriesId, "
+          "iEpisodeId, iEpisodePart, sEpisodeName, iBroadcastUid, idBroadcast) "
+          "VALUES (%u, %u, %u, '%s', '%s', '%s', %i, %i, '%s', %u, %i, %i, %i, %i, %i, %i, '%s', %i, %i);",
+          tag.EpgID(), iStartTime, iEndTime,
+          tag.Title(true).c_str(), tag.PlotOutline(true).c_str(), tag.Plot(true).c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
+          iFirstAired, tag.ParentalRating(), tag.StarRating(), tag.Notify(),
+          tag.SeriesNum(), tag.EpisodeNum(), tag.EpisodePart(), tag.EpisodeName().c_str(),
+          tag.UniqueBroadcastID(), iBroadcastId);
+    }
+
     if (ExecuteQuery(strQuery))
       iReturn = (int) m_pDS->lastinsertid();
   }
   else
   {
-    QueueInsertQuery(strQuery);
-    iReturn = 0;
+    /* batched writes reuse one prepared statement, the caller wraps them in a transaction.
+       a NULL idBroadcast makes the database assign a new id */
+    if (!BeginBulkInsert("REPLACE INTO epgtags (idEpg, iStartTime, "
+        "iEndTime, sTitle, sPlotOutline, sPlot, iGenreType, iGenreSubType, sGenre, "
+        "iFirstAired, iParentalRating, iStarRating, bNotify, iSeriesId, "
+        "iEpisodeId, iEpisodePart, sEpisodeName, iBroadcastUid, idBroadcast) "
+        "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);"))
+      return iReturn;
+
+    vector<field_value> row;
+    row.reserve(19);
+    row.push_back(field_value(tag.EpgID()));
+    row.push_back(field_value((int64_t) iStartTime));
+    row.push_back(field_value((int64_t) iEndTime));
+    row.push_back(field_value(tag.Title(true).c_str()));
+    row.push_back(field_value(tag.PlotOutline(true).c_str()));
+    row.push_back(field_value(tag.Plot(true).c_str()));
+    row.push_back(field_value(tag.GenreType()));
+    row.push_back(field_value(tag.GenreSubType()));
+    row.push_back(field_value(strGenre.c_str()));
+    row.push_back(field_value((int64_t) iFirstAired));
+    row.push_back(field_value(tag.ParentalRating()));
+    row.push_back(field_value(tag.StarRating()));
+    row.push_back(field_value((int) tag.Notify()));
+    row.push_back(field_value(tag.SeriesNum()));
+    row.push_back(field_value(tag.EpisodeNum()));
+    row.push_back(field_value(tag.EpisodePart()));
+    row.push_back(field_value(tag.EpisodeName().c_str()));
+    row.push_back(field_value(tag.UniqueBroadcastID()));
+    row.push_back(field_value(iBroadcastId));
+    if (iBroadcastId < 0)
+      row.back().set_isNull();
+
+    if (BulkInsertRow(row))
+      iReturn = 0;
   }
 
   return iReturn;
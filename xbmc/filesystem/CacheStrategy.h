@@ -30,6 +30,7 @@
 #endif
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
+#include "IFileTypes.h"
 
 namespace XFILE {
 
@@ -37,6 +38,7 @@ namespace XFILE {
 #define CACHE_RC_ERROR -1
 #define CACHE_RC_WOULD_BLOCK -2
 #define CACHE_RC_TIMEOUT -3
+#define CACHE_RC_NOT_CACHED -4 // no data at the read position and the source is not filling there
 
 class CCacheStrategy{
 public:
@@ -48,6 +50,13 @@ public:
 
   virtual int WriteToCache(const char *pBuffer, size_t iSize) = 0;
   virtual int ReadFromCache(char *pBuffer, size_t iMaxSize) = 0;
+
+  /* lend the writer cache memory to read source data into directly, saving the
+     copy WriteToCache would make. returns the size lent, 0 when the cache is full
+     or CACHE_RC_ERROR when the strategy can't lend memory. the data only becomes
+     readable once passed to CommitWriteBuffer */
+  virtual int GetWriteBuffer(char **pBuffer, size_t iMaxSize) { return CACHE_RC_ERROR; }
+  virtual int CommitWriteBuffer(size_t iSize) { return CACHE_RC_ERROR; }
   virtual int64_t WaitForData(unsigned int iMinAvail, unsigned int iMillis) = 0;
 
   virtual int64_t Seek(int64_t iFilePosition) = 0;
@@ -57,6 +66,14 @@ public:
   virtual bool IsEndOfInput();
   virtual void ClearEndOfInput();
 
+  /* returns the end of the cached data that directly follows iFilePosition,
+     or iFilePosition itself if the cache holds nothing beyond it */
+  virtual int64_t CachedDataEndPos(int64_t iFilePosition) { return iFilePosition; }
+  /* continue writing at iSourcePosition without moving the read position, used
+     to skip the source over data that is already cached (see CachedDataEndPos) */
+  virtual void SetWritePosition(int64_t iSourcePosition) {}
+  virtual bool GetSegmentStatus(SCacheSegmentStatus *status) { return false; }
+
   CEvent m_space;
 protected:
   bool  m_bEndOfInput;
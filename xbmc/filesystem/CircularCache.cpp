@@ -76,6 +76,31 @@ void CCircularCache::Close()
   m_buf = NULL;
 }
 
+/**
+ * Returns how much of len can be written at m_end % m_size
+ * without wrapping or eating into the guaranteed back buffer
+ */
+size_t CCircularCache::GetWriteLimit(size_t len)
+{
+  // where are we in the buffer
+  size_t pos   = m_end % m_size;
+  size_t back  = (size_t)(m_cur - m_beg);
+  size_t front = (size_t)(m_end - m_cur);
+
+  size_t limit = m_size - std::min(back, m_size_back) - front;
+  size_t wrap  = m_size - pos;
+
+  // limit by max forward size
+  if(len > limit)
+    len = limit;
+
+  // limit to wrap point
+  if(len > wrap)
+    len = wrap;
+
+  return len;
+}
+
 /**
  * Function will write to m_buf at m_end % m_size location
  * it will write at maximum m_size, but it will only write
@@ -99,27 +124,12 @@ int CCircularCache::WriteToCache(const char *buf, size_t len)
 {
   CSingleLock lock(m_sync);
 
-  // where are we in the buffer
-  size_t pos   = m_end % m_size;
-  size_t back  = (size_t)(m_cur - m_beg);
-  size_t front = (size_t)(m_end - m_cur);
-
-  size_t limit = m_size - std::min(back, m_size_back) - front;
-  size_t wrap  = m_size - pos;
-
-  // limit by max forward size
-  if(len > limit)
-    len = limit;
-
-  // limit to wrap point
-  if(len > wrap)
-    len = wrap;
-
+  len = GetWriteLimit(len);
   if(len == 0)
     return 0;
 
   // write the data
-  memcpy(m_buf + pos, buf, len);
+  memcpy(m_buf + m_end % m_size, buf, len);
   m_end += len;
 
   // drop history that was overwritten
@@ -131,6 +141,36 @@ int CCircularCache::WriteToCache(const char *buf, size_t len)
   return len;
 }
 
+/**
+ * Lends the writer the area WriteToCache would copy into, so
+ * data can be read from the source straight into the buffer.
+ *
+ * History in the lent area is dropped up front as the reader
+ * must not seek back into it while it is being overwritten.
+ */
+int CCircularCache::GetWriteBuffer(char **buf, size_t len)
+{
+  CSingleLock lock(m_sync);
+
+  len = GetWriteLimit(len);
+  if(len == 0)
+    return 0;
+
+  if(m_end + len - m_beg > m_size)
+    m_beg = m_end + len - m_size;
+
+  *buf = (char*)m_buf + m_end % m_size;
+  return len;
+}
+
+int CCircularCache::CommitWriteBuffer(size_t len)
+{
+  CSingleLock lock(m_sync);
+  m_end += len;
+  m_written.Set();
+  return len;
+}
+
 /**
  * Reads data from cache. Will only read up till
  * the buffer wrap point. So multiple calls
@@ -38,12 +38,16 @@ public:
 
     virtual int WriteToCache(const char *buf, size_t len) ;
     virtual int ReadFromCache(char *buf, size_t len) ;
+    virtual int GetWriteBuffer(char **buf, size_t len) ;
+    virtual int CommitWriteBuffer(size_t len) ;
     virtual int64_t WaitForData(unsigned int minimum, unsigned int iMillis) ;
 
     virtual int64_t Seek(int64_t pos) ;
     virtual void Reset(int64_t pos) ;
 
 protected:
+    size_t GetWriteLimit(size_t len);
+
     uint64_t          m_beg;       /**< index in file (not buffer) of beginning of valid data */
     uint64_t          m_end;       /**< index in file (not buffer) of end of valid data */
     uint64_t          m_cur;       /**< current reading index in file */
@@ -135,6 +135,12 @@ bool CDirectory::GetDirectory(const CStdString& strPath, CFileItemList &items, c
     // check our cache for this path
     if (g_directoryCache.GetDirectory(strPath, items, (hints.flags & DIR_FLAG_READ_CACHE) == DIR_FLAG_READ_CACHE))
       items.SetPath(strPath);
+    else if (!(hints.flags & DIR_FLAG_BYPASS_CACHE) && g_directoryCache.GetPersistentDirectory(strPath, items))
+    {
+      // unchanged since a previous session listed it
+      items.SetPath(strPath);
+      g_directoryCache.SetDirectory(strPath, items, pDirectory->GetCacheType(strPath));
+    }
     else
     {
       // need to clear the cache (in case the directory fetch fails)
@@ -198,7 +204,12 @@ bool CDirectory::GetDirectory(const CStdString& strPath, CFileItemList &items, c
 
       // cache the directory, if necessary
       if (!(hints.flags & DIR_FLAG_BYPASS_CACHE))
-        g_directoryCache.SetDirectory(strPath, items, pDirectory->GetCacheType(strPath));
+      {
+        DIR_CACHE_TYPE cacheType = pDirectory->GetCacheType(strPath);
+        g_directoryCache.SetDirectory(strPath, items, cacheType);
+        if (cacheType != DIR_CACHE_NEVER)
+          g_directoryCache.SetPersistentDirectory(strPath, items);
+      }
     }
 
     // now filter for allowed files
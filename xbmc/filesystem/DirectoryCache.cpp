@@ -20,15 +20,36 @@
 
 #include "DirectoryCache.h"
 #include "settings/Settings.h"
+#include "settings/AdvancedSettings.h"
 #include "FileItem.h"
+#include "File.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
+#include "utils/Archive.h"
+#include "utils/Crc32.h"
 #include "utils/URIUtils.h"
 #include "climits"
 
 using namespace std;
 using namespace XFILE;
 
+#define PERSISTENT_CACHE_VERSION 1
+
+// true if path is dir itself or lies below it, /a/foobar isn't below /a/foo
+static bool IsSubPath(const CStdString& path, const CStdString& dir)
+{
+  if (strncmp(path.c_str(), dir.c_str(), dir.size()) != 0)
+    return false;
+  if (path.size() == dir.size() || dir.empty())
+    return true;
+
+  char last = dir[dir.size() - 1];
+  if (last == '/' || last == '\\')
+    return true;
+  char next = path[dir.size()];
+  return next == '/' || next == '\\';
+}
+
 CDirectoryCache::CDir::CDir(DIR_CACHE_TYPE cacheType)
 {
   m_cacheType = cacheType;
@@ -50,6 +71,7 @@ void CDirectoryCache::CDir::SetLastAccess(unsigned int &accessCounter)
 CDirectoryCache::CDirectoryCache(void)
 {
   m_accessCounter = 0;
+  m_persistentPathsLoaded = false;
 #ifdef _DEBUG
   m_cacheHits = 0;
   m_cacheMisses = 0;
@@ -106,7 +128,10 @@ void CDirectoryCache::SetDirectory(const CStdString& strPath, const CFileItemLis
   CStdString storedPath = URIUtils::SubstitutePath(strPath);
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  ClearDirectory(storedPath);
+  // only drop the in-memory copy - the on-disk one is handled by SetPersistentDirectory
+  iCache i = m_cache.find(storedPath);
+  if (i != m_cache.end())
+    Delete(i);
 
   CheckIfFull();
 
@@ -133,6 +158,10 @@ void CDirectoryCache::ClearDirectory(const CStdString& strPath)
   iCache i = m_cache.find(storedPath);
   if (i != m_cache.end())
     Delete(i);
+  lock.Leave();
+
+  if (CanPersist(storedPath))
+    DeletePersistent(storedPath);
 }
 
 void CDirectoryCache::ClearSubPaths(const CStdString& strPath)
@@ -145,12 +174,31 @@ void CDirectoryCache::ClearSubPaths(const CStdString& strPath)
   iCache i = m_cache.begin();
   while (i != m_cache.end())
   {
-    CStdString path = i->first;
-    if (strncmp(path.c_str(), storedPath.c_str(), storedPath.GetLength()) == 0)
+    if (IsSubPath(i->first, storedPath))
       Delete(i++);
     else
       i++;
   }
+  lock.Leave();
+
+  if (!CanPersist(storedPath))
+    return;
+
+  CSingleLock persistentLock(m_persistentSection);
+  LoadPersistentPaths();
+
+  // the paths are sorted, so everything below the path follows right after it
+  set<CStdString>::iterator it = m_persistentPaths.lower_bound(storedPath);
+  while (it != m_persistentPaths.end() && strncmp(it->c_str(), storedPath.c_str(), storedPath.size()) == 0)
+  {
+    if (IsSubPath(*it, storedPath))
+    {
+      CFile::Delete(GetPersistentFile(*it));
+      m_persistentPaths.erase(it++);
+    }
+    else
+      ++it;
+  }
 }
 
 void CDirectoryCache::AddFile(const CStdString& strFile)
@@ -197,6 +245,170 @@ bool CDirectoryCache::FileExists(const CStdString& strFile, bool& bInCache)
   return false;
 }
 
+bool CDirectoryCache::GetPersistentDirectory(const CStdString& strPath, CFileItemList &items)
+{
+  CStdString storedPath = URIUtils::SubstitutePath(strPath);
+  URIUtils::RemoveSlashAtEnd(storedPath);
+
+  if (!CanPersist(storedPath))
+    return false;
+
+  // most directories have no saved listing, don't stat them over the network for nothing
+  if (!CFile::Exists(GetPersistentFile(storedPath)))
+    return false;
+
+  // stat the directory before taking the lock, as this goes over the network
+  int64_t stamp = GetDirectoryStamp(storedPath);
+
+  CSingleLock lock(m_persistentSection);
+  CFile file;
+  if (!file.Open(GetPersistentFile(storedPath)))
+    return false;
+
+  int version = 0;
+  CStdString path;
+  int64_t savedStamp = 0;
+  int64_t savedTime = 0;
+  CArchive ar(&file, CArchive::load);
+  ar >> version;
+  if (version == PERSISTENT_CACHE_VERSION)
+    ar >> path >> savedStamp >> savedTime;
+
+  bool valid = version == PERSISTENT_CACHE_VERSION && path == storedPath;
+  if (valid)
+  {
+    if (savedStamp)
+      valid = savedStamp == stamp;
+    else // no modification time from this source, so we can only trust the listing for a while
+      valid = savedTime + g_advancedSettings.m_persistentDirCacheMaxAge > (int64_t)time(NULL);
+  }
+
+  if (valid)
+  {
+    ar >> items;
+    CLog::Log(LOGDEBUG, "%s - using saved listing of %s (%i items)", __FUNCTION__, storedPath.c_str(), items.Size());
+  }
+  ar.Close();
+  file.Close();
+
+  if (!valid)
+  {
+    CFile::Delete(GetPersistentFile(storedPath));
+    m_persistentPaths.erase(storedPath);
+  }
+
+  return valid;
+}
+
+void CDirectoryCache::SetPersistentDirectory(const CStdString& strPath, const CFileItemList &items)
+{
+  CStdString storedPath = URIUtils::SubstitutePath(strPath);
+  URIUtils::RemoveSlashAtEnd(storedPath);
+
+  if (!CanPersist(storedPath) || items.IsEmpty())
+    return;
+
+  int64_t now = time(NULL);
+  int64_t stamp = GetDirectoryStamp(storedPath);
+  if (stamp)
+  {
+    // modification times only have a resolution of a second, so a listing of a directory
+    // that changed just now might already be out of date without the time changing.
+    if (stamp >= now - 1)
+      return;
+  }
+  else if (g_advancedSettings.m_persistentDirCacheMaxAge <= 0)
+    return;
+
+  CSingleLock lock(m_persistentSection);
+  CFile file;
+  if (!file.OpenForWrite(GetPersistentFile(storedPath), true))
+    return;
+
+  CArchive ar(&file, CArchive::store);
+  ar << (int)PERSISTENT_CACHE_VERSION;
+  ar << storedPath << stamp << now;
+  ar << const_cast<CFileItemList&>(items);
+  ar.Close();
+  file.Close();
+
+  m_persistentPaths.insert(storedPath);
+}
+
+bool CDirectoryCache::CanPersist(const CStdString& storedPath) const
+{
+  if (!g_advancedSettings.m_persistentDirCache)
+    return false;
+
+  // only worthwhile where listing the directory is expensive
+  return URIUtils::IsSmb(storedPath) || URIUtils::IsNfs(storedPath) ||
+         URIUtils::IsAfp(storedPath) || URIUtils::IsUPnP(storedPath);
+}
+
+CStdString CDirectoryCache::GetPersistentFile(const CStdString& storedPath) const
+{
+  Crc32 crc;
+  crc.Compute(storedPath);
+
+  CStdString cacheFile;
+  cacheFile.Format("special://temp/dircache/%08x.fi", (unsigned __int32)crc);
+  return cacheFile;
+}
+
+void CDirectoryCache::DeletePersistent(const CStdString& storedPath)
+{
+  CSingleLock lock(m_persistentSection);
+  CStdString cacheFile = GetPersistentFile(storedPath);
+  if (CFile::Exists(cacheFile))
+    CFile::Delete(cacheFile);
+  m_persistentPaths.erase(storedPath);
+}
+
+void CDirectoryCache::LoadPersistentPaths()
+{
+  if (m_persistentPathsLoaded)
+    return;
+  m_persistentPathsLoaded = true;
+
+  // the on-disk listings are named by hash, so the ones of earlier sessions
+  // have to be looked into once to learn their paths
+  CFileItemList files;
+  if (!CDirectory::GetDirectory("special://temp/dircache/", files, ".fi", DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_BYPASS_CACHE))
+    return;
+
+  for (int i = 0; i < files.Size(); i++)
+  {
+    CFile file;
+    if (!file.Open(files[i]->GetPath()))
+      continue;
+
+    int version = 0;
+    CStdString path;
+    CArchive ar(&file, CArchive::load);
+    ar >> version;
+    if (version == PERSISTENT_CACHE_VERSION)
+      ar >> path;
+    ar.Close();
+    file.Close();
+
+    if (version == PERSISTENT_CACHE_VERSION)
+      m_persistentPaths.insert(path);
+    else
+      CFile::Delete(files[i]->GetPath());
+  }
+}
+
+int64_t CDirectoryCache::GetDirectoryStamp(const CStdString& strPath) const
+{
+  // same modification time the library scanners use for their fast hash
+  struct __stat64 buffer;
+  CStdString path(strPath);
+  URIUtils::AddSlashAtEnd(path);
+  if (CFile::Stat(path, &buffer) == 0)
+    return buffer.st_mtime ? buffer.st_mtime : buffer.st_ctime;
+  return 0;
+}
+
 void CDirectoryCache::Clear()
 {
   // this routine clears everything
@@ -57,6 +57,22 @@ namespace XFILE
     void Clear();
     void AddFile(const CStdString& strFile);
     bool FileExists(const CStdString& strPath, bool& bInCache);
+
+    /*! \brief Fetch a listing saved by a previous session.
+     The listing is only returned if the directory hasn't been modified since it was saved.
+     \param strPath the directory to fetch
+     \param items the listing
+     \return true if a valid listing was found, false otherwise
+     \sa SetPersistentDirectory
+     */
+    bool GetPersistentDirectory(const CStdString& strPath, CFileItemList &items);
+
+    /*! \brief Save a listing of a network directory so it survives a restart.
+     \param strPath the directory that was fetched
+     \param items the listing
+     \sa GetPersistentDirectory
+     */
+    void SetPersistentDirectory(const CStdString& strPath, const CFileItemList &items);
 #ifdef _DEBUG
     void PrintStats() const;
 #endif
@@ -65,12 +81,21 @@ namespace XFILE
     void ClearCache(std::set<CStdString>& dirs);
     void CheckIfFull();
 
+    virtual bool CanPersist(const CStdString& storedPath) const;
+    CStdString GetPersistentFile(const CStdString& storedPath) const;
+    void DeletePersistent(const CStdString& storedPath);
+    void LoadPersistentPaths();
+    virtual int64_t GetDirectoryStamp(const CStdString& strPath) const;
+
     std::map<CStdString, CDir*> m_cache;
     typedef std::map<CStdString, CDir*>::iterator iCache;
     typedef std::map<CStdString, CDir*>::const_iterator ciCache;
     void Delete(iCache i);
 
     CCriticalSection m_cs;
+    CCriticalSection m_persistentSection; ///< serializes access to the on-disk listings
+    std::set<CStdString> m_persistentPaths; ///< paths with an on-disk listing, sorted so subpaths follow their parent
+    bool m_persistentPathsLoaded;           ///< m_persistentPaths also holds the listings of earlier sessions
 
     unsigned int m_accessCounter;
 
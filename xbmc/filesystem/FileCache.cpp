@@ -26,6 +26,8 @@
 #include "URL.h"
 
 #include "CircularCache.h"
+#include "SegmentedCache.h"
+#include "FileCacheReadAhead.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/TimeUtils.h"
@@ -85,13 +87,16 @@ CFileCache::CFileCache() : CThread("CFileCache")
    m_seekPos = 0;
    m_readPos = 0;
    m_writePos = 0;
-   if (g_advancedSettings.m_cacheMemBufferSize == 0)
+   if (g_advancedSettings.m_cacheSegmented)
+     m_pCache = new CSegmentedFileCache();
+   else if (g_advancedSettings.m_cacheMemBufferSize == 0)
      m_pCache = new CSimpleFileCache();
    else
      m_pCache = new CCircularCache(g_advancedSettings.m_cacheMemBufferSize
                                  , std::max<unsigned int>( g_advancedSettings.m_cacheMemBufferSize / 4, 1024 * 1024));
    m_seekPossible = 0;
    m_cacheFull = false;
+   m_readAhead = NULL;
 }
 
 CFileCache::CFileCache(CCacheStrategy *pCache, bool bDeleteCache) : CThread("CFileCache")
@@ -103,6 +108,7 @@ CFileCache::CFileCache(CCacheStrategy *pCache, bool bDeleteCache) : CThread("CFi
   m_writePos = 0;
   m_nSeekResult = 0;
   m_chunkSize = 0;
+  m_readAhead = NULL;
 }
 
 CFileCache::~CFileCache()
@@ -167,6 +173,16 @@ bool CFileCache::Open(const CURL& url)
   m_seekPossible = m_source.IoControl(IOCTRL_SEEK_POSSIBLE, NULL);
   m_chunkSize = CFile::GetChunkSize(m_source.GetChunkSize(), READ_CACHE_CHUNK_SIZE);
 
+  // on high latency sources keep several range requests in flight
+  if (g_advancedSettings.m_cacheReadAheadConnections > 1 && m_seekPossible > 0
+  &&  m_source.GetLength() > 0 && CFileCacheReadAhead::IsSupported(m_sourcePath))
+  {
+    CLog::Log(LOGDEBUG,"CFileCache::Open - reading ahead with %u connections", g_advancedSettings.m_cacheReadAheadConnections);
+    m_readAhead = new CFileCacheReadAhead(m_sourcePath, m_source.GetLength()
+                                        , g_advancedSettings.m_cacheReadAheadConnections
+                                        , g_advancedSettings.m_cacheReadAheadChunkSize);
+  }
+
   m_readPos = 0;
   m_writePos = 0;
   m_writeRate = 1024 * 1024;
@@ -206,7 +222,10 @@ void CFileCache::Process()
     {
       m_seekEvent.Reset();
       CLog::Log(LOGDEBUG,"%s, request seek on source to %"PRId64, __FUNCTION__, m_seekPos);
-      m_nSeekResult = m_source.Seek(m_seekPos, SEEK_SET);
+      if (m_readAhead)
+        m_nSeekResult = m_readAhead->Seek(m_seekPos);
+      else
+        m_nSeekResult = m_source.Seek(m_seekPos, SEEK_SET);
       if (m_nSeekResult != m_seekPos)
       {
         CLog::Log(LOGERROR,"%s, error %d seeking. seek returned %"PRId64, __FUNCTION__, (int)GetLastError(), m_nSeekResult);
@@ -243,7 +262,33 @@ void CFileCache::Process()
       }
     }
 
-    int iRead = m_source.Read(buffer.get(), m_chunkSize);
+    // read straight into cache memory when the strategy lends a full chunk,
+    // saving the copy into the cache. otherwise go through our own buffer
+    char *readBuffer = NULL;
+    bool  lent = m_pCache->GetWriteBuffer(&readBuffer, m_chunkSize) == (int)m_chunkSize;
+    if (!lent)
+      readBuffer = buffer.get();
+
+    int iRead;
+    if (m_readAhead)
+    {
+      iRead = m_readAhead->Read(readBuffer, m_chunkSize, 100);
+      if (iRead == CACHE_RC_WOULD_BLOCK)
+        continue; // check for seek and stop requests while the chunk is in flight
+
+      if (iRead == CACHE_RC_ERROR)
+      {
+        CLog::Log(LOGWARNING,"CFileCache::Process - read ahead failed, continuing with a single connection");
+        delete m_readAhead;
+        m_readAhead = NULL;
+        iRead = -1;
+        if (m_source.Seek(m_writePos, SEEK_SET) == m_writePos)
+          iRead = m_source.Read(readBuffer, m_chunkSize);
+      }
+    }
+    else
+      iRead = m_source.Read(readBuffer, m_chunkSize);
+
     if (iRead == 0)
     {
       CLog::Log(LOGINFO, "CFileCache::Process - Hit eof.");
@@ -262,6 +307,17 @@ void CFileCache::Process()
       m_bStop = true;
 
     int iTotalWrite=0;
+    if (lent && iRead > 0)
+    {
+      iTotalWrite = std::max(0, m_pCache->CommitWriteBuffer(iRead));
+      m_cacheFull = false;
+
+      // whatever wasn't committed is written like a normal read, the lent
+      // memory may be handed out again so move it to our own buffer first
+      if (iTotalWrite < iRead)
+        memcpy(buffer.get() + iTotalWrite, readBuffer + iTotalWrite, iRead - iTotalWrite);
+    }
+
     while (!m_bStop && (iTotalWrite < iRead))
     {
       int iWrite = 0;
@@ -297,6 +353,35 @@ void CFileCache::Process()
 
     m_writePos += iTotalWrite;
 
+    // the data that follows may already be cached from an earlier read,
+    // in which case skip the source over it instead of fetching it again
+    if (m_seekPossible && iTotalWrite > 0)
+    {
+      int64_t cachedEnd = m_pCache->CachedDataEndPos(m_writePos);
+      if (cachedEnd > m_writePos)
+      {
+        CLog::Log(LOGDEBUG,"%s, skipping cached data from %"PRId64" to %"PRId64, __FUNCTION__, m_writePos, cachedEnd);
+        int64_t skipped;
+        if (m_readAhead)
+          skipped = m_readAhead->Seek(cachedEnd);
+        else
+          skipped = m_source.Seek(cachedEnd, SEEK_SET);
+
+        if (skipped == cachedEnd)
+        {
+          m_pCache->SetWritePosition(cachedEnd);
+          average.Reset(cachedEnd);
+          limiter.Reset(cachedEnd);
+          m_writePos = cachedEnd;
+        }
+        else
+        {
+          CLog::Log(LOGERROR,"%s, error %d skipping cached data", __FUNCTION__, (int)GetLastError());
+          m_seekPossible = m_source.IoControl(IOCTRL_SEEK_POSSIBLE, NULL);
+        }
+      }
+    }
+
     // under estimate write rate by a second, to
     // avoid uncertainty at start of caching
     m_writeRateActual = average.Rate(m_writePos, 1000);
@@ -352,6 +437,16 @@ retry:
       goto retry;
   }
 
+  if (iRc == CACHE_RC_NOT_CACHED)
+  {
+    // nothing cached here and the source is filling elsewhere, move it to us
+    if (m_seekPossible && SeekSource(m_readPos) && m_nSeekResult >= 0)
+      goto retry;
+
+    CLog::Log(LOGWARNING, "%s - failed to refill cache at %"PRId64, __FUNCTION__, m_readPos);
+    return 0;
+  }
+
   if (iRc == CACHE_RC_TIMEOUT)
   {
     CLog::Log(LOGWARNING, "%s - timeout waiting for data", __FUNCTION__);
@@ -393,29 +488,8 @@ int64_t CFileCache::Seek(int64_t iFilePosition, int iWhence)
     if (m_seekPossible == 0)
       return m_nSeekResult;
 
-    /* never request closer to end than 2k, speeds up tag reading */
-    m_seekPos = std::min(iTarget, std::max((int64_t)0, m_source.GetLength() - m_chunkSize));
-
-    m_seekEvent.Set();
-    if (!m_seekEnded.Wait())
-    {
-      CLog::Log(LOGWARNING,"%s - seek to %"PRId64" failed.", __FUNCTION__, m_seekPos);
+    if (!SeekSource(iTarget))
       return -1;
-    }
-
-    /* wait for any remainin data */
-    if(m_seekPos < iTarget)
-    {
-      CLog::Log(LOGDEBUG,"%s - waiting for position %"PRId64".", __FUNCTION__, iTarget);
-      if(m_pCache->WaitForData((unsigned)(iTarget - m_seekPos), 10000) < iTarget - m_seekPos)
-      {
-        CLog::Log(LOGWARNING,"%s - failed to get remaining data", __FUNCTION__);
-        return -1;
-      }
-      m_pCache->Seek(iTarget);
-    }
-    m_readPos = iTarget;
-    m_seekEvent.Reset();
   }
   else
     m_readPos = iTarget;
@@ -423,11 +497,43 @@ int64_t CFileCache::Seek(int64_t iFilePosition, int iWhence)
   return m_nSeekResult;
 }
 
+bool CFileCache::SeekSource(int64_t iTarget)
+{
+  /* never request closer to end than 2k, speeds up tag reading */
+  m_seekPos = std::min(iTarget, std::max((int64_t)0, m_source.GetLength() - m_chunkSize));
+
+  m_seekEvent.Set();
+  if (!m_seekEnded.Wait())
+  {
+    CLog::Log(LOGWARNING,"%s - seek to %"PRId64" failed.", __FUNCTION__, m_seekPos);
+    return false;
+  }
+
+  /* wait for any remainin data */
+  if(m_seekPos < iTarget)
+  {
+    CLog::Log(LOGDEBUG,"%s - waiting for position %"PRId64".", __FUNCTION__, iTarget);
+    if(m_pCache->WaitForData((unsigned)(iTarget - m_seekPos), 10000) < iTarget - m_seekPos)
+    {
+      CLog::Log(LOGWARNING,"%s - failed to get remaining data", __FUNCTION__);
+      return false;
+    }
+    m_pCache->Seek(iTarget);
+  }
+  m_readPos = iTarget;
+  m_seekEvent.Reset();
+
+  return true;
+}
+
 void CFileCache::Close()
 {
   StopThread();
 
   CSingleLock lock(m_sync);
+  delete m_readAhead;
+  m_readAhead = NULL;
+
   if (m_pCache)
     m_pCache->Close();
 
@@ -481,5 +587,8 @@ int CFileCache::IoControl(EIoControl request, void* param)
   if (request == IOCTRL_SEEK_POSSIBLE)
     return m_seekPossible;
 
+  if (request == IOCTRL_CACHE_SEGMENTS)
+    return m_pCache->GetSegmentStatus((SCacheSegmentStatus*)param) ? 0 : -1;
+
   return -1;
 }
@@ -27,6 +27,7 @@
 
 namespace XFILE
 {
+  class CFileCacheReadAhead;
 
   class CFileCache : public IFile, public CThread
   {
@@ -61,10 +62,13 @@ namespace XFILE
     virtual CStdString GetContent();
 
   private:
+    bool SeekSource(int64_t iTarget);
+
     CCacheStrategy *m_pCache;
     bool      m_bDeleteCache;
     int        m_seekPossible;
     CFile      m_source;
+    CFileCacheReadAhead *m_readAhead;
     CStdString    m_sourcePath;
     CEvent      m_seekEvent;
     CEvent      m_seekEnded;
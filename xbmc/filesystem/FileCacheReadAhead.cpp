@@ -0,0 +1,259 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FileCacheReadAhead.h"
+#include "CacheStrategy.h"
+#include "URL.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/log.h"
+
+using namespace XFILE;
+
+CFileCacheReadAhead::CReader::CReader(CFileCacheReadAhead *owner)
+  : CThread("CFileCacheReadAhead")
+  , m_owner(owner)
+{
+}
+
+void CFileCacheReadAhead::CReader::Process()
+{
+  CFile file;
+  bool  opened = false;
+  Job   job;
+
+  while (!m_bStop)
+  {
+    if (!m_owner->GetJob(job, 100))
+      continue;
+
+    // each reader keeps its own connection, every chunk is a new range request on it
+    if (!opened)
+    {
+      opened = file.Open(m_owner->m_path, READ_NO_CACHE | READ_TRUNCATED | READ_CHUNKED);
+      if (!opened)
+        CLog::Log(LOGERROR, "%s - failed to open source <%s>", __FUNCTION__, m_owner->m_path.c_str());
+    }
+
+    unsigned int filled = 0;
+    if (opened && file.Seek(job.offset, SEEK_SET) == job.offset)
+    {
+      while (filled < job.size && !m_bStop && m_owner->IsCurrent(job))
+      {
+        // the sources return -1 on errors through the unsigned return type
+        int read = (int)file.Read(job.buffer + filled, job.size - filled);
+        if (read <= 0)
+        {
+          if (read < 0)
+            CLog::Log(LOGERROR, "%s - failed to read at %"PRId64, __FUNCTION__, job.offset + filled);
+          break;
+        }
+        filled += read;
+      }
+    }
+    else if (opened)
+      CLog::Log(LOGERROR, "%s - failed to seek to %"PRId64, __FUNCTION__, job.offset);
+
+    m_owner->CompleteJob(job, filled);
+  }
+
+  file.Close();
+}
+
+CFileCacheReadAhead::CFileCacheReadAhead(const CStdString &path, int64_t length, unsigned int connections, unsigned int chunkSize)
+  : m_path(path)
+  , m_length(length)
+  , m_chunkSize(chunkSize)
+  , m_nextOffset(0)
+  , m_head(0)
+  , m_headPos(0)
+{
+  m_chunks.resize(connections);
+  for (unsigned int i = 0; i < m_chunks.size(); i++)
+  {
+    m_chunks[i].buffer.resize(m_chunkSize);
+    m_chunks[i].seq   = 0;
+    m_chunks[i].state = CHUNK_PENDING;
+  }
+  Seek(0);
+
+  for (unsigned int i = 0; i < connections; i++)
+  {
+    CReader *reader = new CReader(this);
+    reader->Create(false);
+    m_readers.push_back(reader);
+  }
+}
+
+CFileCacheReadAhead::~CFileCacheReadAhead()
+{
+  // signal everyone first so the readers wind down in parallel
+  for (unsigned int i = 0; i < m_readers.size(); i++)
+    m_readers[i]->StopThread(false);
+
+  for (unsigned int i = 0; i < m_readers.size(); i++)
+  {
+    m_readers[i]->StopThread(true);
+    delete m_readers[i];
+  }
+  m_readers.clear();
+}
+
+bool CFileCacheReadAhead::IsSupported(const CStdString &path)
+{
+  CURL url(path);
+  CStdString protocol = url.GetProtocol();
+  return protocol.Equals("http") || protocol.Equals("https")
+      || protocol.Equals("dav")  || protocol.Equals("davs");
+}
+
+void CFileCacheReadAhead::AssignChunk(Chunk &chunk)
+{
+  chunk.offset = m_nextOffset;
+  chunk.size   = 0;
+  if (m_nextOffset < m_length)
+    chunk.size = (unsigned int)std::min((int64_t)m_chunkSize, m_length - m_nextOffset);
+  chunk.filled = 0;
+  chunk.failed = false;
+  chunk.seq++;
+
+  // a reader still busy with the old range keeps the chunk until it notices
+  if (chunk.state != CHUNK_FETCHING)
+    chunk.state = CHUNK_PENDING;
+
+  m_nextOffset += chunk.size;
+}
+
+int64_t CFileCacheReadAhead::Seek(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+  if (m_length > 0 && iFilePosition > m_length)
+    return -1;
+
+  m_nextOffset = iFilePosition;
+  m_head       = 0;
+  m_headPos    = 0;
+  for (unsigned int i = 0; i < m_chunks.size(); i++)
+    AssignChunk(m_chunks[i]);
+
+  m_work.Set();
+  return iFilePosition;
+}
+
+bool CFileCacheReadAhead::GetJob(Job &job, unsigned int iMillis)
+{
+  CSingleLock lock(m_sync);
+  XbmcThreads::EndTime endTime(iMillis);
+  while (true)
+  {
+    // hand out chunks in file order, the head is the one Read() waits for
+    for (unsigned int i = 0; i < m_chunks.size(); i++)
+    {
+      unsigned int index = (m_head + i) % m_chunks.size();
+      Chunk &chunk = m_chunks[index];
+      if (chunk.state != CHUNK_PENDING || chunk.size == 0)
+        continue;
+
+      chunk.state = CHUNK_FETCHING;
+      job.index  = index;
+      job.seq    = chunk.seq;
+      job.offset = chunk.offset;
+      job.size   = chunk.size;
+      job.buffer = &chunk.buffer[0];
+
+      // there may be more work for the other readers
+      m_work.Set();
+      return true;
+    }
+
+    if (endTime.IsTimePast())
+      return false;
+
+    lock.Leave();
+    m_work.WaitMSec(endTime.MillisLeft());
+    lock.Enter();
+  }
+}
+
+bool CFileCacheReadAhead::IsCurrent(const Job &job)
+{
+  CSingleLock lock(m_sync);
+  return m_chunks[job.index].seq == job.seq;
+}
+
+void CFileCacheReadAhead::CompleteJob(const Job &job, unsigned int filled)
+{
+  CSingleLock lock(m_sync);
+  Chunk &chunk = m_chunks[job.index];
+  if (chunk.seq != job.seq)
+  {
+    // reassigned by a seek while we were fetching, needs fetching again
+    chunk.state = CHUNK_PENDING;
+    m_work.Set();
+    return;
+  }
+
+  chunk.filled = filled;
+  chunk.failed = filled < chunk.size;
+  chunk.state  = CHUNK_DONE;
+  m_done.Set();
+}
+
+int CFileCacheReadAhead::Read(char *pBuffer, unsigned int iSize, unsigned int iMillis)
+{
+  CSingleLock lock(m_sync);
+  XbmcThreads::EndTime endTime(iMillis);
+
+  Chunk *chunk = &m_chunks[m_head];
+  if (chunk->size == 0)
+    return 0;
+
+  while (chunk->state != CHUNK_DONE)
+  {
+    if (endTime.IsTimePast())
+      return CACHE_RC_WOULD_BLOCK;
+
+    lock.Leave();
+    m_done.WaitMSec(endTime.MillisLeft());
+    lock.Enter();
+    chunk = &m_chunks[m_head];
+  }
+
+  if (m_headPos >= chunk->filled)
+  {
+    CLog::Log(LOGERROR, "%s - failed to fetch %u bytes at %"PRId64, __FUNCTION__, chunk->size, chunk->offset + chunk->filled);
+    return CACHE_RC_ERROR;
+  }
+
+  unsigned int iRead = std::min(iSize, chunk->filled - m_headPos);
+  memcpy(pBuffer, &chunk->buffer[m_headPos], iRead);
+  m_headPos += iRead;
+
+  // fully consumed, reuse it for the next range
+  if (m_headPos == chunk->size)
+  {
+    AssignChunk(*chunk);
+    m_head    = (m_head + 1) % m_chunks.size();
+    m_headPos = 0;
+    m_work.Set();
+  }
+
+  return iRead;
+}
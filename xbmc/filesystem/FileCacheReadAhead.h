@@ -0,0 +1,113 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+
+#include "File.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+#include "utils/StdString.h"
+
+namespace XFILE
+{
+
+  /**
+   * Reads a file through several connections at once.
+   *
+   * The file is split into chunks that are fetched as independent byte range
+   * requests by a pool of reader threads, keeping one request in flight per
+   * connection. Read() hands out the chunks in file order, so the caller sees
+   * a plain sequential stream. Used by CFileCache for high latency sources
+   * (http/dav) where a single request can't saturate the link.
+   */
+  class CFileCacheReadAhead
+  {
+  public:
+    CFileCacheReadAhead(const CStdString &path, int64_t length, unsigned int connections, unsigned int chunkSize);
+    ~CFileCacheReadAhead();
+
+    /* returns true if the source is worth reading with several connections */
+    static bool IsSupported(const CStdString &path);
+
+    /* restart fetching at iFilePosition, discarding anything in flight */
+    int64_t Seek(int64_t iFilePosition);
+    /* returns bytes read, 0 at end of file, CACHE_RC_WOULD_BLOCK if the next
+       chunk hasn't arrived within iMillis or CACHE_RC_ERROR if it failed */
+    int Read(char *pBuffer, unsigned int iSize, unsigned int iMillis);
+    int64_t GetLength() const { return m_length; }
+
+  private:
+    enum ChunkState
+    {
+      CHUNK_PENDING,
+      CHUNK_FETCHING,
+      CHUNK_DONE
+    };
+
+    struct Chunk
+    {
+      int64_t           offset;
+      unsigned int      size;
+      unsigned int      filled;
+      unsigned int      seq;     /**< bumped each time the chunk is assigned a new offset */
+      bool              failed;
+      ChunkState        state;
+      std::vector<char> buffer;
+    };
+
+    struct Job
+    {
+      unsigned int index;
+      unsigned int seq;
+      int64_t      offset;
+      unsigned int size;
+      char        *buffer;
+    };
+
+    class CReader : public CThread
+    {
+    public:
+      CReader(CFileCacheReadAhead *owner);
+    protected:
+      virtual void Process();
+      CFileCacheReadAhead *m_owner;
+    };
+
+    void AssignChunk(Chunk &chunk);
+    bool GetJob(Job &job, unsigned int iMillis);
+    bool IsCurrent(const Job &job);
+    void CompleteJob(const Job &job, unsigned int filled);
+
+    CStdString             m_path;
+    int64_t                m_length;
+    unsigned int           m_chunkSize;
+    int64_t                m_nextOffset; /**< offset of the next chunk to assign */
+    unsigned int           m_head;       /**< chunk Read() is currently consuming */
+    unsigned int           m_headPos;    /**< bytes of the head chunk already consumed */
+    std::vector<Chunk>     m_chunks;
+    std::vector<CReader*>  m_readers;
+    CCriticalSection       m_sync;
+    CEvent                 m_work;       /**< a chunk is waiting to be fetched */
+    CEvent                 m_done;       /**< a chunk has been fetched */
+  };
+
+}
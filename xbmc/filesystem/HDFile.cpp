@@ -30,16 +30,24 @@
 #include <sys/stat.h>
 #ifdef _LINUX
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #else
 #include <io.h>
 #include "utils/CharsetConverter.h"
 #include "utils/URIUtils.h"
 #endif
 #include "utils/log.h"
+#include "settings/AdvancedSettings.h"
 
 
 using namespace XFILE;
 
+#ifdef _LINUX
+#define HDFILE_MAP_MIN_SIZE  (4 * 1024 * 1024)  // smaller files are read with read()
+#define HDFILE_MAP_WINDOW    (32 * 1024 * 1024) // keeps the address space needed small on 32 bit
+#define HDFILE_MAP_READAHEAD (4 * 1024 * 1024)  // how far ahead of the read position to prefetch
+#endif
+
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
@@ -47,6 +55,13 @@ using namespace XFILE;
 //*********************************************************************************************
 CHDFile::CHDFile()
     : m_hFile(INVALID_HANDLE_VALUE)
+#ifdef _LINUX
+    , m_mapFile(false)
+    , m_map(NULL)
+    , m_mapStart(0)
+    , m_mapSize(0)
+    , m_mapAdvised(0)
+#endif
 {}
 
 //*********************************************************************************************
@@ -101,6 +116,10 @@ bool CHDFile::Open(const CURL& url)
   m_i64FilePos = 0;
   m_i64FileLen = 0;
 
+#ifdef _LINUX
+  m_mapFile = g_advancedSettings.m_memoryMapLocalFiles && GetLength() >= HDFILE_MAP_MIN_SIZE;
+#endif
+
   return true;
 }
 
@@ -203,6 +222,35 @@ bool CHDFile::OpenForWrite(const CURL& url, bool bOverWrite)
 unsigned int CHDFile::Read(void *lpBuf, int64_t uiBufSize)
 {
   if (!m_hFile.isValid()) return 0;
+#ifdef _LINUX
+  if (m_mapFile)
+  {
+    if (m_map == NULL || m_i64FilePos < m_mapStart || m_i64FilePos >= m_mapStart + (int64_t)m_mapSize)
+    {
+      if (m_i64FilePos >= GetLength())
+        return 0;
+
+      if (!MapWindow(m_i64FilePos))
+      {
+        CLog::Log(LOGWARNING, "CHDFile::Read - failed to map file, falling back to read (%d)", errno);
+        m_mapFile = false;
+        Seek(m_i64FilePos, SEEK_SET);
+      }
+    }
+
+    /* there is no ioctl handing out a pointer into the mapping, every
+       caller (ffmpeg's AVIO read callback included) reads into a buffer
+       of its own, so this copy is the only one either way */
+    if (m_mapFile)
+    {
+      unsigned int nBytesRead = (unsigned int)std::min(uiBufSize, m_mapStart + (int64_t)m_mapSize - m_i64FilePos);
+      memcpy(lpBuf, m_map + (m_i64FilePos - m_mapStart), nBytesRead);
+      m_i64FilePos += nBytesRead;
+      AdviseReadAhead();
+      return nBytesRead;
+    }
+  }
+#endif
   DWORD nBytesRead;
   if ( ReadFile((HANDLE)m_hFile, lpBuf, (DWORD)uiBufSize, &nBytesRead, NULL) )
   {
@@ -228,12 +276,41 @@ int CHDFile::Write(const void *lpBuf, int64_t uiBufSize)
 //*********************************************************************************************
 void CHDFile::Close()
 {
+#ifdef _LINUX
+  UnmapWindow();
+  m_mapFile = false;
+#endif
   m_hFile.reset();
 }
 
 //*********************************************************************************************
 int64_t CHDFile::Seek(int64_t iFilePosition, int iWhence)
 {
+#ifdef _LINUX
+  // reads come from the mapping, so there's no file pointer to move
+  if (m_mapFile)
+  {
+    int64_t iNewPos = iFilePosition;
+    if (iWhence == SEEK_CUR)
+      iNewPos += m_i64FilePos;
+    else if (iWhence == SEEK_END)
+      iNewPos += GetLength();
+    else if (iWhence != SEEK_SET)
+      return -1;
+
+    if (iNewPos < 0)
+      return -1;
+
+    m_i64FilePos = iNewPos;
+    if (m_map && m_i64FilePos >= m_mapStart && m_i64FilePos < m_mapStart + (int64_t)m_mapSize)
+    {
+      m_mapAdvised = m_i64FilePos;
+      AdviseReadAhead();
+    }
+    return m_i64FilePos;
+  }
+#endif
+
   LARGE_INTEGER lPos, lNewPos;
   lPos.QuadPart = iFilePosition;
   int bSuccess;
@@ -330,6 +407,56 @@ int CHDFile::IoControl(EIoControl request, void* param)
   return -1;
 }
 
+#ifdef _LINUX
+bool CHDFile::MapWindow(int64_t iFilePosition)
+{
+  UnmapWindow();
+
+  // mappings have to start on a page boundary
+  int64_t page  = sysconf(_SC_PAGESIZE);
+  int64_t start = iFilePosition - iFilePosition % page;
+  size_t  size  = (size_t)std::min((int64_t)HDFILE_MAP_WINDOW, GetLength() - start);
+
+  void *map = mmap(NULL, size, PROT_READ, MAP_SHARED, (*m_hFile).fd, start);
+  if (map == MAP_FAILED)
+    return false;
+
+  // let the kernel read ahead aggressively and drop pages behind us
+  madvise(map, size, MADV_SEQUENTIAL);
+
+  m_map        = (uint8_t*)map;
+  m_mapStart   = start;
+  m_mapSize    = size;
+  m_mapAdvised = iFilePosition;
+  AdviseReadAhead();
+  return true;
+}
+
+void CHDFile::UnmapWindow()
+{
+  if (m_map)
+    munmap(m_map, m_mapSize);
+  m_map     = NULL;
+  m_mapSize = 0;
+}
+
+void CHDFile::AdviseReadAhead()
+{
+  int64_t end = std::min(m_i64FilePos + HDFILE_MAP_READAHEAD, m_mapStart + (int64_t)m_mapSize);
+
+  // only ask again once half of what was requested has been read
+  if (m_mapAdvised >= end - HDFILE_MAP_READAHEAD / 2)
+    return;
+
+  int64_t page  = sysconf(_SC_PAGESIZE);
+  int64_t start = std::max(m_mapAdvised, m_i64FilePos);
+  start -= (start - m_mapStart) % page;
+
+  madvise(m_map + (start - m_mapStart), (size_t)(end - start), MADV_WILLNEED);
+  m_mapAdvised = end;
+}
+#endif
+
 int CHDFile::Truncate(int64_t size)
 {
 #ifdef _WIN32
@@ -64,6 +64,17 @@ protected:
   AUTOPTR::CAutoPtrHandle m_hFile;
   int64_t m_i64FilePos;
   int64_t m_i64FileLen;
+#ifdef _LINUX
+  bool MapWindow(int64_t iFilePosition);
+  void UnmapWindow();
+  void AdviseReadAhead();
+
+  bool     m_mapFile;    /* read through a memory mapped window instead of read() */
+  uint8_t* m_map;        /* the currently mapped window */
+  int64_t  m_mapStart;   /* file position of the start of the window */
+  size_t   m_mapSize;
+  int64_t  m_mapAdvised; /* file position read ahead has been requested up to */
+#endif
 };
 
 }
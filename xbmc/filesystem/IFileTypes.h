@@ -20,6 +20,9 @@
  */
 #pragma once
 
+#include <stdint.h>
+#include <vector>
+
 namespace XFILE
 {
 
@@ -37,12 +40,27 @@ struct SCacheStatus
   bool     full;     /**< is the cache full */
 };
 
+struct SCacheSegment
+{
+  int64_t  start;    /**< file position of the first byte held in the segment */
+  int64_t  end;      /**< file position one past the last byte held in the segment */
+  unsigned hits;     /**< number of seeks served from this segment */
+};
+
+struct SCacheSegmentStatus
+{
+  unsigned hits;     /**< number of seeks served from cached data */
+  unsigned misses;   /**< number of seeks that required the source to be repositioned */
+  std::vector<SCacheSegment> segments; /**< ranges of the file currently held in the cache */
+};
+
 typedef enum {
   IOCTRL_NATIVE        = 1, /**< SNativeIoControl structure, containing what should be passed to native ioctrl */
   IOCTRL_SEEK_POSSIBLE = 2, /**< return 0 if known not to work, 1 if it should work */
   IOCTRL_CACHE_STATUS  = 3, /**< SCacheStatus structure */
   IOCTRL_CACHE_SETRATE = 4, /**< unsigned int with speed limit for caching in bytes per second */
   IOCTRL_SET_CACHE    = 8, /** <CFileCache */
+  IOCTRL_CACHE_SEGMENTS = 9, /**< SCacheSegmentStatus structure, only supported by segmented caches */
 } EIoControl;
 
 }
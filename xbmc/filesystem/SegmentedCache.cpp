@@ -0,0 +1,363 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/SystemClock.h"
+#include "system.h"
+#include "SegmentedCache.h"
+#ifdef _LINUX
+#include "PlatformInclude.h"
+#endif
+#include "Util.h"
+#include "utils/log.h"
+#include "threads/SingleLock.h"
+#include "SpecialProtocol.h"
+#ifdef _WIN32
+#include "PlatformDefs.h" //for PRIdS, PRId64
+#endif
+
+using namespace XFILE;
+
+CSegmentedFileCache::CSegmentedFileCache()
+ : CCacheStrategy()
+ , m_hCacheFileRead(NULL)
+ , m_hCacheFileWrite(NULL)
+ , m_nWritePosition(0)
+ , m_nReadPosition(0)
+ , m_hits(0)
+ , m_misses(0)
+{
+}
+
+CSegmentedFileCache::~CSegmentedFileCache()
+{
+  Close();
+}
+
+int CSegmentedFileCache::Open()
+{
+  Close();
+
+  CStdString fileName = CSpecialProtocol::TranslatePath(CUtil::GetNextFilename("special://temp/filecache%03d.cache", 999));
+  if(fileName.empty())
+  {
+    CLog::Log(LOGERROR, "%s - Unable to generate a new filename", __FUNCTION__);
+    Close();
+    return CACHE_RC_ERROR;
+  }
+
+  m_hCacheFileWrite = CreateFile(fileName.c_str()
+            , GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE
+            , NULL
+            , CREATE_ALWAYS
+            , FILE_ATTRIBUTE_NORMAL
+            , NULL);
+
+  if(m_hCacheFileWrite == INVALID_HANDLE_VALUE)
+  {
+    CLog::Log(LOGERROR, "%s - failed to create file %s with error code %d", __FUNCTION__, fileName.c_str(), GetLastError());
+    Close();
+    return CACHE_RC_ERROR;
+  }
+
+  m_hCacheFileRead = CreateFile(fileName.c_str()
+            , GENERIC_READ, FILE_SHARE_WRITE
+            , NULL
+            , OPEN_EXISTING
+            , FILE_ATTRIBUTE_NORMAL | FILE_FLAG_DELETE_ON_CLOSE
+            , NULL);
+
+  if(m_hCacheFileRead == INVALID_HANDLE_VALUE)
+  {
+    CLog::Log(LOGERROR, "%s - failed to open file %s with error code %d", __FUNCTION__, fileName.c_str(), GetLastError());
+    Close();
+    return CACHE_RC_ERROR;
+  }
+
+  CSingleLock lock(m_sync);
+  m_segments.clear();
+  m_nWritePosition = 0;
+  m_nReadPosition = 0;
+  m_hits = 0;
+  m_misses = 0;
+
+  return CACHE_RC_OK;
+}
+
+void CSegmentedFileCache::Close()
+{
+  if (m_hCacheFileWrite && m_hCacheFileWrite != INVALID_HANDLE_VALUE)
+    CloseHandle(m_hCacheFileWrite);
+
+  m_hCacheFileWrite = NULL;
+
+  if (m_hCacheFileRead && m_hCacheFileRead != INVALID_HANDLE_VALUE)
+    CloseHandle(m_hCacheFileRead);
+
+  m_hCacheFileRead = NULL;
+
+  CSingleLock lock(m_sync);
+  if (!m_segments.empty())
+    CLog::Log(LOGDEBUG, "CSegmentedFileCache::Close - %"PRIdS" segments, %u seeks served from cache, %u missed", m_segments.size(), m_hits, m_misses);
+  m_segments.clear();
+}
+
+/**
+ * Returns the segment holding iFilePosition, including the position
+ * directly after its last byte, or m_segments.end() if there is none.
+ */
+CSegmentedFileCache::SegmentMap::iterator CSegmentedFileCache::FindSegment(int64_t iFilePosition)
+{
+  SegmentMap::iterator it = m_segments.upper_bound(iFilePosition);
+  if (it == m_segments.begin())
+    return m_segments.end();
+
+  --it;
+  if (iFilePosition > it->second.end)
+    return m_segments.end();
+
+  return it;
+}
+
+/**
+ * Marks [iStart, iEnd) as cached, extending the segment it continues
+ * and merging any segments the new range runs into.
+ */
+void CSegmentedFileCache::AddRange(int64_t iStart, int64_t iEnd)
+{
+  SegmentMap::iterator it = FindSegment(iStart);
+  if (it == m_segments.end())
+  {
+    Segment segment;
+    segment.end  = iEnd;
+    segment.hits = 0;
+    it = m_segments.insert(std::make_pair(iStart, segment)).first;
+  }
+  else if (iEnd > it->second.end)
+    it->second.end = iEnd;
+
+  SegmentMap::iterator next = it;
+  ++next;
+  while (next != m_segments.end() && next->first <= it->second.end)
+  {
+    it->second.end   = std::max(it->second.end, next->second.end);
+    it->second.hits += next->second.hits;
+    m_segments.erase(next++);
+  }
+}
+
+int CSegmentedFileCache::WriteToCache(const char *pBuffer, size_t iSize)
+{
+  DWORD iWritten=0;
+  if (!WriteFile(m_hCacheFileWrite, pBuffer, iSize, &iWritten, NULL))
+  {
+    CLog::Log(LOGERROR, "%s - failed to write to file. err: %u",
+                          __FUNCTION__, GetLastError());
+    return CACHE_RC_ERROR;
+  }
+
+  CSingleLock lock(m_sync);
+  AddRange(m_nWritePosition, m_nWritePosition + iWritten);
+  m_nWritePosition += iWritten;
+
+  // when reader waits for data it will wait on the event.
+  m_written.Set();
+
+  return iWritten;
+}
+
+int64_t CSegmentedFileCache::GetAvailableRead()
+{
+  SegmentMap::iterator it = FindSegment(m_nReadPosition);
+  if (it == m_segments.end())
+    return 0;
+
+  return it->second.end - m_nReadPosition;
+}
+
+/**
+ * Returns true if the data following the read position is being written,
+ * ie. if the reader and the writer are in the same segment.
+ */
+bool CSegmentedFileCache::IsFillingReadPosition()
+{
+  if (m_nReadPosition == m_nWritePosition)
+    return true;
+
+  SegmentMap::iterator it = FindSegment(m_nReadPosition);
+  return it != m_segments.end() && it == FindSegment(m_nWritePosition);
+}
+
+int CSegmentedFileCache::ReadFromCache(char *pBuffer, size_t iMaxSize)
+{
+  CSingleLock lock(m_sync);
+
+  int64_t iAvailable = GetAvailableRead();
+  if ( iAvailable <= 0 )
+  {
+    if (!IsFillingReadPosition())
+      return CACHE_RC_NOT_CACHED;
+
+    return m_bEndOfInput? 0 : CACHE_RC_WOULD_BLOCK;
+  }
+
+  // the segment may only grow, so the file can be read without holding the lock
+  lock.Leave();
+
+  if (iMaxSize > (size_t)iAvailable)
+    iMaxSize = (size_t)iAvailable;
+
+  DWORD iRead = 0;
+  if (!ReadFile(m_hCacheFileRead, pBuffer, iMaxSize, &iRead, NULL)) {
+    CLog::Log(LOGERROR,"CSegmentedFileCache::ReadFromCache - failed to read %"PRIdS" bytes.", iMaxSize);
+    return CACHE_RC_ERROR;
+  }
+
+  lock.Enter();
+  m_nReadPosition += iRead;
+
+  if (iRead > 0)
+    m_space.Set();
+
+  return iRead;
+}
+
+int64_t CSegmentedFileCache::WaitForData(unsigned int iMinAvail, unsigned int iMillis)
+{
+  CSingleLock lock(m_sync);
+  int64_t iAvail = GetAvailableRead();
+
+  // no point in waiting when nobody is writing at our position
+  if (iMillis == 0 || IsEndOfInput() || !IsFillingReadPosition())
+    return iAvail;
+
+  XbmcThreads::EndTime endTime(iMillis);
+  while (!IsEndOfInput() && iAvail < iMinAvail && !endTime.IsTimePast())
+  {
+    lock.Leave();
+    m_written.WaitMSec(50); // may miss the deadline. shouldn't be a problem.
+    lock.Enter();
+    iAvail = GetAvailableRead();
+  }
+
+  if (iAvail >= iMinAvail || IsEndOfInput())
+    return iAvail;
+
+  return CACHE_RC_TIMEOUT;
+}
+
+int64_t CSegmentedFileCache::Seek(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+
+  // if seek is a bit over what is being written, try to wait a few seconds for the data to be available.
+  // we try to avoid a (heavy) seek on the source
+  if (iFilePosition > m_nWritePosition && iFilePosition < m_nWritePosition + 100000)
+  {
+    XbmcThreads::EndTime endTime(5000);
+    while (!IsEndOfInput() && m_nWritePosition < iFilePosition && !endTime.IsTimePast())
+    {
+      lock.Leave();
+      m_written.WaitMSec(50);
+      lock.Enter();
+    }
+  }
+
+  SegmentMap::iterator it = FindSegment(iFilePosition);
+  if (it == m_segments.end() && iFilePosition != m_nWritePosition)
+  {
+    CLog::Log(LOGDEBUG,"CSegmentedFileCache::Seek - position %"PRId64" not cached", iFilePosition);
+    m_misses++;
+    return CACHE_RC_ERROR;
+  }
+
+  LARGE_INTEGER pos;
+  pos.QuadPart = iFilePosition;
+
+  if(!SetFilePointerEx(m_hCacheFileRead, pos, NULL, FILE_BEGIN))
+    return CACHE_RC_ERROR;
+
+  // only count seeks that land on data already fetched
+  if (it != m_segments.end() && iFilePosition < it->second.end)
+  {
+    it->second.hits++;
+    m_hits++;
+  }
+
+  m_nReadPosition = iFilePosition;
+  m_space.Set();
+
+  return iFilePosition;
+}
+
+void CSegmentedFileCache::Reset(int64_t iSourcePosition)
+{
+  LARGE_INTEGER pos;
+  pos.QuadPart = iSourcePosition;
+
+  // cached segments are kept, only the positions move
+  CSingleLock lock(m_sync);
+  SetFilePointerEx(m_hCacheFileWrite, pos, NULL, FILE_BEGIN);
+  SetFilePointerEx(m_hCacheFileRead, pos, NULL, FILE_BEGIN);
+  m_nWritePosition = iSourcePosition;
+  m_nReadPosition = iSourcePosition;
+}
+
+void CSegmentedFileCache::EndOfInput()
+{
+  CCacheStrategy::EndOfInput();
+  m_written.Set();
+}
+
+int64_t CSegmentedFileCache::CachedDataEndPos(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+  SegmentMap::iterator it = FindSegment(iFilePosition);
+  if (it == m_segments.end())
+    return iFilePosition;
+
+  return std::max(iFilePosition, it->second.end);
+}
+
+void CSegmentedFileCache::SetWritePosition(int64_t iSourcePosition)
+{
+  LARGE_INTEGER pos;
+  pos.QuadPart = iSourcePosition;
+
+  CSingleLock lock(m_sync);
+  SetFilePointerEx(m_hCacheFileWrite, pos, NULL, FILE_BEGIN);
+  m_nWritePosition = iSourcePosition;
+}
+
+bool CSegmentedFileCache::GetSegmentStatus(SCacheSegmentStatus *status)
+{
+  CSingleLock lock(m_sync);
+  status->hits   = m_hits;
+  status->misses = m_misses;
+  status->segments.clear();
+  for (SegmentMap::const_iterator it = m_segments.begin(); it != m_segments.end(); ++it)
+  {
+    SCacheSegment segment;
+    segment.start = it->first;
+    segment.end   = it->second.end;
+    segment.hits  = it->second.hits;
+    status->segments.push_back(segment);
+  }
+  return true;
+}
@@ -0,0 +1,86 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef CACHESEGMENTED_H
+#define CACHESEGMENTED_H
+
+#include <map>
+
+#include "CacheStrategy.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+
+namespace XFILE {
+
+/**
+ * File backed cache that keeps every range of the source that has been read.
+ *
+ * Data is written to a (sparse) temporary file at its offset in the source, and
+ * the ranges held are tracked as independent segments. Seeking into any cached
+ * segment is served from the cache, so jumping back and forth in a file only
+ * hits the source for data that was never fetched.
+ */
+class CSegmentedFileCache : public CCacheStrategy
+{
+public:
+  CSegmentedFileCache();
+  virtual ~CSegmentedFileCache();
+
+  virtual int Open();
+  virtual void Close();
+
+  virtual int WriteToCache(const char *pBuffer, size_t iSize);
+  virtual int ReadFromCache(char *pBuffer, size_t iMaxSize);
+  virtual int64_t WaitForData(unsigned int iMinAvail, unsigned int iMillis);
+
+  virtual int64_t Seek(int64_t iFilePosition);
+  virtual void Reset(int64_t iSourcePosition);
+  virtual void EndOfInput();
+
+  virtual int64_t CachedDataEndPos(int64_t iFilePosition);
+  virtual void SetWritePosition(int64_t iSourcePosition);
+  virtual bool GetSegmentStatus(SCacheSegmentStatus *status);
+
+protected:
+  struct Segment
+  {
+    int64_t  end;
+    unsigned hits;
+  };
+  typedef std::map<int64_t, Segment> SegmentMap; /**< segments keyed by their start position */
+
+  SegmentMap::iterator FindSegment(int64_t iFilePosition);
+  void AddRange(int64_t iStart, int64_t iEnd);
+  int64_t GetAvailableRead();
+  bool IsFillingReadPosition();
+
+  HANDLE            m_hCacheFileRead;
+  HANDLE            m_hCacheFileWrite;
+  SegmentMap        m_segments;
+  int64_t           m_nWritePosition; /**< file position the next write lands at */
+  int64_t           m_nReadPosition;  /**< file position the next read starts at */
+  unsigned          m_hits;
+  unsigned          m_misses;
+  CCriticalSection  m_sync;
+  CEvent            m_written;
+};
+
+} // namespace XFILE
+#endif
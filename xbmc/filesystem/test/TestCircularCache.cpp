@@ -0,0 +1,56 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/CircularCache.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestCircularCache, WriteBuffer)
+{
+  XFILE::CCircularCache cache(1000, 100);
+  char buf[1000];
+  char *lent = NULL;
+
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  // nothing is readable until the lent memory is committed
+  ASSERT_EQ(600, cache.GetWriteBuffer(&lent, 600));
+  memset(lent, 'a', 600);
+  EXPECT_EQ(CACHE_RC_WOULD_BLOCK, cache.ReadFromCache(buf, sizeof(buf)));
+  EXPECT_EQ(600, cache.CommitWriteBuffer(600));
+
+  // lending stops at the wrap point and at the free space
+  ASSERT_EQ(500, cache.GetWriteBuffer(&lent, 600));
+  memset(lent, 'b', 500);
+  EXPECT_EQ(500, cache.CommitWriteBuffer(500));
+  EXPECT_EQ(0, cache.GetWriteBuffer(&lent, 600));
+
+  EXPECT_EQ(1000, cache.ReadFromCache(buf, sizeof(buf)));
+  EXPECT_EQ('a', buf[0]);
+  EXPECT_EQ('a', buf[599]);
+  EXPECT_EQ('b', buf[600]);
+
+  // the back buffer is kept, the rest can be lent again
+  ASSERT_EQ(100, cache.ReadFromCache(buf, sizeof(buf)));
+  ASSERT_EQ(1000, cache.GetWriteBuffer(&lent, 1000));
+  EXPECT_EQ(1000, cache.Seek(1000));
+  EXPECT_EQ(CACHE_RC_ERROR, cache.Seek(0));
+  cache.Close();
+}
@@ -0,0 +1,162 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/DirectoryCache.h"
+#include "filesystem/Directory.h"
+#include "FileItem.h"
+#include "utils/URIUtils.h"
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+/* persists every smb path and reports the stamp it's told instead of
+   asking the network */
+class CTestDirectoryCache : public CDirectoryCache
+{
+public:
+  CTestDirectoryCache() : m_stamp(1000) { }
+
+  virtual bool CanPersist(const CStdString& storedPath) const
+  {
+    return URIUtils::IsSmb(storedPath);
+  }
+  virtual int64_t GetDirectoryStamp(const CStdString& strPath) const
+  {
+    return m_stamp;
+  }
+
+  int64_t m_stamp;
+};
+
+class TestDirectoryCache : public testing::Test
+{
+protected:
+  TestDirectoryCache()
+  {
+    CDirectory::Create("special://temp/dircache/");
+  }
+  ~TestDirectoryCache()
+  {
+    CTestDirectoryCache cache;
+    cache.ClearSubPaths("smb://server/share");
+  }
+
+  static void Listing(CFileItemList &items, const CStdString &path)
+  {
+    items.Clear();
+    for (int i = 0; i < 3; i++)
+    {
+      CStdString file;
+      file.Format("%sfile%d.mkv", path.c_str(), i);
+      items.Add(CFileItemPtr(new CFileItem(file, false)));
+    }
+  }
+
+  static bool IsSaved(const CStdString &path)
+  {
+    CTestDirectoryCache cache;
+    CFileItemList items;
+    return cache.GetPersistentDirectory(path, items);
+  }
+};
+
+TEST_F(TestDirectoryCache, Persist)
+{
+  CFileItemList items, restored;
+  Listing(items, "smb://server/share/movies/");
+
+  CTestDirectoryCache cache;
+  cache.SetPersistentDirectory("smb://server/share/movies/", items);
+
+  /* a new cache stands in for the next session */
+  CTestDirectoryCache next;
+  ASSERT_TRUE(next.GetPersistentDirectory("smb://server/share/movies", restored));
+  ASSERT_EQ(items.Size(), restored.Size());
+  for (int i = 0; i < items.Size(); i++)
+    EXPECT_STREQ(items[i]->GetPath().c_str(), restored[i]->GetPath().c_str());
+
+  /* only network paths are persisted */
+  cache.SetPersistentDirectory("/tmp/movies/", items);
+  EXPECT_FALSE(next.GetPersistentDirectory("/tmp/movies/", restored));
+}
+
+TEST_F(TestDirectoryCache, Stamp)
+{
+  CFileItemList items, restored;
+  Listing(items, "smb://server/share/tv/");
+
+  CTestDirectoryCache cache;
+  cache.SetPersistentDirectory("smb://server/share/tv/", items);
+
+  /* a directory that was modified since drops its saved listing for good */
+  CTestDirectoryCache next;
+  next.m_stamp = 2000;
+  EXPECT_FALSE(next.GetPersistentDirectory("smb://server/share/tv/", restored));
+  EXPECT_FALSE(IsSaved("smb://server/share/tv/"));
+
+  /* a directory modified just now may still change within the same second */
+  cache.m_stamp = time(NULL);
+  cache.SetPersistentDirectory("smb://server/share/tv/", items);
+  next.m_stamp = cache.m_stamp;
+  EXPECT_FALSE(next.GetPersistentDirectory("smb://server/share/tv/", restored));
+}
+
+TEST_F(TestDirectoryCache, ClearSubPaths)
+{
+  CFileItemList items;
+  const char *paths[] = {
+    "smb://server/share/foo/",
+    "smb://server/share/foo/bar/",
+    "smb://server/share/foobar/",
+  };
+
+  CTestDirectoryCache cache;
+  for (unsigned int i = 0; i < sizeof(paths) / sizeof(paths[0]); i++)
+  {
+    Listing(items, paths[i]);
+    cache.SetDirectory(paths[i], items, DIR_CACHE_ALWAYS);
+    cache.SetPersistentDirectory(paths[i], items);
+  }
+
+  cache.ClearSubPaths("smb://server/share/foo/");
+  EXPECT_FALSE(cache.GetDirectory("smb://server/share/foo/", items));
+  EXPECT_FALSE(cache.GetDirectory("smb://server/share/foo/bar/", items));
+  EXPECT_TRUE(cache.GetDirectory("smb://server/share/foobar/", items));
+  EXPECT_FALSE(IsSaved("smb://server/share/foo/"));
+  EXPECT_FALSE(IsSaved("smb://server/share/foo/bar/"));
+  EXPECT_TRUE(IsSaved("smb://server/share/foobar/"));
+}
+
+TEST_F(TestDirectoryCache, ClearSubPathsOfEarlierSession)
+{
+  CFileItemList items;
+  CTestDirectoryCache cache;
+  Listing(items, "smb://server/share/a/b/");
+  cache.SetPersistentDirectory("smb://server/share/a/b/", items);
+  Listing(items, "smb://server/share/ab/");
+  cache.SetPersistentDirectory("smb://server/share/ab/", items);
+
+  /* the next session only knows the listings from the disk */
+  CTestDirectoryCache next;
+  next.ClearSubPaths("smb://server/share/a");
+  EXPECT_FALSE(IsSaved("smb://server/share/a/b/"));
+  EXPECT_TRUE(IsSaved("smb://server/share/ab/"));
+}
@@ -0,0 +1,68 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/CircularCache.h"
+#include "filesystem/File.h"
+#include "filesystem/FileCache.h"
+#include "test/TestUtils.h"
+#include "URL.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+/* a strategy that lends its memory but only takes half of what was read
+   into it, the rest has to be written the normal way */
+class CPartialCommitCache : public XFILE::CCircularCache
+{
+public:
+  CPartialCommitCache() : CCircularCache(1024 * 1024, 256 * 1024) {}
+
+  virtual int CommitWriteBuffer(size_t len)
+  {
+    return CCircularCache::CommitWriteBuffer(len / 2);
+  }
+};
+
+template<class T> static std::string ReadAll(T &file)
+{
+  std::string data;
+  char buf[1024];
+  unsigned int read;
+  while ((read = file.Read(buf, sizeof(buf))) > 0)
+    data.append(buf, read);
+  return data;
+}
+
+TEST(TestFileCache, PartialCommit)
+{
+  CStdString path = XBMC_REF_FILE_PATH("/xbmc/filesystem/test/reffile.txt");
+
+  XFILE::CFile ref;
+  ASSERT_TRUE(ref.Open(path));
+  std::string expected = ReadAll(ref);
+  ref.Close();
+  ASSERT_FALSE(expected.empty());
+
+  XFILE::CFileCache cache(new CPartialCommitCache);
+  ASSERT_TRUE(cache.Open(CURL(path)));
+  EXPECT_EQ(expected, ReadAll(cache));
+  cache.Close();
+}
@@ -0,0 +1,62 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/File.h"
+#include "filesystem/FileCacheReadAhead.h"
+#include "filesystem/CacheStrategy.h"
+#include "test/TestUtils.h"
+
+#include "gtest/gtest.h"
+
+static std::string ReadAll(XFILE::CFileCacheReadAhead &readAhead)
+{
+  std::string data;
+  char buf[100];
+  int read;
+  while ((read = readAhead.Read(buf, sizeof(buf), 5000)) > 0)
+    data.append(buf, read);
+  EXPECT_EQ(0, read);
+  return data;
+}
+
+TEST(TestFileCacheReadAhead, IsSupported)
+{
+  EXPECT_TRUE(XFILE::CFileCacheReadAhead::IsSupported("http://server/movie.mkv"));
+  EXPECT_TRUE(XFILE::CFileCacheReadAhead::IsSupported("davs://server/movie.mkv"));
+  EXPECT_FALSE(XFILE::CFileCacheReadAhead::IsSupported("smb://server/movie.mkv"));
+  EXPECT_FALSE(XFILE::CFileCacheReadAhead::IsSupported("/home/user/movie.mkv"));
+}
+
+TEST(TestFileCacheReadAhead, ReadInOrder)
+{
+  CStdString path = XBMC_REF_FILE_PATH("/xbmc/filesystem/test/reffile.txt");
+  XFILE::CFile file;
+  ASSERT_TRUE(file.Open(path));
+  std::string reference(file.GetLength(), '\0');
+  ASSERT_EQ(reference.size(), file.Read(&reference[0], reference.size()));
+  file.Close();
+
+  // small chunks so every reader fetches several ranges
+  XFILE::CFileCacheReadAhead readAhead(path, reference.size(), 4, 64);
+  EXPECT_TRUE(reference == ReadAll(readAhead));
+
+  EXPECT_EQ(1000, readAhead.Seek(1000));
+  EXPECT_TRUE(reference.substr(1000) == ReadAll(readAhead));
+}
@@ -0,0 +1,83 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/File.h"
+#include "filesystem/HDFile.h"
+#include "settings/AdvancedSettings.h"
+#include "test/TestUtils.h"
+#include "URL.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+TEST(TestHDFile, MemoryMapped)
+{
+  /* large enough to be mapped, and to need more than one mapped window */
+  const unsigned int size = 40 * 1024 * 1024;
+  std::vector<uint8_t> data(size);
+  for (unsigned int i = 0; i < size; i++)
+    data[i] = (uint8_t)(i * 13 + (i >> 16));
+
+  XFILE::CFile *file;
+  ASSERT_TRUE((file = XBMC_CREATETEMPFILE("")) != NULL);
+  file->Close();
+  ASSERT_TRUE(file->OpenForWrite(XBMC_TEMPFILEPATH(file), true));
+  EXPECT_EQ((int)size, file->Write(&data[0], size));
+  file->Close();
+
+  /* the mapping is decided on open */
+  bool memoryMap = g_advancedSettings.m_memoryMapLocalFiles;
+  g_advancedSettings.m_memoryMapLocalFiles = true;
+  XFILE::CHDFile hd;
+  bool opened = hd.Open(CURL(XBMC_TEMPFILEPATH(file)));
+  g_advancedSettings.m_memoryMapLocalFiles = memoryMap;
+  ASSERT_TRUE(opened);
+  EXPECT_EQ((int64_t)size, hd.GetLength());
+
+  /* an odd read size so reads straddle the ends of the windows */
+  std::vector<uint8_t> buf(size);
+  unsigned int pos = 0;
+  while (pos < size)
+  {
+    unsigned int read = hd.Read(&buf[pos], std::min(size - pos, 777777U));
+    if (read == 0)
+      break;
+    pos += read;
+  }
+  EXPECT_EQ(size, pos);
+  EXPECT_TRUE(memcmp(&data[0], &buf[0], size) == 0);
+
+  /* back into the first window, then up to the end */
+  uint8_t small[4096];
+  EXPECT_EQ(1000, hd.Seek(1000, SEEK_SET));
+  EXPECT_EQ(sizeof(small), hd.Read(small, sizeof(small)));
+  EXPECT_TRUE(memcmp(&data[1000], small, sizeof(small)) == 0);
+
+  EXPECT_EQ((int64_t)size - 10, hd.Seek(-10, SEEK_END));
+  EXPECT_EQ(10U, hd.Read(small, sizeof(small)));
+  EXPECT_TRUE(memcmp(&data[size - 10], small, 10) == 0);
+  EXPECT_EQ(0U, hd.Read(small, sizeof(small)));
+
+  hd.Close();
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
@@ -0,0 +1,105 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/SegmentedCache.h"
+
+#include "gtest/gtest.h"
+
+static void FillCache(XFILE::CSegmentedFileCache &cache, int64_t start, int size)
+{
+  char buf[1024];
+  cache.SetWritePosition(start);
+  for (int i = 0; i < size; i++)
+    buf[i] = (char)((start + i) & 0xff);
+  ASSERT_EQ(size, cache.WriteToCache(buf, size));
+}
+
+TEST(TestSegmentedCache, SeekIntoCachedSegments)
+{
+  XFILE::CSegmentedFileCache cache;
+  XFILE::SCacheSegmentStatus status;
+  char buf[1024];
+
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+  FillCache(cache, 0, 1000);
+  FillCache(cache, 5000, 1000);
+
+  EXPECT_TRUE(cache.GetSegmentStatus(&status));
+  ASSERT_EQ(2U, status.segments.size());
+  EXPECT_EQ(0, status.segments[0].start);
+  EXPECT_EQ(1000, status.segments[0].end);
+  EXPECT_EQ(5000, status.segments[1].start);
+  EXPECT_EQ(6000, status.segments[1].end);
+
+  EXPECT_EQ(5500, cache.Seek(5500));
+  EXPECT_EQ(500, cache.ReadFromCache(buf, sizeof(buf)));
+  EXPECT_EQ((char)(5500 & 0xff), buf[0]);
+  EXPECT_EQ((char)(5999 & 0xff), buf[499]);
+
+  EXPECT_EQ(100, cache.Seek(100));
+  EXPECT_EQ(900, cache.ReadFromCache(buf, sizeof(buf)));
+  EXPECT_EQ((char)100, buf[0]);
+
+  // the end of a segment the source is not filling needs a refill
+  EXPECT_EQ(CACHE_RC_NOT_CACHED, cache.ReadFromCache(buf, sizeof(buf)));
+  EXPECT_EQ(CACHE_RC_ERROR, cache.Seek(3000));
+
+  EXPECT_TRUE(cache.GetSegmentStatus(&status));
+  EXPECT_EQ(2U, status.hits);
+  EXPECT_EQ(1U, status.misses);
+  EXPECT_EQ(1U, status.segments[0].hits);
+  EXPECT_EQ(1U, status.segments[1].hits);
+  cache.Close();
+}
+
+TEST(TestSegmentedCache, MergeSegments)
+{
+  XFILE::CSegmentedFileCache cache;
+  XFILE::SCacheSegmentStatus status;
+
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+  FillCache(cache, 1000, 1000);
+  FillCache(cache, 0, 1000);
+  EXPECT_EQ(2000, cache.CachedDataEndPos(1000));
+  EXPECT_EQ(2000, cache.CachedDataEndPos(500));
+  EXPECT_EQ(3000, cache.CachedDataEndPos(3000));
+
+  EXPECT_TRUE(cache.GetSegmentStatus(&status));
+  ASSERT_EQ(1U, status.segments.size());
+  EXPECT_EQ(0, status.segments[0].start);
+  EXPECT_EQ(2000, status.segments[0].end);
+  cache.Close();
+}
+
+TEST(TestSegmentedCache, EndOfInput)
+{
+  XFILE::CSegmentedFileCache cache;
+  char buf[1024];
+
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+  cache.Reset(0);
+  FillCache(cache, 0, 100);
+  EXPECT_EQ(CACHE_RC_TIMEOUT, cache.WaitForData(200, 100));
+  cache.EndOfInput();
+  EXPECT_EQ(100, cache.WaitForData(200, 100));
+  EXPECT_EQ(100, cache.ReadFromCache(buf, sizeof(buf)));
+  EXPECT_EQ(0, cache.ReadFromCache(buf, sizeof(buf)));
+  cache.Close();
+}
@@ -20,6 +20,7 @@
 
 #include "AnnouncementManager.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include <stdio.h>
 #include "utils/log.h"
 #include "utils/Variant.h"
@@ -36,16 +37,27 @@
 using namespace std;
 using namespace ANNOUNCEMENT;
 
-#define m_announcers XBMC_GLOBAL_USE(ANNOUNCEMENT::CAnnouncementManager::Globals).m_announcers
+#define ANNOUNCEMENT_QUEUE_SIZE   256
+#define ANNOUNCEMENT_FLUSH_TIMEOUT 5000
+
+#define m_queues XBMC_GLOBAL_USE(ANNOUNCEMENT::CAnnouncementManager::Globals).m_queues
+#define m_retired XBMC_GLOBAL_USE(ANNOUNCEMENT::CAnnouncementManager::Globals).m_retired
 #define m_critSection XBMC_GLOBAL_USE(ANNOUNCEMENT::CAnnouncementManager::Globals).m_critSection
+#define m_flushSection XBMC_GLOBAL_USE(ANNOUNCEMENT::CAnnouncementManager::Globals).m_flushSection
 
 void CAnnouncementManager::AddAnnouncer(IAnnouncer *listener)
 {
   if (!listener)
     return;
 
+  ReapRetired();
+
+  // the queue starts its thread with the first announcement, announcers
+  // are also added from static constructors
+  CAnnouncerQueue *queue = new CAnnouncerQueue(listener, ANNOUNCEMENT_QUEUE_SIZE);
+
   CSingleLock lock (m_critSection);
-  m_announcers.push_back(listener);
+  m_queues.push_back(queue);
 }
 
 void CAnnouncementManager::RemoveAnnouncer(IAnnouncer *listener)
@@ -53,15 +65,44 @@ void CAnnouncementManager::RemoveAnnouncer(IAnnouncer *listener)
   if (!listener)
     return;
 
-  CSingleLock lock (m_critSection);
-  for (unsigned int i = 0; i < m_announcers.size(); i++)
+  CAnnouncerQueue *queue = NULL;
   {
-    if (m_announcers[i] == listener)
+    CSingleLock lock (m_critSection);
+    for (unsigned int i = 0; i < m_queues.size(); i++)
     {
-      m_announcers.erase(m_announcers.begin() + i);
-      return;
+      if (m_queues[i]->GetAnnouncer() == listener)
+      {
+        queue = m_queues[i];
+        m_queues.erase(m_queues.begin() + i);
+        break;
+      }
     }
   }
+
+  if (!queue)
+    return;
+
+  // an announcer removing itself while handling an announcement can't wait
+  // for its own thread, so the queue is deleted later on
+  if (queue->IsCurrentThread())
+  {
+    queue->StopThread(false);
+
+    CSingleLock lock (m_critSection);
+    m_retired.push_back(queue);
+    return;
+  }
+
+  // once this returns the announcer must not be called anymore. the thread
+  // is joined without holding any lock as the announcer may be waiting for
+  // one, a flush in progress returns as soon as the thread has stopped
+  queue->StopThread();
+
+  CSingleLock lock (m_flushSection);
+  delete queue;
+  lock.Leave();
+
+  ReapRetired();
 }
 
 void CAnnouncementManager::Announce(AnnouncementFlag flag, const char *sender, const char *message)
@@ -73,9 +114,74 @@ void CAnnouncementManager::Announce(AnnouncementFlag flag, const char *sender, c
 void CAnnouncementManager::Announce(AnnouncementFlag flag, const char *sender, const char *message, CVariant &data)
 {
   CLog::Log(LOGDEBUG, "CAnnouncementManager - Announcement: %s from %s", message, sender);
+
+  if (flag != System)
+  {
+    CSingleLock lock (m_critSection);
+    for (unsigned int i = 0; i < m_queues.size(); i++)
+      m_queues[i]->Push(flag, sender, message, data);
+
+    return;
+  }
+
+  // system announcements (like OnQuit or OnSleep) usually precede a state in
+  // which announcers won't get to handle them anymore, so wait for them here
+  CSingleLock flushLock (m_flushSection);
+  vector<CAnnouncerQueue *> queues;
+  {
+    CSingleLock lock (m_critSection);
+    for (unsigned int i = 0; i < m_queues.size(); i++)
+      m_queues[i]->Push(flag, sender, message, data);
+
+    queues = m_queues;
+  }
+
+  XbmcThreads::EndTime timeout(ANNOUNCEMENT_FLUSH_TIMEOUT);
+  for (unsigned int i = 0; i < queues.size(); i++)
+  {
+    if (!queues[i]->Flush(timeout.MillisLeft()))
+      CLog::Log(LOGWARNING, "CAnnouncementManager - %s from %s has not been handled by all announcers in time", message, sender);
+  }
+}
+
+bool CAnnouncementManager::GetStatistics(IAnnouncer *listener, AnnouncerStatistics &statistics)
+{
   CSingleLock lock (m_critSection);
-  for (unsigned int i = 0; i < m_announcers.size(); i++)
-    m_announcers[i]->Announce(flag, sender, message, data);
+  for (unsigned int i = 0; i < m_queues.size(); i++)
+  {
+    if (m_queues[i]->GetAnnouncer() == listener)
+    {
+      m_queues[i]->GetStatistics(statistics);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void CAnnouncementManager::ReapRetired()
+{
+  vector<CAnnouncerQueue *> retired;
+  {
+    CSingleLock lock (m_critSection);
+    for (vector<CAnnouncerQueue *>::iterator it = m_retired.begin(); it != m_retired.end(); )
+    {
+      if ((*it)->IsCurrentThread())
+        ++it;
+      else
+      {
+        retired.push_back(*it);
+        it = m_retired.erase(it);
+      }
+    }
+  }
+
+  if (retired.empty())
+    return;
+
+  CSingleLock lock (m_flushSection);
+  for (unsigned int i = 0; i < retired.size(); i++)
+    delete retired[i];
 }
 
 void CAnnouncementManager::Announce(AnnouncementFlag flag, const char *sender, const char *message, CFileItemPtr item)
@@ -20,6 +20,7 @@
  */
 
 #include "IAnnouncer.h"
+#include "AnnouncerQueue.h"
 #include "FileItem.h"
 #include "threads/CriticalSection.h"
 #include "utils/GlobalsHandling.h"
@@ -35,7 +36,9 @@ namespace ANNOUNCEMENT
      {
      public:
        CCriticalSection m_critSection;
-       std::vector<IAnnouncer *> m_announcers;
+       CCriticalSection m_flushSection;
+       std::vector<CAnnouncerQueue *> m_queues;
+       std::vector<CAnnouncerQueue *> m_retired;
      };
 
     static void AddAnnouncer(IAnnouncer *listener);
@@ -44,7 +47,14 @@ namespace ANNOUNCEMENT
     static void Announce(AnnouncementFlag flag, const char *sender, const char *message, CVariant &data);
     static void Announce(AnnouncementFlag flag, const char *sender, const char *message, CFileItemPtr item);
     static void Announce(AnnouncementFlag flag, const char *sender, const char *message, CFileItemPtr item, CVariant &data);
+
+    /*!
+     \brief Retrieves how the announcements for the given announcer have been handled so far
+     \return False if the announcer is unknown
+     */
+    static bool GetStatistics(IAnnouncer *listener, AnnouncerStatistics &statistics);
   private:
+    static void ReapRetired();
   };
 }
 
@@ -0,0 +1,182 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string.h>
+
+#include "AnnouncerQueue.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+using namespace std;
+using namespace ANNOUNCEMENT;
+
+CAnnouncerQueue::CAnnouncerQueue(IAnnouncer *announcer, unsigned int size)
+  : CThread("CAnnouncerQueue"),
+    m_announcer(announcer),
+    m_size(size > 0 ? size : 1),
+    m_idle(true, true),
+    m_started(false)
+{
+  memset(&m_statistics, 0, sizeof(m_statistics));
+}
+
+CAnnouncerQueue::~CAnnouncerQueue()
+{
+  StopThread();
+}
+
+void CAnnouncerQueue::Push(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data)
+{
+  CSingleLock lock(m_critSection);
+
+  // only the announcements at the end of the queue which are of the same
+  // kind are merged so the order of different announcements is kept
+  bool isState = IsState(flag, message);
+  for (deque<Announcement>::reverse_iterator it = m_queue.rbegin(); it != m_queue.rend(); ++it)
+  {
+    if (it->flag != flag || it->sender != sender || it->message != message)
+      break;
+
+    const CVariant &pending = it->data;
+    if (IsEqual(pending, data))
+    {
+      m_statistics.coalesced++;
+      return;
+    }
+
+    // a newer state of the same item replaces the older one
+    if (isState && IsEqual(pending["item"], data["item"]))
+    {
+      it->data = data;
+      m_statistics.coalesced++;
+      return;
+    }
+  }
+
+  if (m_queue.size() >= m_size)
+  {
+    if (m_statistics.dropped % 1000 == 0)
+      CLog::Log(LOGWARNING, "CAnnouncerQueue: announcer is too slow, dropping announcements (%u so far)", m_statistics.dropped + 1);
+
+    m_queue.pop_front();
+    m_statistics.dropped++;
+  }
+
+  Announcement announcement;
+  announcement.flag = flag;
+  announcement.sender = sender;
+  announcement.message = message;
+  announcement.data = data;
+  m_queue.push_back(announcement);
+
+  m_statistics.backlog = m_queue.size();
+  if (m_statistics.backlog > m_statistics.maxBacklog)
+    m_statistics.maxBacklog = m_statistics.backlog;
+
+  m_idle.Reset();
+  m_queued.Set();
+
+  if (!m_started)
+  {
+    m_started = true;
+    Create();
+  }
+}
+
+bool CAnnouncerQueue::Flush(unsigned int timeout)
+{
+  // the announcer can't wait for itself
+  if (IsCurrentThread())
+    return true;
+
+  return m_idle.WaitMSec(timeout);
+}
+
+void CAnnouncerQueue::GetStatistics(AnnouncerStatistics &statistics)
+{
+  CSingleLock lock(m_critSection);
+  statistics = m_statistics;
+}
+
+void CAnnouncerQueue::Process()
+{
+  while (!m_bStop)
+  {
+    Announcement announcement;
+    {
+      CSingleLock lock(m_critSection);
+      if (m_queue.empty())
+      {
+        m_idle.Set();
+        lock.Leave();
+
+        AbortableWait(m_queued);
+        continue;
+      }
+
+      announcement = m_queue.front();
+      m_queue.pop_front();
+      m_statistics.backlog = m_queue.size();
+    }
+
+    m_announcer->Announce(announcement.flag, announcement.sender.c_str(), announcement.message.c_str(), announcement.data);
+
+    CSingleLock lock(m_critSection);
+    m_statistics.delivered++;
+  }
+
+  // whatever is left won't be delivered anymore
+  CSingleLock lock(m_critSection);
+  m_queue.clear();
+  m_statistics.backlog = 0;
+  m_idle.Set();
+}
+
+bool CAnnouncerQueue::IsState(AnnouncementFlag flag, const char *message)
+{
+  static const struct
+  {
+    AnnouncementFlag flag;
+    const char *message;
+  } states[] = {
+    { Application,  "OnVolumeChanged" },
+    { Player,       "OnSeek" },
+    { Player,       "OnSpeedChanged" },
+    { VideoLibrary, "OnUpdate" },
+    { AudioLibrary, "OnUpdate" }
+  };
+
+  for (unsigned int i = 0; i < sizeof(states) / sizeof(states[0]); i++)
+  {
+    if (states[i].flag == flag && strcmp(states[i].message, message) == 0)
+      return true;
+  }
+
+  return false;
+}
+
+bool CAnnouncerQueue::IsEqual(const CVariant &left, const CVariant &right)
+{
+  // CVariant doesn't consider two null values to be equal
+  if (left.isNull() || right.isNull())
+    return left.isNull() && right.isNull();
+
+  return left == right;
+}
@@ -0,0 +1,100 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <deque>
+#include <string>
+
+#include "IAnnouncer.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+#include "utils/Variant.h"
+
+namespace ANNOUNCEMENT
+{
+  typedef struct AnnouncerStatistics
+  {
+    unsigned int delivered;  // announcements passed on to the announcer
+    unsigned int coalesced;  // announcements merged into one that was still waiting
+    unsigned int dropped;    // announcements thrown away because the queue was full
+    unsigned int backlog;    // announcements currently waiting
+    unsigned int maxBacklog; // most announcements that have been waiting at once
+  } AnnouncerStatistics;
+
+  /*!
+   \brief Bounded queue of announcements for a single IAnnouncer
+
+   The announcements are passed on to the announcer on a thread of its
+   own so that a slow announcer neither holds up the thread making the
+   announcement nor any of the other announcers. The thread is started
+   with the first announcement.
+   */
+  class CAnnouncerQueue : public CThread
+  {
+  public:
+    CAnnouncerQueue(IAnnouncer *announcer, unsigned int size);
+    virtual ~CAnnouncerQueue();
+
+    IAnnouncer *GetAnnouncer() const { return m_announcer; }
+
+    /*!
+     \brief Queues an announcement
+
+     An announcement equal to one that is still waiting is dropped. For
+     announcements describing a state (like the volume or the details of
+     an item) only the latest one is kept. If the queue is full the
+     oldest announcement is dropped.
+     */
+    void Push(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data);
+
+    /*!
+     \brief Waits until all queued announcements have been passed on
+     \return False if that didn't happen within the given time
+     */
+    bool Flush(unsigned int timeout);
+
+    void GetStatistics(AnnouncerStatistics &statistics);
+
+  protected:
+    virtual void Process();
+
+  private:
+    typedef struct Announcement
+    {
+      AnnouncementFlag flag;
+      std::string sender;
+      std::string message;
+      CVariant data;
+    } Announcement;
+
+    static bool IsState(AnnouncementFlag flag, const char *message);
+    static bool IsEqual(const CVariant &left, const CVariant &right);
+
+    IAnnouncer *m_announcer;
+    unsigned int m_size;
+    std::deque<Announcement> m_queue;
+    CCriticalSection m_critSection;
+    CEvent m_queued;
+    CEvent m_idle;
+    AnnouncerStatistics m_statistics;
+    bool m_started;
+  };
+}
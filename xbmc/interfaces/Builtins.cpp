@@ -38,6 +38,8 @@
 #include "GUIUserMessages.h"
 #include "windows/GUIWindowLoginScreen.h"
 #include "video/windows/GUIWindowVideoBase.h"
+#include "video/VideoThumbLoader.h"
+#include "utils/JobManager.h"
 #include "addons/GUIWindowAddonBrowser.h"
 #include "addons/Addon.h" // for TranslateType, TranslateContent
 #include "addons/AddonInstaller.h"
@@ -214,6 +216,7 @@ const BUILT_IN commands[] = {
   { "LCD.Resume",                 false,  "Resumes LCDproc" },
 #endif
   { "VideoLibrary.Search",        false,  "Brings up a search dialog which will search the library" },
+  { "VideoLibrary.BenchmarkThumbs",true,  "Extracts thumbs from the videos in a directory with 1 to 4 threads and logs how long it took" },
   { "ToggleDebug",                false,  "Enables/disables debug mode" },
   { "StartPVRManager",            false,  "(Re)Starts the PVR manager" },
   { "StopPVRManager",             false,  "Stops the PVR manager" },
@@ -1640,6 +1643,18 @@ int CBuiltins::Execute(const CStdString& execString)
     CGUIMessage msg(GUI_MSG_SEARCH, 0, 0, 0);
     g_windowManager.SendMessage(msg, WINDOW_VIDEO_NAV);
   }
+  else if (execute.Equals("videolibrary.benchmarkthumbs") && params.size())
+  {
+    // same range as <extractthreads>, each thread opens its own demuxer and decoder
+    int threads = g_advancedSettings.m_videoExtractThreads;
+    if (params.size() > 1)
+      threads = atoi(params[1].c_str());
+    if (threads < 1)
+      threads = 1;
+    else if (threads > 4)
+      threads = 4;
+    CJobManager::GetInstance().AddJob(new CThumbBenchmarkJob(params[0], threads), NULL);
+  }
   else if (execute.Equals("toggledebug"))
   {
     bool debug = g_guiSettings.GetBool("debug.showloginfo");
@@ -194,6 +194,72 @@ void CFileItemHandler::FillDetails(const ISerializable *info, const CFileItemPtr
   }
 }
 
+static CThumbLoader* CreateThumbLoader(const CFileItemPtr &item)
+{
+  CThumbLoader *thumbLoader = NULL;
+  if (item->HasVideoInfoTag())
+    thumbLoader = new CVideoThumbLoader();
+  else if (item->HasMusicInfoTag())
+    thumbLoader = new CMusicThumbLoader();
+
+  if (thumbLoader != NULL)
+    thumbLoader->Initialize();
+
+  return thumbLoader;
+}
+
+namespace JSONRPC
+{
+  /*!
+   \brief Converts the items of a list one by one while a streamed response is written
+   */
+  class CFileItemListSource : public IJSONRPCListSource
+  {
+  public:
+    CFileItemListSource(const char *ID, bool allowFile, const char *resultname, const CFileItemList &items, int start, int end, const CVariant &parameterObject, const std::set<std::string> &fields)
+      : m_ID(ID), m_allowFile(allowFile), m_resultname(resultname),
+        m_parameterObject(parameterObject), m_fields(fields),
+        m_thumbLoader(NULL), m_index(0)
+    {
+      m_items.reserve(end - start);
+      for (int i = start; i < end; i++)
+        m_items.push_back(items.Get(i));
+    }
+
+    virtual ~CFileItemListSource()
+    {
+      delete m_thumbLoader;
+    }
+
+    virtual bool GetNext(CVariant &value)
+    {
+      if (m_index >= m_items.size())
+        return false;
+
+      if (m_index == 0)
+        m_thumbLoader = CreateThumbLoader(m_items[0]);
+
+      CVariant object;
+      CFileItemHandler::HandleFileItem(m_ID, m_allowFile, m_resultname, m_items[m_index], m_parameterObject, m_fields, object, false, m_thumbLoader);
+      value.swap(object[m_resultname]);
+
+      // the item isn't needed anymore once it has been written
+      m_items[m_index++].reset();
+      return true;
+    }
+
+  private:
+    const char *m_ID;
+    bool m_allowFile;
+    const char *m_resultname;
+    std::vector<CFileItemPtr> m_items;
+    CVariant m_parameterObject;
+    std::set<std::string> m_fields;
+    CThumbLoader *m_thumbLoader;
+    size_t m_index;
+  };
+}
+
 void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result, bool sortLimit /* = true */)
 {
   HandleFileItemList(ID, allowFile, resultname, items, parameterObject, result, items.Size(), sortLimit);
@@ -212,18 +278,6 @@ void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const
     end = items.Size();
   }
 
-  CThumbLoader *thumbLoader = NULL;
-  if (end - start > 0)
-  {
-    if (items.Get(start)->HasVideoInfoTag())
-      thumbLoader = new CVideoThumbLoader();
-    else if (items.Get(start)->HasMusicInfoTag())
-      thumbLoader = new CMusicThumbLoader();
-
-    if (thumbLoader != NULL)
-      thumbLoader->Initialize();
-  }
-
   std::set<std::string> fields;
   if (parameterObject.isMember("properties") && parameterObject["properties"].isArray())
   {
@@ -231,9 +285,22 @@ void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const
       fields.insert(field->asString());
   }
 
+  if (end - start <= 0)
+    return;
+
+  if (resultname != NULL)
+  {
+    CFileItemListSource *source = new CFileItemListSource(ID, allowFile, resultname, items, start, end, parameterObject, fields);
+    if (CJSONRPC::StreamList(result, resultname, source))
+      return;
+
+    delete source;
+  }
+
+  CThumbLoader *thumbLoader = CreateThumbLoader(items.Get(start));
+
   for (int i = start; i < end; i++)
   {
-    CVariant object;
     CFileItemPtr item = items.Get(i);
     HandleFileItem(ID, allowFile, resultname, item, parameterObject, fields, result, true, thumbLoader);
   }
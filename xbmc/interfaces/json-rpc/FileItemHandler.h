@@ -32,9 +32,20 @@ namespace JSONRPC
 {
   class CFileItemHandler : public CJSONUtils
   {
+    friend class CFileItemListSource;
+
   protected:
     static void FillDetails(const ISerializable *info, const CFileItemPtr &item, std::set<std::string> &fields, CVariant &result, CThumbLoader *thumbLoader = NULL);
     static void HandleFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result, bool sortLimit = true);
+    /*!
+     \brief Adds the (sorted and limited) items to result[resultname]
+
+     If the method is executed for a streamed response and result is its
+     top level result object, the items are only converted while the
+     response is written (see CJSONRPC::StreamList()) and result[resultname]
+     stays empty. Methods which need to modify the converted items have to
+     pass their own result object.
+     */
     static void HandleFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result, int size, bool sortLimit = true);
     static void HandleFileItem(const char *ID, bool allowFile, const char *resultname, CFileItemPtr item, const CVariant &parameterObject, const CVariant &validFields, CVariant &result, bool append = true, CThumbLoader *thumbLoader = NULL);
     static void HandleFileItem(const char *ID, bool allowFile, const char *resultname, CFileItemPtr item, const CVariant &parameterObject, const std::set<std::string> &validFields, CVariant &result, bool append = true, CThumbLoader *thumbLoader = NULL);
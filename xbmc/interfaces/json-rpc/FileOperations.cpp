@@ -176,22 +176,27 @@ JSONRPC_STATUS CFileOperations::GetDirectory(const CStdString &method, ITranspor
     if (!hasFileField)
       param["properties"].append("file");
 
-    HandleFileItemList("id", true, "files", filteredDirectories, param, result);
-    for (unsigned int index = 0; index < result["files"].size(); index++)
+    // the items are modified after being converted so they must not be
+    // streamed (see CFileItemHandler::HandleFileItemList())
+    CVariant listing;
+    HandleFileItemList("id", true, "files", filteredDirectories, param, listing);
+    for (unsigned int index = 0; index < listing["files"].size(); index++)
     {
-      result["files"][index]["filetype"] = "directory";
+      listing["files"][index]["filetype"] = "directory";
     }
-    int count = (int)result["limits"]["total"].asInteger();
+    int count = (int)listing["limits"]["total"].asInteger();
 
-    HandleFileItemList("id", true, "files", filteredFiles, param, result);
-    for (unsigned int index = count; index < result["files"].size(); index++)
+    HandleFileItemList("id", true, "files", filteredFiles, param, listing);
+    for (unsigned int index = count; index < listing["files"].size(); index++)
     {
-      result["files"][index]["filetype"] = "file";
+      listing["files"][index]["filetype"] = "file";
     }
-    count += (int)result["limits"]["total"].asInteger();
+    count += (int)listing["limits"]["total"].asInteger();
 
-    result["limits"]["end"] = count;
-    result["limits"]["total"] = count;
+    listing["limits"]["end"] = count;
+    listing["limits"]["total"] = count;
+
+    result = listing;
 
     return OK;
   }
@@ -18,6 +18,7 @@
  *
  */
 
+#include <algorithm>
 #include <string.h>
 
 #include "JSONRPC.h"
@@ -26,6 +27,7 @@
 #include "interfaces/AnnouncementManager.h"
 #include "playlists/SmartPlayList.h"
 #include "settings/AdvancedSettings.h"
+#include "threads/ThreadLocal.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
@@ -36,6 +38,15 @@ using namespace std;
 
 bool CJSONRPC::m_initialized = false;
 
+typedef struct
+{
+  CJSONRPCResponseStream *stream;
+  const CVariant *result;
+} StreamContext;
+
+// the streamed method call currently executed on this thread
+static XbmcThreads::ThreadLocal<StreamContext> streamContext;
+
 void CJSONRPC::Initialize()
 {
   if (m_initialized)
@@ -97,6 +108,9 @@ void CJSONRPC::Initialize()
 
   for (unsigned int index = 0; index < size; index++)
     CJSONServiceDescription::AddNotification(JSONRPC_SERVICE_NOTIFICATIONS[index]);
+
+  // resolve all references up front instead of on the first request
+  CJSONServiceDescription::Prepare();
   
   m_initialized = true;
   CLog::Log(LOGINFO, "JSONRPC v%s: Successfully initialized", CJSONServiceDescription::GetVersion());
@@ -222,9 +236,22 @@ JSONRPC_STATUS CJSONRPC::NotifyAll(const CStdString &method, ITransportLayer *tr
 }
 
 CStdString CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *transport, IClient *client)
+{
+  CJSONRPCResponseStream *stream = MethodCallStream(inputString, transport, client);
+  if (stream == NULL)
+    return "";
+
+  CStdString str = stream->ReadAll();
+  delete stream;
+
+  return str;
+}
+
+CJSONRPCResponseStream* CJSONRPC::MethodCallStream(const CStdString &inputString, ITransportLayer *transport, IClient *client)
 {
   CVariant inputroot, outputroot, result;
   bool hasResponse = false;
+  CJSONRPCResponseStream *stream = new CJSONRPCResponseStream(g_advancedSettings.m_jsonOutputCompact);
 
   CLog::Log(LOGDEBUG, "JSONRPC: Incoming request: %s", inputString.c_str());
   inputroot = CJSONVariantParser::Parse((unsigned char *)inputString.c_str(), inputString.length());
@@ -252,7 +279,7 @@ CStdString CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *
       }
     }
     else
-      hasResponse = HandleMethodCall(inputroot, outputroot, transport, client);
+      hasResponse = HandleMethodCall(inputroot, outputroot, transport, client, stream);
   }
   else
   {
@@ -261,11 +288,31 @@ CStdString CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *
     hasResponse = true;
   }
 
-  CStdString str = hasResponse ? CJSONVariantWriter::Write(outputroot, g_advancedSettings.m_jsonOutputCompact) : "";
-  return str;
+  if (!hasResponse)
+  {
+    delete stream;
+    return NULL;
+  }
+
+  stream->SetResponse(outputroot);
+  return stream;
+}
+
+bool CJSONRPC::StreamList(CVariant &result, const std::string &key, IJSONRPCListSource *source)
+{
+  StreamContext *context = streamContext.get();
+  if (context == NULL || context->result != &result || source == NULL)
+    return false;
+
+  if (result.isNull())
+    result = CVariant(CVariant::VariantTypeObject);
+  else if (!result.isObject() || result.isMember(key))
+    return false;
+
+  return context->stream->AddSource(key, source);
 }
 
-bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client)
+bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client, CJSONRPCResponseStream *stream /* = NULL */)
 {
   JSONRPC_STATUS errorCode = OK;
   CVariant result;
@@ -283,7 +330,16 @@ bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITr
 
     CLog::Log(LOGDEBUG, "JSONRPC: Calling %s", methodName.c_str());
     if ((errorCode = CJSONServiceDescription::CheckCall(methodName, request["params"], transport, client, isNotification, method, params)) == OK)
+    {
+      // let the method hand over its lists to the response stream
+      StreamContext context = { stream, &result };
+      StreamContext *previousContext = streamContext.get();
+      streamContext.set(stream != NULL && !isNotification ? &context : NULL);
+
       errorCode = method(methodName, transport, client, params, result);
+
+      streamContext.set(previousContext);
+    }
     else
       result = params;
   }
@@ -348,3 +404,179 @@ inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code
       break;
   }
 }
+
+CJSONRPCResponseStream::CJSONRPCResponseStream(bool compact)
+  : m_writer(compact),
+    m_state(StateDone),
+    m_key(0)
+{ }
+
+CJSONRPCResponseStream::~CJSONRPCResponseStream()
+{
+  for (map<string, IJSONRPCListSource*>::iterator it = m_sources.begin(); it != m_sources.end(); it++)
+    delete it->second;
+}
+
+size_t CJSONRPCResponseStream::Read(char *buffer, size_t size)
+{
+  while (m_writer.GetPendingSize() < size && m_state != StateDone)
+  {
+    if (!Step())
+    {
+      CLog::Log(LOGERROR, "JSONRPC: Failed to serialize the response");
+      m_state = StateDone;
+    }
+  }
+
+  return m_writer.Read(buffer, size);
+}
+
+std::string CJSONRPCResponseStream::ReadAll()
+{
+  string output;
+  char buffer[16384];
+  size_t read;
+  while ((read = Read(buffer, sizeof(buffer))) > 0)
+    output.append(buffer, read);
+
+  return output;
+}
+
+void CJSONRPCResponseStream::SetResponse(const CVariant &response)
+{
+  m_response = response;
+  m_state = StateStart;
+}
+
+bool CJSONRPCResponseStream::AddSource(const std::string &key, IJSONRPCListSource *source)
+{
+  if (m_sources.find(key) != m_sources.end())
+    return false;
+
+  m_sources.insert(make_pair(key, source));
+  return true;
+}
+
+bool CJSONRPCResponseStream::Step()
+{
+  const CVariant &response = m_response;
+
+  switch (m_state)
+  {
+    case StateStart:
+      if (response.isArray())
+      {
+        m_element = response.begin_array();
+        m_elementEnd = response.end_array();
+        m_state = StateBatch;
+        return m_writer.BeginArray();
+      }
+      if (response.isObject())
+      {
+        m_member = response.begin_map();
+        m_state = StateEnvelope;
+        return m_writer.BeginObject();
+      }
+
+      m_state = StateDone;
+      return m_writer.WriteValue(response);
+
+    case StateBatch:
+      if (m_element == m_elementEnd)
+      {
+        m_state = StateDone;
+        return m_writer.EndArray();
+      }
+
+      return m_writer.WriteValue(*m_element++);
+
+    case StateEnvelope:
+      if (m_member == response.end_map())
+      {
+        m_state = StateDone;
+        return m_writer.EndObject();
+      }
+
+      if (!m_writer.WriteKey(m_member->first))
+        return false;
+
+      if (m_member->first == "result" && m_member->second.isObject())
+      {
+        // merge the lazily evaluated lists into the keys of the result
+        m_keys.clear();
+        for (CVariant::const_iterator_map it = m_member->second.begin_map(); it != m_member->second.end_map(); it++)
+          m_keys.push_back(it->first);
+        for (map<string, IJSONRPCListSource*>::const_iterator it = m_sources.begin(); it != m_sources.end(); it++)
+          m_keys.push_back(it->first);
+        sort(m_keys.begin(), m_keys.end());
+        m_keys.erase(unique(m_keys.begin(), m_keys.end()), m_keys.end());
+
+        m_key = 0;
+        m_state = StateResult;
+        return m_writer.BeginObject();
+      }
+
+      return m_writer.WriteValue((m_member++)->second);
+
+    case StateResult:
+    {
+      if (m_key >= m_keys.size())
+      {
+        m_member++;
+        m_state = StateEnvelope;
+        return m_writer.EndObject();
+      }
+
+      const string &key = m_keys[m_key];
+      if (!m_writer.WriteKey(key))
+        return false;
+
+      if (m_sources.find(key) != m_sources.end())
+      {
+        m_state = StateResultSource;
+        return m_writer.BeginArray();
+      }
+
+      const CVariant &value = m_member->second[key];
+      if (value.isArray())
+      {
+        m_element = value.begin_array();
+        m_elementEnd = value.end_array();
+        m_state = StateResultArray;
+        return m_writer.BeginArray();
+      }
+
+      m_key++;
+      return m_writer.WriteValue(value);
+    }
+
+    case StateResultArray:
+      if (m_element == m_elementEnd)
+      {
+        m_key++;
+        m_state = StateResult;
+        return m_writer.EndArray();
+      }
+
+      return m_writer.WriteValue(*m_element++);
+
+    case StateResultSource:
+    {
+      CVariant value;
+      if (!m_sources[m_keys[m_key]]->GetNext(value))
+      {
+        m_key++;
+        m_state = StateResult;
+        return m_writer.EndArray();
+      }
+
+      return m_writer.WriteValue(value);
+    }
+
+    case StateDone:
+    default:
+      break;
+  }
+
+  return true;
+}
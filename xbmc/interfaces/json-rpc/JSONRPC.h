@@ -23,14 +23,96 @@
 #include <map>
 #include <stdio.h>
 #include <string>
+#include <vector>
 
 #include "JSONRPCUtils.h"
 #include "JSONServiceDescription.h"
 #include "interfaces/IAnnouncer.h"
+#include "utils/JSONStreamWriter.h"
 #include "utils/StdString.h"
 
 namespace JSONRPC
 {
+  /*!
+   \ingroup jsonrpc
+   \brief Lazily evaluated array in the result of a JSON-RPC method
+
+   Instead of putting every element of a (potentially huge) array into the
+   result of a method call the method can hand over a list source which is
+   asked for one element at a time while the response is being sent.
+   */
+  class IJSONRPCListSource
+  {
+  public:
+    virtual ~IJSONRPCListSource() { }
+
+    /*!
+     \brief Fills value with the next element of the array
+     \return False if there are no more elements
+     */
+    virtual bool GetNext(CVariant &value) = 0;
+  };
+
+  /*!
+   \ingroup jsonrpc
+   \brief Incrementally serialized JSON-RPC response
+
+   Serializes the response of a JSON-RPC request step by step while it is
+   being read. Arrays in the result (and the responses of a batch call) are
+   serialized one element at a time and the elements of lazily evaluated
+   arrays are only retrieved from their source when they are written, so
+   neither the whole result nor its serialized form has to be held in
+   memory at once.
+
+   The produced output is identical to serializing the complete response
+   with CJSONVariantWriter.
+   */
+  class CJSONRPCResponseStream
+  {
+  public:
+    CJSONRPCResponseStream(bool compact);
+    ~CJSONRPCResponseStream();
+
+    /*!
+     \brief Moves up to size bytes of the serialized response into buffer
+     \return Number of bytes copied into buffer, 0 once the whole response has been read
+     */
+    size_t Read(char *buffer, size_t size);
+
+    /*!
+     \brief Reads the whole (remaining) response into a string
+     */
+    std::string ReadAll();
+
+  private:
+    friend class CJSONRPC;
+
+    void SetResponse(const CVariant &response);
+    bool AddSource(const std::string &key, IJSONRPCListSource *source);
+    bool Step();
+
+    enum State
+    {
+      StateStart,
+      StateBatch,
+      StateEnvelope,
+      StateResult,
+      StateResultArray,
+      StateResultSource,
+      StateDone
+    };
+
+    CJSONStreamWriter m_writer;
+    CVariant m_response;
+    std::map<std::string, IJSONRPCListSource*> m_sources;
+    std::vector<std::string> m_keys;
+    State m_state;
+    size_t m_key;
+    CVariant::const_iterator_map m_member;
+    CVariant::const_iterator_array m_element;
+    CVariant::const_iterator_array m_elementEnd;
+  };
+
   /*!
    \ingroup jsonrpc
    \brief JSON RPC handler
@@ -64,6 +146,33 @@ namespace JSONRPC
      */
     static CStdString MethodCall(const CStdString &inputString, ITransportLayer *transport, IClient *client);
 
+    /*!
+     \brief Handles an incoming JSON-RPC request and streams the response
+     \param inputString received JSON-RPC request
+     \param transport Transport protocol on which the request arrived
+     \param client Client which sent the request
+     \return Stream of the JSON-RPC response or NULL if there is no response (notification)
+
+     Same as MethodCall() but the response is only serialized while it is
+     read from the returned stream, which has to be deleted by the caller.
+     Lists of file items are not converted before they are read (see
+     StreamList()).
+     */
+    static CJSONRPCResponseStream* MethodCallStream(const CStdString &inputString, ITransportLayer *transport, IClient *client);
+
+    /*!
+     \brief Lets the response stream retrieve result[key] from the given source
+     \param result Result object of the currently executed method
+     \param key Name of the array in the result object
+     \param source Source of the elements of the array
+     \return True if the source will be used (and deleted) by the response stream
+
+     Only works for the top level result object of a method which is
+     executed for a streamed response. If it fails the caller has to fill
+     result[key] itself and keeps ownership of the source.
+     */
+    static bool StreamList(CVariant &result, const std::string &key, IJSONRPCListSource *source);
+
     static JSONRPC_STATUS Introspect(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Version(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Permission(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
@@ -74,7 +183,7 @@ namespace JSONRPC
   
   private:
     static void setup();
-    static bool HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client);
+    static bool HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client, CJSONRPCResponseStream *stream = NULL);
     static inline bool IsProperJSONRPC(const CVariant& inputroot);
 
     inline static void BuildResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, CVariant& response);
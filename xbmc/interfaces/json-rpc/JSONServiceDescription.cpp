@@ -18,11 +18,14 @@
  *
  */
 
+#include <algorithm>
+
 #include "ServiceDescription.h"
 #include "JSONServiceDescription.h"
 #include "utils/log.h"
 #include "utils/StdString.h"
 #include "utils/JSONVariantParser.h"
+#include "threads/SingleLock.h"
 #include "JSONRPC.h"
 #include "PlayerOperations.h"
 #include "PlaylistOperations.h"
@@ -44,6 +47,8 @@ map<string, CVariant> CJSONServiceDescription::m_notifications = map<string, CVa
 CJSONServiceDescription::CJsonRpcMethodMap CJSONServiceDescription::m_actionMap;
 map<string, JSONSchemaTypeDefinitionPtr> CJSONServiceDescription::m_types = map<string, JSONSchemaTypeDefinitionPtr>();
 CJSONServiceDescription::IncompleteSchemaDefinitionMap CJSONServiceDescription::m_incompleteDefinitions = CJSONServiceDescription::IncompleteSchemaDefinitionMap();
+CCriticalSection CJSONServiceDescription::m_section;
+bool CJSONServiceDescription::m_prepared = false;
 
 JsonRpcMethodMap CJSONServiceDescription::m_methodMaps[] = {
 // JSON-RPC
@@ -202,7 +207,8 @@ JSONSchemaTypeDefinition::JSONSchemaTypeDefinition()
     exclusiveMinimum(false), exclusiveMaximum(false), divisibleBy(0),
     minLength(-1), maxLength(-1),
     minItems(0), maxItems(0), uniqueItems(false),
-    hasAdditionalProperties(false)
+    hasAdditionalProperties(false),
+    prepared(false)
 { }
 
 bool JSONSchemaTypeDefinition::Parse(const CVariant &value, bool isParameter /* = false */)
@@ -229,6 +235,8 @@ bool JSONSchemaTypeDefinition::Parse(const CVariant &value, bool isParameter /*
     if (!typeName.empty())
       name = typeName;
     referencedType = referencedTypeDef;
+    // the lookup tables of the referenced type don't cover what is parsed below
+    prepared = false;
     hasReference = true;
   }
   else if (value.isMember("id") && value["id"].isString())
@@ -578,15 +586,29 @@ bool JSONSchemaTypeDefinition::Parse(const CVariant &value, bool isParameter /*
   return true;
 }
 
+static bool ComparePropertyNames(const JSONSchemaTypeDefinitionPtr &left, const JSONSchemaTypeDefinitionPtr &right)
+{
+  return left->name < right->name;
+}
+
 JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &outputValue, CVariant &errorData)
 {
-  if (!name.empty())
-    errorData["name"] = name;
-  SchemaValueTypeToJson(type, errorData["type"]);
-  CStdString errorMessage;
+  JSONRPC_STATUS status = check(value, outputValue, errorData);
 
-  if (referencedType != NULL && !referencedTypeSet)
-    Set(referencedType);
+  // only describe the type if the value didn't match
+  if (status != OK)
+  {
+    if (!name.empty())
+      errorData["name"] = name;
+    SchemaValueTypeToJson(type, errorData["type"]);
+  }
+
+  return status;
+}
+
+JSONRPC_STATUS JSONSchemaTypeDefinition::check(const CVariant &value, CVariant &outputValue, CVariant &errorData)
+{
+  CStdString errorMessage;
 
   // Let's check the type of the provided parameter
   if (!IsType(value, type))
@@ -675,9 +697,8 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
       // Loop through all array elements
       for (unsigned int arrayIndex = 0; arrayIndex < value.size(); arrayIndex++)
       {
-        CVariant temp;
-        JSONRPC_STATUS status = itemType->Check(value[arrayIndex], temp, errorData["property"]);
-        outputValue.push_back(temp);
+        outputValue.push_back(CVariant());
+        JSONRPC_STATUS status = itemType->Check(value[arrayIndex], outputValue[arrayIndex], errorData["property"]);
         if (status != OK)
         {
           CLog::Log(LOGDEBUG, "JSONRPC: Array element at index %u does not match in type %s", arrayIndex, name.c_str());
@@ -776,26 +797,32 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
   if (HasType(type, ObjectValue) && value.isObject())
   {
     unsigned int handled = 0;
-    JSONSchemaTypeDefinition::CJsonSchemaPropertiesMap::JSONSchemaPropertiesIterator propertiesEnd = properties.end();
-    JSONSchemaTypeDefinition::CJsonSchemaPropertiesMap::JSONSchemaPropertiesIterator propertiesIterator;
-    for (propertiesIterator = properties.begin(); propertiesIterator != propertiesEnd; propertiesIterator++)
+    // both the properties and the members of the object are sorted by
+    // name so they can be matched in a single pass over both of them
+    CVariant::const_iterator_map member = value.begin_map();
+    CVariant::const_iterator_map membersEnd = value.end_map();
+    for (std::vector<JSONSchemaTypeDefinitionPtr>::const_iterator propertiesIterator = sortedProperties.begin(); propertiesIterator != sortedProperties.end(); propertiesIterator++)
     {
-      if (value.isMember(propertiesIterator->second->name))
+      const JSONSchemaTypeDefinitionPtr &property = *propertiesIterator;
+      while (member != membersEnd && member->first < property->name)
+        member++;
+
+      if (member != membersEnd && member->first == property->name)
       {
-        JSONRPC_STATUS status = propertiesIterator->second->Check(value[propertiesIterator->second->name], outputValue[propertiesIterator->second->name], errorData["property"]);
+        JSONRPC_STATUS status = property->Check(member->second, outputValue[property->name], errorData["property"]);
         if (status != OK)
         {
-          CLog::Log(LOGDEBUG, "JSONRPC: Invalid property \"%s\" in type %s", propertiesIterator->second->name.c_str(), name.c_str());
+          CLog::Log(LOGDEBUG, "JSONRPC: Invalid property \"%s\" in type %s", property->name.c_str(), name.c_str());
           return status;
         }
         handled++;
       }
-      else if (propertiesIterator->second->optional)
-        outputValue[propertiesIterator->second->name] = propertiesIterator->second->defaultValue;
+      else if (property->optional)
+        outputValue[property->name] = property->defaultValue;
       else
       {
-        errorData["property"]["name"] = propertiesIterator->second->name.c_str();
-        errorData["property"]["type"] = SchemaValueTypeToString(propertiesIterator->second->type);
+        errorData["property"]["name"] = property->name.c_str();
+        errorData["property"]["type"] = SchemaValueTypeToString(property->type);
         errorData["message"] = "Missing property";
         return InvalidParams;
       }
@@ -852,12 +879,17 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
   if (enums.size() > 0)
   {
     bool valid = false;
-    for (std::vector<CVariant>::const_iterator enumItr = enums.begin(); enumItr != enums.end(); enumItr++)
+    if (!enumStrings.empty() && value.isString())
+      valid = binary_search(enumStrings.begin(), enumStrings.end(), value.asString());
+    else
     {
-      if (*enumItr == value)
+      for (std::vector<CVariant>::const_iterator enumItr = enums.begin(); enumItr != enums.end(); enumItr++)
       {
-        valid = true;
-        break;
+        if (*enumItr == value)
+        {
+          valid = true;
+          break;
+        }
       }
     }
 
@@ -1120,6 +1152,52 @@ void JSONSchemaTypeDefinition::Set(const JSONSchemaTypeDefinitionPtr typeDefinit
   referencedTypeSet = true;
 }
 
+void JSONSchemaTypeDefinition::Prepare()
+{
+  if (prepared)
+    return;
+
+  // mark it right away as types can (indirectly) contain themselves
+  prepared = true;
+
+  if (referencedType != NULL && !referencedTypeSet)
+  {
+    referencedType->Prepare();
+    Set(referencedType);
+    prepared = true;
+  }
+
+  sortedProperties.clear();
+  for (CJsonSchemaPropertiesMap::JSONSchemaPropertiesIterator it = properties.begin(); it != properties.end(); it++)
+    sortedProperties.push_back(it->second);
+  sort(sortedProperties.begin(), sortedProperties.end(), ComparePropertyNames);
+
+  enumStrings.clear();
+  for (std::vector<CVariant>::const_iterator enumItr = enums.begin(); enumItr != enums.end(); enumItr++)
+  {
+    if (!enumItr->isString())
+    {
+      enumStrings.clear();
+      break;
+    }
+    enumStrings.push_back(enumItr->asString());
+  }
+  sort(enumStrings.begin(), enumStrings.end());
+
+  for (unsigned int index = 0; index < unionTypes.size(); index++)
+    unionTypes.at(index)->Prepare();
+  for (unsigned int index = 0; index < extends.size(); index++)
+    extends.at(index)->Prepare();
+  for (unsigned int index = 0; index < items.size(); index++)
+    items.at(index)->Prepare();
+  for (unsigned int index = 0; index < additionalItems.size(); index++)
+    additionalItems.at(index)->Prepare();
+  for (std::vector<JSONSchemaTypeDefinitionPtr>::iterator it = sortedProperties.begin(); it != sortedProperties.end(); it++)
+    (*it)->Prepare();
+  if (additionalProperties != NULL)
+    additionalProperties->Prepare();
+}
+
 JSONSchemaTypeDefinition::CJsonSchemaPropertiesMap::CJsonSchemaPropertiesMap()
 {
   m_propertiesmap = std::map<std::string, JSONSchemaTypeDefinitionPtr>();
@@ -1237,7 +1315,6 @@ JSONRPC_STATUS JsonRpcMethod::Check(const CVariant &requestParameters, ITranspor
       // parameters
       unsigned int handled = 0;
       CVariant errorData = CVariant(CVariant::VariantTypeObject);
-      errorData["method"] = name;
 
       // Loop through all the parameters to check
       for (unsigned int i = 0; i < parameters.size(); i++)
@@ -1247,6 +1324,7 @@ JSONRPC_STATUS JsonRpcMethod::Check(const CVariant &requestParameters, ITranspor
         if (status != OK)
         {
           // Return the error data object in the outputParameters reference
+          errorData["method"] = name;
           outputParameters = errorData;
           return status;
         }
@@ -1255,6 +1333,7 @@ JSONRPC_STATUS JsonRpcMethod::Check(const CVariant &requestParameters, ITranspor
       // Check if there were unnecessary parameters
       if (handled < requestParameters.size())
       {
+        errorData["method"] = name;
         errorData["message"] = "Too many parameters";
         outputParameters = errorData;
         return InvalidParams;
@@ -1306,7 +1385,7 @@ JSONRPC_STATUS JsonRpcMethod::checkParameter(const CVariant &requestParameters,
   if (ParameterExists(requestParameters, type->name, position))
   {
     // Get the parameter
-    CVariant parameterValue = GetParameter(requestParameters, type->name, position);
+    const CVariant &parameterValue = IsValueMember(requestParameters, type->name) ? requestParameters[type->name] : requestParameters[position];
 
     // Evaluate the type of the parameter
     JSONRPC_STATUS status = type->Check(parameterValue, outputParameters[type->name], errorData["stack"]);
@@ -1334,7 +1413,10 @@ JSONRPC_STATUS JsonRpcMethod::checkParameter(const CVariant &requestParameters,
 
 void CJSONServiceDescription::Cleanup()
 {
+  CSingleLock lock(m_section);
+
   // reset all of the static data
+  m_prepared = false;
   m_notifications.clear();
   m_actionMap.clear();
   m_types.clear();
@@ -1381,6 +1463,7 @@ bool CJSONServiceDescription::prepareDescription(std::string &description, CVari
 
 bool CJSONServiceDescription::addMethod(const std::string &jsonMethod, MethodCall method)
 {
+  CSingleLock lock(m_section);
   CVariant descriptionObject;
   std::string methodName;
 
@@ -1450,6 +1533,13 @@ bool CJSONServiceDescription::addMethod(const std::string &jsonMethod, MethodCal
     return false;
   }
 
+  // methods added after Prepare() are prepared before anyone can call them
+  if (m_prepared)
+  {
+    for (unsigned int index = 0; index < newMethod.parameters.size(); index++)
+      newMethod.parameters.at(index)->Prepare();
+  }
+
   m_actionMap.add(newMethod);
 
   return true;
@@ -1457,6 +1547,7 @@ bool CJSONServiceDescription::addMethod(const std::string &jsonMethod, MethodCal
 
 bool CJSONServiceDescription::AddType(const std::string &jsonType)
 {
+  CSingleLock lock(m_section);
   CVariant descriptionObject;
   std::string typeName;
 
@@ -1504,6 +1595,9 @@ bool CJSONServiceDescription::AddType(const std::string &jsonType)
     return false;
   }
 
+  if (m_prepared)
+    globalType->Prepare();
+
   return true;
 }
 
@@ -1556,6 +1650,7 @@ bool CJSONServiceDescription::AddNotification(const std::string &jsonNotificatio
 
 bool CJSONServiceDescription::AddEnum(const std::string &name, const std::vector<CVariant> &values, CVariant::VariantType type /* = CVariant::VariantTypeNull */, const CVariant &defaultValue /* = CVariant::ConstNullVariant */)
 {
+  CSingleLock lock(m_section);
   if (name.empty() || m_types.find(name) != m_types.end() ||
       values.size() == 0)
     return false;
@@ -1625,6 +1720,8 @@ bool CJSONServiceDescription::AddEnum(const std::string &name, const std::vector
     definition->defaultValue = defaultValue;
 
   addReferenceTypeDefinition(definition);
+  if (m_prepared)
+    definition->Prepare();
 
   return true;
 }
@@ -1826,6 +1923,21 @@ JSONRPC_STATUS CJSONServiceDescription::CheckCall(const char* const method, cons
   return MethodNotFound;
 }
 
+void CJSONServiceDescription::Prepare()
+{
+  CSingleLock lock(m_section);
+  m_prepared = true;
+
+  for (std::map<std::string, JSONSchemaTypeDefinitionPtr>::iterator type = m_types.begin(); type != m_types.end(); type++)
+    type->second->Prepare();
+
+  for (CJsonRpcMethodMap::JsonRpcMethodIterator method = m_actionMap.begin(); method != m_actionMap.end(); method++)
+  {
+    for (unsigned int index = 0; index < method->second.parameters.size(); index++)
+      method->second.parameters.at(index)->Prepare();
+  }
+}
+
 JSONSchemaTypeDefinitionPtr CJSONServiceDescription::GetType(const std::string &identification)
 {
   std::map<std::string, JSONSchemaTypeDefinitionPtr>::iterator iter = m_types.find(identification);
@@ -25,6 +25,7 @@
 #include <boost/shared_ptr.hpp>
 
 #include "JSONUtils.h"
+#include "threads/CriticalSection.h"
 
 namespace JSONRPC
 {
@@ -50,6 +51,12 @@ namespace JSONRPC
     JSONRPC_STATUS Check(const CVariant &value, CVariant &outputValue, CVariant &errorData);
     void Print(bool isParameter, bool isGlobal, bool printDefault, bool printDescriptions, CVariant &output) const;
     void Set(const JSONSchemaTypeDefinitionPtr typeDefinition);
+
+    /*!
+     \brief Resolves the referenced type and builds the lookup
+     tables used by Check() for this type and all its sub-types
+     */
+    void Prepare();
     
     std::string missingReference;
 
@@ -221,6 +228,27 @@ namespace JSONRPC
      \brief Type definition for additional properties
      */
     JSONSchemaTypeDefinitionPtr additionalProperties;
+
+  private:
+    JSONRPC_STATUS check(const CVariant &value, CVariant &outputValue, CVariant &errorData);
+
+    /*!
+     \brief Whether Prepare() has been run
+     */
+    bool prepared;
+
+    /*!
+     \brief Properties sorted by their (case sensitive)
+     name so that they can be matched against the members
+     of an object in a single pass
+     */
+    std::vector<JSONSchemaTypeDefinitionPtr> sortedProperties;
+
+    /*!
+     \brief Sorted values of "enums" if all of them are
+     strings
+     */
+    std::vector<std::string> enumStrings;
   };
 
   /*! 
@@ -392,6 +420,16 @@ namespace JSONRPC
     
     static JSONSchemaTypeDefinitionPtr GetType(const std::string &identification);
 
+    /*!
+     \brief Resolves all type references and builds the lookup
+     tables needed to check calls of the defined methods
+
+     Should be called once all types and methods have been added.
+     Types and methods added afterwards are prepared by AddType()
+     and AddMethod() themselves.
+     */
+    static void Prepare();
+
     static void Cleanup();
 
   private:
@@ -425,6 +463,8 @@ namespace JSONRPC
     static std::map<std::string, JSONSchemaTypeDefinitionPtr> m_types;
     static std::map<std::string, CVariant> m_notifications;
     static JsonRpcMethodMap m_methodMaps[];
+    static CCriticalSection m_section;
+    static bool m_prepared;
 
     typedef enum SchemaDefinition
     {
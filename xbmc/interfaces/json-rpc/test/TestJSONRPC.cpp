@@ -0,0 +1,157 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "interfaces/json-rpc/JSONRPC.h"
+#include "interfaces/json-rpc/FileItemHandler.h"
+#include "settings/AdvancedSettings.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+#define TEST_ITEMS 250
+
+using namespace JSONRPC;
+
+class TestJSONRPCTransportLayer : public ITransportLayer
+{
+public:
+  virtual bool PrepareDownload(const char *path, CVariant &details, std::string &protocol) { return false; }
+  virtual bool Download(const char *path, CVariant &result) { return false; }
+  virtual int GetCapabilities() { return Response; }
+};
+
+class TestJSONRPCClient : public IClient
+{
+public:
+  virtual int GetPermissionFlags() { return OPERATION_PERMISSION_ALL; }
+  virtual int GetAnnouncementFlags() { return 0; }
+  virtual bool SetAnnouncementFlags(int flags) { return false; }
+};
+
+/* hands a list of plain file items to HandleFileItemList() like the
+   library methods do, without needing a database */
+class TestFileItemOperations : public CFileItemHandler
+{
+public:
+  static JSONRPC_STATUS GetFiles(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+  {
+    CFileItemList items;
+    for (int i = 0; i < TEST_ITEMS; i++)
+    {
+      CStdString path;
+      path.Format("special://temp/streamed/file %03d.mp3", i);
+      CFileItemPtr item(new CFileItem(path, false));
+      item->SetLabel(path.Mid(path.ReverseFind('/') + 1));
+      items.Add(item);
+    }
+
+    HandleFileItemList(NULL, true, "files", items, parameterObject, result);
+    return OK;
+  }
+};
+
+static const char *getFilesDescription =
+  "\"Test.GetFiles\": {"
+    "\"type\": \"method\","
+    "\"description\": \"Lists plain file items\","
+    "\"transport\": \"Response\","
+    "\"permission\": \"ReadData\","
+    "\"params\": ["
+      "{ \"name\": \"properties\", \"$ref\": \"List.Fields.Files\" },"
+      "{ \"name\": \"limits\", \"$ref\": \"List.Limits\" }"
+    "],"
+    "\"returns\": { \"type\": \"object\" }"
+  "}";
+
+class TestJSONRPC : public testing::Test
+{
+protected:
+  TestJSONRPC()
+  {
+    CJSONRPC::Initialize();
+    /* fails quietly once the method has been added by an earlier test */
+    CJSONServiceDescription::AddMethod(getFilesDescription, TestFileItemOperations::GetFiles);
+  }
+
+  /* reads the streamed response in small pieces so the list is written
+     over many steps */
+  std::string Stream(const CStdString &request)
+  {
+    CJSONRPCResponseStream *stream = CJSONRPC::MethodCallStream(request, &transport, &client);
+    if (stream == NULL)
+      return "";
+
+    std::string response;
+    char buffer[7];
+    size_t read;
+    while ((read = stream->Read(buffer, sizeof(buffer))) > 0)
+      response.append(buffer, read);
+
+    delete stream;
+    return response;
+  }
+
+  /* the responses of a batch call are built in memory, without any list
+     being streamed */
+  std::string Buffer(const CStdString &request)
+  {
+    CStdString batch = CJSONRPC::MethodCall("[" + request + "]", &transport, &client);
+    CVariant responses = CJSONVariantParser::Parse((const unsigned char *)batch.c_str(), batch.size());
+    if (!responses.isArray() || responses.size() != 1)
+      return "";
+
+    return CJSONVariantWriter::Write(responses[0], g_advancedSettings.m_jsonOutputCompact);
+  }
+
+  TestJSONRPCTransportLayer transport;
+  TestJSONRPCClient client;
+};
+
+TEST_F(TestJSONRPC, StreamedFileItemList)
+{
+  CStdString request = "{ \"jsonrpc\": \"2.0\", \"id\": 1, \"method\": \"Test.GetFiles\", \"params\": { \"properties\": [ \"file\" ] } }";
+
+  std::string streamed = Stream(request);
+  std::string buffered = Buffer(request);
+
+  ASSERT_FALSE(buffered.empty());
+  EXPECT_EQ(buffered, streamed);
+
+  CVariant response = CJSONVariantParser::Parse((const unsigned char *)streamed.c_str(), streamed.size());
+  ASSERT_TRUE(response["result"]["files"].isArray());
+  EXPECT_EQ((unsigned int)TEST_ITEMS, response["result"]["files"].size());
+  EXPECT_STREQ("special://temp/streamed/file 000.mp3", response["result"]["files"][0]["file"].asString().c_str());
+  EXPECT_EQ(TEST_ITEMS, response["result"]["limits"]["total"].asInteger());
+}
+
+TEST_F(TestJSONRPC, StreamedFileItemListLimits)
+{
+  CStdString request = "{ \"jsonrpc\": \"2.0\", \"id\": 2, \"method\": \"Test.GetFiles\", \"params\": { \"limits\": { \"start\": 10, \"end\": 20 } } }";
+
+  std::string streamed = Stream(request);
+  EXPECT_EQ(Buffer(request), streamed);
+
+  CVariant response = CJSONVariantParser::Parse((const unsigned char *)streamed.c_str(), streamed.size());
+  ASSERT_TRUE(response["result"]["files"].isArray());
+  EXPECT_EQ(10u, response["result"]["files"].size());
+  EXPECT_STREQ("file 010.mp3", response["result"]["files"][0]["label"].asString().c_str());
+}
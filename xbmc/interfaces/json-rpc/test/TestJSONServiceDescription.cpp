@@ -0,0 +1,163 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "interfaces/json-rpc/JSONRPC.h"
+#include "interfaces/json-rpc/JSONServiceDescription.h"
+#include "utils/Stopwatch.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+#define BENCHMARK_CALLS 10000
+
+using namespace JSONRPC;
+
+class TestTransportLayer : public ITransportLayer
+{
+public:
+  virtual bool PrepareDownload(const char *path, CVariant &details, std::string &protocol) { return false; }
+  virtual bool Download(const char *path, CVariant &result) { return false; }
+  virtual int GetCapabilities() { return Response; }
+};
+
+class TestClient : public IClient
+{
+public:
+  virtual int GetPermissionFlags() { return OPERATION_PERMISSION_ALL; }
+  virtual int GetAnnouncementFlags() { return 0; }
+  virtual bool SetAnnouncementFlags(int flags) { return false; }
+};
+
+class TestJSONServiceDescription : public testing::Test
+{
+protected:
+  TestJSONServiceDescription()
+  {
+    CJSONRPC::Initialize();
+  }
+
+  JSONRPC_STATUS CheckCall(const char *method, const CVariant &parameters, CVariant &output)
+  {
+    MethodCall methodCall = NULL;
+    return CJSONServiceDescription::CheckCall(method, parameters, &transport, &client, false, methodCall, output);
+  }
+
+  static void GetPlayerProperties(CVariant &parameters)
+  {
+    parameters["playerid"] = 1;
+    parameters["properties"].push_back("time");
+    parameters["properties"].push_back("totaltime");
+    parameters["properties"].push_back("percentage");
+    parameters["properties"].push_back("speed");
+  }
+
+  static void GetMovies(CVariant &parameters)
+  {
+    const char *fields[] = { "title", "genre", "year", "rating", "director", "tagline", "plot",
+                             "playcount", "studio", "mpaa", "cast", "runtime", "streamdetails",
+                             "votes", "fanart", "thumbnail", "file", "sorttitle", "dateadded" };
+    for (unsigned int i = 0; i < sizeof(fields) / sizeof(fields[0]); i++)
+      parameters["properties"].push_back(fields[i]);
+    parameters["limits"]["start"] = 0;
+    parameters["limits"]["end"] = 50;
+    parameters["sort"]["method"] = "sorttitle";
+    parameters["sort"]["ignorearticle"] = true;
+  }
+
+  TestTransportLayer transport;
+  TestClient client;
+};
+
+TEST_F(TestJSONServiceDescription, CheckCallValid)
+{
+  CVariant parameters, output;
+  GetPlayerProperties(parameters);
+
+  EXPECT_EQ(OK, CheckCall("player.getproperties", parameters, output));
+  EXPECT_EQ(1, output["playerid"].asInteger());
+  EXPECT_EQ((unsigned int)4, output["properties"].size());
+  EXPECT_STREQ("totaltime", output["properties"][1].asString().c_str());
+}
+
+TEST_F(TestJSONServiceDescription, CheckCallDefaults)
+{
+  CVariant parameters, output;
+  GetMovies(parameters);
+
+  EXPECT_EQ(OK, CheckCall("videolibrary.getmovies", parameters, output));
+  EXPECT_STREQ("sorttitle", output["sort"]["method"].asString().c_str());
+  EXPECT_STREQ("ascending", output["sort"]["order"].asString().c_str());
+  EXPECT_TRUE(output["sort"]["ignorearticle"].asBoolean());
+  EXPECT_EQ(50, output["limits"]["end"].asInteger());
+}
+
+TEST_F(TestJSONServiceDescription, CheckCallInvalidEnum)
+{
+  CVariant parameters, output;
+  GetPlayerProperties(parameters);
+  parameters["properties"].push_back("unknown");
+
+  EXPECT_EQ(InvalidParams, CheckCall("player.getproperties", parameters, output));
+  EXPECT_STREQ("Player.GetProperties", output["method"].asString().c_str());
+  EXPECT_STREQ("properties", output["stack"]["name"].asString().c_str());
+}
+
+TEST_F(TestJSONServiceDescription, CheckCallMissingParameter)
+{
+  CVariant parameters, output;
+  parameters["playerid"] = 1;
+
+  EXPECT_EQ(InvalidParams, CheckCall("player.getproperties", parameters, output));
+  EXPECT_STREQ("properties", output["stack"]["name"].asString().c_str());
+}
+
+TEST_F(TestJSONServiceDescription, CheckCallAdditionalProperty)
+{
+  CVariant parameters, output;
+  GetMovies(parameters);
+  parameters["limits"]["length"] = 10;
+
+  EXPECT_EQ(InvalidParams, CheckCall("videolibrary.getmovies", parameters, output));
+}
+
+/* only prints the calls/s, run it with --gtest_also_run_disabled_tests */
+TEST_F(TestJSONServiceDescription, DISABLED_Benchmark)
+{
+  // replay the mix of calls a remote sends while showing the movie library
+  // with a playing video: mostly polling the player and some list requests
+  CVariant playerParameters, moviesParameters;
+  GetPlayerProperties(playerParameters);
+  GetMovies(moviesParameters);
+
+  CStopWatch watch;
+  watch.StartZero();
+  for (int i = 0; i < BENCHMARK_CALLS; i++)
+  {
+    CVariant output;
+    if (i % 4 == 0)
+      EXPECT_EQ(OK, CheckCall("videolibrary.getmovies", moviesParameters, output));
+    else
+      EXPECT_EQ(OK, CheckCall("player.getproperties", playerParameters, output));
+  }
+  float elapsed = watch.GetElapsedSeconds();
+
+  std::cout << "Checking " << BENCHMARK_CALLS << " calls: " <<
+    testing::PrintToString(elapsed > 0.0f ? (int)(BENCHMARK_CALLS / elapsed) : 0) << " calls/s" << std::endl;
+}
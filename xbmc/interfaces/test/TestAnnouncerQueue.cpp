@@ -0,0 +1,172 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "interfaces/AnnouncerQueue.h"
+#include "threads/SingleLock.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+
+using namespace ANNOUNCEMENT;
+
+class TestAnnouncer : public IAnnouncer
+{
+public:
+  TestAnnouncer() : m_blocked(true, true) { }
+
+  virtual void Announce(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data)
+  {
+    m_blocked.Wait();
+
+    CSingleLock lock(m_critSection);
+    m_messages.push_back(message);
+    m_data.push_back(data);
+  }
+
+  CEvent m_blocked;
+  CCriticalSection m_critSection;
+  std::vector<std::string> m_messages;
+  std::vector<CVariant> m_data;
+};
+
+TEST(TestAnnouncerQueue, Deliver)
+{
+  TestAnnouncer announcer;
+  CAnnouncerQueue queue(&announcer, 16);
+
+  CVariant data;
+  queue.Push(Player, "xbmc", "OnPlay", data);
+  queue.Push(Player, "xbmc", "OnStop", data);
+  EXPECT_TRUE(queue.Flush(5000));
+
+  ASSERT_EQ((size_t)2, announcer.m_messages.size());
+  EXPECT_STREQ("OnPlay", announcer.m_messages[0].c_str());
+  EXPECT_STREQ("OnStop", announcer.m_messages[1].c_str());
+
+  AnnouncerStatistics statistics;
+  queue.GetStatistics(statistics);
+  EXPECT_EQ(2U, statistics.delivered);
+  EXPECT_EQ(0U, statistics.backlog);
+}
+
+TEST(TestAnnouncerQueue, StartOnPush)
+{
+  TestAnnouncer announcer;
+  CAnnouncerQueue queue(&announcer, 16);
+
+  // nothing to deliver, no thread
+  EXPECT_FALSE(queue.IsRunning());
+  EXPECT_TRUE(queue.Flush(0));
+
+  CVariant data;
+  queue.Push(Player, "xbmc", "OnPlay", data);
+  EXPECT_TRUE(queue.IsRunning());
+  EXPECT_TRUE(queue.Flush(5000));
+  EXPECT_EQ((size_t)1, announcer.m_messages.size());
+}
+
+TEST(TestAnnouncerQueue, Coalesce)
+{
+  TestAnnouncer announcer;
+  announcer.m_blocked.Reset();
+  CAnnouncerQueue queue(&announcer, 16);
+
+  // keeps the announcer busy so that the following ones stay queued
+  CVariant data;
+  queue.Push(Player, "xbmc", "OnPlay", data);
+
+  for (int volume = 0; volume <= 100; volume++)
+  {
+    CVariant volumeData;
+    volumeData["volume"] = volume;
+    queue.Push(Application, "xbmc", "OnVolumeChanged", volumeData);
+  }
+
+  // updates of the same item are merged, different items are kept
+  CVariant first, second;
+  first["item"]["type"] = "movie";
+  first["item"]["id"] = 1;
+  first["playcount"] = 1;
+  second["item"]["type"] = "movie";
+  second["item"]["id"] = 2;
+  queue.Push(VideoLibrary, "xbmc", "OnUpdate", first);
+  queue.Push(VideoLibrary, "xbmc", "OnUpdate", second);
+  first["playcount"] = 2;
+  queue.Push(VideoLibrary, "xbmc", "OnUpdate", first);
+
+  // announcements which aren't states are only merged if they are equal
+  queue.Push(GUI, "xbmc", "OnScreensaverActivated", data);
+  queue.Push(GUI, "xbmc", "OnScreensaverActivated", data);
+
+  announcer.m_blocked.Set();
+  EXPECT_TRUE(queue.Flush(5000));
+
+  ASSERT_EQ((size_t)5, announcer.m_messages.size());
+  EXPECT_STREQ("OnVolumeChanged", announcer.m_messages[1].c_str());
+  EXPECT_EQ(100, announcer.m_data[1]["volume"].asInteger());
+  EXPECT_EQ(1, announcer.m_data[2]["item"]["id"].asInteger());
+  EXPECT_EQ(2, announcer.m_data[2]["playcount"].asInteger());
+  EXPECT_EQ(2, announcer.m_data[3]["item"]["id"].asInteger());
+  EXPECT_STREQ("OnScreensaverActivated", announcer.m_messages[4].c_str());
+}
+
+TEST(TestAnnouncerQueue, Overflow)
+{
+  TestAnnouncer announcer;
+  announcer.m_blocked.Reset();
+  CAnnouncerQueue queue(&announcer, 4);
+
+  CVariant data;
+  queue.Push(Player, "xbmc", "OnPlay", data);
+  // wait for the first announcement to be taken off the queue
+  for (int i = 0; i < 500; i++)
+  {
+    AnnouncerStatistics statistics;
+    queue.GetStatistics(statistics);
+    if (statistics.backlog == 0)
+      break;
+    queue.Sleep(10);
+  }
+
+  for (int i = 0; i < 10; i++)
+  {
+    CVariant added;
+    added["item"]["id"] = i;
+    queue.Push(VideoLibrary, "xbmc", "OnRemove", added);
+  }
+  EXPECT_FALSE(queue.Flush(0));
+
+  AnnouncerStatistics statistics;
+  queue.GetStatistics(statistics);
+  EXPECT_EQ(6U, statistics.dropped);
+  EXPECT_EQ(4U, statistics.backlog);
+  EXPECT_EQ(4U, statistics.maxBacklog);
+
+  announcer.m_blocked.Set();
+  EXPECT_TRUE(queue.Flush(5000));
+
+  // the oldest announcements are the ones which are dropped
+  ASSERT_EQ((size_t)5, announcer.m_messages.size());
+  EXPECT_EQ(6, announcer.m_data[1]["item"]["id"].asInteger());
+  EXPECT_EQ(9, announcer.m_data[4]["item"]["id"].asInteger());
+}
@@ -66,6 +66,7 @@
 #include "playlists/SmartPlayList.h"
 
 using namespace std;
+using namespace dbiplus;
 using namespace AUTOPTR;
 using namespace XFILE;
 using namespace MUSICDATABASEDIRECTORY;
@@ -331,44 +332,57 @@ int CMusicDatabase::AddSong(const CSong& song, bool bCheck, int idAlbum)
     }
     if (bInsert)
     {
-      CStdString strSQL1;
-
-      CStdString strIdSong;
-      if (song.idSong < 0)
-        strIdSong = "NULL";
-      else
-        strIdSong.Format("%d", song.idSong);
-
       // we use replace because it can handle both inserting a new song
-      // and replacing an existing song's record if the given idSong already exists
-      strSQL=PrepareSQL("replace into song (idSong,idAlbum,idPath,strArtists,strGenres,strTitle,iTrack,iDuration,iYear,dwFileNameCRC,strFileName,strMusicBrainzTrackID,strMusicBrainzArtistID,strMusicBrainzAlbumID,strMusicBrainzAlbumArtistID,strMusicBrainzTRMID,iTimesPlayed,iStartOffset,iEndOffset,lastplayed,rating,comment) values (%s,%i,%i,'%s','%s','%s',%i,%i,%i,'%ul','%s','%s','%s','%s','%s','%s'",
-                    strIdSong.c_str(),
-                    idAlbum, idPath, 
-                    StringUtils::Join(song.artist, g_advancedSettings.m_musicItemSeparator).c_str(),
-                    StringUtils::Join(song.genre, g_advancedSettings.m_musicItemSeparator).c_str(),
-                    song.strTitle.c_str(),
-                    song.iTrack, song.iDuration, song.iYear,
-                    crc, strFileName.c_str(),
-                    song.strMusicBrainzTrackID.c_str(),
-                    song.strMusicBrainzArtistID.c_str(),
-                    song.strMusicBrainzAlbumID.c_str(),
-                    song.strMusicBrainzAlbumArtistID.c_str(),
-                    song.strMusicBrainzTRMID.c_str());
-
-      if (song.lastPlayed.IsValid())
-        strSQL1=PrepareSQL(",%i,%i,%i,'%s','%c','%s')",
-                      song.iTimesPlayed, song.iStartOffset, song.iEndOffset, song.lastPlayed.GetAsDBDateTime().c_str(), song.rating, song.strComment.c_str());
-      else
-        strSQL1=PrepareSQL(",%i,%i,%i,NULL,'%c','%s')",
-                      song.iTimesPlayed, song.iStartOffset, song.iEndOffset, song.rating, song.strComment.c_str());
-      strSQL+=strSQL1;
+      // and replacing an existing song's record if the given idSong already exists.
+      // The statement is kept prepared, so a scan only parses it once.
+      strSQL = "replace into song (idSong,idAlbum,idPath,strArtists,strGenres,strTitle,iTrack,iDuration,iYear,dwFileNameCRC,strFileName,strMusicBrainzTrackID,strMusicBrainzArtistID,strMusicBrainzAlbumID,strMusicBrainzAlbumArtistID,strMusicBrainzTRMID,iTimesPlayed,iStartOffset,iEndOffset,lastplayed,rating,comment) values (?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?)";
+      if (!BeginBulkInsert(strSQL))
+        return -1;
 
-      m_pDS->exec(strSQL.c_str());
+      CStdString strCRC;
+      strCRC.Format("%ul", crc);
 
+      vector<field_value> row;
+      row.reserve(22);
+      row.push_back(field_value(song.idSong));
       if (song.idSong < 0)
-        idSong = (int)m_pDS->lastinsertid();
+        row.back().set_isNull();
+      row.push_back(field_value(idAlbum));
+      row.push_back(field_value(idPath));
+      row.push_back(field_value(StringUtils::Join(song.artist, g_advancedSettings.m_musicItemSeparator).c_str()));
+      row.push_back(field_value(StringUtils::Join(song.genre, g_advancedSettings.m_musicItemSeparator).c_str()));
+      row.push_back(field_value(song.strTitle.c_str()));
+      row.push_back(field_value(song.iTrack));
+      row.push_back(field_value(song.iDuration));
+      row.push_back(field_value(song.iYear));
+      row.push_back(field_value(strCRC.c_str()));
+      row.push_back(field_value(strFileName.c_str()));
+      row.push_back(field_value(song.strMusicBrainzTrackID.c_str()));
+      row.push_back(field_value(song.strMusicBrainzArtistID.c_str()));
+      row.push_back(field_value(song.strMusicBrainzAlbumID.c_str()));
+      row.push_back(field_value(song.strMusicBrainzAlbumArtistID.c_str()));
+      row.push_back(field_value(song.strMusicBrainzTRMID.c_str()));
+      row.push_back(field_value(song.iTimesPlayed));
+      row.push_back(field_value(song.iStartOffset));
+      row.push_back(field_value(song.iEndOffset));
+      if (song.lastPlayed.IsValid())
+        row.push_back(field_value(song.lastPlayed.GetAsDBDateTime().c_str()));
       else
+      {
+        row.push_back(field_value());
+        row.back().set_isNull();
+      }
+      row.push_back(field_value(song.rating));
+      row.push_back(field_value(song.strComment.c_str()));
+
+      bool bAdded = BulkInsertRow(row);
+      if (bAdded && song.idSong < 0)
+        idSong = (int)m_pDS2->lastinsertid();
+      else if (bAdded)
         idSong = song.idSong;
+
+      if (!bAdded)
+        return -1;
     }
 
     if (!song.strThumb.empty())
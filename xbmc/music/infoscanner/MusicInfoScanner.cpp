@@ -21,6 +21,7 @@
 #include "threads/SystemClock.h"
 #include "MusicInfoScanner.h"
 #include "music/tags/MusicInfoTagLoaderFactory.h"
+#include "music/tags/TagLoaderPool.h"
 #include "MusicAlbumInfo.h"
 #include "MusicInfoScraper.h"
 #include "filesystem/MusicDatabaseDirectory.h"
@@ -68,6 +69,7 @@ CMusicInfoScanner::CMusicInfoScanner() : CThread("CMusicInfoScanner")
   m_currentItem=0;
   m_itemCount=0;
   m_flags = 0;
+  m_tagLoaderPool = NULL;
 }
 
 CMusicInfoScanner::~CMusicInfoScanner()
@@ -115,6 +117,9 @@ void CMusicInfoScanner::Process()
       m_bCanInterrupt = false;
       m_needsCleanup = false;
 
+      if (g_advancedSettings.m_musicScannerThreads > 1)
+        m_tagLoaderPool = new CTagLoaderPool(g_advancedSettings.m_musicScannerThreads);
+
       bool commit = false;
       bool cancelled = false;
       while (!cancelled && m_pathsToScan.size())
@@ -154,6 +159,9 @@ void CMusicInfoScanner::Process()
 
       fileCountReader.StopThread();
 
+      delete m_tagLoaderPool;
+      m_tagLoaderPool = NULL;
+
       m_musicDatabase.EmptyCache();
 
       m_musicDatabase.Close();
@@ -471,6 +479,21 @@ int CMusicInfoScanner::RetrieveMusicInfo(CFileItemList& items, const CStdString&
 
   CStdStringArray regexps = g_advancedSettings.m_audioExcludeFromScanRegExps;
 
+  // read all the tags up front if we have threads to spare, the loop below
+  // then only picks up the loaded tags
+  if (m_tagLoaderPool)
+  {
+    vector<CFileItemPtr> itemsToLoad;
+    for (int i = 0; i < items.Size(); ++i)
+    {
+      CFileItemPtr pItem = items[i];
+      if (!pItem->m_bIsFolder && !pItem->IsPlayList() && !pItem->IsPicture() && !pItem->IsLyrics() &&
+          !CUtil::ExcludeFileOrFolder(pItem->GetPath(), regexps))
+        itemsToLoad.push_back(pItem);
+    }
+    m_tagLoaderPool->Load(itemsToLoad, m_bStop);
+  }
+
   // for every file found, but skip folder
   for (int i = 0; i < items.Size(); ++i)
   {
@@ -28,6 +28,8 @@ class CGUIDialogProgressBarHandle;
 
 namespace MUSIC_INFO
 {
+class CTagLoaderPool;
+
 class CMusicInfoScanner : CThread, public IRunnable
 {
 public:
@@ -116,6 +118,7 @@ protected:
   bool m_needsCleanup;
   int m_scanType; // 0 - load from files, 1 - albums, 2 - artists
   CMusicDatabase m_musicDatabase;
+  CTagLoaderPool* m_tagLoaderPool;
 
   std::set<CStdString> m_pathsToScan;
   std::set<CAlbum> m_albumsToScan;
@@ -30,6 +30,15 @@ namespace MUSIC_INFO
       virtual ~CMusicInfoTagLoaderFactory();
 
       static IMusicInfoTagLoader* CreateLoader(const CStdString& strFileName);
+
+      /*! \brief Whether the tags of a file are read with TagLib
+       TagLib keeps no state between files, so these may be read on several threads at once.
+       \param strFileName the file to check
+       \return true if CreateLoader() returns a TagLib loader for this file
+       */
+      static bool UsesTagLib(const CStdString& strFileName);
+    private:
+      static bool IsTagLibExtension(const CStdString& strExtension);
   };
 }
 
@@ -0,0 +1,159 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TagLoaderPool.h"
+#include "MusicInfoTagLoaderFactory.h"
+#include "MusicInfoTag.h"
+#undef byte
+#include <taglib/id3v2framefactory.h>
+#include "FileItem.h"
+#include "threads/SingleLock.h"
+
+#include <memory>
+
+using namespace std;
+using namespace MUSIC_INFO;
+
+CTagLoaderPool::CTagLoaderPool(unsigned int threads)
+  : m_work(true)
+{
+  m_outstanding = 0;
+  m_exit = false;
+
+  // make sure the shared frame factory exists before several threads ask for it
+  TagLib::ID3v2::FrameFactory::instance();
+
+  for (unsigned int i = 1; i < threads; i++)
+  {
+    CThread *thread = new CThread(this, "CTagLoaderPool");
+    thread->Create();
+    m_threads.push_back(thread);
+  }
+}
+
+CTagLoaderPool::~CTagLoaderPool()
+{
+  {
+    CSingleLock lock(m_section);
+    m_exit = true;
+    m_queue.clear();
+    m_work.Set();
+  }
+
+  for (vector<CThread*>::iterator it = m_threads.begin(); it != m_threads.end(); ++it)
+  {
+    (*it)->StopThread();
+    delete *it;
+  }
+}
+
+void CTagLoaderPool::Load(const vector<CFileItemPtr> &items, const volatile bool &stop)
+{
+  if (stop)
+    return;
+
+  vector<CFileItemPtr> local;
+  {
+    CSingleLock lock(m_section);
+    for (vector<CFileItemPtr>::const_iterator it = items.begin(); it != items.end(); ++it)
+    {
+      if ((*it)->GetMusicInfoTag()->Loaded())
+        continue;
+
+      if (!m_threads.empty() && CMusicInfoTagLoaderFactory::UsesTagLib((*it)->GetPath()))
+      {
+        m_queue.push_back(*it);
+        m_outstanding++;
+      }
+      else
+        local.push_back(*it);
+    }
+    if (!m_queue.empty())
+      m_work.Set();
+  }
+
+  // the other loaders might not cope with being run on several threads at once
+  for (vector<CFileItemPtr>::iterator it = local.begin(); it != local.end() && !stop; ++it)
+    LoadTag(**it);
+
+  // help out with the rest
+  while (!stop && LoadNext())
+    ;
+
+  CSingleLock lock(m_section);
+  if (stop)
+  {
+    m_outstanding -= m_queue.size();
+    m_queue.clear();
+    m_work.Reset();
+  }
+
+  // wait for the items still being read
+  while (m_outstanding)
+  {
+    CSingleExit exit(m_section);
+    m_done.WaitMSec(100);
+  }
+}
+
+void CTagLoaderPool::Run()
+{
+  while (true)
+  {
+    m_work.Wait();
+    {
+      CSingleLock lock(m_section);
+      if (m_exit)
+        return;
+    }
+    while (LoadNext())
+      ;
+  }
+}
+
+bool CTagLoaderPool::LoadNext()
+{
+  CFileItemPtr item;
+  {
+    CSingleLock lock(m_section);
+    if (m_queue.empty())
+    {
+      m_work.Reset();
+      return false;
+    }
+    item = m_queue.front();
+    m_queue.pop_front();
+  }
+
+  LoadTag(*item);
+
+  CSingleLock lock(m_section);
+  if (--m_outstanding == 0)
+    m_done.Set();
+  return true;
+}
+
+void CTagLoaderPool::LoadTag(CFileItem &item)
+{
+  CMusicInfoTag& tag = *item.GetMusicInfoTag();
+  auto_ptr<IMusicInfoTagLoader> pLoader (CMusicInfoTagLoaderFactory::CreateLoader(item.GetPath()));
+  if (NULL != pLoader.get())
+    pLoader->Load(item.GetPath(), tag);
+}
@@ -0,0 +1,68 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+
+#include <deque>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+class CFileItem;
+typedef boost::shared_ptr<CFileItem> CFileItemPtr;
+
+namespace MUSIC_INFO
+{
+  /*! \brief Reads music tags on several threads at once.
+   Files whose tags are read with TagLib are shared between the worker threads and the
+   calling thread, every other loader is run on the calling thread as before.
+   */
+  class CTagLoaderPool : private IRunnable
+  {
+  public:
+    /*! \brief Create a pool
+     \param threads the number of threads reading tags, including the one calling Load()
+     */
+    CTagLoaderPool(unsigned int threads);
+    virtual ~CTagLoaderPool();
+
+    /*! \brief Load the music tags of the given items
+     Blocks until every tag has been read, or until stop is set.
+     \param items the items to load tags for, items that already have a tag are skipped
+     \param stop checked between items to abort loading
+     */
+    void Load(const std::vector<CFileItemPtr> &items, const volatile bool &stop);
+
+  private:
+    virtual void Run();
+    bool LoadNext();
+    static void LoadTag(CFileItem &item);
+
+    CCriticalSection m_section;
+    CEvent m_work; ///< set while there are items queued
+    CEvent m_done; ///< set when the last outstanding item has been read
+    std::deque<CFileItemPtr> m_queue;
+    unsigned int m_outstanding;
+    bool m_exit;
+    std::vector<CThread*> m_threads;
+  };
+}
@@ -0,0 +1,175 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "music/tags/TagLoaderPool.h"
+#include "music/tags/MusicInfoTag.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "threads/SystemClock.h"
+#include "FileItem.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+
+#define SYNTHETIC_DIRS  20
+#define SYNTHETIC_FILES 25 // per directory
+
+/* Writes a tree of small mp3 files carrying nothing but an ID3v2.3 tag,
+ * which is all TagLib needs to hand back a title, artist and album.
+ */
+class TestTagLoaderPool : public testing::Test
+{
+protected:
+  TestTagLoaderPool()
+  {
+    XFILE::CDirectory::Create("special://temp/tagloaderpool/");
+    for (int dir = 0; dir < SYNTHETIC_DIRS; dir++)
+    {
+      CStdString path;
+      path.Format("special://temp/tagloaderpool/album%02i/", dir);
+      XFILE::CDirectory::Create(path);
+      for (int file = 0; file < SYNTHETIC_FILES; file++)
+      {
+        CStdString fileName, title, album;
+        fileName.Format("%strack%02i.mp3", path.c_str(), file);
+        title.Format("Track %i", dir * SYNTHETIC_FILES + file);
+        album.Format("Album %i", dir);
+        WriteFile(fileName, title, album);
+        m_files.push_back(fileName);
+      }
+    }
+  }
+
+  ~TestTagLoaderPool()
+  {
+    for (std::vector<CStdString>::iterator it = m_files.begin(); it != m_files.end(); ++it)
+      XFILE::CFile::Delete(*it);
+    for (int dir = 0; dir < SYNTHETIC_DIRS; dir++)
+    {
+      CStdString path;
+      path.Format("special://temp/tagloaderpool/album%02i/", dir);
+      XFILE::CDirectory::Remove(path);
+    }
+    XFILE::CDirectory::Remove("special://temp/tagloaderpool/");
+  }
+
+  static void AddFrame(std::string &tag, const char *id, const CStdString &text)
+  {
+    unsigned int size = text.size() + 1;
+    tag.append(id, 4);
+    tag += (char)((size >> 24) & 0xff);
+    tag += (char)((size >> 16) & 0xff);
+    tag += (char)((size >> 8) & 0xff);
+    tag += (char)(size & 0xff);
+    tag.append(2, '\0'); // flags
+    tag += '\0'; // ISO-8859-1
+    tag += text;
+  }
+
+  static void WriteFile(const CStdString &fileName, const CStdString &title, const CStdString &album)
+  {
+    std::string frames;
+    AddFrame(frames, "TIT2", title);
+    AddFrame(frames, "TPE1", "Synthetic Artist");
+    AddFrame(frames, "TALB", album);
+    frames.append(1024, '\0'); // padding
+
+    std::string data("ID3\x03\x00\x00", 6);
+    unsigned int size = frames.size();
+    data += (char)((size >> 21) & 0x7f);
+    data += (char)((size >> 14) & 0x7f);
+    data += (char)((size >> 7) & 0x7f);
+    data += (char)(size & 0x7f);
+    data += frames;
+    data.append(4096, '\0'); // stands in for the audio
+
+    XFILE::CFile file;
+    ASSERT_TRUE(file.OpenForWrite(fileName, true));
+    ASSERT_EQ((int)data.size(), file.Write(data.c_str(), data.size()));
+    file.Close();
+  }
+
+  void LoadAll(unsigned int threads, bool timed = false)
+  {
+    std::vector<CFileItemPtr> items;
+    for (std::vector<CStdString>::iterator it = m_files.begin(); it != m_files.end(); ++it)
+      items.push_back(CFileItemPtr(new CFileItem(*it, false)));
+
+    bool stop = false;
+    unsigned int start = XbmcThreads::SystemClockMillis();
+    {
+      MUSIC_INFO::CTagLoaderPool pool(threads);
+      for (unsigned int i = 0; i < items.size(); i += SYNTHETIC_FILES)
+      {
+        std::vector<CFileItemPtr> directory(items.begin() + i, items.begin() + i + SYNTHETIC_FILES);
+        pool.Load(directory, stop);
+      }
+    }
+    unsigned int elapsed = XbmcThreads::SystemClockMillis() - start;
+    if (timed)
+      printf("%u thread(s): %u files in %u ms (%.1f files/sec)\n", threads, (unsigned int)items.size(), elapsed,
+             elapsed ? items.size() * 1000.0f / elapsed : 0.0f);
+
+    for (unsigned int i = 0; i < items.size(); i++)
+    {
+      CStdString title;
+      title.Format("Track %u", i);
+      MUSIC_INFO::CMusicInfoTag *tag = items[i]->GetMusicInfoTag();
+      EXPECT_TRUE(tag->Loaded());
+      EXPECT_STREQ(title.c_str(), tag->GetTitle().c_str());
+    }
+  }
+
+  std::vector<CStdString> m_files;
+};
+
+TEST_F(TestTagLoaderPool, SingleThread)
+{
+  LoadAll(1);
+}
+
+TEST_F(TestTagLoaderPool, FourThreads)
+{
+  LoadAll(4);
+}
+
+/* compares the throughput of one and four threads, the numbers say
+   nothing in the normal run so it has to be asked for with
+   --gtest_also_run_disabled_tests */
+TEST_F(TestTagLoaderPool, DISABLED_Benchmark)
+{
+  LoadAll(1, true);
+  LoadAll(4, true);
+}
+
+TEST_F(TestTagLoaderPool, Stop)
+{
+  std::vector<CFileItemPtr> items;
+  for (std::vector<CStdString>::iterator it = m_files.begin(); it != m_files.end(); ++it)
+    items.push_back(CFileItemPtr(new CFileItem(*it, false)));
+
+  bool stop = true;
+  MUSIC_INFO::CTagLoaderPool pool(4);
+  pool.Load(items, stop);
+
+  for (unsigned int i = 0; i < items.size(); i++)
+    EXPECT_FALSE(items[i]->GetMusicInfoTag()->Loaded());
+}
@@ -467,6 +467,9 @@ bool CTCPServer::InitializeTCP()
 
 void CTCPServer::Deinitialize()
 {
+  // the announcer thread sends to the connections, so it goes first
+  CAnnouncementManager::RemoveAnnouncer(this);
+
   for (unsigned int i = 0; i < m_connections.size(); i++)
   {
     m_connections[i]->Disconnect();
@@ -485,8 +488,6 @@ void CTCPServer::Deinitialize()
     sdp_close( (sdp_session_t*)m_sdpd );
   m_sdpd = NULL;
 #endif
-
-  CAnnouncementManager::RemoveAnnouncer(this);
 }
 
 CTCPServer::CTCPClient::CTCPClient()
@@ -535,10 +536,22 @@ void CTCPServer::CTCPClient::Send(const char *data, unsigned int size)
   do
   {
     CSingleLock lock (m_critSection);
-    sent += send(m_socket, data, size - sent, 0);
+    int ret = send(m_socket, data + sent, size - sent, 0);
+    if (ret < 0)
+      break;
+    sent += ret;
   } while (sent < size);
 }
 
+void CTCPServer::CTCPClient::Send(CJSONRPCResponseStream &stream)
+{
+  // send the response in pieces while it is serialized
+  char buffer[16384];
+  size_t size;
+  while ((size = stream.Read(buffer, sizeof(buffer))) > 0)
+    Send(buffer, (unsigned int)size);
+}
+
 void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
 {
   m_new = false;
@@ -567,8 +580,12 @@ void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, in
         m_endBrackets++;
       if (m_beginBrackets > 0 && m_endBrackets > 0 && m_beginBrackets == m_endBrackets)
       {
-        std::string line = CJSONRPC::MethodCall(m_buffer, host, this);
-        Send(line.c_str(), line.size());
+        CJSONRPCResponseStream *stream = CJSONRPC::MethodCallStream(m_buffer, host, this);
+        if (stream != NULL)
+        {
+          Send(*stream);
+          delete stream;
+        }
         m_beginChar = m_beginBrackets = m_endBrackets = 0;
         m_buffer.clear();
       }
@@ -643,6 +660,13 @@ void CTCPServer::CWebSocketClient::Send(const char *data, unsigned int size)
     CTCPClient::Send(frames.at(index)->GetFrameData(), (unsigned int)frames.at(index)->GetFrameLength());
 }
 
+void CTCPServer::CWebSocketClient::Send(CJSONRPCResponseStream &stream)
+{
+  // every piece sent would be a websocket message of its own
+  std::string response = stream.ReadAll();
+  Send(response.c_str(), (unsigned int)response.size());
+}
+
 void CTCPServer::CWebSocketClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
 {
   bool send;
@@ -25,7 +25,9 @@
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
 #include "utils/Base64.h"
+#include "utils/HttpRangeUtils.h"
 #include "threads/SingleLock.h"
+#include "settings/AdvancedSettings.h"
 #include "XBDateTime.h"
 #include "URL.h"
 
@@ -34,6 +36,11 @@
 #endif
 
 #define MAX_POST_BUFFER_SIZE 2048
+#define FILE_DOWNLOAD_BLOCK_SIZE (64 * 1024)
+
+#ifndef MHD_SIZE_UNKNOWN
+#define MHD_SIZE_UNKNOWN -1
+#endif
 
 #define PAGE_FILE_NOT_FOUND "<html><head><title>File not found</title></head><body>File not found</body></html>"
 #define NOT_SUPPORTED       "<html><head><title>Not Supported</title></head><body>The method you are trying to use is not supported by this server</body></html>"
@@ -305,6 +312,10 @@ int CWebServer::HandleRequest(IHTTPRequestHandler *handler, const HTTPRequest &r
       ret = CreateMemoryDownloadResponse(request.connection, handler->GetHTTPResponseData(), handler->GetHTTPResonseDataLength(), true, true, response);
       break;
 
+    case HTTPStreamDownload:
+      ret = CreateStreamDownloadResponse(request.connection, handler->GetHTTPResponseStream(), response);
+      break;
+
     case HTTPError:
       ret = CreateErrorResponse(request.connection, handler->GetHTTPResonseCode(), request.method, response);
       break;
@@ -361,39 +372,133 @@ int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, co
   if (file->Open(strURL, READ_NO_CACHE))
   {
     bool getData = true;
+
+    CStdString ext = URIUtils::GetExtension(strURL);
+    ext = ext.ToLower();
+    const char *mime = CreateMimeTypeFromExtension(ext.c_str());
+    string contentType = mime != NULL ? mime : "";
+
+    CDateTime lastModified;
+    struct __stat64 statBuffer;
+    if (file->Stat(&statBuffer) == 0)
+    {
+      struct tm *time = localtime((time_t *)&statBuffer.st_mtime);
+      if (time != NULL)
+        lastModified = *time;
+    }
+
     if (methodType != HEAD)
     {
       if (methodType == GET)
       {
         string ifModifiedSince = GetRequestHeaderValue(connection, MHD_HEADER_KIND, "If-Modified-Since");
-        if (!ifModifiedSince.empty())
+        if (!ifModifiedSince.empty() && lastModified.IsValid())
         {
           CDateTime ifModifiedSinceDate;
           ifModifiedSinceDate.SetFromRFC1123DateTime(ifModifiedSince);
 
-          struct __stat64 statBuffer;
-          if (file->Stat(&statBuffer) == 0)
+          if (lastModified.GetAsUTCDateTime() <= ifModifiedSinceDate)
           {
-            struct tm *time = localtime((time_t *)&statBuffer.st_mtime);
-            if (time != NULL)
+            getData = false;
+            response = MHD_create_response_from_data (0, NULL, MHD_NO, MHD_NO);
+            responseCode = MHD_HTTP_NOT_MODIFIED;
+          }
+        }
+      }
+
+      if (getData)
+      {
+        HttpFileDownloadContext *context = new HttpFileDownloadContext();
+        context->file = file;
+
+        uint64_t totalLength = file->GetLength();
+        uint64_t bodyLength = totalLength;
+
+        // only honour the Range header if the file hasn't changed since the
+        // client got the date of the last modification in the If-Range header
+        CHttpRanges ranges;
+        bool hasRanges = false;
+        if (methodType == GET && totalLength > 0)
+        {
+          string range = GetRequestHeaderValue(connection, MHD_HEADER_KIND, "Range");
+          string ifRange = GetRequestHeaderValue(connection, MHD_HEADER_KIND, "If-Range");
+          if (!range.empty() && (ifRange.empty() || (lastModified.IsValid() && ifRange == lastModified.GetAsRFC1123DateTime())))
+            hasRanges = ranges.Parse(range, totalLength);
+        }
+
+        if (hasRanges && ranges.IsEmpty())
+        {
+          delete context;
+          getData = false;
+
+          response = MHD_create_response_from_data (0, NULL, MHD_NO, MHD_NO);
+          responseCode = MHD_HTTP_REQUESTED_RANGE_NOT_SATISFIABLE;
+          if (response != NULL)
+          {
+            CStdString contentRange;
+            contentRange.Format("bytes */%" PRIu64, totalLength);
+            MHD_add_response_header(response, "Content-Range", contentRange.c_str());
+          }
+        }
+        else
+        {
+          if (hasRanges && ranges.Size() == 1)
+          {
+            const CHttpRange &range = ranges.Get(0);
+            HttpFileDownloadPart part = { "", range.GetFirstPosition(), range.GetLength() };
+            context->parts.push_back(part);
+            bodyLength = range.GetLength();
+          }
+          // several ranges are sent as a multipart/byteranges body
+          // with every range introduced by its own headers
+          else if (hasRanges)
+          {
+            string boundary = GenerateMultipartBoundary();
+            bodyLength = 0;
+            for (size_t index = 0; index < ranges.Size(); index++)
             {
-              CDateTime lastModified = *time;
-              if (lastModified.GetAsUTCDateTime() <= ifModifiedSinceDate)
-              {
-                getData = false;
-                response = MHD_create_response_from_data (0, NULL, MHD_NO, MHD_NO);
-                responseCode = MHD_HTTP_NOT_MODIFIED;
-              }
+              const CHttpRange &range = ranges.Get(index);
+
+              string header = (index > 0 ? "\r\n--" : "--") + boundary + "\r\n";
+              if (!contentType.empty())
+                header += "Content-Type: " + contentType + "\r\n";
+              header += "Content-Range: " + range.GetContentRange(totalLength) + "\r\n\r\n";
+
+              HttpFileDownloadPart headerPart = { header, 0, header.size() };
+              HttpFileDownloadPart dataPart = { "", range.GetFirstPosition(), range.GetLength() };
+              context->parts.push_back(headerPart);
+              context->parts.push_back(dataPart);
+              bodyLength += headerPart.length + dataPart.length;
             }
+
+            string footer = "\r\n--" + boundary + "--\r\n";
+            HttpFileDownloadPart footerPart = { footer, 0, footer.size() };
+            context->parts.push_back(footerPart);
+            bodyLength += footerPart.length;
+
+            contentType = "multipart/byteranges; boundary=" + boundary;
+          }
+          else
+          {
+            HttpFileDownloadPart part = { "", 0, totalLength };
+            context->parts.push_back(part);
+          }
+
+          response = MHD_create_response_from_callback(bodyLength,
+                                                       FILE_DOWNLOAD_BLOCK_SIZE,
+                                                       &CWebServer::ContentReaderCallback, context,
+                                                       &CWebServer::ContentReaderFreeCallback);
+          if (response == NULL)
+            delete context;
+          else if (hasRanges)
+          {
+            responseCode = MHD_HTTP_PARTIAL_CONTENT;
+            if (ranges.Size() == 1)
+              MHD_add_response_header(response, "Content-Range", ranges.Get(0).GetContentRange(totalLength).c_str());
           }
         }
       }
 
-      if (getData)
-        response = MHD_create_response_from_callback(file->GetLength(),
-                                                     2048,
-                                                     &CWebServer::ContentReaderCallback, file,
-                                                     &CWebServer::ContentReaderFreeCallback);
       if (response == NULL)
       {
         file->Close();
@@ -418,24 +523,16 @@ int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, co
       MHD_add_response_header(response, "Content-Length", contentLength);
     }
 
+    // let the client know it can ask for parts of the file
+    MHD_add_response_header(response, "Accept-Ranges", "bytes");
+
     // set the Content-Type header
-    CStdString ext = URIUtils::GetExtension(strURL);
-    ext = ext.ToLower();
-    const char *mime = CreateMimeTypeFromExtension(ext.c_str());
-    if (mime)
-      MHD_add_response_header(response, "Content-Type", mime);
+    if (!contentType.empty())
+      MHD_add_response_header(response, "Content-Type", contentType.c_str());
 
     // set the Last-Modified header
-    struct __stat64 statBuffer;
-    if (file->Stat(&statBuffer) == 0)
-    {
-      struct tm *time = localtime((time_t *)&statBuffer.st_mtime);
-      if (time != NULL)
-      {
-        CDateTime lastModified = *time;
-        MHD_add_response_header(response, "Last-Modified", lastModified.GetAsRFC1123DateTime());
-      }
-    }
+    if (lastModified.IsValid())
+      MHD_add_response_header(response, "Last-Modified", lastModified.GetAsRFC1123DateTime());
 
     // set the Expires header
     CDateTime expiryTime = CDateTime::GetCurrentDateTime();
@@ -495,6 +592,23 @@ int CWebServer::CreateMemoryDownloadResponse(struct MHD_Connection *connection,
   return MHD_NO;
 }
 
+int CWebServer::CreateStreamDownloadResponse(struct MHD_Connection *connection, IHTTPResponseStream *stream, struct MHD_Response *&response)
+{
+  if (stream == NULL)
+    return MHD_NO;
+
+  // the length is unknown so libmicrohttpd sends the body chunked
+  response = MHD_create_response_from_callback(MHD_SIZE_UNKNOWN,
+                                               16384,
+                                               &CWebServer::StreamReaderCallback, stream,
+                                               &CWebServer::StreamReaderFreeCallback);
+  if (response)
+    return MHD_YES;
+
+  delete stream;
+  return MHD_NO;
+}
+
 int CWebServer::SendErrorResponse(struct MHD_Connection *connection, int errorType, HTTPMethod method)
 {
   struct MHD_Response *response = NULL;
@@ -522,21 +636,78 @@ int CWebServer::ContentReaderCallback(void *cls, uint64_t pos, char *buf, int ma
 int CWebServer::ContentReaderCallback(void *cls, size_t pos, char *buf, int max)
 #endif
 {
-  CFile *file = (CFile *)cls;
-  if((unsigned int)pos != file->GetPosition())
-    file->Seek(pos);
-  unsigned res = file->Read(buf, max);
-  if(res == 0)
+  HttpFileDownloadContext *context = (HttpFileDownloadContext *)cls;
+  if (context == NULL || context->file == NULL || max <= 0)
     return -1;
-  return res;
+
+  size_t written = 0;
+  uint64_t partStart = 0;
+  for (vector<HttpFileDownloadPart>::const_iterator part = context->parts.begin(); part != context->parts.end() && written < (size_t)max; part++)
+  {
+    uint64_t position = pos + written;
+    uint64_t partEnd = partStart + part->length;
+    if (position >= partEnd)
+    {
+      partStart = partEnd;
+      continue;
+    }
+
+    size_t size = (size_t)min((uint64_t)(max - written), partEnd - position);
+    if (!part->data.empty())
+      memcpy(buf + written, part->data.c_str() + (position - partStart), size);
+    else
+    {
+      int64_t filePosition = part->position + (position - partStart);
+      if (context->file->GetPosition() != filePosition && context->file->Seek(filePosition) != filePosition)
+        break;
+
+      size = context->file->Read(buf + written, size);
+      if (size == 0)
+        break;
+    }
+
+    written += size;
+    // a short read from the file leaves the rest to the next call
+    if (position + size < partEnd)
+      break;
+
+    partStart = partEnd;
+  }
+
+  if (written == 0)
+    return -1;
+  return written;
 }
 
 void CWebServer::ContentReaderFreeCallback(void *cls)
 {
-  CFile *file = (CFile *)cls;
-  file->Close();
+  HttpFileDownloadContext *context = (HttpFileDownloadContext *)cls;
+  if (context == NULL)
+    return;
 
-  delete file;
+  context->file->Close();
+  delete context->file;
+  delete context;
+}
+
+#if (MHD_VERSION >= 0x00090200)
+ssize_t CWebServer::StreamReaderCallback (void *cls, uint64_t pos, char *buf, size_t max)
+#elif (MHD_VERSION >= 0x00040001)
+int CWebServer::StreamReaderCallback(void *cls, uint64_t pos, char *buf, int max)
+#else   //libmicrohttpd < 0.4.0
+int CWebServer::StreamReaderCallback(void *cls, size_t pos, char *buf, int max)
+#endif
+{
+  IHTTPResponseStream *stream = (IHTTPResponseStream *)cls;
+  size_t res = stream->Read(buf, max);
+  if (res == 0)
+    return -1;
+  return res;
+}
+
+void CWebServer::StreamReaderFreeCallback(void *cls)
+{
+  delete (IHTTPResponseStream *)cls;
 }
 
 struct MHD_Daemon* CWebServer::StartMHD(unsigned int flags, int port)
@@ -555,7 +726,7 @@ struct MHD_Daemon* CWebServer::StartMHD(unsigned int flags, int port)
                           &CWebServer::AnswerToConnection,
                           this,
 #if (MHD_VERSION >= 0x00040002)
-                          MHD_OPTION_THREAD_POOL_SIZE, 4,
+                          MHD_OPTION_THREAD_POOL_SIZE, (flags & MHD_USE_THREAD_PER_CONNECTION) ? 0 : g_advancedSettings.m_webServerThreads,
 #endif
                           MHD_OPTION_CONNECTION_LIMIT, 512,
                           MHD_OPTION_CONNECTION_TIMEOUT, timeout,
@@ -568,7 +739,12 @@ bool CWebServer::Start(int port, const string &username, const string &password)
   SetCredentials(username, password);
   if (!m_running)
   {
-    m_daemon = StartMHD(MHD_USE_SELECT_INTERNALLY, port);
+    // either a pool of threads serving all connections or one thread per
+    // connection so that slow reads on one connection don't hold up others
+    if (g_advancedSettings.m_webServerThreads > 0)
+      m_daemon = StartMHD(MHD_USE_SELECT_INTERNALLY, port);
+    else
+      m_daemon = StartMHD(MHD_USE_THREAD_PER_CONNECTION, port);
 
     m_running = m_daemon != NULL;
     if (m_running)
@@ -681,6 +857,17 @@ void CWebServer::UnregisterRequestHandler(IHTTPRequestHandler *handler)
   }
 }
 
+std::string CWebServer::GenerateMultipartBoundary()
+{
+  static const char chars[] = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+  string boundary = "xbmc-";
+  for (int i = 0; i < 24; i++)
+    boundary += chars[rand() % (sizeof(chars) - 1)];
+
+  return boundary;
+}
+
 std::string CWebServer::GetRequestHeaderValue(struct MHD_Connection *connection, enum MHD_ValueKind kind, const std::string &key)
 {
   if (connection == NULL)
@@ -31,6 +31,11 @@
 using namespace std;
 using namespace JSONRPC;
 
+CHTTPJsonRpcHandler::~CHTTPJsonRpcHandler()
+{
+  delete m_stream;
+}
+
 bool CHTTPJsonRpcHandler::CheckHTTPRequest(const HTTPRequest &request)
 {
   return (request.url.compare("/jsonrpc") == 0);
@@ -68,7 +73,7 @@ int CHTTPJsonRpcHandler::HandleHTTPRequest(const HTTPRequest &request)
   }
 
   if (isRequest)
-    m_response = CJSONRPC::MethodCall(m_request, request.webserver, &client);
+    m_stream = CJSONRPC::MethodCallStream(m_request, request.webserver, &client);
   else
   {
     // get the whole output of JSONRPC.Introspect
@@ -81,12 +86,24 @@ int CHTTPJsonRpcHandler::HandleHTTPRequest(const HTTPRequest &request)
 
   m_request.clear();
   
-  m_responseType = HTTPMemoryDownloadNoFreeCopy;
+  // send the response while it is serialized instead of building it in memory first
+  m_responseType = m_stream != NULL ? HTTPStreamDownload : HTTPMemoryDownloadNoFreeCopy;
   m_responseCode = MHD_HTTP_OK;
 
   return MHD_YES;
 }
 
+IHTTPResponseStream* CHTTPJsonRpcHandler::GetHTTPResponseStream()
+{
+  if (m_stream == NULL)
+    return NULL;
+
+  IHTTPResponseStream *stream = new CResponseStream(m_stream);
+  m_stream = NULL;
+
+  return stream;
+}
+
 #if (MHD_VERSION >= 0x00040001)
 bool CHTTPJsonRpcHandler::appendPostData(const char *data, size_t size)
 #else
@@ -104,6 +121,16 @@ bool CHTTPJsonRpcHandler::appendPostData(const char *data, unsigned int size)
   return true;
 }
 
+CHTTPJsonRpcHandler::CResponseStream::~CResponseStream()
+{
+  delete m_stream;
+}
+
+size_t CHTTPJsonRpcHandler::CResponseStream::Read(char *buffer, size_t size)
+{
+  return m_stream->Read(buffer, size);
+}
+
 int CHTTPJsonRpcHandler::CHTTPClient::GetPermissionFlags()
 {
   return OPERATION_PERMISSION_ALL;
@@ -22,17 +22,24 @@
 #include "IHTTPRequestHandler.h"
 #include "interfaces/json-rpc/IClient.h"
 
+namespace JSONRPC
+{
+  class CJSONRPCResponseStream;
+}
+
 class CHTTPJsonRpcHandler : public IHTTPRequestHandler
 {
 public:
-  CHTTPJsonRpcHandler() { };
-  
+  CHTTPJsonRpcHandler() : m_stream(NULL) { };
+  virtual ~CHTTPJsonRpcHandler();
+
   virtual IHTTPRequestHandler* GetInstance() { return new CHTTPJsonRpcHandler(); }
   virtual bool CheckHTTPRequest(const HTTPRequest &request);
   virtual int HandleHTTPRequest(const HTTPRequest &request);
 
   virtual void* GetHTTPResponseData() const { return (void *)m_response.c_str(); };
   virtual size_t GetHTTPResonseDataLength() const { return m_response.size(); }
+  virtual IHTTPResponseStream* GetHTTPResponseStream();
 
   virtual int GetPriority() const { return 2; }
 
@@ -46,6 +53,17 @@ protected:
 private:
   std::string m_request;
   std::string m_response;
+  JSONRPC::CJSONRPCResponseStream *m_stream;
+
+  class CResponseStream : public IHTTPResponseStream
+  {
+  public:
+    CResponseStream(JSONRPC::CJSONRPCResponseStream *stream) : m_stream(stream) { }
+    virtual ~CResponseStream();
+    virtual size_t Read(char *buffer, size_t size);
+  private:
+    JSONRPC::CJSONRPCResponseStream *m_stream;
+  };
 
   class CHTTPClient : public JSONRPC::IClient
   {
@@ -92,9 +92,10 @@ CPeripheralCecAdapter::CPeripheralCecAdapter(const PeripheralType type, const Pe
 
 CPeripheralCecAdapter::~CPeripheralCecAdapter(void)
 {
+  // not under m_critSection, RemoveAnnouncer waits for Announce() which takes it
+  CAnnouncementManager::RemoveAnnouncer(this);
   {
     CSingleLock lock(m_critSection);
-    CAnnouncementManager::RemoveAnnouncer(this);
     m_bStop = true;
   }
 
@@ -1697,10 +1698,10 @@ void CPeripheralCecAdapter::OnDeviceRemoved(void)
 bool CPeripheralCecAdapter::ReopenConnection(void)
 {
   // stop running thread
+  CAnnouncementManager::RemoveAnnouncer(this);
   {
     CSingleLock lock(m_critSection);
     m_iExitCode = EXITCODE_RESTARTAPP;
-    CAnnouncementManager::RemoveAnnouncer(this);
     StopThread(false);
   }
   StopThread();
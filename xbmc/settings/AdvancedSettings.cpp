@@ -56,6 +56,12 @@ void CAdvancedSettings::Initialize()
   m_allChannelStereo = false;
   m_streamSilence = false;
   m_audioSinkBufferDurationMsec = 50;
+#if defined(__arm__)
+  // the sinc converter is too heavy for most arm boxes
+  m_audioResampler = "polyphase";
+#else
+  m_audioResampler = "libsamplerate";
+#endif
 
   //default hold time of 25 ms, this allows a 20 hertz sine to pass undistorted
   m_limiterHold = 0.025f;
@@ -111,6 +117,9 @@ void CAdvancedSettings::Initialize()
   m_DXVAForceProcessorRenderer = true;
   m_DXVANoDeintProcForProgressive = false;
   m_videoFpsDetect = 1;
+  m_videoKeyframeIndexJob = false;
+  m_videoExtractThreads = 2;
+  m_videoThreadingPolicy = 0;
   m_videoDefaultLatency = 0.0;
 
   m_musicUseTimeSeeking = true;
@@ -122,6 +131,9 @@ void CAdvancedSettings::Initialize()
   m_musicPercentSeekBackward = -1;
   m_musicPercentSeekForwardBig = 10;
   m_musicPercentSeekBackwardBig = -10;
+  m_musicPreDecodeTracks = 1;
+  m_musicPreDecodeSeconds = 10;
+  m_musicDecodedHistory = 2;
 
   m_slideshowPanAmount = 2.5f;
   m_slideshowZoomAmount = 5.0f;
@@ -137,6 +149,7 @@ void CAdvancedSettings::Initialize()
   m_cddbAddress = "freedb.freedb.org";
 
   m_handleMounting = g_application.IsStandAlone();
+  m_memoryMapLocalFiles = false;
 
   m_fullScreenOnMovieStart = true;
   m_cachePath = "special://temp/";
@@ -205,6 +218,7 @@ void CAdvancedSettings::Initialize()
   m_strMusicLibraryAlbumFormatRight = "";
   m_prioritiseAPEv2tags = false;
   m_musicItemSeparator = " / ";
+  m_musicScannerThreads = 1;
   m_videoItemSeparator = " / ";
 
   m_bVideoLibraryHideAllItems = false;
@@ -216,6 +230,7 @@ void CAdvancedSettings::Initialize()
   m_bVideoLibraryImportWatchedState = false;
   m_bVideoLibraryImportResumePoint = false;
   m_bVideoScannerIgnoreErrors = false;
+  m_videoScannerThreads = 1;
   m_iVideoLibraryDateAdded = 1; // prefer mtime over ctime and current time
 
   m_iTuxBoxStreamtsPort = 31339;
@@ -302,8 +317,15 @@ void CAdvancedSettings::Initialize()
   m_measureRefreshrate = false;
 
   m_cacheMemBufferSize = 1024 * 1024 * 20;
+  m_cacheSegmented = false;
+  m_cacheReadAheadConnections = 1;
+  m_cacheReadAheadChunkSize = 1024 * 1024;
+  m_persistentDirCache = false;
+  m_persistentDirCacheMaxAge = 0;
   m_addonPackageFolderSize = 200;
 
+  m_webServerThreads = 4;
+
   m_jsonOutputCompact = true;
   m_jsonTcpPort = 9090;
 
@@ -394,6 +416,10 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetInt(pElement, "percentseekforwardbig", m_musicPercentSeekForwardBig, 0, 100);
     XMLUtils::GetInt(pElement, "percentseekbackwardbig", m_musicPercentSeekBackwardBig, -100, 0);
 
+    XMLUtils::GetInt(pElement, "predecodetracks", m_musicPreDecodeTracks, 0, 2);
+    XMLUtils::GetInt(pElement, "predecodeseconds", m_musicPreDecodeSeconds, 2, 60);
+    XMLUtils::GetInt(pElement, "decodedhistory", m_musicDecodedHistory, 0, 8);
+
     XMLUtils::GetInt(pElement, "resample", m_audioResample, 0, 192000);
     XMLUtils::GetBoolean(pElement, "allowtranscode44100", m_allowTranscode44100);
     XMLUtils::GetBoolean(pElement, "forceDirectSound", m_audioForceDirectSound);
@@ -402,6 +428,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetBoolean(pElement, "streamsilence", m_streamSilence);
     XMLUtils::GetString(pElement, "transcodeto", m_audioTranscodeTo);
     XMLUtils::GetInt(pElement, "audiosinkbufferdurationmsec", m_audioSinkBufferDurationMsec);
+    XMLUtils::GetString(pElement, "resampler", m_audioResampler);
 
     TiXmlElement* pAudioExcludes = pElement->FirstChildElement("excludefromlisting");
     if (pAudioExcludes)
@@ -594,6 +621,12 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetBoolean(pElement,"dxvanodeintforprogressive", m_DXVANoDeintProcForProgressive);
     //0 = disable fps detect, 1 = only detect on timestamps with uniform spacing, 2 detect on all timestamps
     XMLUtils::GetInt(pElement, "fpsdetect", m_videoFpsDetect, 0, 2);
+    // index the keyframes of the whole file in the background on playback, for files where seeking is slow
+    XMLUtils::GetBoolean(pElement, "keyframeindexjob", m_videoKeyframeIndexJob);
+    // number of files thumbs and stream details are extracted from at once
+    XMLUtils::GetInt(pElement, "extractthreads", m_videoExtractThreads, 1, 4);
+    //0 = pick frame or slice threads per stream, 1 = slice threads only, 2 = frame threads whenever possible
+    XMLUtils::GetInt(pElement, "threadingpolicy", m_videoThreadingPolicy, 0, 2);
 
     // Store global display latency settings
     TiXmlElement* pVideoLatency = pElement->FirstChildElement("latency");
@@ -644,6 +677,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetString(pElement, "albumformat", m_strMusicLibraryAlbumFormat);
     XMLUtils::GetString(pElement, "albumformatright", m_strMusicLibraryAlbumFormatRight);
     XMLUtils::GetString(pElement, "itemseparator", m_musicItemSeparator);
+    XMLUtils::GetInt(pElement, "scannerthreads", m_musicScannerThreads, 1, 16);
   }
 
   pElement = pRootElement->FirstChildElement("videolibrary");
@@ -665,6 +699,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
   if (pElement)
   {
     XMLUtils::GetBoolean(pElement, "ignoreerrors", m_bVideoScannerIgnoreErrors);
+    XMLUtils::GetInt(pElement, "threads", m_videoScannerThreads, 1, 16);
   }
 
   // Backward-compatibility of ExternalPlayer config
@@ -697,8 +732,17 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetInt(pElement, "curlretries", m_curlretries, 0, 10);
     XMLUtils::GetBoolean(pElement,"disableipv6", m_curlDisableIPV6);
     XMLUtils::GetUInt(pElement, "cachemembuffersize", m_cacheMemBufferSize);
+    XMLUtils::GetBoolean(pElement, "segmentedcache", m_cacheSegmented);
+    XMLUtils::GetUInt(pElement, "readaheadconnections", m_cacheReadAheadConnections, 1, 16);
+    XMLUtils::GetUInt(pElement, "readaheadchunksize", m_cacheReadAheadChunkSize, 64 * 1024, 64 * 1024 * 1024);
+    XMLUtils::GetBoolean(pElement, "persistentdircache", m_persistentDirCache);
+    XMLUtils::GetInt(pElement, "persistentdircachemaxage", m_persistentDirCacheMaxAge, 0, 30 * 24 * 60 * 60);
   }
 
+  pElement = pRootElement->FirstChildElement("webserver");
+  if (pElement)
+    XMLUtils::GetUInt(pElement, "threads", m_webServerThreads, 0, 64);
+
   pElement = pRootElement->FirstChildElement("jsonrpc");
   if (pElement)
   {
@@ -748,6 +792,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
   XMLUtils::GetInt(pRootElement,     "airplayport", m_airPlayPort);  
 
   XMLUtils::GetBoolean(pRootElement, "handlemounting", m_handleMounting);
+  XMLUtils::GetBoolean(pRootElement, "memorymaplocalfiles", m_memoryMapLocalFiles);
 
 #if defined(HAS_SDL) || defined(TARGET_WINDOWS)
   XMLUtils::GetBoolean(pRootElement, "fullscreen", m_startFullScreen);
@@ -111,6 +111,7 @@ class CAdvancedSettings
     bool m_streamSilence;
     int m_audioSinkBufferDurationMsec;
     CStdString m_audioTranscodeTo;
+    CStdString m_audioResampler;
     float m_limiterHold;
     float m_limiterRelease;
 
@@ -142,6 +143,9 @@ class CAdvancedSettings
     int m_musicPercentSeekBackward;
     int m_musicPercentSeekForwardBig;
     int m_musicPercentSeekBackwardBig;
+    int m_musicPreDecodeTracks;  // upcoming playlist items PAPlayer opens and decodes ahead of time
+    int m_musicPreDecodeSeconds; // seconds decoded into memory for each of them
+    int m_musicDecodedHistory;   // recently played items kept opened and decoded for skipping back
     int m_videoBlackBarColour;
     int m_videoIgnoreSecondsAtStart;
     float m_videoIgnorePercentAtEnd;
@@ -164,6 +168,9 @@ class CAdvancedSettings
     bool m_DXVAForceProcessorRenderer;
     bool m_DXVANoDeintProcForProgressive;
     int  m_videoFpsDetect;
+    bool m_videoKeyframeIndexJob;
+    int  m_videoExtractThreads;
+    int  m_videoThreadingPolicy;
 
     CStdString m_videoDefaultPlayer;
     CStdString m_videoDefaultDVDPlayer;
@@ -189,6 +196,7 @@ class CAdvancedSettings
     int m_airPlayPort;
 
     bool m_handleMounting;
+    bool m_memoryMapLocalFiles; // read large local files through a memory mapped window instead of read()
 
     bool m_fullScreenOnMovieStart;
     CStdString m_cachePath;
@@ -240,6 +248,7 @@ class CAdvancedSettings
     CStdString m_strMusicLibraryAlbumFormatRight;
     bool m_prioritiseAPEv2tags;
     CStdString m_musicItemSeparator;
+    int m_musicScannerThreads; // threads reading music tags during a scan
     CStdString m_videoItemSeparator;
     std::vector<CStdString> m_musicTagsFromFileFilters;
 
@@ -253,6 +262,7 @@ class CAdvancedSettings
     bool m_bVideoLibraryImportResumePoint;
 
     bool m_bVideoScannerIgnoreErrors;
+    int m_videoScannerThreads; // directories listed and hashed in parallel ahead of the scan
     int m_iVideoLibraryDateAdded;
 
     std::vector<CStdString> m_vecTokens; // cleaning strings tied to language
@@ -359,6 +369,13 @@ class CAdvancedSettings
     unsigned int m_addonPackageFolderSize;
 
     unsigned int m_cacheMemBufferSize;
+    bool m_cacheSegmented; // keep every range read from the source in a file backed cache
+    unsigned int m_cacheReadAheadConnections; // number of range requests kept in flight on http/dav sources
+    unsigned int m_cacheReadAheadChunkSize;   // size of each of those range requests
+    bool m_persistentDirCache;      // keep listings of network directories across restarts
+    int m_persistentDirCacheMaxAge; // seconds to trust a saved listing from sources without modification times
+
+    unsigned int m_webServerThreads; // threads serving the connections of the webserver, 0 for one thread per connection
 
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
@@ -0,0 +1,159 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+
+#include "HttpRangeUtils.h"
+#ifdef _LINUX
+#include "PlatformInclude.h"
+#endif
+#include "StdString.h"
+#ifdef _WIN32
+#include "PlatformDefs.h" // for PRIu64
+#endif
+
+using namespace std;
+
+static bool CompareRanges(const CHttpRange &left, const CHttpRange &right)
+{
+  return left.GetFirstPosition() < right.GetFirstPosition();
+}
+
+/* parses the decimal number in value between start and end, which has to
+   consist of digits only */
+static bool ParsePosition(const string &value, size_t start, size_t end, uint64_t &position)
+{
+  if (start >= end)
+    return false;
+
+  position = 0;
+  for (size_t index = start; index < end; index++)
+  {
+    char digit = value[index];
+    if (digit < '0' || digit > '9')
+      return false;
+
+    // don't let the number overflow
+    if (position > ((uint64_t)-1 - (digit - '0')) / 10)
+      return false;
+
+    position = position * 10 + (digit - '0');
+  }
+
+  return true;
+}
+
+CHttpRange::CHttpRange(uint64_t first, uint64_t last)
+  : m_first(first), m_last(last)
+{ }
+
+string CHttpRange::GetContentRange(uint64_t totalLength) const
+{
+  CStdString contentRange;
+  contentRange.Format("bytes %" PRIu64 "-%" PRIu64 "/%" PRIu64, m_first, m_last, totalLength);
+  return contentRange;
+}
+
+bool CHttpRanges::Parse(const string &header, uint64_t totalLength)
+{
+  m_ranges.clear();
+
+  // only byte ranges are supported
+  CStdString value = header;
+  value.Trim();
+  if (value.size() < 6 || value.Left(6).CompareNoCase("bytes=") != 0)
+    return false;
+
+  value = value.Mid(6);
+  vector<CHttpRange> ranges;
+  bool valid = false;
+  size_t start = 0;
+  while (start <= value.size())
+  {
+    size_t end = value.find(',', start);
+    if (end == string::npos)
+      end = value.size();
+
+    CStdString spec = value.substr(start, end - start);
+    start = end + 1;
+
+    // empty elements between commas are allowed
+    spec.Trim();
+    if (spec.empty())
+      continue;
+
+    size_t dash = spec.find('-');
+    if (dash == string::npos)
+      return false;
+
+    uint64_t first, last;
+    // "-n" asks for the last n bytes
+    if (dash == 0)
+    {
+      if (!ParsePosition(spec, 1, spec.size(), last))
+        return false;
+
+      valid = true;
+      if (last == 0 || totalLength == 0)
+        continue;
+
+      first = last >= totalLength ? 0 : totalLength - last;
+      last = totalLength - 1;
+    }
+    else
+    {
+      if (!ParsePosition(spec, 0, dash, first))
+        return false;
+
+      // "n-" asks for everything from byte n onwards
+      if (dash == spec.size() - 1)
+        last = totalLength - 1;
+      else if (!ParsePosition(spec, dash + 1, spec.size(), last) || last < first)
+        return false;
+
+      valid = true;
+      if (first >= totalLength)
+        continue;
+
+      if (last >= totalLength)
+        last = totalLength - 1;
+    }
+
+    ranges.push_back(CHttpRange(first, last));
+  }
+
+  if (!valid)
+    return false;
+
+  // merge ranges which overlap or directly follow each other
+  sort(ranges.begin(), ranges.end(), CompareRanges);
+  for (vector<CHttpRange>::const_iterator range = ranges.begin(); range != ranges.end(); range++)
+  {
+    if (!m_ranges.empty() && range->GetFirstPosition() <= m_ranges.back().GetLastPosition() + 1)
+    {
+      if (range->GetLastPosition() > m_ranges.back().GetLastPosition())
+        m_ranges.back() = CHttpRange(m_ranges.back().GetFirstPosition(), range->GetLastPosition());
+    }
+    else
+      m_ranges.push_back(*range);
+  }
+
+  return true;
+}
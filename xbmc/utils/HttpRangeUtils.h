@@ -0,0 +1,76 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*!
+ \brief Inclusive range of bytes of a resource
+ */
+class CHttpRange
+{
+public:
+  CHttpRange(uint64_t first, uint64_t last);
+
+  uint64_t GetFirstPosition() const { return m_first; }
+  uint64_t GetLastPosition() const { return m_last; }
+  uint64_t GetLength() const { return m_last - m_first + 1; }
+
+  /*!
+   \brief Value of the Content-Range header describing this range
+   of a resource with the given total length
+   */
+  std::string GetContentRange(uint64_t totalLength) const;
+
+private:
+  uint64_t m_first;
+  uint64_t m_last;
+};
+
+/*!
+ \brief Byte ranges requested through the Range header of a HTTP request
+ */
+class CHttpRanges
+{
+public:
+  CHttpRanges() { }
+
+  /*!
+   \brief Parses the value of a Range header for a resource of the given length
+
+   Ranges beyond the end of the resource are dropped, open ranges are
+   completed and overlapping or adjacent ranges are merged, so the
+   remaining ranges are sorted and don't overlap.
+
+   \return False if the value is not a valid byte range set, in which case
+   the header has to be ignored. True otherwise even if none of the ranges
+   can be satisfied (see IsEmpty()).
+   */
+  bool Parse(const std::string &header, uint64_t totalLength);
+
+  bool IsEmpty() const { return m_ranges.empty(); }
+  size_t Size() const { return m_ranges.size(); }
+  const CHttpRange &Get(size_t index) const { return m_ranges.at(index); }
+
+private:
+  std::vector<CHttpRange> m_ranges;
+};
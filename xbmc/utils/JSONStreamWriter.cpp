@@ -0,0 +1,129 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <locale>
+#include <string.h>
+
+#include "JSONStreamWriter.h"
+
+using namespace std;
+
+CJSONStreamWriter::CJSONStreamWriter(bool compact)
+  : m_position(0)
+{
+#if YAJL_MAJOR == 2
+  m_generator = yajl_gen_alloc(NULL);
+  yajl_gen_config(m_generator, yajl_gen_beautify, compact ? 0 : 1);
+  yajl_gen_config(m_generator, yajl_gen_indent_string, "\t");
+#else
+  yajl_gen_config conf = { compact ? 0 : 1, "\t" };
+  m_generator = yajl_gen_alloc(&conf, NULL);
+#endif
+}
+
+CJSONStreamWriter::~CJSONStreamWriter()
+{
+  yajl_gen_clear(m_generator);
+  yajl_gen_free(m_generator);
+}
+
+bool CJSONStreamWriter::BeginObject()
+{
+  return Collect(yajl_gen_status_ok == yajl_gen_map_open(m_generator));
+}
+
+bool CJSONStreamWriter::EndObject()
+{
+  return Collect(yajl_gen_status_ok == yajl_gen_map_close(m_generator));
+}
+
+bool CJSONStreamWriter::BeginArray()
+{
+  return Collect(yajl_gen_status_ok == yajl_gen_array_open(m_generator));
+}
+
+bool CJSONStreamWriter::EndArray()
+{
+  return Collect(yajl_gen_status_ok == yajl_gen_array_close(m_generator));
+}
+
+bool CJSONStreamWriter::WriteKey(const std::string &key)
+{
+#if YAJL_MAJOR == 2
+  return Collect(yajl_gen_status_ok == yajl_gen_string(m_generator, (const unsigned char*)key.c_str(), (size_t)key.length()));
+#else
+  return Collect(yajl_gen_status_ok == yajl_gen_string(m_generator, (const unsigned char*)key.c_str(), key.length()));
+#endif
+}
+
+bool CJSONStreamWriter::WriteValue(const CVariant &value)
+{
+  // Set locale to classic ("C") to ensure valid JSON numbers. Only do it
+  // for the duration of a single value as the stream might be read slowly
+  std::string currentLocale = setlocale(LC_NUMERIC, NULL);
+  setlocale(LC_NUMERIC, "C");
+
+  bool success = CJSONVariantWriter::InternalWrite(m_generator, value);
+
+  setlocale(LC_NUMERIC, currentLocale.c_str());
+
+  return Collect(success);
+}
+
+size_t CJSONStreamWriter::Read(char *buffer, size_t size)
+{
+  size_t length = GetPendingSize();
+  if (length > size)
+    length = size;
+
+  memcpy(buffer, m_buffer.c_str() + m_position, length);
+  m_position += length;
+
+  // drop what has been read once it makes up most of the buffer
+  if (m_position == m_buffer.size())
+  {
+    m_buffer.clear();
+    m_position = 0;
+  }
+  else if (m_position > m_buffer.size() / 2)
+  {
+    m_buffer.erase(0, m_position);
+    m_position = 0;
+  }
+
+  return length;
+}
+
+bool CJSONStreamWriter::Collect(bool success)
+{
+  const unsigned char *buffer;
+#if YAJL_MAJOR == 2
+  size_t length;
+#else
+  unsigned int length;
+#endif
+  if (yajl_gen_get_buf(m_generator, &buffer, &length) == yajl_gen_status_ok && length > 0)
+  {
+    m_buffer.append((const char *)buffer, length);
+    yajl_gen_clear(m_generator);
+  }
+
+  return success;
+}
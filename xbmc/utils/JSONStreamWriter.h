@@ -0,0 +1,63 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string>
+
+#include "JSONVariantWriter.h"
+
+/*!
+ \brief Incremental JSON writer
+
+ Generates the same output as CJSONVariantWriter but lets the caller emit
+ the document piece by piece and read the serialized bytes back out while
+ the rest of the document hasn't been generated yet.
+ */
+class CJSONStreamWriter
+{
+public:
+  CJSONStreamWriter(bool compact);
+  ~CJSONStreamWriter();
+
+  bool BeginObject();
+  bool EndObject();
+  bool BeginArray();
+  bool EndArray();
+  bool WriteKey(const std::string &key);
+  bool WriteValue(const CVariant &value);
+
+  /*!
+   \brief Number of serialized bytes which haven't been read yet
+   */
+  size_t GetPendingSize() const { return m_buffer.size() - m_position; }
+
+  /*!
+   \brief Moves up to size serialized bytes into buffer
+   \return Number of bytes copied into buffer
+   */
+  size_t Read(char *buffer, size_t size);
+
+private:
+  bool Collect(bool success);
+
+  yajl_gen m_generator;
+  std::string m_buffer;
+  size_t m_position;
+};
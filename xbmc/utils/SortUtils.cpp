@@ -411,111 +411,63 @@ string ByChannel(SortAttribute attributes, const SortItem &values)
   return values.at(FieldChannelName).asString();
 }
 
-bool preliminarySort(const SortItem &left, const SortItem &right, bool handleFolder, bool &result, std::wstring &labelLeft, std::wstring &labelRight)
+/* The keys needed to order the items, stored column by column and
+   indexed by the position of the item in the unsorted list. This way
+   the comparisons neither have to look anything up in the items nor
+   copy any labels, and the items themselves are only moved once. */
+class SortKeys
+{
+public:
+  SortKeys(size_t size)
+    : labels(size), specials(size, SortSpecialNone), folders(size, -1)
+  { }
+
+  std::vector<std::wstring> labels;
+  std::vector<SortSpecial> specials;
+  std::vector<signed char> folders; // -1 if the item doesn't say
+};
+
+class SortKeysComparator
 {
-  // make sure both items have the necessary data to do the sorting
-  SortItem::const_iterator itLeftSort, itRightSort;
-  if ((itLeftSort = left.find(FieldSort)) == left.end())
-  {
-    result = false;
-    return true;
-  }
-  if ((itRightSort = right.find(FieldSort)) == right.end())
-  {
-    result = true;
-    return true;
-  }
+public:
+  SortKeysComparator(const SortKeys &keys, SortOrder sortOrder, bool handleFolders)
+    : m_keys(keys), m_descending(sortOrder == SortOrderDescending), m_handleFolders(handleFolders)
+  { }
 
-  // look at special sorting behaviour
-  SortItem::const_iterator itLeft, itRight;
-  SortSpecial leftSortSpecial = SortSpecialNone;
-  SortSpecial rightSortSpecial = SortSpecialNone;
-  if ((itLeft = left.find(FieldSortSpecial)) != left.end() && itLeft->second.asInteger() <= (int64_t)SortSpecialOnBottom)
-    leftSortSpecial = (SortSpecial)itLeft->second.asInteger();
-  if ((itRight = right.find(FieldSortSpecial)) != right.end() && itRight->second.asInteger() <= (int64_t)SortSpecialOnBottom)
-    rightSortSpecial = (SortSpecial)itRight->second.asInteger();
-  
-  // one has a special sort
-  if (leftSortSpecial != rightSortSpecial)
+  bool operator()(size_t left, size_t right) const
   {
-    // left should be sorted on top
-    // or right should be sorted on bottom
-    // => left is sorted above right
-    if (leftSortSpecial == SortSpecialOnTop ||
-        rightSortSpecial == SortSpecialOnBottom)
+    // look at special sorting behaviour
+    SortSpecial leftSortSpecial = m_keys.specials[left];
+    SortSpecial rightSortSpecial = m_keys.specials[right];
+    if (leftSortSpecial != rightSortSpecial)
     {
-      result = true;
-      return true;
+      // left should be sorted on top
+      // or right should be sorted on bottom
+      // => left is sorted above right
+      return leftSortSpecial == SortSpecialOnTop ||
+             rightSortSpecial == SortSpecialOnBottom;
     }
-    
-    // otherwise right is sorted above left
-    result = false;
-    return true;
-  }
-  // both have either sort on top or sort on bottom -> leave as-is
-  else if (leftSortSpecial != SortSpecialNone && leftSortSpecial == rightSortSpecial)
-  {
-    result = false;
-    return true;
-  }
+    // both have either sort on top or sort on bottom -> leave as-is
+    else if (leftSortSpecial != SortSpecialNone)
+      return false;
 
-  if (handleFolder)
-  {
-    itLeft = left.find(FieldFolder);
-    itRight = right.find(FieldFolder);
-    if (itLeft != left.end() && itRight != right.end() &&
-        itLeft->second.asBoolean() != itRight->second.asBoolean())
+    if (m_handleFolders)
     {
-      result = itLeft->second.asBoolean();
-      return true;
+      signed char leftFolder = m_keys.folders[left];
+      signed char rightFolder = m_keys.folders[right];
+      if (leftFolder >= 0 && rightFolder >= 0 && leftFolder != rightFolder)
+        return leftFolder > 0;
     }
-  }
-
-  labelLeft = itLeftSort->second.asWideString();
-  labelRight = itRightSort->second.asWideString();
-
-  return false;
-}
 
-bool SorterAscending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, true, result, labelLeft, labelRight))
-    return result;
-
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) < 0;
-}
-
-bool SorterDescending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, true, result, labelLeft, labelRight))
-    return result;
-
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) > 0;
-}
-
-bool SorterIgnoreFoldersAscending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, false, result, labelLeft, labelRight))
-    return result;
-
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) < 0;
-}
-
-bool SorterIgnoreFoldersDescending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, false, result, labelLeft, labelRight))
-    return result;
+    int64_t result = StringUtils::AlphaNumericCompare(m_keys.labels[left].c_str(), m_keys.labels[right].c_str());
+    return m_descending ? result > 0 : result < 0;
+  }
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) > 0;
-}
+private:
+  const SortKeys &m_keys;
+  bool m_descending;
+  bool m_handleFolders;
+};
 
 map<SortBy, SortUtils::SortPreparator> fillPreparators()
 {
@@ -650,25 +602,49 @@ void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attribute
     SortPreparator preparator = getPreparator(sortBy);
     if (preparator != NULL)
     {
-      Fields sortingFields = GetFieldsForSorting(sortBy);
+      const Fields &sortingFields = GetFieldsForSorting(sortBy);
+      SortKeys keys(items.size());
 
       // Prepare the string used for sorting and store it under FieldSort
-      for (SortItems::iterator item = items.begin(); item != items.end(); item++)
+      for (size_t index = 0; index < items.size(); index++)
       {
+        SortItem &item = items[index];
+
         // add all fields to the item that are required for sorting if they are currently missing
         for (Fields::const_iterator field = sortingFields.begin(); field != sortingFields.end(); field++)
         {
-          if (item->find(*field) == item->end())
-            item->insert(pair<Field, CVariant>(*field, CVariant::ConstNullVariant));
+          if (item.find(*field) == item.end())
+            item.insert(pair<Field, CVariant>(*field, CVariant::ConstNullVariant));
+        }
+
+        SortItem::const_iterator it = item.find(FieldSort);
+        if (it == item.end())
+        {
+          CStdStringW sortLabel;
+          g_charsetConverter.utf8ToW(preparator(attributes, item), sortLabel, false);
+          item.insert(pair<Field, CVariant>(FieldSort, CVariant(sortLabel)));
+          keys.labels[index] = sortLabel;
         }
+        else
+          keys.labels[index] = it->second.asWideString();
 
-        CStdStringW sortLabel;
-        g_charsetConverter.utf8ToW(preparator(attributes, *item), sortLabel, false);
-        item->insert(pair<Field, CVariant>(FieldSort, CVariant(sortLabel)));
+        if ((it = item.find(FieldSortSpecial)) != item.end() && it->second.asInteger() <= (int64_t)SortSpecialOnBottom)
+          keys.specials[index] = (SortSpecial)it->second.asInteger();
+        if ((it = item.find(FieldFolder)) != item.end())
+          keys.folders[index] = it->second.asBoolean() ? 1 : 0;
       }
 
-      // Do the sorting
-      std::stable_sort(items.begin(), items.end(), getSorter(sortOrder, attributes));
+      // Do the sorting on the positions of the items
+      std::vector<size_t> order(items.size());
+      for (size_t index = 0; index < order.size(); index++)
+        order[index] = index;
+      std::stable_sort(order.begin(), order.end(), SortKeysComparator(keys, sortOrder, !(attributes & SortAttributeIgnoreFolders)));
+
+      // and move the items into their new places
+      SortItems sortedItems(items.size());
+      for (size_t index = 0; index < order.size(); index++)
+        sortedItems[index].swap(items[order[index]]);
+      items.swap(sortedItems);
     }
   }
 
@@ -716,14 +692,6 @@ const SortUtils::SortPreparator& SortUtils::getPreparator(SortBy sortBy)
   return m_preparators[SortByNone];
 }
 
-SortUtils::Sorter SortUtils::getSorter(SortOrder sortOrder, SortAttribute attributes)
-{
-  if (attributes & SortAttributeIgnoreFolders)
-    return sortOrder == SortOrderDescending ? SorterIgnoreFoldersDescending : SorterIgnoreFoldersAscending;
-
-  return sortOrder == SortOrderDescending ? SorterDescending : SorterAscending;
-}
-
 const Fields& SortUtils::GetFieldsForSorting(SortBy sortBy)
 {
   map<SortBy, Fields>::const_iterator it = m_sortingFields.find(sortBy);
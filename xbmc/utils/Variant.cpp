@@ -20,9 +20,12 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <new>
 #include <sstream>
+#include <algorithm>
 
 #include "Variant.h"
+#include "threads/Atomics.h"
 
 using namespace std;
 
@@ -108,6 +111,38 @@ double str2double(const wstring &str, double fallback /* = 0.0 */)
   return fallback;
 }
 
+struct CVariant::SharedArray
+{
+  SharedArray() : refs(1), shareable(true) { }
+  SharedArray(const VariantArray &other) : refs(1), shareable(true), values(other) { }
+
+  volatile long refs;
+  bool shareable;     // false once a reference into the values was handed out
+  VariantArray values;
+};
+
+struct CVariant::SharedMap
+{
+  SharedMap() : refs(1), shareable(true) { }
+  SharedMap(const VariantMap &other) : refs(1), shareable(true), values(other) { }
+
+  volatile long refs;
+  bool shareable;     // false once a reference into the values was handed out
+  VariantMap values;
+};
+
+template<class T> static inline T* acquire(T *shared)
+{
+  AtomicIncrement(&shared->refs);
+  return shared;
+}
+
+template<class T> static inline void release(T *shared)
+{
+  if (AtomicDecrement(&shared->refs) == 0)
+    delete shared;
+}
+
 CVariant CVariant::ConstNullVariant = CVariant::VariantTypeConstNull;
 
 CVariant::CVariant(VariantType type)
@@ -129,16 +164,16 @@ CVariant::CVariant(VariantType type)
       m_data.dvalue = 0.0;
       break;
     case VariantTypeString:
-      m_data.string = new string();
+      new (m_data.string) string();
       break;
     case VariantTypeWideString:
-      m_data.wstring = new wstring();
+      new (m_data.wstring) wstring();
       break;
     case VariantTypeArray:
-      m_data.array = new VariantArray();
+      m_data.array = new SharedArray();
       break;
     case VariantTypeObject:
-      m_data.map = new VariantMap();
+      m_data.map = new SharedMap();
       break;
     default:
       memset(&m_data, 0, sizeof(m_data));
@@ -191,60 +226,60 @@ CVariant::CVariant(bool boolean)
 CVariant::CVariant(const char *str)
 {
   m_type = VariantTypeString;
-  m_data.string = new string(str);
+  new (m_data.string) string(str);
 }
 
 CVariant::CVariant(const char *str, unsigned int length)
 {
   m_type = VariantTypeString;
-  m_data.string = new string(str, length);
+  new (m_data.string) string(str, length);
 }
 
 CVariant::CVariant(const string &str)
 {
   m_type = VariantTypeString;
-  m_data.string = new string(str);
+  new (m_data.string) string(str);
 }
 
 CVariant::CVariant(const wchar_t *str)
 {
   m_type = VariantTypeWideString;
-  m_data.wstring = new wstring(str);
+  new (m_data.wstring) wstring(str);
 }
 
 CVariant::CVariant(const wchar_t *str, unsigned int length)
 {
   m_type = VariantTypeWideString;
-  m_data.wstring = new wstring(str, length);
+  new (m_data.wstring) wstring(str, length);
 }
 
 CVariant::CVariant(const wstring &str)
 {
   m_type = VariantTypeWideString;
-  m_data.wstring = new wstring(str);
+  new (m_data.wstring) wstring(str);
 }
 
 CVariant::CVariant(const std::vector<std::string> &strArray)
 {
   m_type = VariantTypeArray;
-  m_data.array = new VariantArray;
-  m_data.array->reserve(strArray.size());
+  m_data.array = new SharedArray;
+  arrayValues().reserve(strArray.size());
   for (unsigned int index = 0; index < strArray.size(); index++)
-    m_data.array->push_back(strArray.at(index));
+    arrayValues().push_back(strArray.at(index));
 }
 
 CVariant::CVariant(const std::map<std::string, std::string> &strMap)
 {
   m_type = VariantTypeObject;
-  m_data.map = new VariantMap;
+  m_data.map = new SharedMap;
   for (std::map<std::string, std::string>::const_iterator it = strMap.begin(); it != strMap.end(); it++)
-    m_data.map->insert(make_pair(it->first, CVariant(it->second)));
+    mapValues()[it->first] = CVariant(it->second);
 }
 
 CVariant::CVariant(const std::map<std::string, CVariant> &variantMap)
 {
   m_type = VariantTypeObject;
-  m_data.map = new VariantMap(variantMap.begin(), variantMap.end());
+  m_data.map = new SharedMap(variantMap);
 }
 
 CVariant::CVariant(const CVariant &variant)
@@ -261,16 +296,84 @@ CVariant::~CVariant()
 void CVariant::cleanup()
 {
   if (m_type == VariantTypeString)
-    delete m_data.string;
+    str().~string();
   else if (m_type == VariantTypeWideString)
-    delete m_data.wstring;
+    wstr().~wstring();
   else if (m_type == VariantTypeArray)
-    delete m_data.array;
+    release(m_data.array);
   else if (m_type == VariantTypeObject)
-    delete m_data.map;
+    release(m_data.map);
   m_type = VariantTypeNull;
 }
 
+void CVariant::detach()
+{
+  // only copy the members, the values themselves are shared until modified
+  if (m_type == VariantTypeArray && m_data.array->refs > 1)
+  {
+    SharedArray *copy = new SharedArray(arrayValues());
+    release(m_data.array);
+    m_data.array = copy;
+  }
+  else if (m_type == VariantTypeObject && m_data.map->refs > 1)
+  {
+    SharedMap *copy = new SharedMap(mapValues());
+    release(m_data.map);
+    m_data.map = copy;
+  }
+}
+
+void CVariant::unshare()
+{
+  // the caller gets a reference into the values, which must not reach any copy
+  detach();
+  if (m_type == VariantTypeArray)
+    m_data.array->shareable = false;
+  else if (m_type == VariantTypeObject)
+    m_data.map->shareable = false;
+}
+
+void CVariant::take(CVariant &variant)
+{
+  // moves the value of variant into this (empty) variant without copying it
+  m_type = variant.m_type;
+  if (m_type == VariantTypeString)
+  {
+    new (m_data.string) string();
+    str().swap(variant.str());
+    variant.str().~string();
+  }
+  else if (m_type == VariantTypeWideString)
+  {
+    new (m_data.wstring) wstring();
+    wstr().swap(variant.wstr());
+    variant.wstr().~wstring();
+  }
+  else
+    m_data = variant.m_data;
+  variant.m_type = VariantTypeNull;
+}
+
+CVariant::VariantArray &CVariant::arrayValues()
+{
+  return m_data.array->values;
+}
+
+const CVariant::VariantArray &CVariant::arrayValues() const
+{
+  return m_data.array->values;
+}
+
+CVariant::VariantMap &CVariant::mapValues()
+{
+  return m_data.map->values;
+}
+
+const CVariant::VariantMap &CVariant::mapValues() const
+{
+  return m_data.map->values;
+}
+
 bool CVariant::isInteger() const
 {
   return m_type == VariantTypeInteger;
@@ -332,9 +435,9 @@ int64_t CVariant::asInteger(int64_t fallback) const
     case VariantTypeDouble:
       return (int64_t)m_data.dvalue;
     case VariantTypeString:
-      return str2int64(*m_data.string, fallback);
+      return str2int64(str(), fallback);
     case VariantTypeWideString:
-      return str2int64(*m_data.wstring, fallback);
+      return str2int64(wstr(), fallback);
     default:
       return fallback;
   }
@@ -353,9 +456,9 @@ uint64_t CVariant::asUnsignedInteger(uint64_t fallback) const
     case VariantTypeDouble:
       return (uint64_t)m_data.dvalue;
     case VariantTypeString:
-      return str2uint64(*m_data.string, fallback);
+      return str2uint64(str(), fallback);
     case VariantTypeWideString:
-      return str2uint64(*m_data.wstring, fallback);
+      return str2uint64(wstr(), fallback);
     default:
       return fallback;
   }
@@ -374,9 +477,9 @@ double CVariant::asDouble(double fallback) const
     case VariantTypeUnsignedInteger:
       return (double)m_data.unsignedinteger;
     case VariantTypeString:
-      return str2double(*m_data.string, fallback);
+      return str2double(str(), fallback);
     case VariantTypeWideString:
-      return str2double(*m_data.wstring, fallback);
+      return str2double(wstr(), fallback);
     default:
       return fallback;
   }
@@ -395,9 +498,9 @@ float CVariant::asFloat(float fallback) const
     case VariantTypeUnsignedInteger:
       return (float)m_data.unsignedinteger;
     case VariantTypeString:
-      return (float)str2double(*m_data.string, fallback);
+      return (float)str2double(str(), fallback);
     case VariantTypeWideString:
-      return (float)str2double(*m_data.wstring, fallback);
+      return (float)str2double(wstr(), fallback);
     default:
       return fallback;
   }
@@ -418,11 +521,11 @@ bool CVariant::asBoolean(bool fallback) const
     case VariantTypeDouble:
       return (m_data.dvalue != 0);
     case VariantTypeString:
-      if (m_data.string->empty() || m_data.string->compare("0") == 0 || m_data.string->compare("false") == 0)
+      if (str().empty() || str().compare("0") == 0 || str().compare("false") == 0)
         return false;
       return true;
     case VariantTypeWideString:
-      if (m_data.wstring->empty() || m_data.wstring->compare(L"0") == 0 || m_data.wstring->compare(L"false") == 0)
+      if (wstr().empty() || wstr().compare(L"0") == 0 || wstr().compare(L"false") == 0)
         return false;
       return true;
     default:
@@ -437,7 +540,7 @@ std::string CVariant::asString(const std::string &fallback /* = "" */) const
   switch (m_type)
   {
     case VariantTypeString:
-      return *m_data.string;
+      return str();
     case VariantTypeBoolean:
       return m_data.boolean ? "true" : "false";
     case VariantTypeInteger:
@@ -465,7 +568,7 @@ std::wstring CVariant::asWideString(const std::wstring &fallback /* = L"" */) co
   switch (m_type)
   {
     case VariantTypeWideString:
-      return *m_data.wstring;
+      return wstr();
     case VariantTypeBoolean:
       return m_data.boolean ? L"true" : L"false";
     case VariantTypeInteger:
@@ -494,28 +597,37 @@ CVariant &CVariant::operator[](const std::string &key)
   if (m_type == VariantTypeNull)
   {
     m_type = VariantTypeObject;
-    m_data.map = new VariantMap;
+    m_data.map = new SharedMap;
   }
 
   if (m_type == VariantTypeObject)
-    return (*m_data.map)[key];
+  {
+    unshare();
+    return mapValues()[key];
+  }
   else
     return ConstNullVariant;
 }
 
 const CVariant &CVariant::operator[](const std::string &key) const
 {
-  VariantMap::const_iterator it;
-  if (m_type == VariantTypeObject && (it = m_data.map->find(key)) != m_data.map->end())
-    return it->second;
-  else
-    return ConstNullVariant;
+  if (m_type == VariantTypeObject)
+  {
+    VariantMap::const_iterator it = mapValues().find(key);
+    if (it != mapValues().end())
+      return it->second;
+  }
+
+  return ConstNullVariant;
 }
 
 CVariant &CVariant::operator[](unsigned int position)
 {
   if (m_type == VariantTypeArray && size() > position)
-    return m_data.array->at(position);
+  {
+    unshare();
+    return arrayValues().at(position);
+  }
   else
     return ConstNullVariant;
 }
@@ -523,49 +635,64 @@ CVariant &CVariant::operator[](unsigned int position)
 const CVariant &CVariant::operator[](unsigned int position) const
 {
   if (m_type == VariantTypeArray && size() > position)
-    return m_data.array->at(position);
+    return arrayValues().at(position);
   else
     return ConstNullVariant;
 }
 
 CVariant &CVariant::operator=(const CVariant &rhs)
 {
-  if (m_type == VariantTypeConstNull)
+  if (m_type == VariantTypeConstNull || this == &rhs)
     return *this;
 
-  cleanup();
-
-  m_type = rhs.m_type;
-
-  switch (m_type)
+  switch (rhs.m_type)
   {
-  case VariantTypeInteger:
-    m_data.integer = rhs.m_data.integer;
-    break;
-  case VariantTypeUnsignedInteger:
-    m_data.integer = rhs.m_data.unsignedinteger;
-    break;
-  case VariantTypeBoolean:
-    m_data.boolean = rhs.m_data.boolean;
-    break;
-  case VariantTypeDouble:
-    m_data.dvalue = rhs.m_data.dvalue;
-    break;
   case VariantTypeString:
-    m_data.string = new string(*rhs.m_data.string);
-    break;
   case VariantTypeWideString:
-    m_data.wstring = new wstring(*rhs.m_data.wstring);
+    if (m_type == rhs.m_type)
+    { // reuse the memory of the current string
+      if (m_type == VariantTypeString)
+        str() = rhs.str();
+      else
+        wstr() = rhs.wstr();
+    }
+    else
+    { // rhs might be one of our own values, so copy it before cleaning up
+      CVariant copy(rhs.m_type);
+      if (rhs.m_type == VariantTypeString)
+        copy.str() = rhs.str();
+      else
+        copy.wstr() = rhs.wstr();
+      cleanup();
+      take(copy);
+    }
     break;
   case VariantTypeArray:
-    m_data.array = new VariantArray(rhs.m_data.array->begin(), rhs.m_data.array->end());
+  {
+    SharedArray *array = rhs.m_data.array->shareable ? acquire(rhs.m_data.array) : new SharedArray(rhs.arrayValues());
+    cleanup();
+    m_type = VariantTypeArray;
+    m_data.array = array;
     break;
+  }
   case VariantTypeObject:
-    m_data.map = new VariantMap(rhs.m_data.map->begin(), rhs.m_data.map->end());
+  {
+    SharedMap *map = rhs.m_data.map->shareable ? acquire(rhs.m_data.map) : new SharedMap(rhs.mapValues());
+    cleanup();
+    m_type = VariantTypeObject;
+    m_data.map = map;
     break;
+  }
   default:
+  {
+    VariantUnion data = rhs.m_data;
+    VariantType type = rhs.m_type;
+    cleanup();
+    m_type = type;
+    m_data = data;
     break;
   }
+  }
 
   return *this;
 }
@@ -585,13 +712,13 @@ bool CVariant::operator==(const CVariant &rhs) const
     case VariantTypeDouble:
       return m_data.dvalue == rhs.m_data.dvalue;
     case VariantTypeString:
-      return *m_data.string == *rhs.m_data.string;
+      return str() == rhs.str();
     case VariantTypeWideString:
-      return *m_data.wstring == *rhs.m_data.wstring;
+      return wstr() == rhs.wstr();
     case VariantTypeArray:
-      return *m_data.array == *rhs.m_data.array;
+      return m_data.array == rhs.m_data.array || arrayValues() == rhs.arrayValues();
     case VariantTypeObject:
-      return *m_data.map == *rhs.m_data.map;
+      return m_data.map == rhs.m_data.map || mapValues() == rhs.mapValues();
     default:
       break;
     }
@@ -605,11 +732,23 @@ void CVariant::push_back(const CVariant &variant)
   if (m_type == VariantTypeNull)
   {
     m_type = VariantTypeArray;
-    m_data.array = new VariantArray;
+    m_data.array = new SharedArray;
   }
 
   if (m_type == VariantTypeArray)
-    m_data.array->push_back(variant);
+  {
+    if (&variant == this)
+    { // don't make the array contain itself
+      CVariant copy(variant);
+      detach();
+      arrayValues().push_back(copy);
+    }
+    else
+    {
+      detach();
+      arrayValues().push_back(variant);
+    }
+  }
 }
 
 void CVariant::append(const CVariant &variant)
@@ -620,13 +759,23 @@ void CVariant::append(const CVariant &variant)
 const char *CVariant::c_str() const
 {
   if (m_type == VariantTypeString)
-    return m_data.string->c_str();
+    return str().c_str();
   else
     return NULL;
 }
 
 void CVariant::swap(CVariant &rhs)
 {
+  if (m_type == VariantTypeString || m_type == VariantTypeWideString ||
+      rhs.m_type == VariantTypeString || rhs.m_type == VariantTypeWideString)
+  { // strings can't be copied bytewise
+    CVariant temp;
+    temp.take(*this);
+    take(rhs);
+    rhs.take(temp);
+    return;
+  }
+
   VariantType  temp_type = m_type;
   VariantUnion temp_data = m_data;
 
@@ -640,7 +789,10 @@ void CVariant::swap(CVariant &rhs)
 CVariant::iterator_array CVariant::begin_array()
 {
   if (m_type == VariantTypeArray)
-    return m_data.array->begin();
+  {
+    unshare();
+    return arrayValues().begin();
+  }
   else
     return iterator_array();
 }
@@ -648,7 +800,7 @@ CVariant::iterator_array CVariant::begin_array()
 CVariant::const_iterator_array CVariant::begin_array() const
 {
   if (m_type == VariantTypeArray)
-    return m_data.array->begin();
+    return arrayValues().begin();
   else
     return const_iterator_array();
 }
@@ -656,7 +808,10 @@ CVariant::const_iterator_array CVariant::begin_array() const
 CVariant::iterator_array CVariant::end_array()
 {
   if (m_type == VariantTypeArray)
-    return m_data.array->end();
+  {
+    unshare();
+    return arrayValues().end();
+  }
   else
     return iterator_array();
 }
@@ -664,7 +819,7 @@ CVariant::iterator_array CVariant::end_array()
 CVariant::const_iterator_array CVariant::end_array() const
 {
   if (m_type == VariantTypeArray)
-    return m_data.array->end();
+    return arrayValues().end();
   else
     return const_iterator_array();
 }
@@ -672,7 +827,10 @@ CVariant::const_iterator_array CVariant::end_array() const
 CVariant::iterator_map CVariant::begin_map()
 {
   if (m_type == VariantTypeObject)
-    return m_data.map->begin();
+  {
+    unshare();
+    return mapValues().begin();
+  }
   else
     return iterator_map();
 }
@@ -680,7 +838,7 @@ CVariant::iterator_map CVariant::begin_map()
 CVariant::const_iterator_map CVariant::begin_map() const
 {
   if (m_type == VariantTypeObject)
-    return m_data.map->begin();
+    return mapValues().begin();
   else
     return const_iterator_map();
 }
@@ -688,7 +846,10 @@ CVariant::const_iterator_map CVariant::begin_map() const
 CVariant::iterator_map CVariant::end_map()
 {
   if (m_type == VariantTypeObject)
-    return m_data.map->end();
+  {
+    unshare();
+    return mapValues().end();
+  }
   else
     return iterator_map();
 }
@@ -696,7 +857,7 @@ CVariant::iterator_map CVariant::end_map()
 CVariant::const_iterator_map CVariant::end_map() const
 {
   if (m_type == VariantTypeObject)
-    return m_data.map->end();
+    return mapValues().end();
   else
     return const_iterator_map();
 }
@@ -704,13 +865,13 @@ CVariant::const_iterator_map CVariant::end_map() const
 unsigned int CVariant::size() const
 {
   if (m_type == VariantTypeObject)
-    return m_data.map->size();
+    return mapValues().size();
   else if (m_type == VariantTypeArray)
-    return m_data.array->size();
+    return arrayValues().size();
   else if (m_type == VariantTypeString)
-    return m_data.string->size();
+    return str().size();
   else if (m_type == VariantTypeWideString)
-    return m_data.wstring->size();
+    return wstr().size();
   else
     return 0;
 }
@@ -718,13 +879,13 @@ unsigned int CVariant::size() const
 bool CVariant::empty() const
 {
   if (m_type == VariantTypeObject)
-    return m_data.map->empty();
+    return mapValues().empty();
   else if (m_type == VariantTypeArray)
-    return m_data.array->empty();
+    return arrayValues().empty();
   else if (m_type == VariantTypeString)
-    return m_data.string->empty();
+    return str().empty();
   else if (m_type == VariantTypeWideString)
-    return m_data.wstring->empty();
+    return wstr().empty();
   else if (m_type == VariantTypeNull)
     return true;
 
@@ -734,13 +895,35 @@ bool CVariant::empty() const
 void CVariant::clear()
 {
   if (m_type == VariantTypeObject)
-    m_data.map->clear();
+  {
+    if (m_data.map->refs > 1)
+    {
+      release(m_data.map);
+      m_data.map = new SharedMap;
+    }
+    else
+    { // no reference into the old members is valid anymore
+      mapValues().clear();
+      m_data.map->shareable = true;
+    }
+  }
   else if (m_type == VariantTypeArray)
-    m_data.array->clear();
+  {
+    if (m_data.array->refs > 1)
+    {
+      release(m_data.array);
+      m_data.array = new SharedArray;
+    }
+    else
+    {
+      arrayValues().clear();
+      m_data.array->shareable = true;
+    }
+  }
   else if (m_type == VariantTypeString)
-    m_data.string->clear();
+    str().clear();
   else if (m_type == VariantTypeWideString)
-    m_data.wstring->clear();
+    wstr().clear();
 }
 
 void CVariant::erase(const std::string &key)
@@ -748,10 +931,13 @@ void CVariant::erase(const std::string &key)
   if (m_type == VariantTypeNull)
   {
     m_type = VariantTypeObject;
-    m_data.map = new VariantMap;
+    m_data.map = new SharedMap;
+  }
+  else if (m_type == VariantTypeObject && isMember(key))
+  {
+    detach();
+    mapValues().erase(key);
   }
-  else if (m_type == VariantTypeObject)
-    m_data.map->erase(key);
 }
 
 void CVariant::erase(unsigned int position)
@@ -759,17 +945,20 @@ void CVariant::erase(unsigned int position)
   if (m_type == VariantTypeNull)
   {
     m_type = VariantTypeArray;
-    m_data.array = new VariantArray;
+    m_data.array = new SharedArray;
   }
 
   if (m_type == VariantTypeArray && position < size())
-    m_data.array->erase(m_data.array->begin() + position);
+  {
+    detach();
+    arrayValues().erase(arrayValues().begin() + position);
+  }
 }
 
 bool CVariant::isMember(const std::string &key) const
 {
   if (m_type == VariantTypeObject)
-    return m_data.map->find(key) != m_data.map->end();
+    return mapValues().find(key) != mapValues().end();
 
   return false;
 }
@@ -135,17 +135,37 @@ public:
   static CVariant ConstNullVariant;
 
 private:
+  /* arrays and objects are reference counted and shared between copies
+     until one of them is modified (copy-on-write). once a reference or
+     iterator into the values has been handed out they are no longer shared,
+     as it could otherwise be used to modify a copy */
+  struct SharedArray;
+  struct SharedMap;
+
   void cleanup();
+  void detach();
+  void unshare();
+  void take(CVariant &variant);
+
+  std::string &str() { return *reinterpret_cast<std::string *>(m_data.string); }
+  const std::string &str() const { return *reinterpret_cast<const std::string *>(m_data.string); }
+  std::wstring &wstr() { return *reinterpret_cast<std::wstring *>(m_data.wstring); }
+  const std::wstring &wstr() const { return *reinterpret_cast<const std::wstring *>(m_data.wstring); }
+  VariantArray &arrayValues();
+  const VariantArray &arrayValues() const;
+  VariantMap &mapValues();
+  const VariantMap &mapValues() const;
+
   union VariantUnion
   {
     int64_t integer;
     uint64_t unsignedinteger;
     bool boolean;
     double dvalue;
-    std::string *string;
-    std::wstring *wstring;
-    VariantArray *array;
-    VariantMap *map;
+    char string[sizeof(std::string)];   // strings are constructed in place
+    char wstring[sizeof(std::wstring)];
+    SharedArray *array;
+    SharedMap *map;
   };
 
   VariantType m_type;
@@ -0,0 +1,109 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/HttpRangeUtils.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestHttpRangeUtils, SingleRange)
+{
+  CHttpRanges ranges;
+
+  EXPECT_TRUE(ranges.Parse("bytes=0-499", 10000));
+  ASSERT_EQ((size_t)1, ranges.Size());
+  EXPECT_EQ((uint64_t)0, ranges.Get(0).GetFirstPosition());
+  EXPECT_EQ((uint64_t)499, ranges.Get(0).GetLastPosition());
+  EXPECT_EQ((uint64_t)500, ranges.Get(0).GetLength());
+  EXPECT_STREQ("bytes 0-499/10000", ranges.Get(0).GetContentRange(10000).c_str());
+
+  EXPECT_TRUE(ranges.Parse("bytes=9500-", 10000));
+  ASSERT_EQ((size_t)1, ranges.Size());
+  EXPECT_EQ((uint64_t)9500, ranges.Get(0).GetFirstPosition());
+  EXPECT_EQ((uint64_t)9999, ranges.Get(0).GetLastPosition());
+
+  EXPECT_TRUE(ranges.Parse("bytes=-500", 10000));
+  ASSERT_EQ((size_t)1, ranges.Size());
+  EXPECT_EQ((uint64_t)9500, ranges.Get(0).GetFirstPosition());
+  EXPECT_EQ((uint64_t)9999, ranges.Get(0).GetLastPosition());
+
+  // ranges reaching beyond the end are cut off
+  EXPECT_TRUE(ranges.Parse("bytes=9000-20000", 10000));
+  ASSERT_EQ((size_t)1, ranges.Size());
+  EXPECT_EQ((uint64_t)9999, ranges.Get(0).GetLastPosition());
+
+  EXPECT_TRUE(ranges.Parse("bytes=-20000", 10000));
+  ASSERT_EQ((size_t)1, ranges.Size());
+  EXPECT_EQ((uint64_t)0, ranges.Get(0).GetFirstPosition());
+  EXPECT_EQ((uint64_t)9999, ranges.Get(0).GetLastPosition());
+}
+
+TEST(TestHttpRangeUtils, MultipleRanges)
+{
+  CHttpRanges ranges;
+
+  EXPECT_TRUE(ranges.Parse("bytes=500-599, 0-99,-100", 10000));
+  ASSERT_EQ((size_t)3, ranges.Size());
+  EXPECT_EQ((uint64_t)0, ranges.Get(0).GetFirstPosition());
+  EXPECT_EQ((uint64_t)500, ranges.Get(1).GetFirstPosition());
+  EXPECT_EQ((uint64_t)9900, ranges.Get(2).GetFirstPosition());
+
+  // overlapping and adjacent ranges are merged
+  EXPECT_TRUE(ranges.Parse("bytes=0-99,100-199,150-299,1000-", 10000));
+  ASSERT_EQ((size_t)2, ranges.Size());
+  EXPECT_EQ((uint64_t)0, ranges.Get(0).GetFirstPosition());
+  EXPECT_EQ((uint64_t)299, ranges.Get(0).GetLastPosition());
+  EXPECT_EQ((uint64_t)1000, ranges.Get(1).GetFirstPosition());
+  EXPECT_EQ((uint64_t)9999, ranges.Get(1).GetLastPosition());
+
+  // unsatisfiable ranges are dropped
+  EXPECT_TRUE(ranges.Parse("bytes=20000-30000,0-0", 10000));
+  ASSERT_EQ((size_t)1, ranges.Size());
+  EXPECT_EQ((uint64_t)1, ranges.Get(0).GetLength());
+}
+
+TEST(TestHttpRangeUtils, Unsatisfiable)
+{
+  CHttpRanges ranges;
+
+  EXPECT_TRUE(ranges.Parse("bytes=10000-", 10000));
+  EXPECT_TRUE(ranges.IsEmpty());
+
+  EXPECT_TRUE(ranges.Parse("bytes=-0", 10000));
+  EXPECT_TRUE(ranges.IsEmpty());
+
+  EXPECT_TRUE(ranges.Parse("bytes=0-", 0));
+  EXPECT_TRUE(ranges.IsEmpty());
+}
+
+TEST(TestHttpRangeUtils, Invalid)
+{
+  CHttpRanges ranges;
+
+  EXPECT_FALSE(ranges.Parse("", 10000));
+  EXPECT_FALSE(ranges.Parse("bytes=", 10000));
+  EXPECT_FALSE(ranges.Parse("items=0-10", 10000));
+  EXPECT_FALSE(ranges.Parse("bytes=10", 10000));
+  EXPECT_FALSE(ranges.Parse("bytes=-", 10000));
+  EXPECT_FALSE(ranges.Parse("bytes=20-10", 10000));
+  EXPECT_FALSE(ranges.Parse("bytes=a-10", 10000));
+  EXPECT_FALSE(ranges.Parse("bytes=0-10,x", 10000));
+  EXPECT_FALSE(ranges.Parse("bytes=0-99999999999999999999", 10000));
+  EXPECT_TRUE(ranges.IsEmpty());
+}
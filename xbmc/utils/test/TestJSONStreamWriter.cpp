@@ -0,0 +1,88 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/JSONStreamWriter.h"
+#include "utils/JSONVariantWriter.h"
+
+#include "gtest/gtest.h"
+
+static CVariant CreateMovies()
+{
+  CVariant result;
+  result["limits"]["start"] = 0;
+  result["limits"]["total"] = 2;
+  for (int i = 0; i < 2; i++)
+  {
+    CVariant movie;
+    movie["movieid"] = i;
+    movie["label"] = "Movie";
+    movie["rating"] = 7.5;
+    movie["genre"].push_back("Drama");
+    result["movies"].push_back(movie);
+  }
+
+  return result;
+}
+
+static std::string ReadAll(CJSONStreamWriter &writer, size_t chunk)
+{
+  std::string output;
+  char buffer[64];
+  size_t read;
+  while ((read = writer.Read(buffer, chunk)) > 0)
+    output.append(buffer, read);
+
+  return output;
+}
+
+TEST(TestJSONStreamWriter, WriteValue)
+{
+  CVariant movies = CreateMovies();
+
+  CJSONStreamWriter writer(false);
+  EXPECT_TRUE(writer.WriteValue(movies));
+  EXPECT_STREQ(CJSONVariantWriter::Write(movies, false).c_str(), ReadAll(writer, 64).c_str());
+  EXPECT_EQ((size_t)0, writer.GetPendingSize());
+}
+
+TEST(TestJSONStreamWriter, Incremental)
+{
+  CVariant movies = CreateMovies();
+
+  // write the same document element by element and read it in small pieces
+  CJSONStreamWriter writer(true);
+  std::string output;
+  EXPECT_TRUE(writer.BeginObject());
+  EXPECT_TRUE(writer.WriteKey("limits"));
+  EXPECT_TRUE(writer.WriteValue(movies["limits"]));
+  output += ReadAll(writer, 3);
+  EXPECT_TRUE(writer.WriteKey("movies"));
+  EXPECT_TRUE(writer.BeginArray());
+  for (CVariant::const_iterator_array it = movies["movies"].begin_array(); it != movies["movies"].end_array(); it++)
+  {
+    EXPECT_TRUE(writer.WriteValue(*it));
+    output += ReadAll(writer, 5);
+  }
+  EXPECT_TRUE(writer.EndArray());
+  EXPECT_TRUE(writer.EndObject());
+  output += ReadAll(writer, 7);
+
+  EXPECT_STREQ(CJSONVariantWriter::Write(movies, true).c_str(), output.c_str());
+}
@@ -131,3 +131,37 @@ TEST(TestSortUtils, GetFieldsForSorting)
   EXPECT_EQ(FieldTrackNumber, *it);
   EXPECT_EQ((unsigned int)4, fields.size());
 }
+
+TEST(TestSortUtils, Sort_SortSpecialAndFolders)
+{
+  SortItems items;
+  const char *labels[] = { "C", "A", "D", "B", "E", "F" };
+  for (unsigned int i = 0; i < 6; i++)
+  {
+    SortItem item;
+    item[FieldLabel] = labels[i];
+    items.push_back(item);
+  }
+  items[2][FieldSortSpecial] = SortSpecialOnBottom;
+  items[4][FieldSortSpecial] = SortSpecialOnTop;
+  items[0][FieldFolder] = true;
+  items[1][FieldFolder] = false;
+  items[3][FieldFolder] = false;
+  items[5][FieldFolder] = true;
+
+  SortUtils::Sort(SortByLabel, SortOrderDescending, SortAttributeNone, items);
+
+  EXPECT_STREQ("E", items.at(0)[FieldLabel].asString().c_str());
+  EXPECT_STREQ("F", items.at(1)[FieldLabel].asString().c_str());
+  EXPECT_STREQ("C", items.at(2)[FieldLabel].asString().c_str());
+  EXPECT_STREQ("B", items.at(3)[FieldLabel].asString().c_str());
+  EXPECT_STREQ("A", items.at(4)[FieldLabel].asString().c_str());
+  EXPECT_STREQ("D", items.at(5)[FieldLabel].asString().c_str());
+
+  SortUtils::Sort(SortByLabel, SortOrderAscending, SortAttributeIgnoreFolders, items, 4, 1);
+
+  ASSERT_EQ((size_t)3, items.size());
+  EXPECT_STREQ("A", items.at(0)[FieldLabel].asString().c_str());
+  EXPECT_STREQ("B", items.at(1)[FieldLabel].asString().c_str());
+  EXPECT_STREQ("C", items.at(2)[FieldLabel].asString().c_str());
+}
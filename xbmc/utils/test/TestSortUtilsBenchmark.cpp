@@ -0,0 +1,113 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/SortUtils.h"
+#include "utils/Stopwatch.h"
+#include "utils/StdString.h"
+#include "utils/StringUtils.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+#define BENCHMARK_SONGS 60000
+
+/* Builds a library of songs looking roughly like a real one: a few
+   thousand artists with a dozen albums each, numbered tracks and a
+   handful of folders mixed in. */
+static void FillSongs(SortItems &items)
+{
+  items.clear();
+  items.reserve(BENCHMARK_SONGS);
+  for (int i = 0; i < BENCHMARK_SONGS; i++)
+  {
+    int artist = (i * 7919) % 5000;
+    CStdString strArtist, strAlbum, strTitle;
+    strArtist.Format("The Artist %d", artist);
+    strAlbum.Format("Album %d", (i / 12) % 600);
+    strTitle.Format("%02d - Song %d", i % 12 + 1, i);
+
+    SortItem item;
+    item[FieldId] = i;
+    item[FieldLabel] = strTitle;
+    item[FieldArtist] = strArtist;
+    item[FieldAlbum] = strAlbum;
+    item[FieldYear] = 1960 + artist % 50;
+    item[FieldTrackNumber] = i % 12 + 1;
+    item[FieldFolder] = (i % 1000) == 0;
+    items.push_back(item);
+  }
+}
+
+/* sorting 60000 items takes a while and the timings are only printed,
+   so the tests are disabled. --gtest_also_run_disabled_tests and
+   --gtest_filter=TestSortUtilsBenchmark.* run them */
+static void BenchmarkSort(SortBy sortBy, SortOrder sortOrder, SortAttribute attributes, const char *name)
+{
+  SortItems items;
+  FillSongs(items);
+
+  CStopWatch watch;
+  watch.StartZero();
+  SortUtils::Sort(sortBy, sortOrder, attributes, items);
+  float elapsed = watch.GetElapsedMilliseconds();
+
+  ASSERT_EQ((size_t)BENCHMARK_SONGS, items.size());
+
+  // folders come first, the rest has to be in order
+  bool folders = !(attributes & SortAttributeIgnoreFolders);
+  for (size_t i = 1; i < items.size(); i++)
+  {
+    if (folders && items[i - 1][FieldFolder].asBoolean() != items[i][FieldFolder].asBoolean())
+    {
+      EXPECT_TRUE(items[i - 1][FieldFolder].asBoolean());
+      continue;
+    }
+
+    int64_t result = StringUtils::AlphaNumericCompare(items[i - 1][FieldSort].asWideString().c_str(),
+                                                      items[i][FieldSort].asWideString().c_str());
+    if (sortOrder == SortOrderDescending)
+      EXPECT_GE(result, 0);
+    else
+      EXPECT_LE(result, 0);
+  }
+
+  std::cout << name << ": sorted " << BENCHMARK_SONGS << " items in " <<
+    testing::PrintToString(elapsed) << " ms" << std::endl;
+}
+
+TEST(TestSortUtilsBenchmark, DISABLED_SortByArtist)
+{
+  BenchmarkSort(SortByArtist, SortOrderAscending, SortAttributeNone, "SortByArtist");
+}
+
+TEST(TestSortUtilsBenchmark, DISABLED_SortByArtistDescending)
+{
+  BenchmarkSort(SortByArtist, SortOrderDescending, SortAttributeNone, "SortByArtist descending");
+}
+
+TEST(TestSortUtilsBenchmark, DISABLED_SortByLabelIgnoreFolders)
+{
+  BenchmarkSort(SortByLabel, SortOrderAscending, SortAttributeIgnoreFolders, "SortByLabel ignoring folders");
+}
+
+TEST(TestSortUtilsBenchmark, DISABLED_SortByYear)
+{
+  BenchmarkSort(SortByYear, SortOrderAscending, SortAttributeNone, "SortByYear");
+}
@@ -348,3 +348,90 @@ TEST(TestVariant, isMember)
   EXPECT_TRUE(a.isMember("key1"));
   EXPECT_FALSE(a.isMember("key2"));
 }
+
+TEST(TestVariant, map_order)
+{
+  CVariant a;
+  a["key3"] = 3;
+  a["key1"] = 1;
+  a["key4"] = 4;
+  a["key2"] = 2;
+  a.erase("key3");
+
+  ASSERT_EQ((unsigned int)3, a.size());
+  CVariant::const_iterator_map it = a.begin_map();
+  EXPECT_STREQ("key1", it->first.c_str());
+  it++;
+  EXPECT_STREQ("key2", it->first.c_str());
+  it++;
+  EXPECT_STREQ("key4", it->first.c_str());
+  EXPECT_EQ(4, a["key4"].asInteger());
+}
+
+TEST(TestVariant, copy_on_write)
+{
+  CVariant a;
+  a["key1"] = "string1";
+  a["key2"].push_back("string2");
+
+  CVariant b = a;
+  EXPECT_TRUE(a == b);
+
+  b["key1"] = "string3";
+  b["key2"].push_back("string4");
+  EXPECT_STREQ("string1", a["key1"].c_str());
+  EXPECT_EQ((unsigned int)1, a["key2"].size());
+  EXPECT_STREQ("string3", b["key1"].c_str());
+  EXPECT_EQ((unsigned int)2, b["key2"].size());
+
+  CVariant c = a;
+  c.clear();
+  EXPECT_TRUE(c.empty());
+  EXPECT_EQ((unsigned int)2, a.size());
+
+  // assigning a member to its parent
+  a = a["key2"];
+  EXPECT_TRUE(a.isArray());
+  EXPECT_STREQ("string2", a[0].c_str());
+}
+
+TEST(TestVariant, member_reference)
+{
+  CVariant a;
+  a["m"] = "string1";
+  CVariant &m = a["m"];
+
+  // inserting members before and after doesn't move the held one
+  a["a"] = "string2";
+  a["z"] = "string3";
+  EXPECT_STREQ("string1", m.asString().c_str());
+
+  // assigning a member to a new member of the same object
+  a["thumbnail"] = a["m"];
+  EXPECT_STREQ("string1", a["thumbnail"].c_str());
+
+  // a copy made while the reference is held doesn't see changes through it
+  CVariant b = a;
+  m = "string4";
+  EXPECT_STREQ("string4", a["m"].c_str());
+  EXPECT_STREQ("string1", b["m"].c_str());
+
+  CVariant c;
+  c.push_back("string5");
+  CVariant &e = c[0];
+  CVariant d = c;
+  e = "string6";
+  EXPECT_STREQ("string6", c[0].c_str());
+  EXPECT_STREQ("string5", d[0].c_str());
+}
+
+TEST(TestVariant, swap_string)
+{
+  CVariant a("string"), b;
+  b["key"] = 1;
+
+  a.swap(b);
+  EXPECT_TRUE(a.isObject());
+  EXPECT_EQ(1, a["key"].asInteger());
+  EXPECT_STREQ("string", b.c_str());
+}
@@ -0,0 +1,151 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/JSONVariantWriter.h"
+#include "utils/Stopwatch.h"
+#include "utils/StdString.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+/* the benchmarks only print timings, so they are disabled in the normal
+   run. use --gtest_also_run_disabled_tests --gtest_filter=*Benchmark* */
+
+#define BENCHMARK_MOVIES 5000
+
+/* Builds the result of a VideoLibrary.GetMovies request asking for most
+   of the properties a skin shows in the movie library */
+static void BuildMovies(CVariant &result)
+{
+  for (int i = 0; i < BENCHMARK_MOVIES; i++)
+  {
+    CStdString title, path;
+    title.Format("Movie %d", i);
+    path.Format("smb://server/movies/Movie %d (%d)/movie.mkv", i, 1950 + i % 60);
+
+    CVariant movie;
+    movie["movieid"] = i + 1;
+    movie["label"] = title;
+    movie["title"] = title;
+    movie["originaltitle"] = title;
+    movie["sorttitle"] = "";
+    movie["file"] = path;
+    movie["year"] = 1950 + i % 60;
+    movie["rating"] = 5.0 + (i % 50) / 10.0;
+    movie["votes"] = "12,345";
+    movie["runtime"] = "120";
+    movie["mpaa"] = "Rated PG-13";
+    movie["tagline"] = "A tagline that is a little bit longer than the small string buffer";
+    movie["plot"] = "A plot outline which is long enough to never fit into any inline buffer and is "
+                    "therefore a good representation of what the plot of a real movie looks like.";
+    movie["playcount"] = i % 3;
+    movie["lastplayed"] = "2012-10-01 20:15:00";
+    movie["dateadded"] = "2012-09-30 18:00:00";
+    movie["imdbnumber"] = "tt0123456";
+    movie["thumbnail"] = "image://smb%3a%2f%2fserver%2fmovies%2fposter.jpg/";
+    movie["fanart"] = "image://smb%3a%2f%2fserver%2fmovies%2ffanart.jpg/";
+
+    for (int j = 0; j < 3; j++)
+    {
+      movie["genre"].push_back("Genre");
+      movie["director"].push_back("Director");
+      movie["studio"].push_back("Studio");
+    }
+
+    for (int j = 0; j < 10; j++)
+    {
+      CVariant actor;
+      actor["name"] = "Actor Name";
+      actor["role"] = "Role";
+      actor["thumbnail"] = "image://http%3a%2f%2fimages.example.com%2factor.jpg/";
+      movie["cast"].push_back(actor);
+    }
+
+    CVariant video;
+    video["codec"] = "h264";
+    video["aspect"] = 1.78f;
+    video["width"] = 1920;
+    video["height"] = 1080;
+    video["duration"] = 7200;
+    movie["streamdetails"]["video"].push_back(video);
+    CVariant audio;
+    audio["codec"] = "dca";
+    audio["channels"] = 6;
+    audio["language"] = "eng";
+    movie["streamdetails"]["audio"].push_back(audio);
+
+    result["movies"].push_back(movie);
+  }
+
+  result["limits"]["start"] = 0;
+  result["limits"]["end"] = BENCHMARK_MOVIES;
+  result["limits"]["total"] = BENCHMARK_MOVIES;
+}
+
+TEST(TestVariantBenchmark, DISABLED_Build)
+{
+  CStopWatch watch;
+  watch.StartZero();
+  CVariant result;
+  BuildMovies(result);
+  float elapsed = watch.GetElapsedMilliseconds();
+
+  EXPECT_EQ((unsigned int)BENCHMARK_MOVIES, result["movies"].size());
+  EXPECT_EQ((unsigned int)10, result["movies"][0]["cast"].size());
+
+  std::cout << "Building " << BENCHMARK_MOVIES << " movies: " <<
+    testing::PrintToString(elapsed) << " ms" << std::endl;
+}
+
+TEST(TestVariantBenchmark, DISABLED_Copy)
+{
+  CVariant result;
+  BuildMovies(result);
+
+  // JSON-RPC copies the result into the response object
+  CStopWatch watch;
+  watch.StartZero();
+  CVariant response;
+  response["jsonrpc"] = "2.0";
+  response["id"] = 1;
+  response["result"] = result;
+  float elapsed = watch.GetElapsedMilliseconds();
+
+  EXPECT_TRUE(response["result"] == result);
+
+  std::cout << "Copying " << BENCHMARK_MOVIES << " movies: " <<
+    testing::PrintToString(elapsed) << " ms" << std::endl;
+}
+
+TEST(TestVariantBenchmark, DISABLED_Serialize)
+{
+  CVariant result;
+  BuildMovies(result);
+
+  CStopWatch watch;
+  watch.StartZero();
+  std::string json = CJSONVariantWriter::Write(result, true);
+  float elapsed = watch.GetElapsedMilliseconds();
+
+  EXPECT_FALSE(json.empty());
+
+  std::cout << "Serializing " << BENCHMARK_MOVIES << " movies (" << json.size() << " bytes): " <<
+    testing::PrintToString(elapsed) << " ms" << std::endl;
+}
@@ -113,6 +113,10 @@ bool CVideoDatabase::CreateTables()
     m_pDS->exec("CREATE TABLE stacktimes (idFile integer, times text)\n");
     m_pDS->exec("CREATE UNIQUE INDEX ix_stacktimes ON stacktimes ( idFile )\n");
 
+    CLog::Log(LOGINFO, "create keyframes table");
+    m_pDS->exec("CREATE TABLE keyframes (idFile integer, keyframes text)\n");
+    m_pDS->exec("CREATE UNIQUE INDEX ix_keyframes ON keyframes ( idFile )\n");
+
     CLog::Log(LOGINFO, "create genre table");
     m_pDS->exec("CREATE TABLE genre ( idGenre integer primary key, strGenre text)\n");
 
@@ -2338,31 +2342,52 @@ void CVideoDatabase::SetStreamDetailsForFileId(const CStreamDetails& details, in
     BeginTransaction();
     m_pDS->exec(PrepareSQL("DELETE FROM streamdetails WHERE idFile = %i", idFile));
 
-    for (int i=1; i<=details.GetVideoStreamCount(); i++)
+    // every stream type is written through the same statement, the columns it
+    // doesn't use are left NULL. it stays prepared for the next file of a scan
+    bool bInserted = BeginBulkInsert("INSERT INTO streamdetails "
+      "(idFile, iStreamType, strVideoCodec, fVideoAspect, iVideoWidth, iVideoHeight, iVideoDuration, "
+      "strAudioCodec, iAudioChannels, strAudioLanguage, strSubtitleLanguage) "
+      "VALUES (?,?,?,?,?,?,?,?,?,?,?)");
+
+    field_value null;
+    null.set_isNull();
+    vector<field_value> row(11, null);
+    row[0] = field_value(idFile);
+
+    for (int i=1; bInserted && i<=details.GetVideoStreamCount(); i++)
     {
-      m_pDS->exec(PrepareSQL("INSERT INTO streamdetails "
-        "(idFile, iStreamType, strVideoCodec, fVideoAspect, iVideoWidth, iVideoHeight, iVideoDuration) "
-        "VALUES (%i,%i,'%s',%f,%i,%i,%i)",
-        idFile, (int)CStreamDetail::VIDEO,
-        details.GetVideoCodec(i).c_str(), details.GetVideoAspect(i),
-        details.GetVideoWidth(i), details.GetVideoHeight(i), details.GetVideoDuration(i)));
+      row[1] = field_value((int)CStreamDetail::VIDEO);
+      row[2] = field_value(details.GetVideoCodec(i).c_str());
+      row[3] = field_value(details.GetVideoAspect(i));
+      row[4] = field_value(details.GetVideoWidth(i));
+      row[5] = field_value(details.GetVideoHeight(i));
+      row[6] = field_value(details.GetVideoDuration(i));
+      bInserted = BulkInsertRow(row);
     }
-    for (int i=1; i<=details.GetAudioStreamCount(); i++)
+    row.assign(11, null);
+    row[0] = field_value(idFile);
+    for (int i=1; bInserted && i<=details.GetAudioStreamCount(); i++)
     {
-      m_pDS->exec(PrepareSQL("INSERT INTO streamdetails "
-        "(idFile, iStreamType, strAudioCodec, iAudioChannels, strAudioLanguage) "
-        "VALUES (%i,%i,'%s',%i,'%s')",
-        idFile, (int)CStreamDetail::AUDIO,
-        details.GetAudioCodec(i).c_str(), details.GetAudioChannels(i),
-        details.GetAudioLanguage(i).c_str()));
+      row[1] = field_value((int)CStreamDetail::AUDIO);
+      row[7] = field_value(details.GetAudioCodec(i).c_str());
+      row[8] = field_value(details.GetAudioChannels(i));
+      row[9] = field_value(details.GetAudioLanguage(i).c_str());
+      bInserted = BulkInsertRow(row);
     }
-    for (int i=1; i<=details.GetSubtitleStreamCount(); i++)
+    row.assign(11, null);
+    row[0] = field_value(idFile);
+    for (int i=1; bInserted && i<=details.GetSubtitleStreamCount(); i++)
     {
-      m_pDS->exec(PrepareSQL("INSERT INTO streamdetails "
-        "(idFile, iStreamType, strSubtitleLanguage) "
-        "VALUES (%i,%i,'%s')",
-        idFile, (int)CStreamDetail::SUBTITLE,
-        details.GetSubtitleLanguage(i).c_str()));
+      row[1] = field_value((int)CStreamDetail::SUBTITLE);
+      row[10] = field_value(details.GetSubtitleLanguage(i).c_str());
+      bInserted = BulkInsertRow(row);
+    }
+
+    if (!bInserted)
+    {
+      RollbackTransaction();
+      CLog::Log(LOGERROR, "%s (%i) failed", __FUNCTION__, idFile);
+      return;
     }
 
     // update the runtime information, if empty
@@ -3786,6 +3811,55 @@ void CVideoDatabase::SetStackTimes(const CStdString& filePath, vector<int> &time
   }
 }
 
+/// \brief GetKeyframeIndex() obtains the saved keyframe index of a video file
+/// \retval Returns true if a keyframe index exists, false otherwise.
+bool CVideoDatabase::GetKeyframeIndex(const CStdString &filePath, CStdString &index)
+{
+  try
+  {
+    int idFile = GetFileId(filePath);
+    if (idFile < 0) return false;
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    CStdString strSQL=PrepareSQL("select keyframes from keyframes where idFile=%i\n", idFile);
+    m_pDS->query( strSQL.c_str() );
+    if (m_pDS->num_rows() > 0)
+    {
+      index = m_pDS->fv("keyframes").get_asString();
+      m_pDS->close();
+      return !index.IsEmpty();
+    }
+    m_pDS->close();
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+  return false;
+}
+
+/// \brief Sets the keyframe index for a particular video file
+void CVideoDatabase::SetKeyframeIndex(const CStdString &filePath, const CStdString &index)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return ;
+    if (NULL == m_pDS.get()) return ;
+    int idFile = AddFile(filePath);
+    if (idFile < 0)
+      return;
+
+    m_pDS->exec( PrepareSQL("delete from keyframes where idFile=%i", idFile) );
+    if (!index.IsEmpty())
+      m_pDS->exec( PrepareSQL("insert into keyframes (idFile,keyframes) values (%i,'%s')\n", idFile, index.c_str()) );
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s (%s) failed", __FUNCTION__, filePath.c_str());
+  }
+}
+
 void CVideoDatabase::RemoveContentForPath(const CStdString& strPath, CGUIDialogProgress *progress /* = NULL */)
 {
   if(URIUtils::IsMultiPath(strPath))
@@ -4317,6 +4391,11 @@ bool CVideoDatabase::UpdateOldVersion(int iVersion)
     m_pDS->exec("CREATE INDEX ix_path ON path ( strPath(255) )");
     m_pDS->exec("CREATE INDEX ix_files ON files ( idPath, strFilename(255) )");
   }
+  if (iVersion < 76)
+  {
+    m_pDS->exec("CREATE TABLE keyframes (idFile integer, keyframes text)\n");
+    m_pDS->exec("CREATE UNIQUE INDEX ix_keyframes ON keyframes ( idFile )\n");
+  }
   // always recreate the view after any table change
   CreateViews();
   return true;
@@ -4324,7 +4403,7 @@ bool CVideoDatabase::UpdateOldVersion(int iVersion)
 
 int CVideoDatabase::GetMinVersion() const
 {
-  return 75;
+  return 76;
 }
 
 bool CVideoDatabase::LookupByFolders(const CStdString &path, bool shows)
@@ -7873,6 +7952,10 @@ void CVideoDatabase::CleanDatabase(CGUIDialogProgressBarHandle* handle, const se
       CLog::Log(LOGDEBUG, "%s: Cleaning stacktimes table", __FUNCTION__);
       sql = "delete from stacktimes where idFile in " + filesToDelete;
       m_pDS->exec(sql.c_str());
+
+      CLog::Log(LOGDEBUG, "%s: Cleaning keyframes table", __FUNCTION__);
+      sql = "delete from keyframes where idFile in " + filesToDelete;
+      m_pDS->exec(sql.c_str());
     }
 
     if ( ! moviesToDelete.IsEmpty() )
@@ -19,6 +19,7 @@
  */
 
 #include "threads/SystemClock.h"
+#include "threads/SingleLock.h"
 #include "FileItem.h"
 #include "VideoInfoScanner.h"
 #include "addons/AddonManager.h"
@@ -68,12 +69,129 @@ namespace VIDEO
     m_itemCount = 0;
     m_bClean = false;
     m_scanAll = false;
+    m_prefetcher = NULL;
+    m_scanStart = 0;
+    m_scannedItems = 0;
   }
 
   CVideoInfoScanner::~CVideoInfoScanner()
   {
   }
 
+  class CVideoInfoScanner::CPrefetchJob : public CJob
+  {
+  public:
+    CPrefetchJob(const CStdString &directory, CONTENT_TYPE content, const CStdString &dbHash)
+      : m_directory(directory), m_content(content), m_dbHash(dbHash), m_listed(false), m_items(new CFileItemList)
+    {
+    }
+
+    virtual const char *GetType() const { return "videoscanprefetch"; }
+
+    virtual bool operator==(const CJob *job) const
+    {
+      if (strcmp(job->GetType(), GetType()) == 0)
+        return m_directory == ((const CPrefetchJob *)job)->m_directory;
+      return false;
+    }
+
+    /* must match what DoScan() does with a directory it lists itself */
+    virtual bool DoWork()
+    {
+      if (m_content == CONTENT_TVSHOWS)
+      {
+        CDirectory::GetDirectory(m_directory, *m_items, g_settings.m_videoExtensions);
+        m_items->SetPath(m_directory);
+      }
+      else
+      {
+        m_fastHash = GetFastHash(m_directory);
+        if (!m_fastHash.IsEmpty() && m_fastHash == m_dbHash)
+          return true; // unchanged, so DoScan() won't need the listing
+
+        CDirectory::GetDirectory(m_directory, *m_items, g_settings.m_videoExtensions);
+        m_items->Stack();
+      }
+      GetPathHash(*m_items, m_hash);
+      m_listed = true;
+      return true;
+    }
+
+    CStdString m_directory;
+    CONTENT_TYPE m_content;
+    CStdString m_dbHash;
+    CStdString m_fastHash;
+    CStdString m_hash;
+    bool m_listed;
+    boost::shared_ptr<CFileItemList> m_items;
+  };
+
+  CVideoInfoScanner::CPrefetcher::CPrefetcher(unsigned int jobsAtOnce, const volatile bool &stop)
+    : CJobQueue(false, jobsAtOnce, CJob::PRIORITY_LOW), m_stop(stop)
+  {
+  }
+
+  CVideoInfoScanner::CPrefetcher::~CPrefetcher()
+  {
+    CancelJobs();
+  }
+
+  bool CVideoInfoScanner::CPrefetcher::IsQueued(const CStdString &directory)
+  {
+    CSingleLock lock(m_lock);
+    return m_pending.find(directory) != m_pending.end() || m_results.find(directory) != m_results.end();
+  }
+
+  void CVideoInfoScanner::CPrefetcher::Prefetch(const CStdString &directory, CONTENT_TYPE content, const CStdString &dbHash)
+  {
+    {
+      CSingleLock lock(m_lock);
+      if (!m_pending.insert(directory).second)
+        return;
+    }
+    AddJob(new CPrefetchJob(directory, content, dbHash));
+  }
+
+  bool CVideoInfoScanner::CPrefetcher::Get(const CStdString &directory, CFileItemList &items, CStdString &fastHash, CStdString &hash, bool &listed)
+  {
+    CSingleLock lock(m_lock);
+    while (m_pending.find(directory) != m_pending.end())
+    {
+      if (m_stop)
+        return false;
+      CSingleExit exit(m_lock);
+      m_completed.WaitMSec(100);
+    }
+
+    map<CStdString, SResult>::iterator it = m_results.find(directory);
+    if (it == m_results.end())
+      return false;
+
+    listed = it->second.listed;
+    fastHash = it->second.fastHash;
+    hash = it->second.hash;
+    if (listed)
+      items.Copy(*it->second.items);
+    m_results.erase(it);
+    return true;
+  }
+
+  void CVideoInfoScanner::CPrefetcher::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+  {
+    CPrefetchJob *prefetch = (CPrefetchJob *)job;
+    {
+      CSingleLock lock(m_lock);
+      SResult &result = m_results[prefetch->m_directory];
+      result.listed = success && prefetch->m_listed;
+      result.fastHash = prefetch->m_fastHash;
+      result.hash = prefetch->m_hash;
+      result.items = prefetch->m_items;
+      m_pending.erase(prefetch->m_directory);
+    }
+    m_completed.Set();
+    CJobQueue::OnJobComplete(jobID, success, job);
+  }
+
   void CVideoInfoScanner::Process()
   {
     try
@@ -97,6 +215,11 @@ namespace VIDEO
       // Reset progress vars
       m_currentItem = 0;
       m_itemCount = -1;
+      m_scanStart = tick;
+      m_scannedItems = 0;
+
+      if (g_advancedSettings.m_videoScannerThreads > 1)
+        m_prefetcher = new CPrefetcher(g_advancedSettings.m_videoScannerThreads, m_bStop);
 
       SetPriority(GetMinPriority());
 
@@ -115,6 +238,15 @@ namespace VIDEO
          * occurs.
          */
         CStdString directory = *m_pathsToScan.begin();
+
+        // keep the next few sources listing while this one is scanned
+        if (m_prefetcher)
+        {
+          set<CStdString>::iterator it = m_pathsToScan.begin();
+          for (int i = 0; i < g_advancedSettings.m_videoScannerThreads && it != m_pathsToScan.end(); ++i, ++it)
+            Prefetch(*it);
+        }
+
         if (!CDirectory::Exists(directory))
         {
           /*
@@ -144,13 +276,17 @@ namespace VIDEO
       m_database.Close();
 
       tick = XbmcThreads::SystemClockMillis() - tick;
-      CLog::Log(LOGNOTICE, "VideoInfoScanner: Finished scan. Scanning for video info took %s", StringUtils::SecondsToTimeString(tick / 1000).c_str());
+      CLog::Log(LOGNOTICE, "VideoInfoScanner: Finished scan. Scanning for video info took %s (%u items, %.1f items/sec)",
+                StringUtils::SecondsToTimeString(tick / 1000).c_str(), m_scannedItems, tick ? m_scannedItems * 1000.0f / tick : 0.0f);
     }
     catch (...)
     {
       CLog::Log(LOGERROR, "VideoInfoScanner: Exception while scanning.");
     }
-    
+
+    delete m_prefetcher;
+    m_prefetcher = NULL;
+
     m_bRunning = false;
     ANNOUNCEMENT::CAnnouncementManager::Announce(ANNOUNCEMENT::VideoLibrary, "xbmc", "OnScanFinished");
 
@@ -260,22 +396,30 @@ namespace VIDEO
       if (m_handle)
       {
         int str = content == CONTENT_MOVIES ? 20317:20318;
-        m_handle->SetTitle(StringUtils::Format(g_localizeStrings.Get(str), info->Name().c_str()));
+        SetProgressTitle(StringUtils::Format(g_localizeStrings.Get(str), info->Name().c_str()));
       }
 
-      CStdString fastHash = GetFastHash(strDirectory);
+      CStdString fastHash;
+      bool listed = false;
+      if (!m_prefetcher || !m_prefetcher->Get(strDirectory, items, fastHash, hash, listed))
+        fastHash = GetFastHash(strDirectory);
       if (m_database.GetPathHash(strDirectory, dbHash) && !fastHash.IsEmpty() && fastHash == dbHash)
       { // fast hashes match - no need to process anything
         CLog::Log(LOGDEBUG, "VideoInfoScanner: Skipping dir '%s' due to no change (fasthash)", strDirectory.c_str());
+        items.Clear();
         hash = fastHash;
         bSkip = true;
       }
       if (!bSkip)
-      { // need to fetch the folder
-        CDirectory::GetDirectory(strDirectory, items, g_settings.m_videoExtensions);
-        items.Stack();
-        // compute hash
-        GetPathHash(items, hash);
+      {
+        if (!listed)
+        { // need to fetch the folder
+          CDirectory::GetDirectory(strDirectory, items, g_settings.m_videoExtensions);
+          items.Stack();
+          // compute hash
+          GetPathHash(items, hash);
+        }
+        m_scannedItems += items.Size();
         if (hash != dbHash && !hash.IsEmpty())
         {
           if (dbHash.IsEmpty())
@@ -304,13 +448,19 @@ namespace VIDEO
     else if (content == CONTENT_TVSHOWS)
     {
       if (m_handle)
-        m_handle->SetTitle(StringUtils::Format(g_localizeStrings.Get(20319), info->Name().c_str()));
+        SetProgressTitle(StringUtils::Format(g_localizeStrings.Get(20319), info->Name().c_str()));
 
       if (foundDirectly && !settings.parent_name_root)
       {
-        CDirectory::GetDirectory(strDirectory, items, g_settings.m_videoExtensions);
-        items.SetPath(strDirectory);
-        GetPathHash(items, hash);
+        CStdString fastHash;
+        bool listed = false;
+        if (!m_prefetcher || !m_prefetcher->Get(strDirectory, items, fastHash, hash, listed) || !listed)
+        {
+          CDirectory::GetDirectory(strDirectory, items, g_settings.m_videoExtensions);
+          items.SetPath(strDirectory);
+          GetPathHash(items, hash);
+        }
+        m_scannedItems += items.Size();
         bSkip = true;
         if (!m_database.GetPathHash(strDirectory, dbHash) || dbHash != hash)
         {
@@ -355,6 +505,17 @@ namespace VIDEO
     if (m_handle)
       OnDirectoryScanned(strDirectory);
 
+    // let the prefetcher list the subfolders while we work through them
+    if (m_prefetcher && settings.recurse > 0 && content != CONTENT_TVSHOWS)
+    {
+      for (int i = 0; i < items.Size() && !m_bStop; ++i)
+      {
+        CFileItemPtr pItem = items[i];
+        if (pItem->m_bIsFolder && !pItem->IsParentFolder() && !pItem->IsPlayList())
+          Prefetch(pItem->GetPath());
+      }
+    }
+
     for (int i = 0; i < items.Size(); ++i)
     {
       CFileItemPtr pItem = items[i];
@@ -375,6 +536,43 @@ namespace VIDEO
     return !m_bStop;
   }
 
+  void CVideoInfoScanner::Prefetch(const CStdString& strDirectory)
+  {
+    if (m_prefetcher->IsQueued(strDirectory))
+      return;
+
+    // same checks as DoScan(), so we only list what will be scanned
+    SScanSettings settings;
+    bool foundDirectly = false;
+    ScraperPtr info = m_database.GetScraperForPath(strDirectory, settings, foundDirectly);
+    CONTENT_TYPE content = info ? info->Content() : CONTENT_NONE;
+    if (content == CONTENT_NONE || (!m_scanAll && settings.noupdate))
+      return;
+
+    if (content == CONTENT_TVSHOWS && (!foundDirectly || settings.parent_name_root))
+      return; // shows are listed while their episodes are fetched
+
+    if (CUtil::ExcludeFileOrFolder(strDirectory, content == CONTENT_TVSHOWS ? g_advancedSettings.m_tvshowExcludeFromScanRegExps
+                                                                            : g_advancedSettings.m_moviesExcludeFromScanRegExps))
+      return;
+
+    CStdString dbHash;
+    m_database.GetPathHash(strDirectory, dbHash);
+    m_prefetcher->Prefetch(strDirectory, content, dbHash);
+  }
+
+  void CVideoInfoScanner::SetProgressTitle(const CStdString& title)
+  {
+    if (!m_handle)
+      return;
+
+    unsigned int elapsed = XbmcThreads::SystemClockMillis() - m_scanStart;
+    if (m_scannedItems && elapsed)
+      m_handle->SetTitle(StringUtils::Format(g_localizeStrings.Get(20465), title.c_str(), m_scannedItems * 1000.0f / elapsed));
+    else
+      m_handle->SetTitle(title);
+  }
+
   bool CVideoInfoScanner::RetrieveVideoInfo(CFileItemList& items, bool bDirNames, CONTENT_TYPE content, bool useLocal, CScraperUrl* pURL, bool fetchEpisodes, CGUIDialogProgress* pDlgProgress)
   {
     if (pDlgProgress)
@@ -1667,7 +1865,7 @@ namespace VIDEO
     return items.GetFolderCount() == 0;
   }
 
-  CStdString CVideoInfoScanner::GetFastHash(const CStdString &directory) const
+  CStdString CVideoInfoScanner::GetFastHash(const CStdString &directory)
   {
     struct __stat64 buffer;
     if (XFILE::CFile::Stat(directory, &buffer) == 0)
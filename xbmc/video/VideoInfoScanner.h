@@ -19,6 +19,8 @@
  *
  */
 #include "threads/Thread.h"
+#include "threads/Event.h"
+#include "utils/JobManager.h"
 #include "VideoDatabase.h"
 #include "addons/Scraper.h"
 #include "NfoFile.h"
@@ -121,9 +123,61 @@ namespace VIDEO
     static std::string GetFanart(CFileItem *pItem, bool useLocal);
 
   protected:
+    class CPrefetchJob;
+
+    /*! \brief Lists and hashes directories ahead of the scan using job manager workers.
+     Only the scanner thread touches the database, so the scraper and stored hash are looked
+     up before a directory is handed out, and the results are picked up again by DoScan().
+     */
+    class CPrefetcher : public CJobQueue
+    {
+    public:
+      CPrefetcher(unsigned int jobsAtOnce, const volatile bool &stop);
+      virtual ~CPrefetcher();
+
+      bool IsQueued(const CStdString &directory);
+      void Prefetch(const CStdString &directory, CONTENT_TYPE content, const CStdString &dbHash);
+
+      /*! \brief Fetch the result for a directory, waiting for it if it's still being listed
+       \param directory the directory to fetch
+       \param items [out] the listing, if the directory had to be listed
+       \param fastHash [out] the fast hash of the directory, movies and music videos only
+       \param hash [out] the hash of the listing, if the directory had to be listed
+       \param listed [out] whether the directory was listed
+       \return true if the directory was prefetched, false if it must be fetched by the caller
+       */
+      bool Get(const CStdString &directory, CFileItemList &items, CStdString &fastHash, CStdString &hash, bool &listed);
+
+      virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
+    private:
+      struct SResult
+      {
+        SResult() : listed(false) {}
+        bool listed;
+        CStdString fastHash;
+        CStdString hash;
+        boost::shared_ptr<CFileItemList> items;
+      };
+      CCriticalSection m_lock;
+      CEvent m_completed;
+      std::set<CStdString> m_pending;
+      std::map<CStdString, SResult> m_results;
+      const volatile bool &m_stop;
+    };
+
     virtual void Process();
     bool DoScan(const CStdString& strDirectory);
 
+    /*! \brief Queue a directory to be listed by the prefetcher, if it will be scanned
+     \param strDirectory the directory to list
+     */
+    void Prefetch(const CStdString& strDirectory);
+
+    /*! \brief Set the title of the progress dialog, including the current scan rate
+     \param title the title to set
+     */
+    void SetProgressTitle(const CStdString& title);
+
     INFO_RET RetrieveInfoForTvShow(CFileItem *pItem, bool bDirNames, ADDON::ScraperPtr &scraper, bool useLocal, CScraperUrl* pURL, bool fetchEpisodes, CGUIDialogProgress* pDlgProgress);
     INFO_RET RetrieveInfoForMovie(CFileItem *pItem, bool bDirNames, ADDON::ScraperPtr &scraper, bool useLocal, CScraperUrl* pURL, CGUIDialogProgress* pDlgProgress);
     INFO_RET RetrieveInfoForMusicVideo(CFileItem *pItem, bool bDirNames, ADDON::ScraperPtr &scraper, bool useLocal, CScraperUrl* pURL, CGUIDialogProgress* pDlgProgress);
@@ -188,7 +242,7 @@ namespace VIDEO
      \param directory folder to hash
      \return the hash of the folder of the form "fast<datetime>"
      */
-    CStdString GetFastHash(const CStdString &directory) const;
+    static CStdString GetFastHash(const CStdString &directory);
 
     /*! \brief Decide whether a folder listing could use the "fast" hash
      Fast hashing can be done whenever the folder contains no scannable subfolders, as the
@@ -238,6 +292,9 @@ namespace VIDEO
     std::set<CStdString> m_pathsToCount;
     std::set<int> m_pathsToClean;
     CNfoFile m_nfoReader;
+    CPrefetcher* m_prefetcher;
+    unsigned int m_scanStart;
+    unsigned int m_scannedItems;
   };
 }
 
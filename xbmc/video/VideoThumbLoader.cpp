@@ -26,6 +26,8 @@
 #include "filesystem/DirectoryCache.h"
 #include "FileItem.h"
 #include "settings/GUISettings.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
 #include "GUIUserMessages.h"
 #include "guilib/GUIWindowManager.h"
 #include "TextureCache.h"
@@ -110,8 +112,19 @@ bool CThumbExtractor::DoWork()
   return result;
 }
 
+CThumbBenchmarkJob::CThumbBenchmarkJob(const CStdString& directory, unsigned int threads)
+{
+  m_directory = directory;
+  m_threads = threads;
+}
+
+bool CThumbBenchmarkJob::DoWork()
+{
+  return CDVDFileInfo::BenchmarkExtractThumbs(m_directory, m_threads);
+}
+
 CVideoThumbLoader::CVideoThumbLoader() :
-  CThumbLoader(1), CJobQueue(true), m_pStreamDetailsObs(NULL)
+  CThumbLoader(1), CJobQueue(true, g_advancedSettings.m_videoExtractThreads), m_pStreamDetailsObs(NULL)
 {
   m_database = new CVideoDatabase();
 }
@@ -431,6 +444,7 @@ void CVideoThumbLoader::OnJobComplete(unsigned int jobID, bool success, CJob* jo
 {
   if (success)
   {
+    CSingleLock lock(m_callbackSection);
     CThumbExtractor* loader = (CThumbExtractor*)job;
     loader->m_item.SetPath(loader->m_listpath);
     CVideoInfoTag* info = loader->m_item.GetVideoInfoTag();
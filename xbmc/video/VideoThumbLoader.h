@@ -23,6 +23,7 @@
 #include "ThumbLoader.h"
 #include "utils/JobManager.h"
 #include "FileItem.h"
+#include "threads/CriticalSection.h"
 
 #define kJobTypeMediaFlags "mediaflags"
 
@@ -62,6 +63,31 @@ public:
   bool       m_thumb; ///< extract thumb?
 };
 
+/*!
+ \ingroup thumbs,jobs
+ \brief Thumb extraction benchmark job class
+
+ Extracts thumbs from all videos in a directory with a number of threads and logs the timings.
+
+ \sa CDVDFileInfo::BenchmarkExtractThumbs()
+ */
+class CThumbBenchmarkJob : public CJob
+{
+public:
+  CThumbBenchmarkJob(const CStdString& directory, unsigned int threads);
+
+  virtual bool DoWork();
+
+  virtual const char* GetType() const
+  {
+    return "thumbbenchmark";
+  }
+
+private:
+  CStdString   m_directory;
+  unsigned int m_threads;
+};
+
 class CVideoThumbLoader : public CThumbLoader, public CJobQueue
 {
 public:
@@ -128,6 +154,7 @@ protected:
   virtual void OnLoaderFinish();
 
   IStreamDetailsObserver *m_pStreamDetailsObs;
+  CCriticalSection m_callbackSection; ///< extraction jobs run in parallel, their callbacks don't
   CVideoDatabase *m_database;
   typedef std::map<int, std::map<std::string, std::string> > ArtCache;
   ArtCache m_showArt;